@@ -0,0 +1,133 @@
+
+#include <loco.h>
+#include <chrono>
+#include <map>
+
+#include <loco_simulation_mujoco.h>
+
+// Contact-collection benchmark: compares the previous name-keyed collection (std::map of vectors,
+// strings created per contact) against the flat geom-indexed contact-buffer used by the backend.
+// Usage: ./bench_contacts_mujoco [num-bodies] [num-iterations]
+
+std::unique_ptr<loco::TScenario> create_contacts_scenario( ssize_t num_bodies )
+{
+    auto scenario = std::make_unique<loco::TScenario>();
+
+    auto floor_data = loco::TBodyData();
+    floor_data.dyntype = loco::eDynamicsType::STATIC;
+    floor_data.collision.type = loco::eShapeType::PLANE;
+    floor_data.collision.size = { 50.0f, 50.0f, 1.0f };
+    floor_data.visual.type = loco::eShapeType::PLANE;
+    floor_data.visual.size = { 50.0f, 50.0f, 1.0f };
+    scenario->AddSingleBody( std::make_unique<loco::primitives::TSingleBody>( "floor", floor_data, loco::TVec3( 0.0f, 0.0f, 0.0f ), loco::TMat3() ) );
+
+    // Boxes resting on the floor (4 contacts each against the floor)
+    const ssize_t grid_size = std::ceil( std::sqrt( (double)num_bodies ) );
+    for ( ssize_t i = 0; i < num_bodies; i++ )
+    {
+        auto body_data = loco::TBodyData();
+        body_data.dyntype = loco::eDynamicsType::DYNAMIC;
+        body_data.collision.type = loco::eShapeType::BOX;
+        body_data.collision.size = { 0.2f, 0.2f, 0.2f };
+        body_data.visual.type = loco::eShapeType::BOX;
+        body_data.visual.size = { 0.2f, 0.2f, 0.2f };
+        const loco::TVec3 position = { 0.4f * ( i % grid_size ), 0.4f * ( i / grid_size ), 0.1f };
+        scenario->AddSingleBody( std::make_unique<loco::primitives::TSingleBody>( "box_" + std::to_string( i ), body_data, position, loco::TMat3() ) );
+    }
+    return scenario;
+}
+
+// Reference implementation of the previous collection strategy (kept here only for comparison)
+void collect_contacts_legacy( const mjModel* mjc_model, const mjData* mjc_data, loco::TScenario* scenario )
+{
+    std::map< std::string, std::vector<loco::TContactData> > detected_contacts;
+    for ( ssize_t i = 0; i < mjc_data->ncon; i++ )
+    {
+        const auto& mjc_contact_info = mjc_data->contact[i];
+        if ( mjc_contact_info.geom1 == -1 || mjc_contact_info.geom2 == -1 )
+            continue;
+
+        const std::string collider_1 = mj_id2name( mjc_model, mjOBJ_GEOM, mjc_contact_info.geom1 );
+        const std::string collider_2 = mj_id2name( mjc_model, mjOBJ_GEOM, mjc_contact_info.geom2 );
+        const loco::TVec3 position = { (loco::TScalar) mjc_contact_info.pos[0],
+                                       (loco::TScalar) mjc_contact_info.pos[1],
+                                       (loco::TScalar) mjc_contact_info.pos[2] };
+        const loco::TVec3 normal = { (loco::TScalar) mjc_contact_info.frame[0],
+                                     (loco::TScalar) mjc_contact_info.frame[1],
+                                     (loco::TScalar) mjc_contact_info.frame[2] };
+
+        loco::TContactData contact_1, contact_2;
+        contact_1.position = position;  contact_2.position = position;
+        contact_1.normal = normal;      contact_2.normal = normal.scaled( -1.0 );
+        contact_1.name = collider_2;    contact_2.name = collider_1;
+        detected_contacts[collider_1].push_back( contact_1 );
+        detected_contacts[collider_2].push_back( contact_2 );
+    }
+
+    for ( auto single_body : scenario->GetSingleBodiesList() )
+    {
+        auto collider = single_body->collider();
+        collider->contacts().clear();
+        if ( detected_contacts.find( collider->name() ) != detected_contacts.end() )
+            collider->contacts() = detected_contacts[collider->name()];
+    }
+}
+
+// Same work done by TMujocoSimulation::_CollectContacts after each step
+void collect_contacts_buffer( loco::TMujocoSimulation* simulation, loco::mujoco::TMujocoContactBuffer* contact_buffer,
+                              const std::vector<loco::primitives::TMujocoSingleBodyAdapter*>& adapters )
+{
+    contact_buffer->Collect( simulation->mjc_model(), simulation->mjc_data() );
+    for ( auto adapter : adapters )
+        adapter->UpdateContacts( *contact_buffer );
+}
+
+int main( int argc, char* argv[] )
+{
+    loco::InitUtils();
+
+    const ssize_t num_bodies = ( argc > 1 ) ? std::stoi( argv[1] ) : 500;
+    const ssize_t num_iterations = ( argc > 2 ) ? std::stoi( argv[2] ) : 2000;
+
+    auto scenario = create_contacts_scenario( num_bodies );
+    auto simulation = std::make_unique<loco::TMujocoSimulation>( scenario.get() );
+    if ( !simulation->Initialize() )
+    {
+        std::cout << "ERROR: couldn't initialize simulation" << std::endl;
+        return 1;
+    }
+    // Let the boxes settle, so that the number of contacts is representative
+    for ( ssize_t i = 0; i < 100; i++ )
+        simulation->Step();
+
+    std::vector<loco::primitives::TMujocoSingleBodyAdapter*> adapters;
+    for ( auto single_body : scenario->GetSingleBodiesList() )
+        adapters.push_back( dynamic_cast<loco::primitives::TMujocoSingleBodyAdapter*>( single_body->adapter() ) );
+    auto contact_buffer = std::make_unique<loco::mujoco::TMujocoContactBuffer>();
+    contact_buffer->Resize( simulation->mjc_model() );
+
+    const ssize_t num_contacts = simulation->mjc_data()->ncon;
+    std::cout << "num-bodies     : " << num_bodies << std::endl;
+    std::cout << "num-contacts   : " << num_contacts << std::endl;
+    std::cout << "num-iterations : " << num_iterations << std::endl;
+
+    auto time_start = std::chrono::high_resolution_clock::now();
+    for ( ssize_t i = 0; i < num_iterations; i++ )
+        collect_contacts_legacy( simulation->mjc_model(), simulation->mjc_data(), scenario.get() );
+    auto time_end = std::chrono::high_resolution_clock::now();
+    const double legacy_secs = std::chrono::duration<double>( time_end - time_start ).count();
+
+    time_start = std::chrono::high_resolution_clock::now();
+    for ( ssize_t i = 0; i < num_iterations; i++ )
+        collect_contacts_buffer( simulation.get(), contact_buffer.get(), adapters );
+    time_end = std::chrono::high_resolution_clock::now();
+    const double buffer_secs = std::chrono::duration<double>( time_end - time_start ).count();
+
+    const double total_contacts = (double)num_contacts * num_iterations;
+    std::cout << "legacy (std::map)   : " << ( total_contacts / legacy_secs ) << " contacts/sec ("
+              << ( 1e6 * legacy_secs / num_iterations ) << " us/step)" << std::endl;
+    std::cout << "flat contact-buffer : " << ( total_contacts / buffer_secs ) << " contacts/sec ("
+              << ( 1e6 * buffer_secs / num_iterations ) << " us/step)" << std::endl;
+    std::cout << "speedup             : " << ( legacy_secs / buffer_secs ) << "x" << std::endl;
+    return 0;
+}
\ No newline at end of file
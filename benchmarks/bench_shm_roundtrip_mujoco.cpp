@@ -0,0 +1,100 @@
+#include <loco.h>
+#include <chrono>
+#include <algorithm>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/wait.h>
+
+#include <loco_simulation_mujoco.h>
+#include <loco_shm_server_mujoco.h>
+
+// Shared-memory round-trip benchmark: a server process steps the simulation on request, and this
+// (client) process measures the latency of step requests, compared against stepping in-process.
+// Usage: ./bench_shm_roundtrip_mujoco [num-bodies] [num-iterations]
+
+std::unique_ptr<loco::TScenario> create_shm_scenario( ssize_t num_bodies )
+{
+    auto scenario = std::make_unique<loco::TScenario>();
+    for ( ssize_t i = 0; i < num_bodies; i++ )
+    {
+        auto body_data = loco::TBodyData();
+        body_data.dyntype = loco::eDynamicsType::DYNAMIC;
+        body_data.collision.type = loco::eShapeType::BOX;
+        body_data.collision.size = { 0.2f, 0.2f, 0.2f };
+        body_data.visual.type = loco::eShapeType::BOX;
+        body_data.visual.size = { 0.2f, 0.2f, 0.2f };
+        const loco::TVec3 position = { 0.4f * i, 0.0f, 1.0f };
+        scenario->AddSingleBody( std::make_unique<loco::primitives::TSingleBody>( "box_" + std::to_string( i ), body_data, position, loco::TMat3() ) );
+    }
+    return scenario;
+}
+
+int run_server( const std::string& shm_name, ssize_t num_bodies )
+{
+    auto scenario = create_shm_scenario( num_bodies );
+    auto simulation = std::make_unique<loco::TMujocoSimulation>( scenario.get() );
+    if ( !simulation->Initialize() )
+        return 1;
+    auto server = std::make_unique<loco::mujoco::TMujocoShmServer>( simulation.get(), shm_name );
+    if ( !server->Start() )
+        return 1;
+    server->Serve();
+    return 0;
+}
+
+int main( int argc, char* argv[] )
+{
+    loco::InitUtils();
+
+    const ssize_t num_bodies = ( argc > 1 ) ? std::stoi( argv[1] ) : 10;
+    const ssize_t num_iterations = ( argc > 2 ) ? std::stoi( argv[2] ) : 10000;
+    const std::string shm_name = "/loco_bench_shm_" + std::to_string( getpid() );
+
+    const pid_t server_pid = fork();
+    if ( server_pid == 0 )
+        return run_server( shm_name, num_bodies );
+
+    auto client = std::make_unique<loco::mujoco::TMujocoShmClient>( shm_name );
+    for ( ssize_t i = 0; i < 1000 && !client->Connect(); i++ )
+        usleep( 10000 );
+    if ( !client->connected() )
+    {
+        std::cout << "ERROR: couldn't connect to the shared-memory server" << std::endl;
+        kill( server_pid, SIGKILL );
+        return 1;
+    }
+
+    std::vector<double> latencies_us( num_iterations );
+    for ( ssize_t i = 0; i < num_iterations; i++ )
+    {
+        const auto time_start = std::chrono::high_resolution_clock::now();
+        client->Step();
+        const auto time_end = std::chrono::high_resolution_clock::now();
+        latencies_us[i] = std::chrono::duration<double, std::micro>( time_end - time_start ).count();
+    }
+    client->Close();
+    waitpid( server_pid, nullptr, 0 );
+
+    // Same steps in-process, to isolate the overhead of the round-trip
+    auto scenario = create_shm_scenario( num_bodies );
+    auto simulation = std::make_unique<loco::TMujocoSimulation>( scenario.get() );
+    simulation->Initialize();
+    const auto time_start = std::chrono::high_resolution_clock::now();
+    for ( ssize_t i = 0; i < num_iterations; i++ )
+        simulation->Step();
+    const auto time_end = std::chrono::high_resolution_clock::now();
+    const double local_us = std::chrono::duration<double, std::micro>( time_end - time_start ).count() / num_iterations;
+
+    std::sort( latencies_us.begin(), latencies_us.end() );
+    double mean_us = 0.0;
+    for ( auto latency_us : latencies_us )
+        mean_us += latency_us / num_iterations;
+    std::cout << "num-bodies      : " << num_bodies << std::endl;
+    std::cout << "num-iterations  : " << num_iterations << std::endl;
+    std::cout << "in-process step : " << local_us << " us" << std::endl;
+    std::cout << "round-trip mean : " << mean_us << " us" << std::endl;
+    std::cout << "round-trip p50  : " << latencies_us[num_iterations / 2] << " us" << std::endl;
+    std::cout << "round-trip p99  : " << latencies_us[( 99 * num_iterations ) / 100] << " us" << std::endl;
+    std::cout << "overhead (mean) : " << ( mean_us - local_us ) << " us" << std::endl;
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,156 @@
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+#include <cstring>
+
+#include <loco_simulation_mujoco.h>
+#include <loco_shm_server_mujoco.h>
+
+namespace py = pybind11;
+
+namespace loco {
+namespace mujoco {
+
+    // Simulations are created (and owned) by the loco runtime, so these are exposed as functions over them
+    TMujocoSimulation* to_mjc_simulation( TISimulation* simulation )
+    {
+        auto mjc_simulation = dynamic_cast<TMujocoSimulation*>( simulation );
+        if ( !mjc_simulation )
+            throw py::type_error( "loco_mujoco >>> expected a simulation created with the MuJoCo backend" );
+        return mjc_simulation;
+    }
+
+    py::array_t<mjtNum> mjc_array_to_numpy( const mjtNum* array, ssize_t array_size )
+    {
+        auto np_array = py::array_t<mjtNum>( array_size );
+        std::memcpy( np_array.mutable_data(), array, sizeof( mjtNum ) * array_size );
+        return np_array;
+    }
+
+    void bindings_simulation_mujoco( py::module& m )
+    {
+        m.def( "StepPhase1", []( TISimulation* simulation )
+            {
+                to_mjc_simulation( simulation )->StepPhase1();
+            }, py::arg( "simulation" ) );
+
+        m.def( "StepPhase2", []( TISimulation* simulation, const TScalar& dt )
+            {
+                to_mjc_simulation( simulation )->StepPhase2( dt );
+            }, py::arg( "simulation" ), py::arg( "dt" ) = -1.0f );
+
+        m.def( "StepN", []( TISimulation* simulation, ssize_t num_periods, const TScalar& dt )
+            {
+                to_mjc_simulation( simulation )->StepN( num_periods, dt );
+            }, py::arg( "simulation" ), py::arg( "num_periods" ), py::arg( "dt" ) = -1.0f );
+
+        m.def( "SetNumSubsteps", []( TISimulation* simulation, ssize_t num_substeps )
+            {
+                to_mjc_simulation( simulation )->SetNumSubsteps( num_substeps );
+            }, py::arg( "simulation" ), py::arg( "num_substeps" ) );
+
+        m.def( "SetCtrl", []( TISimulation* simulation, const py::array_t<mjtNum, py::array::c_style | py::array::forcecast>& ctrl )
+            {
+                auto mjc_simulation = to_mjc_simulation( simulation );
+                const ssize_t num_ctrl = mjc_simulation->mjc_model()->nu;
+                if ( ctrl.size() != num_ctrl )
+                    throw py::value_error( "loco_mujoco::SetCtrl >>> expected " + std::to_string( num_ctrl ) +
+                                           " controls, but got " + std::to_string( ctrl.size() ) );
+                std::memcpy( mjc_simulation->mjc_data()->ctrl, ctrl.data(), sizeof( mjtNum ) * num_ctrl );
+            }, py::arg( "simulation" ), py::arg( "ctrl" ) );
+
+        m.def( "GetQpos", []( TISimulation* simulation )
+            {
+                auto mjc_simulation = to_mjc_simulation( simulation );
+                return mjc_array_to_numpy( mjc_simulation->mjc_data()->qpos, mjc_simulation->mjc_model()->nq );
+            }, py::arg( "simulation" ) );
+
+        m.def( "GetQvel", []( TISimulation* simulation )
+            {
+                auto mjc_simulation = to_mjc_simulation( simulation );
+                return mjc_array_to_numpy( mjc_simulation->mjc_data()->qvel, mjc_simulation->mjc_model()->nv );
+            }, py::arg( "simulation" ) );
+
+        m.def( "GetSensorData", []( TISimulation* simulation )
+            {
+                auto mjc_simulation = to_mjc_simulation( simulation );
+                return mjc_array_to_numpy( mjc_simulation->mjc_data()->sensordata, mjc_simulation->mjc_model()->nsensordata );
+            }, py::arg( "simulation" ) );
+    }
+
+#if defined( __linux__ )
+    // Read-only view into a shared-memory segment (written only by the server), which keeps its owner alive
+    py::array_t<mjtNum> shm_array_to_numpy( const mjtNum* array, ssize_t array_size, py::handle owner )
+    {
+        auto np_array = py::array_t<mjtNum>( array_size, array, owner );
+        np_array.attr( "setflags" )( py::arg( "write" ) = false );
+        return np_array;
+    }
+
+    void bindings_shm_server_mujoco( py::module& m )
+    {
+        // Serving blocks (and steps the simulation) without touching python objects, so the GIL is released
+        py::class_<TMujocoShmServer>( m, "ShmServer" )
+            .def( py::init( []( TISimulation* simulation, const std::string& shm_name )
+                {
+                    return std::make_unique<TMujocoShmServer>( to_mjc_simulation( simulation ), shm_name );
+                } ), py::arg( "simulation" ), py::arg( "shm_name" ) )
+            .def( "Start", &TMujocoShmServer::Start )
+            .def( "Serve", &TMujocoShmServer::Serve, py::call_guard<py::gil_scoped_release>() )
+            .def( "ServeOnce", &TMujocoShmServer::ServeOnce, py::call_guard<py::gil_scoped_release>() )
+            .def( "SetRequestTimeout", &TMujocoShmServer::SetRequestTimeout, py::arg( "timeout_ms" ) )
+            .def_property_readonly( "running", &TMujocoShmServer::running )
+            .def_property_readonly( "shm_name", &TMujocoShmServer::shm_name );
+    }
+
+    void bindings_shm_client_mujoco( py::module& m )
+    {
+        // Observations are exposed as read-only numpy arrays viewing the shared-memory segment (zero-copy),
+        // which keep the client alive, and whose contents change on every Step|Reset. Only ctrl is writable
+        py::class_<TMujocoShmClient>( m, "ShmClient" )
+            .def( py::init<const std::string&>(), py::arg( "shm_name" ) )
+            .def( "Connect", &TMujocoShmClient::Connect )
+            .def( "Step", &TMujocoShmClient::Step, py::call_guard<py::gil_scoped_release>() )
+            .def( "Reset", &TMujocoShmClient::Reset, py::call_guard<py::gil_scoped_release>() )
+            .def( "Close", &TMujocoShmClient::Close, py::call_guard<py::gil_scoped_release>() )
+            .def( "SetRequestTimeout", &TMujocoShmClient::SetRequestTimeout, py::arg( "timeout_ms" ) )
+            .def_property_readonly( "qpos", []( py::object self )
+                {
+                    auto& client = self.cast<const TMujocoShmClient&>();
+                    return shm_array_to_numpy( client.qpos(), client.nq(), self );
+                } )
+            .def_property_readonly( "qvel", []( py::object self )
+                {
+                    auto& client = self.cast<const TMujocoShmClient&>();
+                    return shm_array_to_numpy( client.qvel(), client.nv(), self );
+                } )
+            .def_property_readonly( "sensordata", []( py::object self )
+                {
+                    auto& client = self.cast<const TMujocoShmClient&>();
+                    return shm_array_to_numpy( client.sensordata(), client.nsensordata(), self );
+                } )
+            .def_property_readonly( "ctrl", []( py::object self )
+                {
+                    auto& client = self.cast<TMujocoShmClient&>();
+                    return py::array_t<mjtNum>( client.nu(), client.ctrl(), self );
+                } )
+            .def_property_readonly( "reward", &TMujocoShmClient::reward )
+            .def_property_readonly( "done", &TMujocoShmClient::done )
+            .def_property_readonly( "time", &TMujocoShmClient::time )
+            .def_property_readonly( "connected", &TMujocoShmClient::connected )
+            .def_property_readonly( "shm_name", &TMujocoShmClient::shm_name );
+    }
+#endif /* __linux__ */
+}}
+
+PYBIND11_MODULE( loco_mujoco, m )
+{
+    // Simulation objects are registered by the core bindings, so these must be loaded first
+    py::module::import( "loco" );
+
+    loco::mujoco::bindings_simulation_mujoco( m );
+#if defined( __linux__ )
+    loco::mujoco::bindings_shm_server_mujoco( m );
+    loco::mujoco::bindings_shm_client_mujoco( m );
+#endif
+}
\ No newline at end of file
@@ -29,6 +29,12 @@ namespace kintree {
 
         void Initialize() override;
 
+        // Links the adapters of all bodies to the current model (the core does it only on the first initialization)
+        void InitializeBodies();
+
+        // Links to the same mjc-objects as an adapter of an identical kintree (e.g. when cloning), reusing its cached ids
+        bool InitializeFromAdapter( const TMujocoKinematicTreeAdapter& other );
+
         void Reset() override;
 
         void SetTransform( const TMat4& tf ) override;
@@ -47,6 +53,19 @@ namespace kintree {
 
         void SetMjcData( mjData* mj_data_ref );
 
+        void SetMjcNameIndex( const mujoco::TMujocoNameIndex* mjc_name_index_ref );
+
+        // Model writes of this kintree (and of all its bodies, colliders and joints) go through the simulation
+        void SetMjcModelUniqueFn( const mujoco::FnMjcModelUnique& mjc_model_unique_fn );
+
+        void UpdateContacts( const mujoco::TMujocoContactBuffer& contact_buffer );
+
+        void SetBulkResetEnabled( bool enabled );
+
+        void ResetInitialConditions();
+
+        void ApplyResetOverrides();
+
         parsing::TElement* element_resources() { return m_MjcfElementResources.get(); }
 
         const parsing::TElement* element_resources() const { return m_MjcfElementResources.get(); }
@@ -55,8 +74,24 @@ namespace kintree {
 
         const parsing::TElement* element_assets_resources() const { return m_MjcfElementAssetsResources.get(); }
 
+        std::vector<const mujoco::TMjcVfsFile*> vfs_resources() const;
+
+        const mjModel* mjc_model() const { return m_MjcModelRef; }
+
+        const mjData* mjc_data() const { return m_MjcDataRef; }
+
+        ssize_t mjc_root_body_id() const { return m_MjcRootBodyId; }
+
+        ssize_t mjc_root_joint_qpos_adr() const { return m_MjcRootJointQposAdr[0]; }
+
     private :
 
+        void _CacheRootJointAddresses( TKinematicTreeJoint* root_joint );
+
+        void _ResetRootToInitialConditions();
+
+        std::array<TScalar, 13> _InitialConditionsSignature() const;
+
         void _SetTransformFreeJoint( TKinematicTreeJoint* joint_ref, const TMat4& tf );
 
         void _SetLinearVelFreeJoint( TKinematicTreeJoint* joint_ref, const TVec3& linear_vel );
@@ -71,14 +106,31 @@ namespace kintree {
 
         void _SetTransformFixedJoint( TKinematicTreeBody* body_ref, const TMat4& tf );
 
+        mjModel* _MjcModelUnique();
+
     private :
 
         mjModel* m_MjcModelRef = nullptr;
 
         mjData* m_MjcDataRef = nullptr;
 
+        const mujoco::TMujocoNameIndex* m_MjcNameIndexRef = nullptr;
+
+        mujoco::FnMjcModelUnique m_MjcModelUniqueFn;
+
         ssize_t m_MjcRootBodyId = -1;
 
+        // Cached qpos|qvel addresses of the root-joint (free-joint uses only the first entry,
+        // whereas planar-joints use all three entries, in order trans_1, trans_2, rot)
+        std::array<ssize_t, 3> m_MjcRootJointQposAdr = { -1, -1, -1 };
+
+        std::array<ssize_t, 3> m_MjcRootJointQvelAdr = { -1, -1, -1 };
+
+        bool m_BulkResetEnabled = false;
+
+        // Initial conditions of the root (pos0, quat0, linear_vel0, angular_vel0) last written on reset
+        std::array<TScalar, 13> m_ResetSignature = {};
+
         std::unique_ptr<parsing::TElement> m_MjcfElementResources = nullptr;
 
         std::unique_ptr<parsing::TElement> m_MjcfElementAssetsResources = nullptr;
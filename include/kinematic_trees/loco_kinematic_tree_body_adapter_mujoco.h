@@ -32,6 +32,9 @@ namespace kintree {
 
         void Initialize() override;
 
+        // Links to the same mjc-objects as an adapter of an identical body (e.g. when cloning), reusing its cached ids
+        void InitializeFromAdapter( const TMujocoKinematicTreeBodyAdapter& other );
+
         void Reset() override;
 
         void SetForceCOM( const TVec3& force ) override;
@@ -44,6 +47,18 @@ namespace kintree {
 
         void SetMjcData( mjData* mj_data_ref );
 
+        void SetMjcNameIndex( const mujoco::TMujocoNameIndex* mjc_name_index_ref );
+
+        void SetMjcModelUniqueFn( const mujoco::FnMjcModelUnique& mjc_model_unique_fn );
+
+        void UpdateContacts( const mujoco::TMujocoContactBuffer& contact_buffer );
+
+        void SetBulkResetEnabled( bool enabled );
+
+        void ResetInitialConditions();
+
+        void ApplyResetOverrides();
+
         ssize_t mjc_body_id() const { return m_MjcBodyId; }
 
         parsing::TElement* element_resources() { return m_MjcfElementResources.get(); }
@@ -54,12 +69,16 @@ namespace kintree {
 
         const parsing::TElement* element_assets_resources() const { return m_MjcfElementAssetsResources.get(); }
 
+        const mujoco::TMjcVfsFile* vfs_mesh_resource() const;
+
     private :
 
         mjModel* m_MjcModelRef = nullptr;
 
         mjData* m_MjcDataRef = nullptr;
 
+        const mujoco::TMujocoNameIndex* m_MjcNameIndexRef = nullptr;
+
         ssize_t m_MjcBodyId = -1;
 
         std::unique_ptr<parsing::TElement> m_MjcfElementResources = nullptr;
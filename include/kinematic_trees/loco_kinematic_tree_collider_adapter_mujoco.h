@@ -1,6 +1,7 @@
 #pragma once
 
 #include <loco_common_mujoco.h>
+#include <loco_contact_buffer_mujoco.h>
 #include <utils/loco_parsing_element.h>
 #include <kinematic_trees/loco_kinematic_tree_collider_adapter.h>
 
@@ -28,6 +29,9 @@ namespace kintree {
 
         void Initialize() override;
 
+        // Links to the same mjc-geom as an adapter of an identical collider (e.g. when cloning), reusing its cached ids
+        void InitializeFromAdapter( const TMujocoKinematicTreeColliderAdapter& other );
+
         void SetLocalTransform( const TMat4& local_tf ) override;
 
         void ChangeSize( const TVec3& new_size ) override;
@@ -42,10 +46,20 @@ namespace kintree {
 
         void SetMjcData( mjData* mj_data_ref ) { m_MjcDataRef = mj_data_ref; }
 
+        void SetMjcNameIndex( const mujoco::TMujocoNameIndex* mjc_name_index_ref ) { m_MjcNameIndexRef = mjc_name_index_ref; }
+
+        void SetMjcModelUniqueFn( const mujoco::FnMjcModelUnique& mjc_model_unique_fn ) { m_MjcModelUniqueFn = mjc_model_unique_fn; }
+
+        void UpdateContacts( const mujoco::TMujocoContactBuffer& contact_buffer );
+
         std::vector<const parsing::TElement*> elements_resources() const;
 
         const parsing::TElement* element_assets_resources() const { return m_MjcfElementAssetResources.get(); }
 
+        const mujoco::TMjcVfsFile* vfs_mesh_resource() const { return m_MjcVfsMeshResource.get(); }
+
+        const mujoco::TMujocoContactsView& mjc_contacts() const { return m_MjcContacts; }
+
         ssize_t mjc_geom_id() const { return m_MjcGeomId; }
 
         ssize_t mjc_geom_mesh_id() const { return m_MjcGeomMeshId; }
@@ -58,12 +72,18 @@ namespace kintree {
 
         void _ResizePrimitive( const TVec3& new_size );
 
+        mjModel* _MjcModelUnique();
+
     private :
 
         mjModel* m_MjcModelRef = nullptr;
 
         mjData* m_MjcDataRef = nullptr;
 
+        const mujoco::TMujocoNameIndex* m_MjcNameIndexRef = nullptr;
+
+        mujoco::FnMjcModelUnique m_MjcModelUniqueFn;
+
         ssize_t m_MjcGeomId = -1;
 
         ssize_t m_MjcGeomMeshId = -1;
@@ -82,6 +102,14 @@ namespace kintree {
 
         std::unique_ptr<parsing::TElement> m_MjcfElementAssetResources = nullptr;
 
+        std::unique_ptr<mujoco::TMjcVfsFile> m_MjcVfsMeshResource = nullptr;
+
+        // Key of the mesh-cache entry to be stored once the model is compiled (empty if the hull was already cached)
+        std::string m_MjcMeshCachePendingKey;
+
+        // View over this collider's contacts (into the simulation's contact-buffer, valid until next step)
+        mujoco::TMujocoContactsView m_MjcContacts;
+
         TVec3 m_Size;
 
         TVec3 m_Size0;
@@ -28,6 +28,9 @@ namespace kintree {
 
         void Initialize() override;
 
+        // Links to the same mjc-joint as an adapter of an identical joint (e.g. when cloning), reusing its cached ids
+        void InitializeFromAdapter( const TMujocoKinematicTreeJointAdapter& other );
+
         void Reset() override;
 
         void SetQpos( const std::vector<TScalar>& qpos ) override;
@@ -54,6 +57,16 @@ namespace kintree {
 
         void SetMjcData( mjData* mj_data_ref ) { m_MjcDataRef = mj_data_ref; }
 
+        void SetMjcNameIndex( const mujoco::TMujocoNameIndex* mjc_name_index_ref ) { m_MjcNameIndexRef = mjc_name_index_ref; }
+
+        void SetMjcModelUniqueFn( const mujoco::FnMjcModelUnique& mjc_model_unique_fn ) { m_MjcModelUniqueFn = mjc_model_unique_fn; }
+
+        void SetBulkResetEnabled( bool enabled ) { m_BulkResetEnabled = enabled; }
+
+        void ResetInitialConditions();
+
+        void ApplyResetOverrides();
+
         std::vector<parsing::TElement*> elements_resources();
 
         std::vector<const parsing::TElement*> elements_resources() const;
@@ -66,12 +79,20 @@ namespace kintree {
 
         ssize_t mjc_joint_qveladr() const { return m_MjcJointQvelAdr; }
 
+    private :
+
+        mjModel* _MjcModelUnique();
+
     private :
 
         mjModel* m_MjcModelRef = nullptr;
 
         mjData* m_MjcDataRef = nullptr;
 
+        const mujoco::TMujocoNameIndex* m_MjcNameIndexRef = nullptr;
+
+        mujoco::FnMjcModelUnique m_MjcModelUniqueFn;
+
         ssize_t m_MjcJointId = -1;
 
         ssize_t m_MjcDofId = -1;
@@ -80,6 +101,13 @@ namespace kintree {
 
         ssize_t m_MjcJointQvelAdr = -1;
 
+        bool m_BulkResetEnabled = false;
+
+        // Initial conditions last written on reset (used to detect user overrides on bulk-resets)
+        std::vector<TScalar> m_ResetQpos0;
+
+        std::vector<TScalar> m_ResetQvel0;
+
         std::vector<std::unique_ptr<parsing::TElement>> m_MjcfElementsResources;
     };
 }}
\ No newline at end of file
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <loco_common_mujoco.h>
+#include <atomic>
+#include <deque>
+#include <future>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace loco {
+    class TMujocoSimulation;
+}
+
+namespace loco {
+namespace mujoco {
+
+    // Minimum number of snapshot slots (one being written, one latest, one still held by a reader)
+    const ssize_t LOCO_MUJOCO_ASYNC_MIN_SNAPSHOT_SLOTS = 3;
+
+    // Contact information stored in a snapshot (a copy of the relevant parts of mjContact)
+    struct TMujocoSnapshotContact
+    {
+        ssize_t geom1_id = -1;
+        ssize_t geom2_id = -1;
+        TScalar distance = 0.0f;
+        TVec3 position;
+        TVec3 normal;
+    };
+
+    // Copy of the simulation state after a step (body transforms, joint states and contacts)
+    struct TMujocoStateSnapshot
+    {
+        // Number of steps taken by the async stepper when this snapshot was taken
+        ssize_t step_id = -1;
+        // Simulation time (mjData::time) at the moment of the snapshot
+        mjtNum time = 0.0;
+        std::vector<mjtNum> qpos;
+        std::vector<mjtNum> qvel;
+        // World-space positions (3 x nbody) and orientations (4 x nbody, w-x-y-z) of all bodies
+        std::vector<mjtNum> xpos;
+        std::vector<mjtNum> xquat;
+        std::vector<TMujocoSnapshotContact> contacts;
+    };
+
+    class TMujocoAsyncStepper;
+
+    /// Read-only handle to a snapshot, which keeps it alive (i.e. not overwritten) for its whole lifetime
+    ///
+    /// The handle shares ownership of the snapshot's slot, so it stays valid even after the stepper is
+    /// destroyed (e.g. on StopAsync, or when the simulation is destroyed).
+    class TMujocoSnapshotHandle
+    {
+    public :
+
+        TMujocoSnapshotHandle() = default;
+
+        TMujocoSnapshotHandle( std::shared_ptr<const TMujocoStateSnapshot> snapshot, std::atomic<ssize_t>* refcount_ref )
+            : m_Snapshot( std::move( snapshot ) ), m_RefcountRef( refcount_ref ) {}
+
+        TMujocoSnapshotHandle( const TMujocoSnapshotHandle& other ) = delete;
+
+        TMujocoSnapshotHandle& operator=( const TMujocoSnapshotHandle& other ) = delete;
+
+        TMujocoSnapshotHandle( TMujocoSnapshotHandle&& other );
+
+        TMujocoSnapshotHandle& operator=( TMujocoSnapshotHandle&& other );
+
+        ~TMujocoSnapshotHandle() { Release(); }
+
+        void Release();
+
+        const TMujocoStateSnapshot* operator->() const { return m_Snapshot.get(); }
+
+        const TMujocoStateSnapshot& operator*() const { return *m_Snapshot; }
+
+        const TMujocoStateSnapshot* get() const { return m_Snapshot.get(); }
+
+        bool valid() const { return m_Snapshot != nullptr; }
+
+    private :
+
+        // Snapshot (aliasing its slot, which also owns the refcount below)
+        std::shared_ptr<const TMujocoStateSnapshot> m_Snapshot = nullptr;
+
+        std::atomic<ssize_t>* m_RefcountRef = nullptr;
+    };
+
+    /// Steps a simulation on a dedicated thread, and publishes a snapshot of its state after every step
+    ///
+    /// Step requests are queued and return a future, so the caller can overlap other work (e.g. policy
+    /// evaluation on the previous observation) with the physics step. Snapshots live in a fixed set of
+    /// slots (at least three), each with an atomic reference count: readers grab the latest published
+    /// slot and pin it without taking any lock, and the stepper only writes into slots that are neither
+    /// the latest one nor pinned by any reader, so a snapshot never changes while a handle to it is alive.
+    ///
+    /// While the stepper is running, the simulation must only be stepped through it (mjData is owned by
+    /// the stepping thread, and readers should only use snapshots).
+    class TMujocoAsyncStepper
+    {
+    public :
+
+        TMujocoAsyncStepper( TMujocoSimulation* simulation_ref, ssize_t num_snapshot_slots = LOCO_MUJOCO_ASYNC_MIN_SNAPSHOT_SLOTS );
+
+        TMujocoAsyncStepper( const TMujocoAsyncStepper& other ) = delete;
+
+        TMujocoAsyncStepper& operator=( const TMujocoAsyncStepper& other ) = delete;
+
+        ~TMujocoAsyncStepper();
+
+        std::future<void> StepAsync( const TScalar& dt = -1.0f );
+
+        // Blocks until all queued step requests have been processed
+        void Wait();
+
+        // Returns a handle to the latest published snapshot (lock-free)
+        TMujocoSnapshotHandle AcquireSnapshot() const;
+
+        ssize_t num_snapshot_slots() const { return m_Slots.size(); }
+
+        ssize_t num_steps() const { return m_NumSteps.load(); }
+
+        ssize_t num_pending_requests() const { return m_NumPendingRequests.load(); }
+
+        // Whether or not the caller is the stepping thread (the only one allowed to touch mjData while running)
+        bool in_worker_thread() const { return std::this_thread::get_id() == m_Worker.get_id(); }
+
+    private :
+
+        struct TSnapshotSlot
+        {
+            TMujocoStateSnapshot snapshot;
+            std::atomic<ssize_t> refcount;
+        };
+
+        void _WorkerLoop();
+
+        void _PublishSnapshot();
+
+    private :
+
+        // Simulation being stepped by the worker thread
+        TMujocoSimulation* m_SimulationRef;
+        // Storage for the snapshots (preallocated for the model's sizes, shared with the handles that pin them)
+        std::vector<std::shared_ptr<TSnapshotSlot>> m_Slots;
+        // Index of the latest published slot (readers only ever look at this one)
+        std::atomic<ssize_t> m_LatestSlot;
+        // Queue of step requests (only the submitting thread and the worker touch it)
+        std::deque<std::packaged_task<void()>> m_Requests;
+        std::mutex m_RequestsMutex;
+        std::condition_variable m_CondVarRequests;
+        std::condition_variable m_CondVarIdle;
+        // Number of requests submitted but not yet finished
+        std::atomic<ssize_t> m_NumPendingRequests;
+        // Number of steps taken so far by the worker
+        std::atomic<ssize_t> m_NumSteps;
+        // Thread in charge of stepping the simulation
+        std::thread m_Worker;
+        // Flag used to stop the worker on destruction
+        bool m_Stop;
+    };
+}}
\ No newline at end of file
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <loco_simulation_mujoco.h>
+#include <loco_model_overlay_mujoco.h>
+#include <loco_thread_pool_mujoco.h>
+
+namespace loco
+{
+    /// Batch of copies (environments) of the same scenario, sharing a single compiled mjModel
+    ///
+    /// The scenario is compiled only once, by an internal TMujocoSimulation (which also keeps the
+    /// adapters, so the scenario objects can be queried|rendered). Each environment only owns an
+    /// mjData, created against the shared model and initialized from the initial state of the
+    /// internal simulation. Environments are stepped in parallel using a fixed pool of threads,
+    /// which balances the load across workers by work-stealing (see TMujocoThreadPool). Parameters
+    /// can be randomized per environment (friction, size, mass, damping) without duplicating the
+    /// model: each environment steps with a copy-on-write view of it (see TMujocoModelOverlay). If
+    /// the shared model changes its sizes (e.g. the internal simulation is rebuilt), the environments
+    /// are re-created from the internal simulation's state before they're used again.
+    class TMujocoBatchSimulation
+    {
+    public :
+
+        TMujocoBatchSimulation( TScenario* scenarioRef, ssize_t num_envs, ssize_t num_threads = 0 );
+
+        TMujocoBatchSimulation( const TMujocoBatchSimulation& other ) = delete;
+
+        TMujocoBatchSimulation& operator=( const TMujocoBatchSimulation& other ) = delete;
+
+        ~TMujocoBatchSimulation();
+
+        bool Initialize();
+
+        void Step( const TScalar& dt = -1.0f );
+
+        void StepEnvs( const std::vector<ssize_t>& env_ids, const TScalar& dt = -1.0f );
+
+        void Reset();
+
+        void ResetEnvs( const std::vector<ssize_t>& env_ids );
+
+        void SetCtrl( ssize_t env_id, const std::vector<TScalar>& ctrl );
+
+        void SetCtrlBatch( const std::vector<TScalar>& ctrl_batch );
+
+        void GatherQpos( std::vector<TScalar>& dst_qpos_batch ) const;
+
+        void GatherQvel( std::vector<TScalar>& dst_qvel_batch ) const;
+
+        void GatherSensorData( std::vector<TScalar>& dst_sensordata_batch ) const;
+
+        // Copies the state of an environment into the internal simulation (e.g. to visualize it)
+        void SyncSimulationFromEnv( ssize_t env_id );
+
+        // Per-environment model parameters (not thread-safe w.r.t. stepping, so set these in between steps)
+        void SetGeomFriction( ssize_t env_id, ssize_t geom_id, const TVec3& friction );
+
+        // Resizes a primitive geom (size given as in loco, e.g. full extents for boxes), updating its bounding radius
+        void SetGeomSize( ssize_t env_id, ssize_t geom_id, const TVec3& size );
+
+        // Changes the mass of a body, scaling its inertia accordingly (same density distribution)
+        void SetBodyMass( ssize_t env_id, ssize_t body_id, const TScalar& mass );
+
+        void SetDofDamping( ssize_t env_id, ssize_t dof_id, const TScalar& damping );
+
+        // Private copy of the whole model of an environment, for changes not covered by the setters above
+        mjModel* MakeEnvModelPrivate( ssize_t env_id );
+
+        // Drops all parameters set for an environment (steps with the shared model's values again)
+        void ClearEnvParams( ssize_t env_id );
+
+        const mjModel* env_mjc_model( ssize_t env_id ) const { return m_MjcModelOverlays[env_id]->mjc_model(); }
+
+        const mujoco::TMujocoModelOverlay* env_model_overlay( ssize_t env_id ) const { return m_MjcModelOverlays[env_id].get(); }
+
+        // Memory used by the model-parameters of an environment, on top of the shared model
+        ssize_t env_model_num_bytes( ssize_t env_id ) const { return m_MjcModelOverlays[env_id]->num_bytes(); }
+
+        ssize_t shared_model_num_bytes() const;
+
+        TMujocoSimulation* simulation() { return m_Simulation.get(); }
+
+        const TMujocoSimulation* simulation() const { return m_Simulation.get(); }
+
+        mjModel* mjc_model() { return m_Simulation->mjc_model(); }
+
+        const mjModel* mjc_model() const { return m_Simulation->mjc_model(); }
+
+        mjData* mjc_data( ssize_t env_id ) { return m_MjcDatas[env_id].get(); }
+
+        const mjData* mjc_data( ssize_t env_id ) const { return m_MjcDatas[env_id].get(); }
+
+        ssize_t num_envs() const { return m_NumEnvs; }
+
+        mujoco::TMujocoThreadPool* thread_pool() { return m_ThreadPool.get(); }
+
+        const mujoco::TMujocoThreadPool* thread_pool() const { return m_ThreadPool.get(); }
+
+        ssize_t num_threads() const { return m_ThreadPool->num_threads(); }
+
+        bool initialized() const { return m_Initialized; }
+
+    private :
+
+        void _CreateEnvDatas();
+
+        void _SyncEnvDatas();
+
+        void _SyncEnvModel( ssize_t env_id );
+
+        // Sizes of a model that determine the layout of the mjData created against it
+        static std::vector<int> _MjcDataLayout( const mjModel* mjc_model );
+
+        ssize_t _NumSubsteps( const TScalar& dt ) const;
+
+        void _GatherArray( std::vector<TScalar>& dst_batch, ssize_t array_size,
+                           const std::function<const mjtNum*( const mjData* )>& array_getter ) const;
+
+    private :
+
+        // Number of environments in the batch
+        ssize_t m_NumEnvs;
+        // Whether or not the batch has been initialized (model compiled and environments created)
+        bool m_Initialized;
+        // Internal simulation, in charge of compiling the shared model (and keeping the adapters)
+        std::unique_ptr<TMujocoSimulation> m_Simulation;
+        // Initial state of all environments (used for resets)
+        std::unique_ptr<mjData, mujoco::MjcDataDeleter> m_MjcDataInit;
+        // Per-environment data, all created against the shared model
+        std::vector<std::unique_ptr<mjData, mujoco::MjcDataDeleter>> m_MjcDatas;
+        // Layout of the shared model the environments' data were created for (see _MjcDataLayout)
+        std::vector<int> m_MjcDatasLayout;
+        // Per-environment copy-on-write views of the shared model (hold the randomized parameters, if any)
+        std::vector<std::unique_ptr<mujoco::TMujocoModelOverlay>> m_MjcModelOverlays;
+        // Pool of workers used to step the environments in parallel
+        std::unique_ptr<mujoco::TMujocoThreadPool> m_ThreadPool;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <loco_common_mujoco.h>
+#include <primitives/loco_single_body_adapter_mujoco.h>
+
+namespace loco {
+namespace mujoco {
+
+    // Damping set on the dofs of parked bodies (the euler integrator handles damping implicitly, so they stay frozen)
+    const mjtNum LOCO_MUJOCO_PARKED_DOF_DAMPING = 1e10;
+    // Prefix of the names of the hidden bodies added to the model for reserved slots
+    const std::string LOCO_MUJOCO_RESERVED_SLOT_PREFIX = "__loco_slot_";
+
+    // Pool of hidden free-bodies compiled into the model up-front, to spawn single-bodies of a given shape into
+    struct TMujocoBodySlotsReservation
+    {
+        eShapeType shape = eShapeType::BOX;
+        // Size-class of the pool (size the hidden geoms are compiled with; spawned bodies prefer the closest class)
+        TVec3 size = { 0.1f, 0.1f, 0.1f };
+        ssize_t num_slots = 0;
+    };
+
+    // Body (plus its free-joint and geom) in the compiled model that can back a single-body
+    struct TMujocoBodySlot
+    {
+        ssize_t body_id = -1;
+        // Free-joint of the body (-1 if static, or if constrained by other joints)
+        ssize_t joint_id = -1;
+        ssize_t qpos_adr = -1;
+        ssize_t qvel_adr = -1;
+        ssize_t geom_id = -1;
+        // Shape of the collider the slot was built for (only bodies with the same shape can reuse it)
+        eShapeType shape = eShapeType::BOX;
+        // Size of the collider the slot was built for (spawned bodies take the slot with the closest size)
+        TVec3 size = { 0.0f, 0.0f, 0.0f };
+        // Collision bits and dofs-damping the slot had when parked (restored once reused)
+        int contype = 0;
+        int conaffinity = 0;
+        std::array<mjtNum, 6> dof_damping = {};
+        // Cell of the rest-grid where the slot is parked (-1 if not parked)
+        ssize_t rest_cell = -1;
+    };
+
+    /// Manager of the bodies left behind by detached single-bodies (and of reserved hidden bodies)
+    ///
+    /// A detached body is parked only once: moved to a cell of a rest-grid, removed from collisions
+    /// (contype = conaffinity = 0), gravity-compensated and its dofs frozen, so it never collides nor
+    /// moves afterwards (its dofs are still integrated though). Dofs are frozen by huge damping, which
+    /// only the Euler integrator handles implicitly; under other integrators (e.g. RK4) the simulation
+    /// instead puts parked bodies back at rest after every control period (see HoldParked). Parked slots with a free-joint and a primitive shape
+    /// can be handed to newly spawned single-bodies of the same shape, which then only requires to
+    /// write sizes, masses and poses into mjModel|mjData (no recompilation). Rest-cells of reused
+    /// slots are given back, so the rest-grid only grows with the number of bodies parked at once.
+    /// Reservations add pools of hidden free-bodies to the model, registered as parked from the start.
+    class TMujocoBodySlotsManager
+    {
+    public :
+
+        TMujocoBodySlotsManager( mjModel* mjc_model_ref, mjData* mjc_data_ref );
+
+        TMujocoBodySlotsManager( const TMujocoBodySlotsManager& other ) = delete;
+
+        TMujocoBodySlotsManager& operator=( const TMujocoBodySlotsManager& other ) = delete;
+
+        ~TMujocoBodySlotsManager() = default;
+
+        // Parks the mjc-body of a detached single-body, and returns the id of its slot (-1 if not linked to the model)
+        ssize_t ParkSingleBody( primitives::TMujocoSingleBodyAdapter* single_body_adapter );
+
+        // Registers a hidden free-body compiled for a reservation as a parked slot, and returns the id of its slot
+        ssize_t AddReservedSlot( ssize_t mjc_body_id, ssize_t mjc_geom_id, const eShapeType& shape, const TVec3& size );
+
+        // Takes a parked slot that can back the given single-body and un-parks it (returns -1 if there's none)
+        ssize_t AcquireSlot( primitives::TSingleBody* single_body );
+
+        // Parks again every parked slot (resets and gravity changes undo the parking state in mjData). Only the
+        // parking state in mjData is usually rewritten, as the one in mjModel is mostly there already
+        void RefreshParked();
+
+        // Puts the parked bodies back at their rest-cells with zero velocity (only needed by integrators that
+        // don't handle damping implicitly, where gravity-compensated bodies would slowly drift otherwise)
+        void HoldParked();
+
+        // Takes over the slots of a manager of the same model (e.g. when cloning, as the model|data already hold their parking state)
+        void CopySlotsFrom( const TMujocoBodySlotsManager& other );
+
+        void SetMjcModel( mjModel* mjc_model_ref ) { m_MjcModelRef = mjc_model_ref; }
+
+        // Model writes of the manager go through the simulation (i.e. parking a slot of a model shared with clones copies it)
+        void SetMjcModelUniqueFn( const FnMjcModelUnique& mjc_model_unique_fn ) { m_MjcModelUniqueFn = mjc_model_unique_fn; }
+
+        const TMujocoBodySlot& slot( ssize_t slot_id ) const { return m_Slots[slot_id]; }
+
+        ssize_t num_slots() const { return m_Slots.size(); }
+
+        // Number of parked slots that can still be reused
+        ssize_t num_free_slots() const { return m_FreeSlots.size(); }
+
+        // Position of a cell of the rest-grid (reserved slots are compiled at the first cells, in order)
+        static TVec3 RestCellPosition( ssize_t rest_cell );
+
+    private :
+
+        ssize_t _AddParkedSlot( TMujocoBodySlot slot );
+
+        void _Park( TMujocoBodySlot& slot );
+
+        void _Unpark( TMujocoBodySlot& slot );
+
+        // Writes a single entry of the model, only if its value changes
+        template <typename T, typename U>
+        void _SetMjcModelValue( T* mjModel::* array, ssize_t index, const U& value )
+        {
+            if ( ( m_MjcModelRef->*array )[index] == static_cast<T>( value ) )
+                return;
+            mjModel* mjc_model = ( m_MjcModelUniqueFn ) ? m_MjcModelUniqueFn() : m_MjcModelRef;
+            ( mjc_model->*array )[index] = static_cast<T>( value );
+        }
+
+    private :
+
+        mjModel* m_MjcModelRef = nullptr;
+
+        mjData* m_MjcDataRef = nullptr;
+
+        FnMjcModelUnique m_MjcModelUniqueFn;
+
+        std::vector<TMujocoBodySlot> m_Slots;
+
+        // Parked slots that can be reused by newly spawned single-bodies
+        std::vector<ssize_t> m_FreeSlots;
+
+        // Cells of the rest-grid given back by reused slots (taken first, so the grid doesn't grow unbounded)
+        std::vector<ssize_t> m_FreeRestCells;
+
+        ssize_t m_NumRestCells = 0;
+    };
+}}
\ No newline at end of file
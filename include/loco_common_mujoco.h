@@ -2,6 +2,9 @@
 
 #include <loco_common.h>
 #include <loco_data.h>
+#include <array>
+#include <functional>
+#include <unordered_map>
 // Main mujoco API
 #include <mujoco.h>
 
@@ -22,6 +25,12 @@ namespace mujoco {
     const std::string LOCO_MJCF_ASSET_TAG = "asset";
     const std::string LOCO_MJCF_WORLDBODY_TAG = "worldbody";
 
+    // Name used to register the simulation's mjcf-xml into the virtual file-system
+    const std::string LOCO_MUJOCO_VFS_MODEL_FILE = "loco_simulation.xml";
+
+    // Density mujoco assigns to geoms when none is given (used when computing mass-properties ourselves)
+    const double LOCO_MUJOCO_DEFAULT_DENSITY = 1000.0;
+
     struct MjcModelDeleter
     {
         void operator()( mjModel* model ) const;
@@ -32,10 +41,113 @@ namespace mujoco {
         void operator()( mjData* data ) const;
     };
 
+    // Gives the simulation's model ready to be written, i.e. its own copy if it was shared with clones. Adapters (and
+    // other helpers of the simulation) write model parameters only through it, so clones never see each other's changes
+    using FnMjcModelUnique = std::function<mjModel*()>;
+
+    // In-memory file (e.g. user-defined binary mesh) to be registered into mujoco's virtual file-system
+    struct TMjcVfsFile
+    {
+        // Name of the file, as referenced by the mjcf-xml resources (no directories)
+        std::string filename;
+        // Raw contents of the file (unused if the file views memory owned elsewhere, see below)
+        std::vector<uint8_t> contents;
+        // Contents owned elsewhere (e.g. a memory-mapped cache-entry), kept alive as long as the file
+        const uint8_t* external_data = nullptr;
+        size_t external_size = 0;
+        std::shared_ptr<const void> external_owner = nullptr;
+
+        const uint8_t* data() const { return external_data ? external_data : contents.data(); }
+
+        size_t size() const { return external_data ? external_size : contents.size(); }
+    };
+
+    // Owning wrapper around mujoco's virtual file-system, used to compile models without touching disk
+    class TMjcVirtualFileSystem
+    {
+    public :
+
+        TMjcVirtualFileSystem();
+
+        TMjcVirtualFileSystem( const TMjcVirtualFileSystem& other ) = delete;
+
+        TMjcVirtualFileSystem& operator=( const TMjcVirtualFileSystem& other ) = delete;
+
+        ~TMjcVirtualFileSystem();
+
+        bool AddFile( const std::string& filename, const void* data, size_t size );
+
+        bool AddFile( const TMjcVfsFile& file ) { return AddFile( file.filename, file.data(), file.size() ); }
+
+        bool AddFile( const std::string& filename, const std::string& contents ) { return AddFile( filename, contents.c_str(), contents.size() ); }
+
+        bool HasFile( const std::string& filename ) const;
+
+        void Clear();
+
+        const mjVFS* mjc_vfs() const { return m_MjcVfs.get(); }
+
+        ssize_t num_files() const { return m_MjcVfs->nfile; }
+
+    private :
+
+        // Owned vfs struct (mjVFS has fixed-size arrays, so keep it on the heap)
+        std::unique_ptr<mjVFS> m_MjcVfs;
+    };
+
+    // Number of object types (mjtObj) that can be looked-up by name (mjOBJ_UNKNOWN to mjOBJ_KEY)
+    const ssize_t LOCO_MUJOCO_NUM_OBJ_TYPES = mjOBJ_KEY + 1;
+
+    // Hash-based name-to-id index (one map per mjtObj), built once after the model is compiled. It's
+    // shared by all adapters of a simulation, replacing mj_name2id, which is a linear scan over names
+    class TMujocoNameIndex
+    {
+    public :
+
+        TMujocoNameIndex() = default;
+
+        TMujocoNameIndex( const TMujocoNameIndex& other ) = delete;
+
+        TMujocoNameIndex& operator=( const TMujocoNameIndex& other ) = delete;
+
+        ~TMujocoNameIndex() = default;
+
+        void Build( const mjModel* mjc_model );
+
+        void Clear();
+
+        ssize_t GetId( const mjtObj& obj_type, const std::string& name ) const;
+
+        bool built() const { return m_Built; }
+
+        ssize_t num_names( const mjtObj& obj_type ) const { return m_NamesToIds[obj_type].size(); }
+
+    private :
+
+        // Flag used to check whether or not the index has been populated
+        bool m_Built = false;
+        // Mappings from object-name to object-id, for each mjtObj type
+        std::array<std::unordered_map<std::string, ssize_t>, LOCO_MUJOCO_NUM_OBJ_TYPES> m_NamesToIds;
+    };
+
+    // Resolves the id of a named object, using the name-index if available (falls back to mj_name2id otherwise)
+    ssize_t mjc_name2id( const mjModel* mjc_model, const TMujocoNameIndex* name_index,
+                         const mjtObj& obj_type, const std::string& name );
+
+    // Copies the simulation-state (time, qpos, qvel, act, ctrl, warmstart, applied forces, mocap and userdata)
+    void CopyMjcState( const mjModel* mjc_model, mjData* dst_mjc_data, const mjData* src_mjc_data );
+
+    // Copies the simulation-state between two different models, matching joints|actuators|bodies by name (and joint-type).
+    // Objects only present in the destination model keep their current state. Returns the number of joints transferred
+    ssize_t TransferMjcStateByName( const mjModel* src_mjc_model, const mjData* src_mjc_data,
+                                    const mjModel* dst_mjc_model, mjData* dst_mjc_data, const TMujocoNameIndex* dst_name_index );
+
     TVec4 quat_to_mjcQuat( const TVec4& quat );
 
     TSizef size_to_mjcSize( const eShapeType& shape, const TVec3& size );
 
+    eShapeType mjcGeomType_to_shape( int geom_type );
+
     std::string enumJoint_to_mjcJoint( const eJointType& joint );
 
     std::string enumShape_to_mjcShape( const eShapeType& shape );
@@ -44,9 +156,33 @@ namespace mujoco {
 
     double compute_primitive_volume( const eShapeType& shape, const TVec3& size );
 
+    // Principal moments of inertia of a primitive of given mass, centered at its origin (axes as in mujoco, i.e. z along cylinders|capsules)
+    TVec3 compute_primitive_inertia( const eShapeType& shape, const TVec3& size, double mass );
+
     TSizef mjarray_to_sizef( const mjtNum* array_num, size_t array_size );
 
+    // Writes max( 0, heights[i] * inv_max_height ) into dst, i.e. heights normalized into the hfield range (vectorized)
+    void hfield_normalize( float* dst, const float* heights, ssize_t num_samples, float inv_max_height );
+
+    // Maximum of a span of (non-empty) heights (vectorized)
+    float hfield_max( const float* heights, ssize_t num_samples );
+
+    // Axis-aligned bounding box of a buffer of xyz-interleaved vertices (vectorized)
+    void compute_vertices_aabb( const float* vertices, ssize_t num_vertices, TVec3& dst_aabb_min, TVec3& dst_aabb_max );
+
+    // Radius of a sphere centered at the origin that encloses the given bounding box (conservative geom_rbound)
+    double compute_aabb_rbound( const TVec3& aabb_min, const TVec3& aabb_max );
+
+    std::vector<uint8_t> SerializeMeshToBinary( const std::vector<float>& mesh_vertices,
+                                                const std::vector<int>& mesh_faces );
+
+    std::unique_ptr<TMjcVfsFile> CreateMeshVfsFile( const std::string& mesh_file,
+                                                    const std::vector<float>& mesh_vertices,
+                                                    const std::vector<int>& mesh_faces );
+
     void SaveMeshToBinary( const std::string& mesh_file,
                            const std::vector<float>& mesh_vertices,
                            const std::vector<int>& mesh_faces );
+
+    void SaveVfsFileToDisk( const std::string& filepath, const TMjcVfsFile& file );
 }}
\ No newline at end of file
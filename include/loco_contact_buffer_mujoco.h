@@ -0,0 +1,112 @@
+#pragma once
+
+#include <loco_common_mujoco.h>
+
+namespace loco {
+namespace mujoco {
+
+    // How contacts are collected after each step
+    enum class eContactsCollectionMode
+    {
+        EAGER = 0,  // contacts are collected after every step (default)
+        LAZY        // contacts are only collected on demand, or after every step if there are registered consumers
+    };
+
+    // Contact-information from the point of view of a single geom (one mjContact gives two of these)
+    struct TMujocoContactEntry
+    {
+        // Index of the contact in mjData::contact
+        ssize_t contact_id = -1;
+        // Id of the geom on the other side of the contact
+        ssize_t other_geom_id = -1;
+        // Position of the contact point in world-space
+        TVec3 position;
+        // Normal of the contact, pointing away from this geom (into the other geom)
+        TVec3 normal;
+        // Contact force applied on this geom by the other geom, in world-space (only valid if subscribed to forces)
+        TVec3 force;
+        // Contact torque applied on this geom by the other geom, in world-space (only valid if subscribed to forces)
+        TVec3 torque;
+    };
+
+    // Non-owning view over the contacts of a single geom (valid until the next collection)
+    struct TMujocoContactsView
+    {
+        const TMujocoContactEntry* data = nullptr;
+        ssize_t size = 0;
+
+        const TMujocoContactEntry* begin() const { return data; }
+
+        const TMujocoContactEntry* end() const { return data + size; }
+
+        const TMujocoContactEntry& operator[]( ssize_t index ) const { return data[index]; }
+
+        bool empty() const { return size == 0; }
+    };
+
+    /// Flat, geom-indexed storage of the contacts detected by the engine
+    ///
+    /// All storage is allocated once the model is known (see Resize), and reused on every collection:
+    /// a counting-pass over mjData::contact computes the number of contacts per geom, a prefix-sum gives
+    /// the start of each geom's span, and a scatter-pass fills the spans. No heap allocations happen in
+    /// the steady state (only if the number of contacts exceeds the model's nconmax, which is an error
+    /// condition in mujoco anyways).
+    ///
+    /// Contact wrenches (mj_contactForce) are opt-in, and computed only for contacts that involve at least
+    /// one geom that subscribed to forces (see SetForceSubscription). If no geom subscribed, the collection
+    /// doesn't pay anything extra.
+    class TMujocoContactBuffer
+    {
+    public :
+
+        TMujocoContactBuffer() = default;
+
+        TMujocoContactBuffer( const TMujocoContactBuffer& other ) = delete;
+
+        TMujocoContactBuffer& operator=( const TMujocoContactBuffer& other ) = delete;
+
+        ~TMujocoContactBuffer() = default;
+
+        void Resize( const mjModel* mjc_model );
+
+        // Forces can be disallowed when mjData holds contacts but no constraint solution (e.g. collision-only passes)
+        void Collect( const mjModel* mjc_model, const mjData* mjc_data, bool allow_forces = true );
+
+        void Clear();
+
+        void SetForceSubscription( ssize_t geom_id, bool subscribe );
+
+        bool force_subscribed( ssize_t geom_id ) const;
+
+        ssize_t num_force_subscribers() const { return m_NumForceSubscribers; }
+
+        TMujocoContactsView contacts( ssize_t geom_id ) const;
+
+        const std::string& geom_name( ssize_t geom_id ) const { return m_GeomNames[geom_id]; }
+
+        ssize_t num_geoms() const { return m_GeomNames.size(); }
+
+        ssize_t num_contacts() const { return m_NumContacts; }
+
+        ssize_t num_entries() const { return m_GeomSpanStarts.empty() ? 0 : m_GeomSpanStarts.back(); }
+
+    private :
+
+        // Number of contacts (mjContact) processed during the last collection
+        ssize_t m_NumContacts = 0;
+        // Cached names of all geoms (to avoid creating strings from mj_id2name on every step)
+        std::vector<std::string> m_GeomNames;
+        // Number of contact-entries of each geom
+        std::vector<ssize_t> m_GeomCounts;
+        // Start index (into the flat entries-buffer) of the span of each geom (size ngeom + 1)
+        std::vector<ssize_t> m_GeomSpanStarts;
+        // Write-cursor of each geom's span, used during the scatter-pass
+        std::vector<ssize_t> m_GeomCursors;
+        // Flat buffer with the contact-entries of all geoms
+        std::vector<TMujocoContactEntry> m_Entries;
+        // Whether or not each geom requested contact-forces to be computed
+        std::vector<uint8_t> m_GeomForceSubscribed;
+        // Number of geoms that requested contact-forces
+        ssize_t m_NumForceSubscribers = 0;
+    };
+}}
\ No newline at end of file
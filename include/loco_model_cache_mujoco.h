@@ -0,0 +1,181 @@
+#pragma once
+
+#include <loco_common_mujoco.h>
+#include <atomic>
+#include <mutex>
+
+namespace loco {
+namespace mujoco {
+
+    // Extension used for the compiled-model binaries stored in the cache directory
+    const std::string LOCO_MUJOCO_MODEL_CACHE_EXTENSION = ".mjb";
+
+    /// Content-addressed cache of compiled mujoco models (stored as binary .mjb files)
+    ///
+    /// The key of a cache-entry is a hash of the assembled mjcf-xml, the bytes of every asset it
+    /// references (in-memory vfs-files and files on disk), and the mujoco version. On a cache-hit
+    /// the compiled model is loaded with mj_loadModel, skipping both xml-parsing and compilation
+    /// (e.g. convex-hull and inertia computations for meshes). The cache is disabled by default,
+    /// and can be enabled either by setting a cache directory, or by using the environment
+    /// variable LOCO_MUJOCO_MODEL_CACHE_DIR. Load and Store can be called from any thread (and
+    /// any process sharing the directory), whereas SetCacheDirectory is meant to be called once
+    /// during setup, before any simulation is built.
+    class TMujocoModelCache
+    {
+    public :
+
+        static void SetCacheDirectory( const std::string& cache_dirpath );
+
+        static std::string ComputeKey( const std::string& mjcf_xml_str,
+                                       const std::vector<const TMjcVfsFile*>& vfs_resources,
+                                       const std::vector<std::string>& asset_filepaths );
+
+        static mjModel* Load( const std::string& key );
+
+        static bool Store( const std::string& key, const mjModel* mjc_model );
+
+        static void ResetStats();
+
+        static bool enabled();
+
+        static const std::string& cache_directory();
+
+        static ssize_t num_hits() { return s_NumHits; }
+
+        static ssize_t num_misses() { return s_NumMisses; }
+
+    private :
+
+        static std::string _GetEntryFilepath( const std::string& key );
+
+    private :
+
+        // Directory where the compiled-models are stored (empty means cache disabled)
+        static std::string s_CacheDirectory;
+        // Resolves the cache directory only once (either set by user or read from environment)
+        static std::once_flag s_CacheDirectoryResolved;
+        // Number of times a compiled model was found in the cache
+        static std::atomic<ssize_t> s_NumHits;
+        // Number of times a compiled model was requested but not found in the cache
+        static std::atomic<ssize_t> s_NumMisses;
+    };
+
+    // Extension used for the preprocessed meshes stored in the cache directory
+    const std::string LOCO_MUJOCO_MESH_CACHE_EXTENSION = ".lmsh";
+    // Magic number and version of the preprocessed-mesh entries (bump version on any layout change)
+    const uint32_t LOCO_MUJOCO_MESH_CACHE_MAGIC = 0x4c4d5348; // "LMSH"
+    const uint32_t LOCO_MUJOCO_MESH_CACHE_VERSION = 3;
+
+    // Header of a preprocessed-mesh entry, followed by the hull as a binary .msh (ready to be handed to mujoco)
+    struct TMujocoMeshCacheHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        int64_t source_num_vertices;
+        int64_t source_num_faces;
+        // Vertices|faces of the hull (the stored .msh holds only the hull)
+        int64_t hull_num_vertices;
+        int64_t hull_num_faces;
+        int64_t msh_offset;
+        int64_t msh_size;
+    };
+
+    /// Read-only memory-mapped view of a preprocessed-mesh entry (pages are shared through the page-cache
+    /// by every simulation and process that loads the same entry, and vfs-files view them without copies)
+    class TMujocoMeshCacheEntry
+    {
+    public :
+
+        TMujocoMeshCacheEntry( void* data, size_t size );
+
+        TMujocoMeshCacheEntry( const TMujocoMeshCacheEntry& other ) = delete;
+
+        TMujocoMeshCacheEntry& operator=( const TMujocoMeshCacheEntry& other ) = delete;
+
+        ~TMujocoMeshCacheEntry();
+
+        const TMujocoMeshCacheHeader* header() const { return reinterpret_cast<const TMujocoMeshCacheHeader*>( m_Data ); }
+
+        const uint8_t* msh_data() const { return reinterpret_cast<const uint8_t*>( m_Data ) + header()->msh_offset; }
+
+        size_t msh_size() const { return header()->msh_size; }
+
+    private :
+
+        void* m_Data;
+        size_t m_Size;
+    };
+
+    /// Content-addressed cache of preprocessed meshes, shared across simulations and processes
+    ///
+    /// Mujoco (2.0) recomputes the convex-hull and the inertia of every mesh on each compilation, and it
+    /// can't be handed precomputed ones. Collisions only use the hull though, so the first time a mesh is
+    /// compiled its hull is harvested from the compiled model (mesh_graph) and stored, keyed by a hash of
+    /// the source mesh and its scale. Following compilations are handed the (usually much smaller) hull
+    /// alone instead of the full mesh, so both the hull and inertia computations run over the hull only.
+    /// Mujoco computes the mass-properties (volume, inertia, center and frame) from the mesh it's handed,
+    /// so only convex meshes are cached, as these enclose the same solid as their hull, and the ones
+    /// computed from the hull are then the ones of the source mesh (nothing has to be patched after
+    /// compiling). The compiled mesh holds the hull though, so vertex-data uploads into a cached mesh are
+    /// limited to the hull's vertex|face counts. Load and Store are thread- and process-safe. The cache is
+    /// disabled by default, and can be enabled either by setting a cache directory (setup only, before
+    /// any simulation is created), or by using the environment variable LOCO_MUJOCO_MESH_CACHE_DIR.
+    class TMujocoMeshCache
+    {
+    public :
+
+        static void SetCacheDirectory( const std::string& cache_dirpath );
+
+        static std::string ComputeKey( const std::vector<float>& vertices, const std::vector<int>& faces, const TVec3& scale );
+
+        static std::string ComputeKeyFromFile( const std::string& mesh_filepath, const TVec3& scale );
+
+        static std::shared_ptr<TMujocoMeshCacheEntry> Load( const std::string& key );
+
+        // Stores the hull of a mesh, as compiled into the given model (source vertices|faces as given to mujoco)
+        static bool Store( const std::string& key, const std::vector<float>& vertices, const std::vector<int>& faces,
+                           const mjModel* mjc_model, ssize_t mjc_mesh_id );
+
+        static bool StoreFromFile( const std::string& key, const std::string& mesh_filepath,
+                                   const mjModel* mjc_model, ssize_t mjc_mesh_id );
+
+        // Vfs-file of an in-memory mesh: its cached hull if available (viewing the mapped entry), otherwise the
+        // full mesh (and dst_pending_key is set, so the hull can be stored once the model is compiled)
+        static std::unique_ptr<TMjcVfsFile> CreateMeshVfsFile( const std::string& mesh_file,
+                                                               const std::vector<float>& vertices,
+                                                               const std::vector<int>& faces,
+                                                               const TVec3& scale,
+                                                               std::string& dst_pending_key );
+
+        // Vfs-file with the cached hull of a mesh-file (.msh or binary .stl), or nullptr on a cache-miss (and
+        // dst_pending_key is set, so the hull can be stored once the model is compiled)
+        static std::unique_ptr<TMjcVfsFile> CreateMeshVfsFileFromFile( const std::string& mesh_filepath,
+                                                                       const TVec3& scale,
+                                                                       std::string& dst_pending_key );
+
+        static void ResetStats();
+
+        static bool enabled();
+
+        static const std::string& cache_directory();
+
+        static ssize_t num_hits() { return s_NumHits; }
+
+        static ssize_t num_misses() { return s_NumMisses; }
+
+    private :
+
+        static std::string _GetEntryFilepath( const std::string& key );
+
+    private :
+
+        // Directory where the preprocessed meshes are stored (empty means cache disabled)
+        static std::string s_CacheDirectory;
+        // Whether or not the cache directory has been resolved (either by user or from environment)
+        static std::once_flag s_CacheDirectoryResolved;
+        // Number of times a preprocessed mesh was found in the cache
+        static std::atomic<ssize_t> s_NumHits;
+        // Number of times a preprocessed mesh was requested but not found in the cache
+        static std::atomic<ssize_t> s_NumMisses;
+    };
+}}
\ No newline at end of file
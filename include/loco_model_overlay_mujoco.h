@@ -0,0 +1,84 @@
+#pragma once
+
+#include <loco_common_mujoco.h>
+
+namespace loco {
+namespace mujoco {
+
+    // Model arrays that can be overridden per environment (materialized on first write)
+    enum class eMujocoModelParam : uint8_t
+    {
+        GEOM_FRICTION = 0,
+        GEOM_SIZE,
+        GEOM_RBOUND,
+        BODY_MASS,
+        BODY_SUBTREEMASS,
+        BODY_INERTIA,
+        DOF_DAMPING
+    };
+
+    const ssize_t LOCO_MUJOCO_NUM_MODEL_PARAMS = 7;
+
+    /// Copy-on-write view of a (shared) base model, used to give each environment its own parameters
+    ///
+    /// The view is a shallow copy of the base mjModel struct, so all its arrays point into the buffer of
+    /// the base model. The first write to a parameter materializes only that array (a copy owned by the
+    /// overlay), and redirects the view's pointer to it, so mujoco steps with the overridden values while
+    /// everything else stays shared. Arbitrary changes that aren't covered by the parameters above can fall
+    /// back to a private copy of the whole model (see MakePrivate). The base model must outlive the overlay.
+    /// Changes made to the base model afterwards (e.g. its options) only reach the view once it's synced
+    /// against it again (see Sync), which the owner does before using the view.
+    class TMujocoModelOverlay
+    {
+    public :
+
+        TMujocoModelOverlay( const mjModel* base_mjc_model );
+
+        TMujocoModelOverlay( const TMujocoModelOverlay& other ) = delete;
+
+        TMujocoModelOverlay& operator=( const TMujocoModelOverlay& other ) = delete;
+
+        ~TMujocoModelOverlay() = default;
+
+        // Returns the array of the given parameter, owned by this overlay (copied from the base model on first write)
+        mjtNum* Materialize( const eMujocoModelParam& param );
+
+        // Switches to a private copy of the whole model (keeping the values overridden so far), and returns it
+        mjModel* MakePrivate();
+
+        // Drops all overrides (and the private copy, if any), going back to the base model's values
+        void Clear();
+
+        // Refreshes the view from the (possibly changed or replaced) base model, keeping the overridden parameters
+        void Sync( const mjModel* base_mjc_model );
+
+        // Model to step with (the view, or the private copy if any)
+        const mjModel* mjc_model() const { return m_MjcPrivateModel ? m_MjcPrivateModel.get() : &m_MjcModelView; }
+
+        bool materialized( const eMujocoModelParam& param ) const { return !m_Arrays[static_cast<ssize_t>( param )].empty(); }
+
+        bool is_private() const { return m_MjcPrivateModel != nullptr; }
+
+        // Memory owned by this overlay, on top of the shared base model
+        ssize_t num_bytes() const;
+
+    private :
+
+        static mjtNum* mjModel::* _ParamArray( const eMujocoModelParam& param );
+
+        static ssize_t _ParamSize( const mjModel* mjc_model, const eMujocoModelParam& param );
+
+        void _ResetView();
+
+    private :
+
+        const mjModel* m_MjcBaseModelRef = nullptr;
+
+        // Shallow copy of the base model, with the pointers of materialized parameters redirected to m_Arrays
+        mjModel m_MjcModelView;
+
+        std::array<std::vector<mjtNum>, LOCO_MUJOCO_NUM_MODEL_PARAMS> m_Arrays;
+
+        std::unique_ptr<mjModel, MjcModelDeleter> m_MjcPrivateModel;
+    };
+}}
\ No newline at end of file
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <loco_common_mujoco.h>
+#include <atomic>
+
+#if defined( __linux__ )
+
+namespace loco {
+    class TMujocoSimulation;
+}
+
+namespace loco {
+namespace mujoco {
+
+    // Magic number used to check that a shared-memory segment was created by a loco-mujoco server
+    const uint32_t LOCO_MUJOCO_SHM_MAGIC = 0x4c4f434f; // "LOCO"
+    // Version of the shared-memory layout (bump on any change to TMujocoShmHeader)
+    const uint32_t LOCO_MUJOCO_SHM_VERSION = 3;
+    // Number of polling iterations before going to sleep on the doorbell (trades cpu for latency)
+    const ssize_t LOCO_MUJOCO_SHM_SPIN_ITERS = 2000;
+    // Period (in milliseconds) at which a waiting client|server checks that its peer process is still alive
+    const int64_t LOCO_MUJOCO_SHM_LIVENESS_PERIOD_MS = 100;
+
+    // Commands a client can request through the doorbell
+    enum class eShmCommand : uint32_t
+    {
+        NONE = 0,
+        STEP,
+        RESET,
+        CLOSE
+    };
+
+    /// Header placed at the start of the shared-memory segment, followed by the data buffers
+    ///
+    /// Buffers (all mjtNum) are laid out right after the header, in this order: qpos (nq), qvel (nv),
+    /// sensordata (nsensordata), and ctrl (nu). The first three are written by the server (observations),
+    /// whereas ctrl is written by the client (actions). Both doorbells are 32-bit counters used as futex
+    /// words: the client bumps request_seq after writing its actions and command, and the server bumps
+    /// response_seq (to the same value) once the observations are written. The magic is published last
+    /// (after a release fence), so a client that reads it and then fences sees a complete header.
+    struct TMujocoShmHeader
+    {
+        std::atomic<uint32_t> magic;
+        uint32_t version;
+        // Process serving the segment (used to detect stale segments, and servers that died mid-request)
+        int64_t server_pid;
+        int64_t nq;
+        int64_t nv;
+        int64_t nu;
+        int64_t nsensordata;
+        int64_t qpos_offset;
+        int64_t qvel_offset;
+        int64_t sensordata_offset;
+        int64_t ctrl_offset;
+        int64_t total_size;
+        // Request (written by the client)
+        alignas( 64 ) std::atomic<uint32_t> request_seq;
+        uint32_t command;
+        // Process of the connected client, if any (used to detect clients that died while the server waits)
+        std::atomic<int64_t> client_pid;
+        // Response (written by the server)
+        alignas( 64 ) std::atomic<uint32_t> response_seq;
+        uint32_t done;
+        double reward;
+        double time;
+    };
+
+    // Blocks until the futex-word differs from the given value (spins for a while before sleeping), or until
+    // the timeout expires (negative means no timeout). Returns false if it timed out
+    bool ShmDoorbellWait( std::atomic<uint32_t>* doorbell, uint32_t value, int64_t timeout_ms = -1 );
+
+    // Wakes up all processes waiting on the futex-word
+    void ShmDoorbellRing( std::atomic<uint32_t>* doorbell );
+
+    /// Local server that exposes a simulation's observations|actions through POSIX shared memory
+    ///
+    /// Clients in other processes map the same segment (see TMujocoShmClient), so observations are read
+    /// in place (no serialization nor copies through pipes), and step|reset commands are sent through a
+    /// futex-based doorbell. Rewards (and episode termination) are task-specific, so they're computed by
+    /// an optional user-provided callback after every step. A segment serves a single client (commands,
+    /// actions and the request sequence are written by the client without any arbitration). Segments left
+    /// behind by servers that are no longer running are replaced on Start, but live ones are never reused.
+    class TMujocoShmServer
+    {
+    public :
+
+        using RewardFunction = std::function<double( TMujocoSimulation* simulation, bool& done )>;
+
+        TMujocoShmServer( TMujocoSimulation* simulation_ref, const std::string& shm_name );
+
+        TMujocoShmServer( const TMujocoShmServer& other ) = delete;
+
+        TMujocoShmServer& operator=( const TMujocoShmServer& other ) = delete;
+
+        ~TMujocoShmServer();
+
+        bool Start();
+
+        // Serves requests until a client sends a CLOSE command (or no request can be served, see ServeOnce)
+        void Serve();
+
+        // Serves a single request (blocks until it arrives), and returns false if it was a CLOSE command, or if
+        // no request arrived because the connected client died or the request timeout expired
+        bool ServeOnce();
+
+        void SetRewardFunction( const RewardFunction& reward_fcn ) { m_RewardFcn = reward_fcn; }
+
+        // Maximum time to wait for a client's request (negative means wait as long as the client is alive)
+        void SetRequestTimeout( int64_t timeout_ms ) { m_RequestTimeoutMs = timeout_ms; }
+
+        int64_t request_timeout() const { return m_RequestTimeoutMs; }
+
+        const std::string& shm_name() const { return m_ShmName; }
+
+        bool running() const { return m_Header != nullptr; }
+
+    private :
+
+        void _WriteObservations();
+
+        void _Release();
+
+        const mjtNum* _BufferCtrl() const { return reinterpret_cast<const mjtNum*>( static_cast<const uint8_t*>( m_ShmData ) + m_Header->ctrl_offset ); }
+
+    private :
+
+        // Simulation being served
+        TMujocoSimulation* m_SimulationRef;
+        // Name of the shared-memory object (as given to shm_open, e.g. "/loco_env_0")
+        std::string m_ShmName;
+        // Mapped shared-memory segment
+        void* m_ShmData;
+        // Size of the mapped segment (in bytes)
+        size_t m_ShmSize;
+        // Header of the segment (start of the mapping)
+        TMujocoShmHeader* m_Header;
+        // Last request served (to detect new requests)
+        uint32_t m_LastRequestSeq;
+        // Optional task-specific reward function
+        RewardFunction m_RewardFcn;
+        // Maximum time to wait for a request (negative means wait as long as the client is alive)
+        int64_t m_RequestTimeoutMs;
+    };
+
+    /// Client-side view of a TMujocoShmServer's segment (observations are read in place, zero-copy)
+    ///
+    /// Requests block until the server answers, but fail (return false) if the server process dies, or if
+    /// the optional request timeout expires. Only one client may be connected to a segment at a time (a
+    /// segment whose client is still running refuses other connections).
+    class TMujocoShmClient
+    {
+    public :
+
+        TMujocoShmClient( const std::string& shm_name );
+
+        TMujocoShmClient( const TMujocoShmClient& other ) = delete;
+
+        TMujocoShmClient& operator=( const TMujocoShmClient& other ) = delete;
+
+        ~TMujocoShmClient();
+
+        bool Connect();
+
+        bool Step();
+
+        bool Reset();
+
+        bool Close();
+
+        // Maximum time to wait for the server to answer a request (negative means no timeout)
+        void SetRequestTimeout( int64_t timeout_ms ) { m_RequestTimeoutMs = timeout_ms; }
+
+        int64_t request_timeout() const { return m_RequestTimeoutMs; }
+
+        const mjtNum* qpos() const { return _Buffer( m_Header->qpos_offset ); }
+
+        const mjtNum* qvel() const { return _Buffer( m_Header->qvel_offset ); }
+
+        const mjtNum* sensordata() const { return _Buffer( m_Header->sensordata_offset ); }
+
+        mjtNum* ctrl() { return const_cast<mjtNum*>( _Buffer( m_Header->ctrl_offset ) ); }
+
+        ssize_t nq() const { return m_Header->nq; }
+
+        ssize_t nv() const { return m_Header->nv; }
+
+        ssize_t nu() const { return m_Header->nu; }
+
+        ssize_t nsensordata() const { return m_Header->nsensordata; }
+
+        double reward() const { return m_Header->reward; }
+
+        bool done() const { return m_Header->done != 0; }
+
+        double time() const { return m_Header->time; }
+
+        bool connected() const { return m_Header != nullptr; }
+
+        const std::string& shm_name() const { return m_ShmName; }
+
+    private :
+
+        bool _Request( const eShmCommand& command );
+
+        const mjtNum* _Buffer( int64_t offset ) const { return reinterpret_cast<const mjtNum*>( static_cast<const uint8_t*>( m_ShmData ) + offset ); }
+
+    private :
+
+        // Name of the shared-memory object created by the server
+        std::string m_ShmName;
+        // Mapped shared-memory segment
+        void* m_ShmData;
+        // Size of the mapped segment (in bytes)
+        size_t m_ShmSize;
+        // Header of the segment (start of the mapping)
+        TMujocoShmHeader* m_Header;
+        // Maximum time to wait for an answer (negative means wait as long as the server is alive)
+        int64_t m_RequestTimeoutMs;
+    };
+}}
+
+#endif /* __linux__ */
\ No newline at end of file
@@ -1,6 +1,12 @@
 #pragma once
 
 #include <loco_common_mujoco.h>
+#include <loco_model_cache_mujoco.h>
+#include <loco_contact_buffer_mujoco.h>
+#include <loco_state_buffer_mujoco.h>
+#include <loco_async_stepper_mujoco.h>
+#include <loco_trajectory_recorder_mujoco.h>
+#include <loco_body_slots_mujoco.h>
 #include <loco_simulation.h>
 #include <utils/loco_parsing_common.h>
 #include <utils/loco_parsing_schema.h>
@@ -35,6 +41,144 @@ namespace loco
 
         const mjData* mjc_data() const { return m_MjcData.get(); }
 
+        const mujoco::TMujocoNameIndex* mjc_name_index() const { return m_MjcNameIndex.get(); }
+
+        // Creates an independent copy of this simulation over the given scenario (holding the same objects, i.e. same names
+        // and structure, as this simulation's scenario), sharing the compiled model and copying only the simulation-state
+        std::unique_ptr<TMujocoSimulation> Clone( TScenario* scenario_clone ) const;
+
+        // Makes a private copy of the model if shared with clones, and returns it. Every model write (made by the simulation
+        // or through adapters) already goes through it, so this is only needed to write into the model directly
+        mjModel* MakeMjcModelUnique();
+
+        bool mjc_model_shared() const { return m_MjcModel.use_count() > 1; }
+
+        const mujoco::TMujocoContactBuffer* mjc_contact_buffer() const { return m_MjcContactBuffer.get(); }
+
+        // Collects the contacts of the last step (only if not collected yet, e.g. when using lazy collection)
+        void CollectContacts();
+
+        void SetContactsCollectionMode( const mujoco::eContactsCollectionMode& mode ) { m_ContactsCollectionMode = mode; }
+
+        // Consumers request contacts to be collected after every step (even when using lazy collection)
+        void RegisterContactsConsumer() { m_NumContactsConsumers++; }
+
+        void UnregisterContactsConsumer() { m_NumContactsConsumers = std::max<ssize_t>( 0, m_NumContactsConsumers - 1 ); }
+
+        mujoco::eContactsCollectionMode contacts_collection_mode() const { return m_ContactsCollectionMode; }
+
+        ssize_t num_contacts_consumers() const { return m_NumContactsConsumers; }
+
+        bool contacts_dirty() const { return m_ContactsDirty; }
+
+        // Requests contact-forces to be computed for the given collider (single-body or kintree collider)
+        void SetContactForcesSubscription( const std::string& collider_name, bool subscribe );
+
+        // Returns a view over the contacts (and forces, if subscribed) of a collider, valid until the next step
+        mujoco::TMujocoContactsView GetMjcContacts( const std::string& collider_name );
+
+        // Same as the base Step|Reset, but refused while stepping asynchronously (only the stepping thread owns mjData;
+        // calls through a TISimulation pointer are refused by the internal hooks, after the scenario hooks already ran)
+        void Step( const TScalar& dt = -1.0f );
+
+        void Reset();
+
+        // Runs n control periods (each one of num_substeps physics steps), with pre|post-step hooks only at the boundaries
+        void StepN( ssize_t num_periods, const TScalar& dt = -1.0f );
+
+        // First half of a control period: pre-step hooks, then position|velocity dependent computations (mj_step1)
+        void StepPhase1();
+
+        // Second half of a control period: acceleration|integration (mj_step2, plus remaining substeps), then post-step hooks
+        void StepPhase2( const TScalar& dt = -1.0f );
+
+        bool step_phase1_done() const { return m_StepPhase1Done; }
+
+        // Starts stepping on a dedicated thread (the simulation must then only be stepped through StepAsync)
+        void StartAsync( ssize_t num_snapshot_slots = mujoco::LOCO_MUJOCO_ASYNC_MIN_SNAPSHOT_SLOTS );
+
+        // Waits for pending step requests, and goes back to synchronous stepping
+        void StopAsync();
+
+        std::future<void> StepAsync( const TScalar& dt = -1.0f );
+
+        // Returns a handle to the latest snapshot of the state (only while running asynchronously)
+        mujoco::TMujocoSnapshotHandle AcquireSnapshot() const;
+
+        bool async_running() const { return m_AsyncStepper != nullptr; }
+
+        // Fixes the number of physics steps per control period (0 means derived from dt and the physics time-step)
+        void SetNumSubsteps( ssize_t num_substeps );
+
+        ssize_t num_substeps() const { return m_NumSubsteps; }
+
+    #if defined( __linux__ ) || defined( __APPLE__ )
+        // Starts appending every step to a memory-mapped trajectory log (see TMujocoTrajectoryRecorder)
+        bool StartRecording( const std::string& filepath, ssize_t keyframe_interval = 100 );
+
+        void StopRecording();
+
+        bool recording() const { return m_TrajectoryRecorder != nullptr; }
+
+        const mujoco::TMujocoTrajectoryRecorder* trajectory_recorder() const { return m_TrajectoryRecorder.get(); }
+
+        // Starts playing back a trajectory log (kinematics only, no dynamics): each Step() moves to the next record
+        bool StartReplay( const std::string& filepath, bool compute_contacts = false );
+
+        // Stops playing back, and restores the state the simulation had before the replay started
+        void StopReplay();
+
+        // Moves the replay to the given record (hooks run as on a regular step, so adapters report its transforms)
+        bool ReplaySeek( ssize_t record_id );
+
+        bool replaying() const { return m_TrajectoryReader != nullptr; }
+
+        ssize_t replay_record_id() const { return m_ReplayRecordId; }
+
+        const mujoco::TMujocoTrajectoryReader* trajectory_reader() const { return m_TrajectoryReader.get(); }
+    #endif
+
+        // Reserves hidden free-bodies of the given shape and size-class, to spawn single-bodies into (call before Initialize)
+        void ReserveBodySlots( const eShapeType& shape, const TVec3& size, ssize_t num_slots );
+
+        const std::vector<mujoco::TMujocoBodySlotsReservation>& body_slots_reservations() const { return m_BodySlotsReservations; }
+
+        // Adds a single-body at runtime by reusing a compatible parked slot (no recompilation), or nullptr if there's none
+        primitives::TSingleBody* SpawnSingleBody( std::unique_ptr<primitives::TSingleBody> single_body );
+
+        const mujoco::TMujocoBodySlotsManager* mjc_body_slots() const { return m_MjcBodySlots.get(); }
+
+        // Compiles a model with the objects added to the scenario since the last build on a background thread (the
+        // current model keeps stepping), and swaps it in at the next step boundary, transferring the state by name
+        bool RebuildAsync();
+
+        // Blocks until the pending rebuild (if any) is compiled, and swaps it in right away
+        bool WaitRebuild();
+
+        bool rebuild_pending() const { return m_PendingMjcModel.valid(); }
+
+        // Requests the compiled mjcf-xml (and generated assets) to be dumped to disk (debugging only)
+        void SetMjcfDumpFilepath( const std::string& filepath ) { m_MjcfDumpFilepath = filepath; }
+
+        const std::string& mjcf_dump_filepath() const { return m_MjcfDumpFilepath; }
+
+        // Saves the integration-state into the ring of checkpoints, and returns the id of the checkpoint
+        ssize_t SaveState();
+
+        // Restores the integration-state from a checkpoint (-1 for the latest), without going through the adapters
+        bool RestoreState( ssize_t checkpoint_id = -1, bool recompute_derived = true );
+
+        void SetStateRingCapacity( ssize_t capacity );
+
+        const mujoco::TMujocoStateRing* mjc_state_ring() const { return m_MjcStateRing.get(); }
+
+        // Resets restore an initial-state image (taken on the first reset) plus user overrides, instead of going through every adapter
+        void SetBulkResetEnabled( bool enabled );
+
+        bool bulk_reset_enabled() const { return m_BulkResetEnabled; }
+
+        ssize_t state_ring_capacity() const { return m_StateRingCapacity; }
+
     protected :
 
         bool _InitializeInternal() override;
@@ -57,24 +201,118 @@ namespace loco
 
         void _CreateKinematicTreeAdapters();
 
+        std::string _AssembleMjcfXml();
+
+        void _LinkMjcModel();
+
+        bool _SwapRebuiltModel();
+
+        bool _CloneFrom( const TMujocoSimulation& other );
+
+        void _RebindMjcModel();
+
+        // Accessor given to adapters (and the slots-manager), so their model writes go through MakeMjcModelUnique
+        mujoco::FnMjcModelUnique _MjcModelUniqueFn();
+
         void _CollectResourcesFromSingleBodies();
 
         void _CollectResourcesFromKinematicTrees();
 
+        void _CollectResourcesFromReservedSlots();
+
+        void _RegisterReservedSlots();
+
+        std::vector<const mujoco::TMjcVfsFile*> _CollectVfsResources() const;
+
+        std::vector<std::string> _CollectAssetFilepaths( const std::vector<const mujoco::TMjcVfsFile*>& vfs_resources ) const;
+
+        mjModel* _LoadMjcModel( const std::string& mjcf_xml_str,
+                                const std::vector<const mujoco::TMjcVfsFile*>& vfs_resources ) const;
+
+        mjModel* _CompileMjcModel( const std::string& mjcf_xml_str,
+                                   const std::vector<const mujoco::TMjcVfsFile*>& vfs_resources ) const;
+
+        void _DumpMjcfResources( const std::string& mjcf_xml_str,
+                                 const std::vector<const mujoco::TMjcVfsFile*>& vfs_resources ) const;
+
         void _CollectContacts();
 
+        ssize_t _NumSubsteps( const TScalar& dt ) const;
+
+        bool _BlockedByAsync( const std::string& caller ) const;
+
+        void _BulkReset();
+
+        void _SetAdaptersBulkResetEnabled( bool enabled );
+
+    #if defined( __linux__ ) || defined( __APPLE__ )
+        bool _ReplayRecord( ssize_t record_id );
+    #endif
+
     private :
 
-        // Owned MuJoCo-mjModel struct (access mujoco resources related to model structure)
-        std::unique_ptr<mjModel, mujoco::MjcModelDeleter> m_MjcModel;
+        // MuJoCo-mjModel struct (access mujoco resources related to model structure), shared with clones until modified
+        std::shared_ptr<mjModel> m_MjcModel;
         // Owned MuJoCo-mjData struct (access mujoco resources related to simulation computations)
         std::unique_ptr<mjData, mujoco::MjcDataDeleter> m_MjcData;
+        // Name-to-id index of the compiled model, shared by all adapters (and clones, as ids don't change on copies)
+        std::shared_ptr<mujoco::TMujocoNameIndex> m_MjcNameIndex;
+        // Preallocated storage for the contacts collected after each step (indexed by geom-id)
+        std::unique_ptr<mujoco::TMujocoContactBuffer> m_MjcContactBuffer;
+        // Number of physics steps per control period (0 means derived from dt and the physics time-step)
+        ssize_t m_NumSubsteps = 0;
+        // Whether or not the first half of a split-phase step has been taken (waiting for StepPhase2)
+        bool m_StepPhase1Done = false;
+        // Stepper used when running asynchronously (steps on its own thread and publishes snapshots)
+        std::unique_ptr<mujoco::TMujocoAsyncStepper> m_AsyncStepper;
+    #if defined( __linux__ ) || defined( __APPLE__ )
+        // Recorder of the trajectory (records right after every step, only while recording)
+        std::unique_ptr<mujoco::TMujocoTrajectoryRecorder> m_TrajectoryRecorder;
+        // Reader of the trajectory being played back (only while replaying)
+        std::unique_ptr<mujoco::TMujocoTrajectoryReader> m_TrajectoryReader;
+        // State of the simulation right before the replay started (restored once the replay stops)
+        std::unique_ptr<mujoco::TMujocoStateImage> m_MjcPreReplayImage;
+        // Record currently loaded into mjData during replay (-1 if none yet)
+        ssize_t m_ReplayRecordId = -1;
+        // Whether or not to run collision detection on each replayed record (for contacts, without forces)
+        bool m_ReplayContacts = false;
+    #endif
+        // Manager of the bodies left behind by detached single-bodies (parked once, reusable by spawned ones)
+        std::unique_ptr<mujoco::TMujocoBodySlotsManager> m_MjcBodySlots;
+        // Number of recycled adapters already handed to the slots-manager
+        ssize_t m_NumRecycledParked = 0;
+        // Pools of hidden free-bodies added to the model on initialization (registered as parked slots)
+        std::vector<mujoco::TMujocoBodySlotsReservation> m_BodySlotsReservations;
+        // Model being compiled in the background by RebuildAsync (swapped in at the next step boundary)
+        std::future<mjModel*> m_PendingMjcModel;
+        // Adapters of the objects added since the last build (linked to their objects once the rebuilt model is swapped in)
+        std::vector<std::unique_ptr<primitives::TISingleBodyAdapter>> m_PendingSingleBodyAdapters;
+        // Adapters of the kinematic-trees added since the last build (same as above)
+        std::vector<std::unique_ptr<kintree::TIKinematicTreeAdapter>> m_PendingKinematicTreeAdapters;
+        // Preallocated ring of checkpoints of the integration-state (used by SaveState|RestoreState)
+        std::unique_ptr<mujoco::TMujocoStateRing> m_MjcStateRing;
+        // Number of checkpoints kept in the ring (oldest ones are overwritten first)
+        ssize_t m_StateRingCapacity = 8;
+        // State-image taken right after the first (full) reset, restored on every following reset
+        std::unique_ptr<mujoco::TMujocoStateImage> m_MjcResetImage;
+        // Whether or not resets are done in bulk (by restoring the initial-state image)
+        bool m_BulkResetEnabled = true;
+        // Names of the colliders that requested contact-forces (kept to re-apply after initialization)
+        std::set<std::string> m_ContactForcesSubscriptions;
+        // Mode used for the collection of contacts after each step
+        mujoco::eContactsCollectionMode m_ContactsCollectionMode = mujoco::eContactsCollectionMode::EAGER;
+        // Number of consumers that require contacts after every step
+        ssize_t m_NumContactsConsumers = 0;
+        // Whether or not the contacts of the last step haven't been collected yet
+        bool m_ContactsDirty = true;
         // Owned mjcf Element used to store the simulation object
         std::unique_ptr<parsing::TElement> m_MjcfSimulationElement;
         // Checking-set to avoid double-additions of assets with same name
         std::set<std::string> m_MjcfAssetsNames;
         // Checking-set to avoid double-additions of assets with same filepath
         std::set<std::string> m_MjcfAssetsFilepaths;
+        // Filepath where to dump the compiled mjcf-xml (empty means no dump, compile from memory only)
+        std::string m_MjcfDumpFilepath;
         // Flag to check if MuJoCo has already been activated (can only call activate once)
         static bool s_HasActivatedMujoco;
     };
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <loco_common_mujoco.h>
+#include <cstring>
+
+namespace loco {
+namespace mujoco {
+
+    /// Snapshot of the integration-state of a mjData (time, qpos, qvel, act, ctrl, qacc_warmstart,
+    /// applied forces, mocap and userdata), stored in a single preallocated contiguous buffer
+    ///
+    /// Storage is allocated once for a given model (see Allocate), so capturing and restoring a
+    /// snapshot are just a handful of memcpys (one per field), without any heap allocations. Derived
+    /// quantities (e.g. kinematics, contacts) are not stored, and can be recomputed with mj_forward
+    /// after restoring.
+    class TMujocoStateImage
+    {
+    public :
+
+        TMujocoStateImage() = default;
+
+        void Allocate( const mjModel* mjc_model );
+
+        void Capture( const mjModel* mjc_model, const mjData* mjc_data );
+
+        void Restore( const mjModel* mjc_model, mjData* mjc_data ) const;
+
+        // Loads a serialized state (e.g. from disk), given as time plus the contiguous buffer (see data())
+        void Assign( mjtNum time, const mjtNum* values );
+
+        void Invalidate() { m_Valid = false; }
+
+        const mjtNum* data() const { return m_Buffer.data(); }
+
+        ssize_t num_values() const { return m_Buffer.size(); }
+
+        bool valid() const { return m_Valid; }
+
+        mjtNum time() const { return m_Time; }
+
+        ssize_t num_bytes() const { return m_Buffer.size() * sizeof( mjtNum ); }
+
+        // Simulation time tracked by the backend-agnostic simulation (might differ from mjData::time)
+        TScalar world_time = 0.0f;
+
+    private :
+
+        // Number of mjtNum entries of each field, given the model's sizes
+        static std::array<ssize_t, 10> _FieldSizes( const mjModel* mjc_model );
+
+    private :
+
+        // Contiguous storage of all fields (in the same order as the fields listed above)
+        std::vector<mjtNum> m_Buffer;
+        // Start of each field in the contiguous storage
+        std::array<ssize_t, 10> m_FieldsOffsets;
+        // Value of mjData::time at capture
+        mjtNum m_Time = 0.0;
+        // Whether or not this image holds a captured state
+        bool m_Valid = false;
+    };
+
+    /// Fixed-capacity ring of state-images (checkpoints), where saving a new state overwrites the oldest one
+    ///
+    /// Checkpoints are identified by a monotonically increasing id, so an id that has already been
+    /// overwritten can be detected (and rejected) instead of silently restoring a different state.
+    class TMujocoStateRing
+    {
+    public :
+
+        TMujocoStateRing() = default;
+
+        void Resize( const mjModel* mjc_model, ssize_t capacity );
+
+        ssize_t Save( const mjModel* mjc_model, const mjData* mjc_data, const TScalar& world_time );
+
+        // Returns the image associated with a checkpoint-id (-1 for the latest), or nullptr if not available
+        const TMujocoStateImage* Get( ssize_t checkpoint_id = -1 ) const;
+
+        void Clear();
+
+        ssize_t capacity() const { return m_Images.size(); }
+
+        ssize_t size() const { return std::min<ssize_t>( m_NextCheckpointId - m_FirstCheckpointId, m_Images.size() ); }
+
+        ssize_t latest_checkpoint_id() const { return m_NextCheckpointId - 1; }
+
+    private :
+
+        // Preallocated images, indexed by checkpoint-id modulo the capacity
+        std::vector<TMujocoStateImage> m_Images;
+        // Id to be assigned to the next saved checkpoint
+        ssize_t m_NextCheckpointId = 0;
+        // Id of the first checkpoint saved since the last clear
+        ssize_t m_FirstCheckpointId = 0;
+    };
+}}
\ No newline at end of file
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <loco_common_mujoco.h>
+#include <functional>
+
+namespace loco {
+    class TScenario;
+namespace primitives {
+    class TSingleBody;
+    class TMujocoSingleBodyAdapter;
+    class TMujocoSingleBodyColliderAdapter;
+}
+namespace kintree {
+    class TKinematicTree;
+}}
+
+namespace loco {
+namespace mujoco {
+
+    // Prefix of the names of the single-bodies used as terrain tiles (followed by terrain-name and slot-index)
+    const std::string LOCO_MUJOCO_STREAMING_TERRAIN_TILE_PREFIX = "__loco_terrain_";
+
+    // Region of the world covered by a terrain tile (tiles are indexed in a grid centered at the origin)
+    struct TMujocoTerrainTile
+    {
+        // Grid indices of the tile (tile (0,0) is centered at the origin)
+        ssize_t ix = 0;
+        ssize_t iy = 0;
+        // World coordinates of the first sample (row 0, column 0), i.e. the min-corner of the tile
+        TScalar x_min = 0.0f;
+        TScalar y_min = 0.0f;
+        // Distance between consecutive samples (edge samples are shared with the neighbouring tiles)
+        TScalar sample_spacing = 0.0f;
+        // Number of samples per side of the tile
+        ssize_t num_samples = 0;
+    };
+
+    // Writes the heights of a tile (num_samples x num_samples, row-major, rows along y and columns along x)
+    using FnTerrainTileGenerator = std::function<void( const TMujocoTerrainTile& tile, std::vector<float>& dst_heights )>;
+
+    /// Terrain of unbounded size, streamed as a fixed window of k x k heightfield tiles around a tracked agent
+    ///
+    /// Tiles are regular static heightfield single-bodies added to the scenario before the simulation is
+    /// created, so the compiled model holds exactly k x k hfields regardless of the size of the world. The
+    /// world-tile (ix, iy) always lives in slot (ix mod k, iy mod k), so when the agent crosses into another
+    /// tile only the row|column of slots that left the window is recycled: its heights are regenerated into
+    /// hfield_data and its geom is moved, without recompiling the model. Recycled tiles keep their placement
+    /// on simulation resets (which don't touch hfield_data), so heights and placements never go out of sync.
+    class TMujocoStreamingTerrain
+    {
+    public :
+
+        // Must be created before the simulation (tiles are added to the scenario as single-bodies)
+        TMujocoStreamingTerrain( TScenario* scenario_ref,
+                                 const std::string& name,
+                                 ssize_t num_tiles_per_side,
+                                 TScalar tile_size,
+                                 ssize_t num_samples_per_side,
+                                 TScalar height_scale,
+                                 const FnTerrainTileGenerator& generator );
+
+        TMujocoStreamingTerrain( const TMujocoStreamingTerrain& other ) = delete;
+
+        TMujocoStreamingTerrain& operator=( const TMujocoStreamingTerrain& other ) = delete;
+
+        ~TMujocoStreamingTerrain() = default;
+
+        // Links to the tiles' mjc-adapters (call once the simulation has been initialized)
+        bool Initialize();
+
+        // Recenters the window around the tracked kinematic-tree (if any)
+        void Update();
+
+        // Recenters the window around a world position (tiles are recycled only if the center-tile changed)
+        void Update( const TVec3& position );
+
+        void SetTrackedKinematicTree( kintree::TKinematicTree* kintree_ref ) { m_TrackedKintreeRef = kintree_ref; }
+
+        // Fraction of a tile the agent has to move beyond the center-tile before recentering (avoids thrashing at borders)
+        void SetRecenterMargin( TScalar margin ) { m_RecenterMargin = std::max( 0.0f, margin ); }
+
+        const std::string& name() const { return m_Name; }
+
+        ssize_t num_tiles_per_side() const { return m_NumTilesPerSide; }
+
+        TScalar tile_size() const { return m_TileSize; }
+
+        ssize_t num_samples_per_side() const { return m_NumSamplesPerSide; }
+
+        ssize_t center_ix() const { return m_CenterIx; }
+
+        ssize_t center_iy() const { return m_CenterIy; }
+
+        // Number of tiles (re)generated so far, including the initial ones
+        ssize_t num_tiles_streamed() const { return m_NumTilesStreamed; }
+
+        // World-tile currently held by a slot
+        const TMujocoTerrainTile& slot_tile( ssize_t slot_index ) const { return m_SlotsTiles[slot_index]; }
+
+    private :
+
+        TMujocoTerrainTile _MakeTile( ssize_t ix, ssize_t iy ) const;
+
+        ssize_t _SlotIndex( ssize_t ix, ssize_t iy ) const;
+
+        void _StreamTile( ssize_t slot_index, ssize_t ix, ssize_t iy );
+
+    private :
+
+        std::string m_Name;
+        // Number of tiles per side of the window (k, odd so the window is centered on the agent's tile)
+        ssize_t m_NumTilesPerSide;
+        // Side length of a tile (in world units)
+        TScalar m_TileSize;
+        // Number of heightfield samples per side of a tile
+        ssize_t m_NumSamplesPerSide;
+        // Height-scale of the heightfield colliders
+        TScalar m_HeightScale;
+        // User-defined source of the heights of each tile
+        FnTerrainTileGenerator m_Generator;
+        // Single-bodies used as tiles, and their mjc body|collider-adapters (one per slot)
+        std::vector<primitives::TSingleBody*> m_SlotsBodies;
+        std::vector<primitives::TMujocoSingleBodyAdapter*> m_SlotsBodiesAdapters;
+        std::vector<primitives::TMujocoSingleBodyColliderAdapter*> m_SlotsAdapters;
+        // World-tile currently held by each slot
+        std::vector<TMujocoTerrainTile> m_SlotsTiles;
+        // Scratch buffer where the generator writes the heights of a tile
+        std::vector<float> m_ScratchHeights;
+        // Grid indices of the tile at the center of the window
+        ssize_t m_CenterIx = 0;
+        ssize_t m_CenterIy = 0;
+        TScalar m_RecenterMargin = 0.25f;
+        ssize_t m_NumTilesStreamed = 0;
+        kintree::TKinematicTree* m_TrackedKintreeRef = nullptr;
+    };
+}}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <loco_common_mujoco.h>
+#include <deque>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace loco {
+namespace mujoco {
+
+    /// Execution statistics of a single worker of a TMujocoThreadPool (accumulated over batches)
+    struct TMujocoWorkerStats
+    {
+        // Time spent running tasks (in milliseconds)
+        double busy_time_ms = 0.0;
+        // Number of tasks executed by this worker
+        ssize_t num_tasks = 0;
+        // Number of chunks this worker stole from other workers' queues
+        ssize_t num_steals = 0;
+        // Fraction of the wall-time of the batches that this worker spent running tasks
+        double utilization = 0.0;
+    };
+
+    /// Fixed-size pool of worker threads, used to run batches of independent tasks (e.g. stepping
+    /// many mjData instances that share the same mjModel), whose cost might vary wildly from task
+    /// to task (e.g. an env in free-fall vs an env with lots of contacts)
+    ///
+    /// Work is scheduled by work-stealing: each worker owns a deque of chunks of tasks, seeded with
+    /// a contiguous range of the batch. Workers consume chunks from the front of their own deque,
+    /// and once it's empty they steal chunks from the back of the other workers' deques, so idle
+    /// workers help with the expensive parts of the batch. The chunk-size can be increased so that
+    /// batches of many cheap tasks don't pay the scheduling overhead per task.
+    class TMujocoThreadPool
+    {
+    public :
+
+        // If num_threads <= 0, uses the number of hardware threads available
+        TMujocoThreadPool( ssize_t num_threads = 0 );
+
+        TMujocoThreadPool( const TMujocoThreadPool& other ) = delete;
+
+        TMujocoThreadPool& operator=( const TMujocoThreadPool& other ) = delete;
+
+        ~TMujocoThreadPool();
+
+        void ParallelFor( ssize_t num_tasks, const std::function<void( ssize_t )>& task );
+
+        void SetChunkSize( ssize_t chunk_size );
+
+        void ResetStats();
+
+        std::vector<TMujocoWorkerStats> GetWorkerStats() const;
+
+        ssize_t num_threads() const { return m_Workers.size(); }
+
+        ssize_t chunk_size() const { return m_ChunkSize; }
+
+        double batches_wall_time_ms() const { return m_BatchesWallTimeMs; }
+
+    private :
+
+        struct TTaskChunk
+        {
+            ssize_t start;
+            ssize_t end;
+        };
+
+        struct TWorkerQueue
+        {
+            std::mutex mutex;
+            std::deque<TTaskChunk> chunks;
+            TMujocoWorkerStats stats;
+            // Padding to keep the queues of different workers in separate cache-lines
+            char padding[64];
+        };
+
+        void _WorkerLoop( ssize_t worker_id );
+
+        bool _PopChunk( ssize_t worker_id, TTaskChunk& dst_chunk );
+
+        bool _StealChunk( ssize_t worker_id, TTaskChunk& dst_chunk );
+
+    private :
+
+        // Worker threads owned by this pool
+        std::vector<std::thread> m_Workers;
+        // Per-worker queues of chunks of tasks (and execution stats)
+        std::vector<std::unique_ptr<TWorkerQueue>> m_Queues;
+        // Synchronization primitives used to dispatch batches and wait for their completion
+        std::mutex m_Mutex;
+        std::condition_variable m_CondVarBatch;
+        std::condition_variable m_CondVarDone;
+        // Current batch of tasks (valid only while ParallelFor is running)
+        const std::function<void( ssize_t )>* m_Task = nullptr;
+        // Id of the current batch (workers use it to detect new batches)
+        uint64_t m_BatchId = 0;
+        // Number of workers that have run out of work for the current batch
+        ssize_t m_NumWorkersDone = 0;
+        // Number of consecutive tasks grouped into a single schedulable chunk
+        ssize_t m_ChunkSize = 1;
+        // Accumulated wall-time of all batches run in parallel (used to compute utilization)
+        double m_BatchesWallTimeMs = 0.0;
+        // Flag used to stop the workers on destruction
+        bool m_Stop = false;
+    };
+}}
\ No newline at end of file
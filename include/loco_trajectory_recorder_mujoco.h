@@ -0,0 +1,193 @@
+#pragma once
+
+#include <loco_common_mujoco.h>
+#include <loco_state_buffer_mujoco.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#if defined( __linux__ ) || defined( __APPLE__ )
+
+namespace loco {
+namespace mujoco {
+
+    // Magic number used to check that a file was written by the trajectory recorder
+    const uint32_t LOCO_MUJOCO_TRAJECTORY_MAGIC = 0x4c545241; // "LTRA"
+    // Version of the file layout (bump on any change to TMujocoTrajectoryHeader or the records)
+    const uint32_t LOCO_MUJOCO_TRAJECTORY_VERSION = 2;
+    // Extension appended to the trajectory filepath for the keyframes sidecar file
+    const std::string LOCO_MUJOCO_TRAJECTORY_KEYFRAMES_EXTENSION = ".keys";
+    // Number of records the log file grows by when it runs out of space (at least)
+    const ssize_t LOCO_MUJOCO_TRAJECTORY_GROW_RECORDS = 4096;
+
+    /// Header at the start of a trajectory log
+    ///
+    /// Records are stored right after the header (aligned to 64 bytes), all with the same stride, as
+    /// mjtNum values in this order: time, qpos (nq), qvel (nv), ctrl (nu), xfrc_applied (6 x nbody). So
+    /// any record can be located in O(1). Records are partial states, so every keyframe_interval records
+    /// a full state-image (see TMujocoStateImage) is appended to the keyframes sidecar, as entries of
+    /// record-id, time and state-values. Keyframes are also forced right after discontinuities (e.g. a
+    /// reset, or a restored checkpoint), so replaying never integrates across a jump in the state. The
+    /// keyframe for any record is found by binary search over their record-ids, and from it the exact
+    /// state can be recovered by replaying the recorded controls and applied forces.
+    struct TMujocoTrajectoryHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        int64_t nq;
+        int64_t nv;
+        int64_t nu;
+        int64_t nbody;
+        // Sizes that only affect the keyframes (state-images), checked too before restoring from them
+        int64_t na;
+        int64_t nmocap;
+        int64_t nuserdata;
+        int64_t record_num_values;
+        int64_t keyframe_num_values;
+        int64_t keyframe_interval;
+        int64_t num_records;
+        int64_t num_keyframes;
+        double time_step;
+    };
+
+    /// Appends fixed-stride records of mjData to a growable memory-mapped log (plus keyframes sidecar)
+    ///
+    /// Recording a step is a few memcpys into the mapping (the file grows geometrically, remapping only
+    /// when full). Dirty pages are written back by a background thread every flush-interval, so the
+    /// simulation thread never waits for the disk.
+    class TMujocoTrajectoryRecorder
+    {
+    public :
+
+        TMujocoTrajectoryRecorder();
+
+        TMujocoTrajectoryRecorder( const TMujocoTrajectoryRecorder& other ) = delete;
+
+        TMujocoTrajectoryRecorder& operator=( const TMujocoTrajectoryRecorder& other ) = delete;
+
+        ~TMujocoTrajectoryRecorder();
+
+        bool Open( const std::string& filepath, const mjModel* mjc_model,
+                   ssize_t keyframe_interval = 100, ssize_t flush_interval_ms = 200 );
+
+        void Record( const mjModel* mjc_model, const mjData* mjc_data );
+
+        // Forces the next record to be a keyframe (call whenever the state jumps, e.g. on resets)
+        void MarkDiscontinuity() { m_ForceKeyframe = true; }
+
+        void Close();
+
+        bool is_open() const { return m_Data != nullptr; }
+
+        ssize_t num_records() const { return m_NumRecords; }
+
+        ssize_t num_keyframes() const { return m_NumKeyframes; }
+
+        const std::string& filepath() const { return m_Filepath; }
+
+    private :
+
+        bool _Grow( size_t min_size );
+
+        void _FlushLoop();
+
+        TMujocoTrajectoryHeader* _Header() { return reinterpret_cast<TMujocoTrajectoryHeader*>( m_Data ); }
+
+    private :
+
+        // Path of the log file (keyframes go into the sidecar file with the same path plus extension)
+        std::string m_Filepath;
+        // File descriptor of the log file
+        int m_Fd;
+        // Mapping of the log file (header + records)
+        uint8_t* m_Data;
+        // Size of the mapping (file size while recording, grows geometrically)
+        size_t m_MappedSize;
+        // Size of the header (aligned to 64 bytes, records start right after it)
+        size_t m_HeaderSize;
+        // Size of a single record (in bytes)
+        size_t m_RecordStride;
+        // Number of records (and keyframes) written so far
+        ssize_t m_NumRecords;
+        ssize_t m_NumKeyframes;
+        // Number of records in between keyframes
+        ssize_t m_KeyframeInterval;
+        // Record-id of the last keyframe taken
+        ssize_t m_LastKeyframeRecordId;
+        // Whether or not the next record must be a keyframe (the state jumped since the last record)
+        bool m_ForceKeyframe;
+        // Sidecar file where keyframes are appended
+        FILE* m_KeyframesFile;
+        // Scratch image used to capture keyframes
+        TMujocoStateImage m_KeyframeImage;
+        // Background flushing of dirty pages (and synchronization with remapping)
+        std::thread m_FlushThread;
+        std::mutex m_FlushMutex;
+        std::condition_variable m_FlushCondVar;
+        ssize_t m_FlushIntervalMs;
+        bool m_StopFlush;
+    };
+
+    /// Read-only access to a trajectory log written by TMujocoTrajectoryRecorder
+    class TMujocoTrajectoryReader
+    {
+    public :
+
+        TMujocoTrajectoryReader();
+
+        TMujocoTrajectoryReader( const TMujocoTrajectoryReader& other ) = delete;
+
+        TMujocoTrajectoryReader& operator=( const TMujocoTrajectoryReader& other ) = delete;
+
+        ~TMujocoTrajectoryReader();
+
+        bool Open( const std::string& filepath );
+
+        void Close();
+
+        // Recovers the exact state at a record, from the nearest keyframe before it plus replay of controls
+        bool RestoreState( const mjModel* mjc_model, mjData* mjc_data, ssize_t record_id ) const;
+
+        mjtNum record_time( ssize_t record_id ) const { return _Record( record_id )[0]; }
+
+        const mjtNum* record_qpos( ssize_t record_id ) const { return _Record( record_id ) + 1; }
+
+        const mjtNum* record_qvel( ssize_t record_id ) const { return record_qpos( record_id ) + m_Header->nq; }
+
+        const mjtNum* record_ctrl( ssize_t record_id ) const { return record_qvel( record_id ) + m_Header->nv; }
+
+        const mjtNum* record_xfrc_applied( ssize_t record_id ) const { return record_ctrl( record_id ) + m_Header->nu; }
+
+        const TMujocoTrajectoryHeader* header() const { return m_Header; }
+
+        // Whether or not the given model has the same state layout as the recorded one
+        bool matches_model( const mjModel* mjc_model ) const;
+
+        ssize_t num_records() const { return m_Header ? m_Header->num_records : 0; }
+
+        ssize_t num_keyframes() const { return m_NumKeyframes; }
+
+        bool is_open() const { return m_Header != nullptr; }
+
+    private :
+
+        const mjtNum* _Record( ssize_t record_id ) const;
+
+        const mjtNum* _Keyframe( ssize_t keyframe_id ) const;
+
+        ssize_t _FindKeyframe( ssize_t record_id ) const;
+
+    private :
+
+        // Mapping of the log file
+        void* m_Data;
+        size_t m_DataSize;
+        const TMujocoTrajectoryHeader* m_Header;
+        // Mapping of the keyframes sidecar file
+        void* m_KeyframesData;
+        size_t m_KeyframesDataSize;
+        ssize_t m_NumKeyframes;
+    };
+}}
+
+#endif /* __linux__ || __APPLE__ */
\ No newline at end of file
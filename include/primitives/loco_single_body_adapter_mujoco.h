@@ -14,7 +14,7 @@ namespace primitives {
 namespace loco {
 namespace primitives {
 
-    // Where the detached objects rest-grid starts
+    // Where the rest-grid for detached (parked) objects starts
     const TVec3 DETACHED_REST_GRID_START = { 0.0, 0.0, 100.0 };
     // The amount in x-y-z in between elements in the rest-grid
     const TVec3 DETACHED_REST_GRID_DELTA = { 1.0, 1.0, 1.0 };
@@ -40,8 +40,6 @@ namespace primitives {
 
         void Reset() override;
 
-        void OnDetach() override;
-
         void SetTransform( const TMat4& transform ) override;
 
         void SetLinearVelocity( const TVec3& linear_vel ) override;
@@ -62,7 +60,27 @@ namespace primitives {
 
         void SetMjcData( mjData* mjDataRef );
 
-        void HideMjcObject();
+        void SetMjcNameIndex( const mujoco::TMujocoNameIndex* mjcNameIndexRef );
+
+        // Model writes of this adapter (and of its collider and constraint) go through the simulation
+        void SetMjcModelUniqueFn( const mujoco::FnMjcModelUnique& mjc_model_unique_fn );
+
+        void UpdateContacts( const mujoco::TMujocoContactBuffer& contactBuffer );
+
+        void SetBulkResetEnabled( bool enabled ) { m_mjcBulkResetEnabled = enabled; }
+
+        void ResetInitialConditions();
+
+        void ApplyResetOverrides();
+
+        // Placement static bodies go back to on resets, instead of their initial one (e.g. recycled terrain tiles)
+        void SetStaticResetPlacement( const TVec3& position, const TVec4& quaternion );
+
+        // Links to an existing (free) mjc-body and geom, e.g. a parked slot, writing this body's size, mass and pose into them
+        void InitializeFromMjcIds( ssize_t mjc_body_id, ssize_t mjc_geom_id );
+
+        // Links to the same mjc-objects as an adapter of an identical body (e.g. when cloning), reusing its cached ids
+        void InitializeFromAdapter( const TMujocoSingleBodyAdapter& other );
 
         parsing::TElement* element_resources() { return m_mjcfElementResources.get(); }
 
@@ -72,6 +90,8 @@ namespace primitives {
 
         const parsing::TElement* element_asset_resources() const { return m_mjcfElementAssetResources.get(); }
 
+        const mujoco::TMjcVfsFile* vfs_mesh_resource() const;
+
         mjModel* mjc_model() { return m_mjcModelRef; }
 
         const mjModel* mjc_model() const { return m_mjcModelRef; }
@@ -84,6 +104,8 @@ namespace primitives {
 
         ssize_t mjc_joint_id() const { return m_mjcJointId; }
 
+        ssize_t mjc_geom_id() const;
+
         ssize_t mjc_joint_qpos_num() const { return m_mjcJointQposNum; }
 
         ssize_t mjc_joint_qvel_num() const { return m_mjcJointQvelNum; }
@@ -92,10 +114,27 @@ namespace primitives {
 
         ssize_t mjc_joint_qvel_adr() const { return m_mjcJointQvelAdr; }
 
+    private :
+
+        std::array<TScalar, 13> _InitialConditionsSignature() const;
+
+        void _InitializeFreeJoint();
+
+        void _SetMjcMassProperties();
+
+        void _GetStaticResetPlacement( TVec3& dst_position, TVec4& dst_quaternion ) const;
+
+        // Writes the placement of a static body into its mjc-body (static meshes) or mjc-geom, if it changed
+        void _SetMjcStaticPlacement( bool through_body, const TVec3& position, const TVec4& quaternion );
+
+        mjModel* _MjcModelUnique();
+
     private :
 
         mjModel* m_mjcModelRef;
         mjData* m_mjcDataRef;
+        const mujoco::TMujocoNameIndex* m_mjcNameIndexRef;
+        mujoco::FnMjcModelUnique m_mjcModelUniqueFn;
 
         ssize_t m_mjcBodyId;
         ssize_t m_mjcJointId;
@@ -103,12 +142,18 @@ namespace primitives {
         ssize_t m_mjcJointQvelAdr;
         ssize_t m_mjcJointQposNum;
         ssize_t m_mjcJointQvelNum;
+        // Placement of static bodies on resets, if overriding their initial one
+        bool m_mjcHasStaticResetPlacement;
+        TVec3 m_mjcStaticResetPosition;
+        TVec4 m_mjcStaticResetQuaternion;
         ssize_t m_mjcGeomId;
 
+        // Whether or not dynamic state is reset in bulk by the simulation (initial-state image + overrides)
+        bool m_mjcBulkResetEnabled;
+        // Initial conditions (pos0, quat0, linear_vel0, angular_vel0) last written on reset
+        std::array<TScalar, 13> m_mjcResetSignature;
+
         std::unique_ptr<parsing::TElement> m_mjcfElementResources;
         std::unique_ptr<parsing::TElement> m_mjcfElementAssetResources;
-
-        TMat4 m_DetachedRestTransform;
-        static ssize_t s_DetachedNum;
     };
 }}
\ No newline at end of file
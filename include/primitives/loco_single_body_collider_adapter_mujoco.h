@@ -1,6 +1,7 @@
 #pragma once
 
 #include <loco_common_mujoco.h>
+#include <loco_contact_buffer_mujoco.h>
 #include <utils/loco_parsing_element.h>
 #include <primitives/loco_single_body_collider_adapter.h>
 
@@ -13,6 +14,12 @@ namespace loco {
 namespace primitives {
 
     const float LOCO_MUJOCO_HFIELD_BASE = 1.0f;
+    // Side (in samples) of the square blocks of the heightfield whose max-heights are tracked (for region updates)
+    const ssize_t LOCO_MUJOCO_HFIELD_BLOCK_SIZE = 32;
+    // Headroom given to the normalization height when a region update requires it to change
+    const float LOCO_MUJOCO_HFIELD_NORM_HEADROOM = 1.25f;
+    // Region updates shrink the normalization height only once the max-height drops below this fraction of it
+    const float LOCO_MUJOCO_HFIELD_NORM_SHRINK_RATIO = 0.5f;
 
     class TMujocoSingleBodyColliderAdapter : public TISingleBodyColliderAdapter
     {
@@ -30,30 +37,65 @@ namespace primitives {
 
         void Initialize() override;
 
+        // Links to an existing primitive mjc-geom (e.g. of a parked slot), writing this collider's properties into it
+        void InitializeFromMjcGeom( ssize_t mjc_geom_id );
+
         void ChangeSize( const TVec3& newSize ) override;
 
         void ChangeVertexData( const std::vector<float>& vertices, const std::vector<int>& faces ) override;
 
+        // Uploads contiguous vertex|face buffers (xyz-interleaved, triangles) into the space compiled for this mesh
+        bool ChangeVertexData( const float* vertices, ssize_t num_vertices, const int* faces, ssize_t num_faces );
+
+        // Uploads the meshes of many colliders at once, given as contiguous buffers (one slice per collider, in order)
+        static bool ChangeVertexDataBatch( const std::vector<TMujocoSingleBodyColliderAdapter*>& colliders_adapters,
+                                           const std::vector<float>& vertices,
+                                           const std::vector<int>& faces,
+                                           const std::vector<ssize_t>& num_vertices_per_mesh,
+                                           const std::vector<ssize_t>& num_faces_per_mesh );
+
         void ChangeElevationData( const std::vector<float>& heights ) override;
 
+        // Updates a rectangular region of the heightfield (heights given row-major, of size region_nrows x region_ncols)
+        void ChangeElevationDataRegion( ssize_t row_start, ssize_t col_start,
+                                        ssize_t region_nrows, ssize_t region_ncols,
+                                        const std::vector<float>& heights );
+
         void ChangeCollisionGroup( int collisionGroup ) override;
 
         void ChangeCollisionMask( int collisionMask ) override;
 
         void ChangeFriction( const TScalar& friction ) override;
 
+        // Links to the same mjc-geom as an adapter of an identical collider (e.g. when cloning), reusing its cached ids
+        void InitializeFromAdapter( const TMujocoSingleBodyColliderAdapter& other );
+
         void SetMjcModel( mjModel* mjModelRef ) { m_mjcModelRef = mjModelRef; }
 
         void SetMjcData( mjData* mjDataRef ) { m_mjcDataRef = mjDataRef; }
 
+        void SetMjcNameIndex( const mujoco::TMujocoNameIndex* mjcNameIndexRef ) { m_mjcNameIndexRef = mjcNameIndexRef; }
+
+        void SetMjcModelUniqueFn( const mujoco::FnMjcModelUnique& mjc_model_unique_fn ) { m_mjcModelUniqueFn = mjc_model_unique_fn; }
+
+        void UpdateContacts( const mujoco::TMujocoContactBuffer& contactBuffer );
+
         std::vector<const parsing::TElement*> elements_resources() const;
 
         const parsing::TElement* element_asset_resources() const { return m_mjcfElementAssetResources.get(); }
 
+        const mujoco::TMjcVfsFile* vfs_mesh_resource() const { return m_mjcVfsMeshResource.get(); }
+
+        const mujoco::TMujocoContactsView& mjc_contacts() const { return m_mjcContacts; }
+
         ssize_t mjc_geom_id() const { return m_mjcGeomId; }
 
         ssize_t mjc_geom_mesh_id() const { return m_mjcGeomMeshId; }
 
+        ssize_t mjc_geom_mesh_vert_capacity() const { return m_mjcGeomMeshVertCapacity; }
+
+        ssize_t mjc_geom_mesh_face_capacity() const { return m_mjcGeomMeshFaceCapacity; }
+
         ssize_t mjc_geom_hfield_id() const { return m_mjcGeomHFieldId; }
 
         ssize_t mjc_geom_hfield_start_addr() const { return m_mjcGeomHFieldStartAddr; }
@@ -64,6 +106,8 @@ namespace primitives {
 
         double mjc_geom_radius_bound() const { return m_mjcGeomRbound; }
 
+        float mjc_hfield_norm_height() const { return m_mjcHFieldNormHeight; }
+
     private :
 
         void _resize_mesh( const TVec3& new_size );
@@ -72,10 +116,22 @@ namespace primitives {
 
         void _resize_primitive( const TVec3& new_size );
 
+        bool _upload_vertex_data( const float* vertices, ssize_t num_vertices, const int* faces, ssize_t num_faces );
+
+        void _update_hfield_blocks_max( ssize_t row_start, ssize_t col_start, ssize_t region_nrows, ssize_t region_ncols );
+
+        void _normalize_hfield_region( ssize_t row_start, ssize_t col_start, ssize_t region_nrows, ssize_t region_ncols );
+
+        void _update_hfield_rbound();
+
+        mjModel* _mjc_model_unique();
+
     private :
 
         mjModel* m_mjcModelRef;
         mjData* m_mjcDataRef;
+        const mujoco::TMujocoNameIndex* m_mjcNameIndexRef;
+        mujoco::FnMjcModelUnique m_mjcModelUniqueFn;
 
         ssize_t m_mjcGeomId;
         ssize_t m_mjcGeomMeshId;
@@ -83,17 +139,36 @@ namespace primitives {
         ssize_t m_mjcGeomMeshFaceNum;
         ssize_t m_mjcGeomMeshVertStartAddr;
         ssize_t m_mjcGeomMeshFaceStartAddr;
+        // Number of vertices|faces compiled for the mesh (its slice of mesh_vert|mesh_face can't grow beyond these)
+        ssize_t m_mjcGeomMeshVertCapacity;
+        ssize_t m_mjcGeomMeshFaceCapacity;
         ssize_t m_mjcGeomHFieldId;
         ssize_t m_mjcGeomHFieldStartAddr;
         ssize_t m_mjcGeomHFieldNRows;
         ssize_t m_mjcGeomHFieldNCols;
         double m_mjcGeomRbound;
 
+        // Height used to normalize the samples into hfield_data (at least the max-height, see region updates)
+        float m_mjcHFieldNormHeight;
+        // Max-height of each block of samples (blocks of LOCO_MUJOCO_HFIELD_BLOCK_SIZE, row-major)
+        std::vector<float> m_mjcHFieldBlocksMax;
+        ssize_t m_mjcHFieldNBlockRows;
+        ssize_t m_mjcHFieldNBlockCols;
+
         TVec3 m_size;
         TVec3 m_size0;
 
         std::vector<std::unique_ptr<parsing::TElement>> m_mjcfElementsResources;
 
         std::unique_ptr<parsing::TElement> m_mjcfElementAssetResources;
+
+        // In-memory binary mesh (user-defined vertices|faces), registered into the vfs on compilation
+        std::unique_ptr<mujoco::TMjcVfsFile> m_mjcVfsMeshResource;
+
+        // Key of the mesh-cache entry to be stored once the model is compiled (empty if the hull was already cached)
+        std::string m_mjcMeshCachePendingKey;
+
+        // View over this collider's contacts (into the simulation's contact-buffer, valid until next step)
+        mujoco::TMujocoContactsView m_mjcContacts;
     };
 }}
\ No newline at end of file
@@ -24,6 +24,10 @@ namespace primitives {
 
         void SetMjcData( mjData* mjc_data_ref ) { m_MjcDataRef = mjc_data_ref; }
 
+        void SetMjcNameIndex( const mujoco::TMujocoNameIndex* mjc_name_index_ref ) { m_MjcNameIndexRef = mjc_name_index_ref; }
+
+        void SetMjcModelUniqueFn( const mujoco::FnMjcModelUnique& mjc_model_unique_fn ) { m_MjcModelUniqueFn = mjc_model_unique_fn; }
+
         mjModel* mjc_model() { return m_MjcModelRef; }
 
         const mjModel* mjc_model() const { return m_MjcModelRef; }
@@ -40,10 +44,16 @@ namespace primitives {
 
         ssize_t mjc_joint_qvel_num() const { return m_MjcJointQvelNum; }
 
+    protected :
+
+        mjModel* _MjcModelUnique();
+
     protected :
 
         mjModel* m_MjcModelRef;
         mjData* m_MjcDataRef;
+        const mujoco::TMujocoNameIndex* m_MjcNameIndexRef;
+        mujoco::FnMjcModelUnique m_MjcModelUniqueFn;
 
         ssize_t m_MjcJointQposNum;
         ssize_t m_MjcJointQvelNum;
@@ -11,6 +11,7 @@ namespace kintree {
     {
         m_MjcModelRef = nullptr;
         m_MjcDataRef = nullptr;
+        m_MjcNameIndexRef = nullptr;
         m_MjcRootBodyId = -1;
         m_MjcfElementResources = nullptr;
         m_MjcfElementAssetsResources = nullptr;
@@ -82,7 +83,69 @@ namespace kintree {
             LOCO_CORE_ERROR( "TMujocoKinematicTreeAdapter::Initialize >>> kintree {0} doesn't have a root-body", m_KintreeRef->name() );
             return;
         }
-        m_MjcRootBodyId = mj_name2id( m_MjcModelRef, mjOBJ_BODY, root_body->name().c_str() );
+        m_MjcRootBodyId = mujoco::mjc_name2id( m_MjcModelRef, m_MjcNameIndexRef, mjOBJ_BODY, root_body->name() );
+        if ( auto root_joint = root_body->joint() )
+            _CacheRootJointAddresses( root_joint );
+    }
+
+    void TMujocoKinematicTreeAdapter::InitializeBodies()
+    {
+        for ( auto& body_adapter : m_BodyAdapters )
+            body_adapter->Initialize();
+    }
+
+    bool TMujocoKinematicTreeAdapter::InitializeFromAdapter( const TMujocoKinematicTreeAdapter& other )
+    {
+        LOCO_CORE_ASSERT( m_MjcModelRef, "TMujocoKinematicTreeAdapter::InitializeFromAdapter >>> must have a valid mjModel "
+                          "reference, but got nullptr. Error found while processing kintree {0}", m_KintreeRef->name() );
+        LOCO_CORE_ASSERT( m_MjcDataRef, "TMujocoKinematicTreeAdapter::InitializeFromAdapter >>> must have a valid mjData "
+                          "reference, but got nullptr. Error found while processing kintree {0}", m_KintreeRef->name() );
+        // Body-adapters are created in the same (dfs) order on Build, so identical kintrees have them paired by index
+        if ( m_BodyAdapters.size() != other.m_BodyAdapters.size() )
+        {
+            LOCO_CORE_ERROR( "TMujocoKinematicTreeAdapter::InitializeFromAdapter >>> kintree {0} has {1} bodies, but the "
+                             "adapter to link from has {2}", m_KintreeRef->name(), m_BodyAdapters.size(), other.m_BodyAdapters.size() );
+            return false;
+        }
+
+        m_MjcRootBodyId = other.m_MjcRootBodyId;
+        m_MjcRootJointQposAdr = other.m_MjcRootJointQposAdr;
+        m_MjcRootJointQvelAdr = other.m_MjcRootJointQvelAdr;
+        m_ResetSignature = other.m_ResetSignature;
+        for ( size_t i = 0; i < m_BodyAdapters.size(); i++ )
+        {
+            auto mjc_body_adapter = dynamic_cast<TMujocoKinematicTreeBodyAdapter*>( m_BodyAdapters[i].get() );
+            auto other_mjc_body_adapter = dynamic_cast<const TMujocoKinematicTreeBodyAdapter*>( other.m_BodyAdapters[i].get() );
+            if ( mjc_body_adapter && other_mjc_body_adapter )
+                mjc_body_adapter->InitializeFromAdapter( *other_mjc_body_adapter );
+        }
+        return true;
+    }
+
+    void TMujocoKinematicTreeAdapter::_CacheRootJointAddresses( TKinematicTreeJoint* root_joint )
+    {
+        m_MjcRootJointQposAdr = { -1, -1, -1 };
+        m_MjcRootJointQvelAdr = { -1, -1, -1 };
+
+        std::vector<std::string> root_joint_names;
+        const eJointType root_joint_type = root_joint->type();
+        /**/ if ( root_joint_type == eJointType::FREE )
+            root_joint_names = { root_joint->name() };
+        else if ( root_joint_type == eJointType::PLANAR )
+            root_joint_names = { root_joint->name() + "_trans_1", root_joint->name() + "_trans_2", root_joint->name() + "_rot" };
+
+        for ( size_t i = 0; i < root_joint_names.size(); i++ )
+        {
+            const ssize_t jnt_id = mujoco::mjc_name2id( m_MjcModelRef, m_MjcNameIndexRef, mjOBJ_JOINT, root_joint_names[i] );
+            if ( jnt_id < 0 )
+            {
+                LOCO_CORE_ERROR( "TMujocoKinematicTreeAdapter::_CacheRootJointAddresses >>> couldn't find mjc-joint {0} "
+                                 "for the root-joint of kintree {1}", root_joint_names[i], m_KintreeRef->name() );
+                continue;
+            }
+            m_MjcRootJointQposAdr[i] = m_MjcModelRef->jnt_qposadr[jnt_id];
+            m_MjcRootJointQvelAdr[i] = m_MjcModelRef->jnt_dofadr[jnt_id];
+        }
     }
 
     void TMujocoKinematicTreeAdapter::Reset()
@@ -91,6 +154,54 @@ namespace kintree {
                           "reference, but got nullptr. Error found while processing kintree {0}", m_KintreeRef->name() );
         LOCO_CORE_ASSERT( m_MjcDataRef, "TMujocoKinematicTreeAdapter::Reset >>> must have a valid mjData "
                           "reference, but got nullptr. Error found while processing kintree {0}", m_KintreeRef->name() );
+        // On bulk-resets the simulation restores the initial-state image, and then applies overrides (if any)
+        if ( m_BulkResetEnabled )
+            return;
+
+        _ResetRootToInitialConditions();
+    }
+
+    void TMujocoKinematicTreeAdapter::SetBulkResetEnabled( bool enabled )
+    {
+        m_BulkResetEnabled = enabled;
+        for ( auto& body_adapter : m_BodyAdapters )
+            if ( auto mjc_body_adapter = dynamic_cast<TMujocoKinematicTreeBodyAdapter*>( body_adapter.get() ) )
+                mjc_body_adapter->SetBulkResetEnabled( enabled );
+    }
+
+    void TMujocoKinematicTreeAdapter::ResetInitialConditions()
+    {
+        _ResetRootToInitialConditions();
+        for ( auto& body_adapter : m_BodyAdapters )
+            if ( auto mjc_body_adapter = dynamic_cast<TMujocoKinematicTreeBodyAdapter*>( body_adapter.get() ) )
+                mjc_body_adapter->ResetInitialConditions();
+    }
+
+    void TMujocoKinematicTreeAdapter::ApplyResetOverrides()
+    {
+        // Fixed-roots are placed through the model (not part of the state-image), so these are always written
+        auto root_body = m_KintreeRef->root();
+        const bool is_fixed_root = ( root_body && root_body->joint() && root_body->joint()->type() == eJointType::FIXED );
+        if ( is_fixed_root || _InitialConditionsSignature() != m_ResetSignature )
+            _ResetRootToInitialConditions();
+        for ( auto& body_adapter : m_BodyAdapters )
+            if ( auto mjc_body_adapter = dynamic_cast<TMujocoKinematicTreeBodyAdapter*>( body_adapter.get() ) )
+                mjc_body_adapter->ApplyResetOverrides();
+    }
+
+    std::array<TScalar, 13> TMujocoKinematicTreeAdapter::_InitialConditionsSignature() const
+    {
+        const TVec3 pos0 = m_KintreeRef->pos0();
+        const TVec4 quat0 = m_KintreeRef->quat0();
+        const TVec3 linear_vel0 = m_KintreeRef->linear_vel0();
+        const TVec3 angular_vel0 = m_KintreeRef->angular_vel0();
+        return { pos0.x(), pos0.y(), pos0.z(), quat0.x(), quat0.y(), quat0.z(), quat0.w(),
+                 linear_vel0.x(), linear_vel0.y(), linear_vel0.z(), angular_vel0.x(), angular_vel0.y(), angular_vel0.z() };
+    }
+
+    void TMujocoKinematicTreeAdapter::_ResetRootToInitialConditions()
+    {
+        m_ResetSignature = _InitialConditionsSignature();
         // Grab the root joint and reset accordingly to its type
         auto root_body = m_KintreeRef->root();
         if ( !root_body )
@@ -274,6 +385,43 @@ namespace kintree {
                 mjc_body_adapter->SetMjcData( mj_data_ref );
     }
 
+    void TMujocoKinematicTreeAdapter::SetMjcNameIndex( const mujoco::TMujocoNameIndex* mjc_name_index_ref )
+    {
+        m_MjcNameIndexRef = mjc_name_index_ref;
+        for ( auto& body_adapter : m_BodyAdapters )
+            if ( auto mjc_body_adapter = dynamic_cast<TMujocoKinematicTreeBodyAdapter*>( body_adapter.get() ) )
+                mjc_body_adapter->SetMjcNameIndex( mjc_name_index_ref );
+    }
+
+    void TMujocoKinematicTreeAdapter::SetMjcModelUniqueFn( const mujoco::FnMjcModelUnique& mjc_model_unique_fn )
+    {
+        m_MjcModelUniqueFn = mjc_model_unique_fn;
+        for ( auto& body_adapter : m_BodyAdapters )
+            if ( auto mjc_body_adapter = dynamic_cast<TMujocoKinematicTreeBodyAdapter*>( body_adapter.get() ) )
+                mjc_body_adapter->SetMjcModelUniqueFn( mjc_model_unique_fn );
+    }
+
+    void TMujocoKinematicTreeAdapter::UpdateContacts( const mujoco::TMujocoContactBuffer& contact_buffer )
+    {
+        for ( auto& body_adapter : m_BodyAdapters )
+            if ( auto mjc_body_adapter = dynamic_cast<TMujocoKinematicTreeBodyAdapter*>( body_adapter.get() ) )
+                mjc_body_adapter->UpdateContacts( contact_buffer );
+    }
+
+    std::vector<const mujoco::TMjcVfsFile*> TMujocoKinematicTreeAdapter::vfs_resources() const
+    {
+        std::vector<const mujoco::TMjcVfsFile*> vec_vfs_resources;
+        for ( auto& body_adapter : m_BodyAdapters )
+        {
+            auto mjc_body_adapter = dynamic_cast<const TMujocoKinematicTreeBodyAdapter*>( body_adapter.get() );
+            if ( !mjc_body_adapter )
+                continue;
+            if ( auto vfs_mesh_resource = mjc_body_adapter->vfs_mesh_resource() )
+                vec_vfs_resources.push_back( vfs_mesh_resource );
+        }
+        return vec_vfs_resources;
+    }
+
     void TMujocoKinematicTreeAdapter::_SetTransformFreeJoint( TKinematicTreeJoint* joint_ref, const TMat4& tf )
     {
         const auto world_pos = TVec3( tf.col( 3 ) );
@@ -284,8 +432,9 @@ namespace kintree {
 
     void TMujocoKinematicTreeAdapter::_SetLinearVelFreeJoint( TKinematicTreeJoint* joint_ref, const TVec3& linear_vel )
     {
-        const ssize_t free_jnt_id = mj_name2id( m_MjcModelRef, mjOBJ_JOINT, joint_ref->name().c_str() );
-        const ssize_t free_jnt_qveladr = m_MjcModelRef->jnt_dofadr[free_jnt_id];
+        const ssize_t free_jnt_qveladr = m_MjcRootJointQvelAdr[0];
+        if ( free_jnt_qveladr < 0 )
+            return;
         /* @todo: set qvel as well, as there might be a mismatch of one update step between stored qvel and internal-backend qvels */
         m_MjcDataRef->qvel[free_jnt_qveladr + 0] = linear_vel.x();
         m_MjcDataRef->qvel[free_jnt_qveladr + 1] = linear_vel.y();
@@ -294,8 +443,9 @@ namespace kintree {
 
     void TMujocoKinematicTreeAdapter::_SetAngularVelFreeJoint( TKinematicTreeJoint* joint_ref, const TVec3& angular_vel )
     {
-        const ssize_t free_jnt_id = mj_name2id( m_MjcModelRef, mjOBJ_JOINT, joint_ref->name().c_str() );
-        const ssize_t free_jnt_qveladr = m_MjcModelRef->jnt_dofadr[free_jnt_id];
+        const ssize_t free_jnt_qveladr = m_MjcRootJointQvelAdr[0];
+        if ( free_jnt_qveladr < 0 )
+            return;
         /* @todo: set qvel as well, as there might be a mismatch of one update step between stored qvel and internal-backend qvels */
         m_MjcDataRef->qvel[free_jnt_qveladr + 3] = angular_vel.x();
         m_MjcDataRef->qvel[free_jnt_qveladr + 4] = angular_vel.y();
@@ -304,13 +454,11 @@ namespace kintree {
 
     void TMujocoKinematicTreeAdapter::_SetTransformPlanarJoint( TKinematicTreeJoint* joint_ref, const TMat4& tf )
     {
-        const ssize_t pj_trans_1_id = mj_name2id( m_MjcModelRef, mjOBJ_JOINT, ( joint_ref->name() + "_trans_1" ).c_str() );
-        const ssize_t pj_trans_2_id = mj_name2id( m_MjcModelRef, mjOBJ_JOINT, ( joint_ref->name() + "_trans_2" ).c_str() );
-        const ssize_t pj_rot_id = mj_name2id( m_MjcModelRef, mjOBJ_JOINT, ( joint_ref->name() + "_rot" ).c_str() );
-
-        const ssize_t pj_trans_1_qposadr = m_MjcModelRef->jnt_qposadr[pj_trans_1_id];
-        const ssize_t pj_trans_2_qposadr = m_MjcModelRef->jnt_qposadr[pj_trans_2_id];
-        const ssize_t pj_rot_qposadr = m_MjcModelRef->jnt_qposadr[pj_rot_id];
+        const ssize_t pj_trans_1_qposadr = m_MjcRootJointQposAdr[0];
+        const ssize_t pj_trans_2_qposadr = m_MjcRootJointQposAdr[1];
+        const ssize_t pj_rot_qposadr = m_MjcRootJointQposAdr[2];
+        if ( pj_trans_1_qposadr < 0 || pj_trans_2_qposadr < 0 || pj_rot_qposadr < 0 )
+            return;
 
         const auto vec_trans_1 = joint_ref->data().plane_axis_1.normalized();
         const auto vec_trans_2 = joint_ref->data().plane_axis_2.normalized();
@@ -324,10 +472,10 @@ namespace kintree {
 
     void TMujocoKinematicTreeAdapter::_SetLinearVelPlanarJoint( TKinematicTreeJoint* joint_ref, const TVec3& linear_vel )
     {
-            const ssize_t pj_trans_1_id = mj_name2id( m_MjcModelRef, mjOBJ_JOINT, ( joint_ref->name() + "_trans_1" ).c_str() );
-            const ssize_t pj_trans_2_id = mj_name2id( m_MjcModelRef, mjOBJ_JOINT, ( joint_ref->name() + "_trans_2" ).c_str() );
-            const ssize_t pj_trans_1_qveladr = m_MjcModelRef->jnt_dofadr[pj_trans_1_id];
-            const ssize_t pj_trans_2_qveladr = m_MjcModelRef->jnt_dofadr[pj_trans_2_id];
+            const ssize_t pj_trans_1_qveladr = m_MjcRootJointQvelAdr[0];
+            const ssize_t pj_trans_2_qveladr = m_MjcRootJointQvelAdr[1];
+            if ( pj_trans_1_qveladr < 0 || pj_trans_2_qveladr < 0 )
+                return;
 
             const auto vec_trans_1 = joint_ref->data().plane_axis_1.normalized();
             const auto vec_trans_2 = joint_ref->data().plane_axis_2.normalized();
@@ -339,8 +487,9 @@ namespace kintree {
 
     void TMujocoKinematicTreeAdapter::_SetAngularVelPlanarJoint( TKinematicTreeJoint* joint_ref, const TVec3& angular_vel )
     {
-        const ssize_t pj_rot_id = mj_name2id( m_MjcModelRef, mjOBJ_JOINT, ( joint_ref->name() + "_rot" ).c_str() );
-        const ssize_t pj_rot_qveladr = m_MjcModelRef->jnt_dofadr[pj_rot_id];
+        const ssize_t pj_rot_qveladr = m_MjcRootJointQvelAdr[2];
+        if ( pj_rot_qveladr < 0 )
+            return;
 
         const auto vec_trans_1 = joint_ref->data().plane_axis_1;
         const auto vec_trans_2 = joint_ref->data().plane_axis_2;
@@ -351,15 +500,28 @@ namespace kintree {
 
     void TMujocoKinematicTreeAdapter::_SetTransformFixedJoint( TKinematicTreeBody* body_ref, const TMat4& tf )
     {
-        const ssize_t fj_rootbody_id = mj_name2id( m_MjcModelRef, mjOBJ_BODY, body_ref->name().c_str() );
+        const ssize_t fj_rootbody_id = m_MjcRootBodyId;
+        if ( fj_rootbody_id < 0 )
+            return;
         const auto world_pos = TVec3( tf.col( 3 ) );
         const auto world_quat = tinymath::quaternion( tf );
-        m_MjcModelRef->body_pos[3 * fj_rootbody_id + 0] = world_pos.x();
-        m_MjcModelRef->body_pos[3 * fj_rootbody_id + 1] = world_pos.y();
-        m_MjcModelRef->body_pos[3 * fj_rootbody_id + 2] = world_pos.z();
-        m_MjcModelRef->body_quat[4 * fj_rootbody_id + 0] = world_quat.w();
-        m_MjcModelRef->body_quat[4 * fj_rootbody_id + 1] = world_quat.x();
-        m_MjcModelRef->body_quat[4 * fj_rootbody_id + 2] = world_quat.y();
-        m_MjcModelRef->body_quat[4 * fj_rootbody_id + 3] = world_quat.z();
+        const mjtNum placement[7] = { world_pos.x(), world_pos.y(), world_pos.z(),
+                                      world_quat.w(), world_quat.x(), world_quat.y(), world_quat.z() };
+        // Resets place fixed roots on every call, mostly where they already are (no need to copy a shared model then)
+        if ( std::equal( placement, placement + 3, m_MjcModelRef->body_pos + 3 * fj_rootbody_id ) &&
+             std::equal( placement + 3, placement + 7, m_MjcModelRef->body_quat + 4 * fj_rootbody_id ) )
+            return;
+
+        mjModel* mjc_model = _MjcModelUnique();
+        mju_copy( mjc_model->body_pos + 3 * fj_rootbody_id, placement, 3 );
+        mju_copy( mjc_model->body_quat + 4 * fj_rootbody_id, placement + 3, 4 );
+    }
+
+    mjModel* TMujocoKinematicTreeAdapter::_MjcModelUnique()
+    {
+        // Copies the model first if shared with clones (the simulation then rebinds m_MjcModelRef to the copy)
+        if ( m_MjcModelUniqueFn )
+            return m_MjcModelUniqueFn();
+        return m_MjcModelRef;
     }
 }}
\ No newline at end of file
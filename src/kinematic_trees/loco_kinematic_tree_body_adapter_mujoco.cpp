@@ -12,6 +12,7 @@ namespace kintree {
         m_MjcBodyId = -1;
         m_MjcModelRef = nullptr;
         m_MjcDataRef = nullptr;
+        m_MjcNameIndexRef = nullptr;
         m_MjcfElementResources = nullptr;
         m_MjcfElementAssetsResources = nullptr;
     }
@@ -97,7 +98,7 @@ namespace kintree {
         LOCO_CORE_ASSERT( m_MjcModelRef, "TMujocoKinematicTreeBodyAdapter::Initialize >>> must have a valid mjModel reference (got nullptr)" );
         LOCO_CORE_ASSERT( m_MjcDataRef, "TMujocoKinematicTreeBodyAdapter::Initialize >>> must have a valid mjData reference (got nullptr)" );
 
-        if ( auto mjc_collider_adapter = dynamic_cast<TMujocoKinematicTreeJointAdapter*>( m_ColliderAdapter.get() ) )
+        if ( auto mjc_collider_adapter = dynamic_cast<TMujocoKinematicTreeColliderAdapter*>( m_ColliderAdapter.get() ) )
             mjc_collider_adapter->Initialize();
 
         if ( auto mjc_joint_adapter = dynamic_cast<TMujocoKinematicTreeJointAdapter*>( m_JointAdapter.get() ) )
@@ -108,7 +109,7 @@ namespace kintree {
         if ( is_dummy_body )
             return;
 
-        m_MjcBodyId = mj_name2id( m_MjcModelRef, mjOBJ_BODY, m_BodyRef->name().c_str() );
+        m_MjcBodyId = mujoco::mjc_name2id( m_MjcModelRef, m_MjcNameIndexRef, mjOBJ_BODY, m_BodyRef->name() );
         if ( m_MjcBodyId < 0 )
         {
             LOCO_CORE_ERROR( "TMujocoKinematicTreeBodyAdapter::Initialize >>> couldn't find associated "
@@ -117,6 +118,24 @@ namespace kintree {
         }
     }
 
+    void TMujocoKinematicTreeBodyAdapter::InitializeFromAdapter( const TMujocoKinematicTreeBodyAdapter& other )
+    {
+        LOCO_CORE_ASSERT( m_MjcModelRef, "TMujocoKinematicTreeBodyAdapter::InitializeFromAdapter >>> must have a valid mjModel reference (got nullptr)" );
+        LOCO_CORE_ASSERT( m_MjcDataRef, "TMujocoKinematicTreeBodyAdapter::InitializeFromAdapter >>> must have a valid mjData reference (got nullptr)" );
+
+        auto mjc_collider_adapter = dynamic_cast<TMujocoKinematicTreeColliderAdapter*>( m_ColliderAdapter.get() );
+        auto other_mjc_collider_adapter = dynamic_cast<const TMujocoKinematicTreeColliderAdapter*>( other.m_ColliderAdapter.get() );
+        if ( mjc_collider_adapter && other_mjc_collider_adapter )
+            mjc_collider_adapter->InitializeFromAdapter( *other_mjc_collider_adapter );
+
+        auto mjc_joint_adapter = dynamic_cast<TMujocoKinematicTreeJointAdapter*>( m_JointAdapter.get() );
+        auto other_mjc_joint_adapter = dynamic_cast<const TMujocoKinematicTreeJointAdapter*>( other.m_JointAdapter.get() );
+        if ( mjc_joint_adapter && other_mjc_joint_adapter )
+            mjc_joint_adapter->InitializeFromAdapter( *other_mjc_joint_adapter );
+
+        m_MjcBodyId = other.m_MjcBodyId;
+    }
+
     void TMujocoKinematicTreeBodyAdapter::Reset()
     {
         LOCO_CORE_ASSERT( m_MjcModelRef, "TMujocoKinematicTreeBodyAdapter::Reset >>> must have a valid mjModel reference (got nullptr)" );
@@ -170,6 +189,37 @@ namespace kintree {
         dst_transform.set( tinymath::rotation( world_quat ) );
     }
 
+    void TMujocoKinematicTreeBodyAdapter::UpdateContacts( const mujoco::TMujocoContactBuffer& contact_buffer )
+    {
+        if ( auto mjc_collider_adapter = dynamic_cast<TMujocoKinematicTreeColliderAdapter*>( m_ColliderAdapter.get() ) )
+            mjc_collider_adapter->UpdateContacts( contact_buffer );
+    }
+
+    void TMujocoKinematicTreeBodyAdapter::SetBulkResetEnabled( bool enabled )
+    {
+        if ( auto mjc_joint_adapter = dynamic_cast<TMujocoKinematicTreeJointAdapter*>( m_JointAdapter.get() ) )
+            mjc_joint_adapter->SetBulkResetEnabled( enabled );
+    }
+
+    void TMujocoKinematicTreeBodyAdapter::ResetInitialConditions()
+    {
+        if ( auto mjc_joint_adapter = dynamic_cast<TMujocoKinematicTreeJointAdapter*>( m_JointAdapter.get() ) )
+            mjc_joint_adapter->ResetInitialConditions();
+    }
+
+    void TMujocoKinematicTreeBodyAdapter::ApplyResetOverrides()
+    {
+        if ( auto mjc_joint_adapter = dynamic_cast<TMujocoKinematicTreeJointAdapter*>( m_JointAdapter.get() ) )
+            mjc_joint_adapter->ApplyResetOverrides();
+    }
+
+    const mujoco::TMjcVfsFile* TMujocoKinematicTreeBodyAdapter::vfs_mesh_resource() const
+    {
+        if ( auto mjc_collider_adapter = dynamic_cast<const TMujocoKinematicTreeColliderAdapter*>( m_ColliderAdapter.get() ) )
+            return mjc_collider_adapter->vfs_mesh_resource();
+        return nullptr;
+    }
+
     void TMujocoKinematicTreeBodyAdapter::SetMjcModel( mjModel* mj_model_ref )
     {
         m_MjcModelRef = mj_model_ref;
@@ -180,6 +230,15 @@ namespace kintree {
             mjc_joint_adapter->SetMjcModel( mj_model_ref );
     }
 
+    void TMujocoKinematicTreeBodyAdapter::SetMjcModelUniqueFn( const mujoco::FnMjcModelUnique& mjc_model_unique_fn )
+    {
+        if ( auto mjc_collider_adapter = dynamic_cast<TMujocoKinematicTreeColliderAdapter*>( m_ColliderAdapter.get() ) )
+            mjc_collider_adapter->SetMjcModelUniqueFn( mjc_model_unique_fn );
+
+        if ( auto mjc_joint_adapter = dynamic_cast<TMujocoKinematicTreeJointAdapter*>( m_JointAdapter.get() ) )
+            mjc_joint_adapter->SetMjcModelUniqueFn( mjc_model_unique_fn );
+    }
+
     void TMujocoKinematicTreeBodyAdapter::SetMjcData( mjData* mj_data_ref )
     {
         m_MjcDataRef = mj_data_ref;
@@ -189,4 +248,14 @@ namespace kintree {
         if ( auto mjc_joint_adapter = dynamic_cast<TMujocoKinematicTreeJointAdapter*>( m_JointAdapter.get() ) )
             mjc_joint_adapter->SetMjcData( mj_data_ref );
     }
+
+    void TMujocoKinematicTreeBodyAdapter::SetMjcNameIndex( const mujoco::TMujocoNameIndex* mjc_name_index_ref )
+    {
+        m_MjcNameIndexRef = mjc_name_index_ref;
+        if ( auto mjc_collider_adapter = dynamic_cast<TMujocoKinematicTreeColliderAdapter*>( m_ColliderAdapter.get() ) )
+            mjc_collider_adapter->SetMjcNameIndex( mjc_name_index_ref );
+
+        if ( auto mjc_joint_adapter = dynamic_cast<TMujocoKinematicTreeJointAdapter*>( m_JointAdapter.get() ) )
+            mjc_joint_adapter->SetMjcNameIndex( mjc_name_index_ref );
+    }
 }}
\ No newline at end of file
@@ -1,5 +1,6 @@
 
 #include <kinematic_trees/loco_kinematic_tree_collider_adapter_mujoco.h>
+#include <loco_model_cache_mujoco.h>
 
 namespace loco {
 namespace kintree {
@@ -22,9 +23,11 @@ namespace kintree {
 
         m_MjcModelRef = nullptr;
         m_MjcDataRef = nullptr;
+        m_MjcNameIndexRef = nullptr;
 
         m_MjcfElementsResources.clear();
         m_MjcfElementAssetResources = nullptr;
+        m_MjcVfsMeshResource = nullptr;
     }
 
     void TMujocoKinematicTreeColliderAdapter::Build()
@@ -95,9 +98,12 @@ namespace kintree {
                     const std::string mesh_id = tinyutils::GetFilenameNoExtension( mesh_file );
                     const auto mesh_scale = m_ColliderRef->size();
 
+                    // Hand mujoco the cached hull of the mesh-file if available (stored on Initialize otherwise)
+                    m_MjcVfsMeshResource = mujoco::TMujocoMeshCache::CreateMeshVfsFileFromFile( mesh_file, mesh_scale, m_MjcMeshCachePendingKey );
+
                     m_MjcfElementAssetResources = std::make_unique<parsing::TElement>( mujoco::LOCO_MJCF_MESH_TAG, parsing::eSchemaType::MJCF );
                     m_MjcfElementAssetResources->SetString( "name", mesh_id );
-                    m_MjcfElementAssetResources->SetString( "file", mesh_file );
+                    m_MjcfElementAssetResources->SetString( "file", m_MjcVfsMeshResource ? m_MjcVfsMeshResource->filename : mesh_file );
                     m_MjcfElementAssetResources->SetVec3( "scale", mesh_scale );
                     mjcf_element_resource->SetString( "mesh", mesh_id );
                 }
@@ -119,7 +125,7 @@ namespace kintree {
                                         0, 3, 2 };
                     const auto& mesh_vertices = mesh_data.vertices;
                     const auto& mesh_faces = mesh_data.faces;
-                    mujoco::SaveMeshToBinary( mesh_file, mesh_vertices, mesh_faces );
+                    m_MjcVfsMeshResource = mujoco::CreateMeshVfsFile( mesh_file, mesh_vertices, mesh_faces );
 
                     m_MjcfElementAssetResources = std::make_unique<parsing::TElement>( mujoco::LOCO_MJCF_MESH_TAG, parsing::eSchemaType::MJCF );
                     m_MjcfElementAssetResources->SetString( "name", mesh_id );
@@ -158,7 +164,7 @@ namespace kintree {
         if ( m_ColliderRef->shape() == eShapeType::COMPOUND )
             return; // Compound shapes don't allow to handle its MuJoCo properties (as they are composed multiple geoms)
 
-        m_MjcGeomId = mj_name2id( m_MjcModelRef, mjOBJ_GEOM, m_ColliderRef->name().c_str() );
+        m_MjcGeomId = mujoco::mjc_name2id( m_MjcModelRef, m_MjcNameIndexRef, mjOBJ_GEOM, m_ColliderRef->name() );
         if ( m_MjcGeomId < 0 )
         {
             LOCO_CORE_ERROR( "TMujocoKinematicTreeColliderAdapter::Initialize >>> couldn't find associated \
@@ -178,6 +184,13 @@ namespace kintree {
                 return;
             }
 
+            if ( !m_MjcMeshCachePendingKey.empty() )
+            {
+                mujoco::TMujocoMeshCache::StoreFromFile( m_MjcMeshCachePendingKey, m_ColliderRef->data().mesh_data.filename,
+                                                         m_MjcModelRef, m_MjcGeomMeshId );
+                m_MjcMeshCachePendingKey = "";
+            }
+
             m_MjcGeomMeshVertNum = m_MjcModelRef->mesh_vertnum[m_MjcGeomMeshId];
             m_MjcGeomMeshFaceNum = m_MjcModelRef->mesh_facenum[m_MjcGeomMeshId];
             m_MjcGeomMeshVertStartAddr = m_MjcModelRef->mesh_vertadr[m_MjcGeomMeshId];
@@ -185,6 +198,39 @@ namespace kintree {
         }
     }
 
+    void TMujocoKinematicTreeColliderAdapter::InitializeFromAdapter( const TMujocoKinematicTreeColliderAdapter& other )
+    {
+        LOCO_CORE_ASSERT( m_MjcModelRef, "TMujocoKinematicTreeColliderAdapter::InitializeFromAdapter >>> must have a valid mjModel reference" );
+        LOCO_CORE_ASSERT( m_MjcDataRef, "TMujocoKinematicTreeColliderAdapter::InitializeFromAdapter >>> must have a valid mjData reference" );
+
+        m_MjcGeomId = other.m_MjcGeomId;
+        m_MjcGeomMeshId = other.m_MjcGeomMeshId;
+        m_MjcGeomMeshVertNum = other.m_MjcGeomMeshVertNum;
+        m_MjcGeomMeshFaceNum = other.m_MjcGeomMeshFaceNum;
+        m_MjcGeomMeshVertStartAddr = other.m_MjcGeomMeshVertStartAddr;
+        m_MjcGeomMeshFaceStartAddr = other.m_MjcGeomMeshFaceStartAddr;
+        m_MjcGeomRbound = other.m_MjcGeomRbound;
+        m_Size = other.m_Size;
+        m_Size0 = other.m_Size0;
+        m_MjcMeshCachePendingKey = "";
+    }
+
+    void TMujocoKinematicTreeColliderAdapter::UpdateContacts( const mujoco::TMujocoContactBuffer& contact_buffer )
+    {
+        m_MjcContacts = contact_buffer.contacts( m_MjcGeomId );
+
+        // Update the collider's contacts in place (reuses the vector's and strings' storage)
+        auto& contacts = m_ColliderRef->contacts();
+        contacts.resize( m_MjcContacts.size );
+        for ( ssize_t i = 0; i < m_MjcContacts.size; i++ )
+        {
+            const auto& mjc_contact = m_MjcContacts[i];
+            contacts[i].position = mjc_contact.position;
+            contacts[i].normal = mjc_contact.normal;
+            contacts[i].name = contact_buffer.geom_name( mjc_contact.other_geom_id );
+        }
+    }
+
     void TMujocoKinematicTreeColliderAdapter::SetLocalTransform( const TMat4& local_tf )
     {
         LOCO_CORE_ASSERT( m_MjcModelRef, "TMujocoKinematicTreeColliderAdapter::SetLocalTransform >>> must have a valid mjModel reference" );
@@ -195,13 +241,14 @@ namespace kintree {
 
         const auto rel_position = local_tf.col( 3 );
         const auto rel_quaternion = tinymath::quaternion( TMat3( local_tf ) );
-        m_MjcModelRef->geom_pos[3 * m_MjcGeomId + 0] = rel_position.x();
-        m_MjcModelRef->geom_pos[3 * m_MjcGeomId + 1] = rel_position.y();
-        m_MjcModelRef->geom_pos[3 * m_MjcGeomId + 2] = rel_position.z();
-        m_MjcModelRef->geom_quat[4 * m_MjcGeomId + 0] = rel_quaternion.w();
-        m_MjcModelRef->geom_quat[4 * m_MjcGeomId + 1] = rel_quaternion.x();
-        m_MjcModelRef->geom_quat[4 * m_MjcGeomId + 2] = rel_quaternion.y();
-        m_MjcModelRef->geom_quat[4 * m_MjcGeomId + 3] = rel_quaternion.z();
+        mjModel* mjc_model = _MjcModelUnique();
+        mjc_model->geom_pos[3 * m_MjcGeomId + 0] = rel_position.x();
+        mjc_model->geom_pos[3 * m_MjcGeomId + 1] = rel_position.y();
+        mjc_model->geom_pos[3 * m_MjcGeomId + 2] = rel_position.z();
+        mjc_model->geom_quat[4 * m_MjcGeomId + 0] = rel_quaternion.w();
+        mjc_model->geom_quat[4 * m_MjcGeomId + 1] = rel_quaternion.x();
+        mjc_model->geom_quat[4 * m_MjcGeomId + 2] = rel_quaternion.y();
+        mjc_model->geom_quat[4 * m_MjcGeomId + 3] = rel_quaternion.z();
     }
 
     void TMujocoKinematicTreeColliderAdapter::ChangeSize( const TVec3& new_size )
@@ -230,23 +277,18 @@ namespace kintree {
                                         std::max( 1e-3f, new_size.y() / m_Size0.y() ),
                                         std::max( 1e-3f, new_size.z() / m_Size0.z() ) };
 
-        TVec3 aabb_min( 1e6f, 1e6f, 1e6f );
-        TVec3 aabb_max( -1e6f, -1e6f, -1e6f );
+        // mesh_vertadr is given in vertices (3 floats each), not in floats
+        mjModel* mjc_model = _MjcModelUnique();
+        float* mesh_vertices = mjc_model->mesh_vert + 3 * m_MjcGeomMeshVertStartAddr;
         for ( ssize_t v = 0; v < m_MjcGeomMeshVertNum; v++ )
         {
-            m_MjcModelRef->mesh_vert[m_MjcGeomMeshVertStartAddr + 3 * v + 0] *= effective_scale.x();
-            m_MjcModelRef->mesh_vert[m_MjcGeomMeshVertStartAddr + 3 * v + 1] *= effective_scale.y();
-            m_MjcModelRef->mesh_vert[m_MjcGeomMeshVertStartAddr + 3 * v + 2] *= effective_scale.z();
-
-            aabb_min.x() = std::min( aabb_min.x(), m_MjcModelRef->mesh_vert[m_MjcGeomMeshVertStartAddr + 3 * v + 0] );
-            aabb_min.y() = std::min( aabb_min.y(), m_MjcModelRef->mesh_vert[m_MjcGeomMeshVertStartAddr + 3 * v + 1] );
-            aabb_min.z() = std::min( aabb_min.z(), m_MjcModelRef->mesh_vert[m_MjcGeomMeshVertStartAddr + 3 * v + 2] );
-
-            aabb_max.x() = std::max( aabb_max.x(), m_MjcModelRef->mesh_vert[m_MjcGeomMeshVertStartAddr + 3 * v + 0] );
-            aabb_max.y() = std::max( aabb_max.y(), m_MjcModelRef->mesh_vert[m_MjcGeomMeshVertStartAddr + 3 * v + 1] );
-            aabb_max.z() = std::max( aabb_max.z(), m_MjcModelRef->mesh_vert[m_MjcGeomMeshVertStartAddr + 3 * v + 2] );
+            mesh_vertices[3 * v + 0] *= effective_scale.x();
+            mesh_vertices[3 * v + 1] *= effective_scale.y();
+            mesh_vertices[3 * v + 2] *= effective_scale.z();
         }
-        m_MjcModelRef->geom_rbound[m_MjcGeomId] = 0.5f * ( aabb_max - aabb_min ).length();
+        TVec3 aabb_min, aabb_max;
+        mujoco::compute_vertices_aabb( mesh_vertices, m_MjcGeomMeshVertNum, aabb_min, aabb_max );
+        mjc_model->geom_rbound[m_MjcGeomId] = mujoco::compute_aabb_rbound( aabb_min, aabb_max );
         // New size becomes previous size for next resizing operation
         m_Size0 = new_size;
 
@@ -257,9 +299,10 @@ namespace kintree {
     {
         const auto shape = m_ColliderRef->shape();
         const auto arr_size = mujoco::size_to_mjcSize( shape, new_size );
+        mjModel* mjc_model = _MjcModelUnique();
         for ( ssize_t i = 0; i < arr_size.ndim; i++ )
-            m_MjcModelRef->geom_size[3 * m_MjcGeomId + i] = arr_size[i];
-        m_MjcModelRef->geom_rbound[m_MjcGeomId] = mujoco::compute_primitive_rbound( shape, new_size );
+            mjc_model->geom_size[3 * m_MjcGeomId + i] = arr_size[i];
+        mjc_model->geom_rbound[m_MjcGeomId] = mujoco::compute_primitive_rbound( shape, new_size );
     }
 
     void TMujocoKinematicTreeColliderAdapter::ChangeCollisionGroup( int collision_group )
@@ -269,7 +312,7 @@ namespace kintree {
 
         if ( m_MjcGeomId < 0 )
             return;
-        m_MjcModelRef->geom_contype[m_MjcGeomId] = collision_group;
+        _MjcModelUnique()->geom_contype[m_MjcGeomId] = collision_group;
     }
 
     void TMujocoKinematicTreeColliderAdapter::ChangeCollisionMask( int collision_mask )
@@ -279,7 +322,7 @@ namespace kintree {
 
         if ( m_MjcGeomId < 0 )
             return;
-        m_MjcModelRef->geom_conaffinity[m_MjcGeomId] = collision_mask;
+        _MjcModelUnique()->geom_conaffinity[m_MjcGeomId] = collision_mask;
     }
 
     void TMujocoKinematicTreeColliderAdapter::ChangeFriction( const TScalar& friction )
@@ -290,7 +333,15 @@ namespace kintree {
         if ( m_MjcGeomId < 0 )
             return;
         // Update only sliding friction (leave rolling and torsional as defaults)
-        m_MjcModelRef->geom_friction[3 * m_MjcGeomId + 0] = friction;
+        _MjcModelUnique()->geom_friction[3 * m_MjcGeomId + 0] = friction;
+    }
+
+    mjModel* TMujocoKinematicTreeColliderAdapter::_MjcModelUnique()
+    {
+        // Copies the model first if shared with clones (the simulation then rebinds m_MjcModelRef to the copy)
+        if ( m_MjcModelUniqueFn )
+            return m_MjcModelUniqueFn();
+        return m_MjcModelRef;
     }
 
     std::vector<const parsing::TElement*> TMujocoKinematicTreeColliderAdapter::elements_resources() const
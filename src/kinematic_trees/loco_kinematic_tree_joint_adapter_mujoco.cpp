@@ -16,6 +16,7 @@ namespace kintree {
 
         m_MjcModelRef = nullptr;
         m_MjcDataRef = nullptr;
+        m_MjcNameIndexRef = nullptr;
         m_MjcfElementsResources.clear();
     }
 
@@ -105,7 +106,7 @@ namespace kintree {
         if ( joint_type == eJointType::PLANAR )
             return; // A planar joint requires multiple mjc-joints, so don't use handles
 
-        m_MjcJointId = mj_name2id( m_MjcModelRef, mjOBJ_JOINT, m_JointRef->name().c_str() );
+        m_MjcJointId = mujoco::mjc_name2id( m_MjcModelRef, m_MjcNameIndexRef, mjOBJ_JOINT, m_JointRef->name() );
         if ( m_MjcJointId < 0 )
         {
             LOCO_CORE_ERROR( "TMujocoKinematicTreeJointAdapter::Initialize >>> couldn't find associated \
@@ -121,11 +122,36 @@ namespace kintree {
         m_MjcDofId = m_MjcModelRef->body_dofadr[mjc_body_parent_id];
     }
 
+    void TMujocoKinematicTreeJointAdapter::InitializeFromAdapter( const TMujocoKinematicTreeJointAdapter& other )
+    {
+        LOCO_CORE_ASSERT( m_MjcModelRef, "TMujocoKinematicTreeJointAdapter::InitializeFromAdapter >>> must have a valid mjModel reference" );
+        LOCO_CORE_ASSERT( m_MjcDataRef, "TMujocoKinematicTreeJointAdapter::InitializeFromAdapter >>> must have a valid mjData reference" );
+
+        m_MjcJointId = other.m_MjcJointId;
+        m_MjcDofId = other.m_MjcDofId;
+        m_MjcJointQposAdr = other.m_MjcJointQposAdr;
+        m_MjcJointQvelAdr = other.m_MjcJointQvelAdr;
+        m_ResetQpos0 = other.m_ResetQpos0;
+        m_ResetQvel0 = other.m_ResetQvel0;
+    }
+
     void TMujocoKinematicTreeJointAdapter::Reset()
     {
         LOCO_CORE_ASSERT( m_MjcModelRef, "TMujocoKinematicTreeJointAdapter::Reset >>> must have a valid mjModel reference" );
         LOCO_CORE_ASSERT( m_MjcDataRef, "TMujocoKinematicTreeJointAdapter::Reset >>> must have a valid mjData reference" );
 
+        // On bulk-resets the simulation restores the initial-state image, and then applies overrides (if any)
+        if ( m_BulkResetEnabled )
+            return;
+
+        ResetInitialConditions();
+    }
+
+    void TMujocoKinematicTreeJointAdapter::ResetInitialConditions()
+    {
+        LOCO_CORE_ASSERT( m_MjcModelRef, "TMujocoKinematicTreeJointAdapter::ResetInitialConditions >>> must have a valid mjModel reference" );
+        LOCO_CORE_ASSERT( m_MjcDataRef, "TMujocoKinematicTreeJointAdapter::ResetInitialConditions >>> must have a valid mjData reference" );
+
         if ( m_MjcJointId < 0 )
             return;
 
@@ -154,6 +180,19 @@ namespace kintree {
 
         for ( ssize_t i = 0; i < num_qvel; i++ )
             m_MjcDataRef->qvel[m_MjcJointQvelAdr + i] = qvel0[i];
+
+        m_ResetQpos0 = qpos0;
+        m_ResetQvel0 = qvel0;
+    }
+
+    void TMujocoKinematicTreeJointAdapter::ApplyResetOverrides()
+    {
+        if ( m_MjcJointId < 0 )
+            return;
+
+        // Only joints whose initial conditions changed since the initial-state image was taken are written
+        if ( m_JointRef->qpos0() != m_ResetQpos0 || m_JointRef->qvel0() != m_ResetQvel0 )
+            ResetInitialConditions();
     }
 
     void TMujocoKinematicTreeJointAdapter::SetQpos( const std::vector<TScalar>& qpos )
@@ -207,9 +246,10 @@ namespace kintree {
             return;
         // @todo: check case for rel-rotation changes, as it might change the local axis
         const auto rel_position = local_tf.col( 3 );
-        m_MjcModelRef->jnt_pos[3 * m_MjcJointId + 0] = rel_position.x();
-        m_MjcModelRef->jnt_pos[3 * m_MjcJointId + 1] = rel_position.y();
-        m_MjcModelRef->jnt_pos[3 * m_MjcJointId + 2] = rel_position.z();
+        mjModel* mjc_model = _MjcModelUnique();
+        mjc_model->jnt_pos[3 * m_MjcJointId + 0] = rel_position.x();
+        mjc_model->jnt_pos[3 * m_MjcJointId + 1] = rel_position.y();
+        mjc_model->jnt_pos[3 * m_MjcJointId + 2] = rel_position.z();
     }
 
     void TMujocoKinematicTreeJointAdapter::ChangeStiffness( const TScalar& stiffness )
@@ -220,7 +260,7 @@ namespace kintree {
         if ( m_MjcJointId < 0 )
             return;
 
-        m_MjcModelRef->jnt_stiffness[m_MjcJointId] = stiffness;
+        _MjcModelUnique()->jnt_stiffness[m_MjcJointId] = stiffness;
     }
 
     void TMujocoKinematicTreeJointAdapter::ChangeArmature( const TScalar& armature )
@@ -231,7 +271,7 @@ namespace kintree {
         if ( m_MjcDofId < 0 )
             return;
 
-        m_MjcModelRef->dof_armature[m_MjcDofId] = armature;
+        _MjcModelUnique()->dof_armature[m_MjcDofId] = armature;
     }
 
     void TMujocoKinematicTreeJointAdapter::ChangeDamping( const TScalar& damping )
@@ -242,7 +282,7 @@ namespace kintree {
         if ( m_MjcDofId < 0 )
             return;
 
-        m_MjcModelRef->dof_damping[m_MjcDofId] = damping;
+        _MjcModelUnique()->dof_damping[m_MjcDofId] = damping;
     }
 
     void TMujocoKinematicTreeJointAdapter::ChangeAxis( const TVec3& axis )
@@ -254,9 +294,10 @@ namespace kintree {
             return;
 
         const auto axis_normalized = axis.normalized();
-        m_MjcModelRef->jnt_axis[3 * m_MjcDofId + 0] = axis_normalized.x();
-        m_MjcModelRef->jnt_axis[3 * m_MjcDofId + 1] = axis_normalized.y();
-        m_MjcModelRef->jnt_axis[3 * m_MjcDofId + 2] = axis_normalized.z();
+        mjModel* mjc_model = _MjcModelUnique();
+        mjc_model->jnt_axis[3 * m_MjcDofId + 0] = axis_normalized.x();
+        mjc_model->jnt_axis[3 * m_MjcDofId + 1] = axis_normalized.y();
+        mjc_model->jnt_axis[3 * m_MjcDofId + 2] = axis_normalized.z();
     }
 
     void TMujocoKinematicTreeJointAdapter::ChangeLimits( const TVec2& limits )
@@ -269,28 +310,37 @@ namespace kintree {
 
         const auto joint_type = m_JointRef->type();
         const auto limited = ( limits.x() < limits.y() );
-        m_MjcModelRef->jnt_limited[m_MjcJointId] = (limited) ? 1 : 0;
+        mjModel* mjc_model = _MjcModelUnique();
+        mjc_model->jnt_limited[m_MjcJointId] = (limited) ? 1 : 0;
         if ( limited )
         {
             /**/ if ( joint_type == eJointType::SPHERICAL )
             {
-                m_MjcModelRef->jnt_range[2 * m_MjcJointId + 0] = 0.0f;
-                m_MjcModelRef->jnt_range[2 * m_MjcJointId + 1] = limits.y();
+                mjc_model->jnt_range[2 * m_MjcJointId + 0] = 0.0f;
+                mjc_model->jnt_range[2 * m_MjcJointId + 1] = limits.y();
             }
             else if ( joint_type == eJointType::REVOLUTE )
             {
                 // @todo: check if limits for revolute joints are required in degrees or radians
-                m_MjcModelRef->jnt_range[2 * m_MjcJointId + 0] = Rad2degrees( limits.x() );
-                m_MjcModelRef->jnt_range[2 * m_MjcJointId + 1] = Rad2degrees( limits.y() );
+                mjc_model->jnt_range[2 * m_MjcJointId + 0] = Rad2degrees( limits.x() );
+                mjc_model->jnt_range[2 * m_MjcJointId + 1] = Rad2degrees( limits.y() );
             }
             else if ( joint_type == eJointType::PRISMATIC )
             {
-                m_MjcModelRef->jnt_range[2 * m_MjcJointId + 0] = limits.x();
-                m_MjcModelRef->jnt_range[2 * m_MjcJointId + 1] = limits.y();
+                mjc_model->jnt_range[2 * m_MjcJointId + 0] = limits.x();
+                mjc_model->jnt_range[2 * m_MjcJointId + 1] = limits.y();
             }
         }
     }
 
+    mjModel* TMujocoKinematicTreeJointAdapter::_MjcModelUnique()
+    {
+        // Copies the model first if shared with clones (the simulation then rebinds m_MjcModelRef to the copy)
+        if ( m_MjcModelUniqueFn )
+            return m_MjcModelUniqueFn();
+        return m_MjcModelRef;
+    }
+
     void TMujocoKinematicTreeJointAdapter::GetQpos( std::vector<TScalar>& dst_qpos )
     {
         LOCO_CORE_ASSERT( m_MjcModelRef, "TMujocoKinematicTreeJointAdapter::ChangeAxis >>> must have a valid mjModel reference" );
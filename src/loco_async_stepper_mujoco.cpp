@@ -0,0 +1,188 @@
+#include <loco_async_stepper_mujoco.h>
+#include <loco_simulation_mujoco.h>
+
+namespace loco {
+namespace mujoco {
+
+    TMujocoSnapshotHandle::TMujocoSnapshotHandle( TMujocoSnapshotHandle&& other )
+        : m_Snapshot( std::move( other.m_Snapshot ) ), m_RefcountRef( other.m_RefcountRef )
+    {
+        other.m_Snapshot = nullptr;
+        other.m_RefcountRef = nullptr;
+    }
+
+    TMujocoSnapshotHandle& TMujocoSnapshotHandle::operator=( TMujocoSnapshotHandle&& other )
+    {
+        if ( this != &other )
+        {
+            Release();
+            m_Snapshot = std::move( other.m_Snapshot );
+            m_RefcountRef = other.m_RefcountRef;
+            other.m_Snapshot = nullptr;
+            other.m_RefcountRef = nullptr;
+        }
+        return *this;
+    }
+
+    void TMujocoSnapshotHandle::Release()
+    {
+        // Unpin before dropping the slot (the refcount lives in the slot, which this handle might be the last owner of)
+        if ( m_RefcountRef )
+            m_RefcountRef->fetch_sub( 1 );
+        m_Snapshot = nullptr;
+        m_RefcountRef = nullptr;
+    }
+
+    TMujocoAsyncStepper::TMujocoAsyncStepper( TMujocoSimulation* simulation_ref, ssize_t num_snapshot_slots )
+    {
+        LOCO_CORE_ASSERT( simulation_ref, "TMujocoAsyncStepper >>> must have a valid simulation reference (got nullptr)" );
+        LOCO_CORE_ASSERT( simulation_ref->mjc_model() && simulation_ref->mjc_data(), "TMujocoAsyncStepper >>> \
+                          simulation must be initialized before stepping it asynchronously" );
+
+        m_SimulationRef = simulation_ref;
+        m_NumPendingRequests = 0;
+        m_NumSteps = 0;
+        m_Stop = false;
+
+        const mjModel* mjc_model = m_SimulationRef->mjc_model();
+        num_snapshot_slots = std::max( num_snapshot_slots, LOCO_MUJOCO_ASYNC_MIN_SNAPSHOT_SLOTS );
+        for ( ssize_t i = 0; i < num_snapshot_slots; i++ )
+        {
+            auto slot = std::make_shared<TSnapshotSlot>();
+            slot->refcount = 0;
+            slot->snapshot.qpos.resize( mjc_model->nq );
+            slot->snapshot.qvel.resize( mjc_model->nv );
+            slot->snapshot.xpos.resize( 3 * mjc_model->nbody );
+            slot->snapshot.xquat.resize( 4 * mjc_model->nbody );
+            slot->snapshot.contacts.reserve( mjc_model->nconmax );
+            m_Slots.push_back( std::move( slot ) );
+        }
+
+        // Publish the current state, so readers always have a valid snapshot to look at
+        m_LatestSlot = -1;
+        _PublishSnapshot();
+        m_Worker = std::thread( &TMujocoAsyncStepper::_WorkerLoop, this );
+    }
+
+    TMujocoAsyncStepper::~TMujocoAsyncStepper()
+    {
+        {
+            std::lock_guard<std::mutex> lock( m_RequestsMutex );
+            m_Stop = true;
+        }
+        m_CondVarRequests.notify_all();
+        if ( m_Worker.joinable() )
+            m_Worker.join();
+        // Requests never processed are dropped (their futures report a broken promise). Slots still pinned
+        // by handles are kept alive by these, so only the stepper's references are released here
+        m_Requests.clear();
+        m_Slots.clear();
+    }
+
+    std::future<void> TMujocoAsyncStepper::StepAsync( const TScalar& dt )
+    {
+        std::packaged_task<void()> request( [this, dt]()
+            {
+                m_SimulationRef->Step( dt );
+                m_NumSteps++;
+                _PublishSnapshot();
+            } );
+        auto future = request.get_future();
+        {
+            std::lock_guard<std::mutex> lock( m_RequestsMutex );
+            m_Requests.push_back( std::move( request ) );
+            m_NumPendingRequests++;
+        }
+        m_CondVarRequests.notify_one();
+        return future;
+    }
+
+    void TMujocoAsyncStepper::Wait()
+    {
+        std::unique_lock<std::mutex> lock( m_RequestsMutex );
+        m_CondVarIdle.wait( lock, [this]() { return m_NumPendingRequests.load() == 0; } );
+    }
+
+    TMujocoSnapshotHandle TMujocoAsyncStepper::AcquireSnapshot() const
+    {
+        // Pin the latest slot, and double-check it's still the latest one: if it isn't, the stepper might
+        // have already picked it for writing (it was unpinned when checked), so unpin and try again
+        while ( true )
+        {
+            const ssize_t slot_index = m_LatestSlot.load();
+            const auto& slot = m_Slots[slot_index];
+            slot->refcount.fetch_add( 1 );
+            if ( m_LatestSlot.load() == slot_index )
+                return TMujocoSnapshotHandle( std::shared_ptr<const TMujocoStateSnapshot>( slot, &slot->snapshot ), &slot->refcount );
+            slot->refcount.fetch_sub( 1 );
+        }
+    }
+
+    void TMujocoAsyncStepper::_WorkerLoop()
+    {
+        while ( true )
+        {
+            std::packaged_task<void()> request;
+            {
+                std::unique_lock<std::mutex> lock( m_RequestsMutex );
+                m_CondVarRequests.wait( lock, [this]() { return m_Stop || !m_Requests.empty(); } );
+                if ( m_Stop )
+                    return;
+                request = std::move( m_Requests.front() );
+                m_Requests.pop_front();
+            }
+
+            request();
+
+            {
+                std::lock_guard<std::mutex> lock( m_RequestsMutex );
+                m_NumPendingRequests--;
+            }
+            m_CondVarIdle.notify_all();
+        }
+    }
+
+    void TMujocoAsyncStepper::_PublishSnapshot()
+    {
+        // Find a slot that's neither the latest one nor pinned by a reader (readers release quickly, and
+        // there are at least three slots, so this only waits if readers hold on to many old snapshots)
+        const ssize_t latest_slot = m_LatestSlot.load();
+        ssize_t slot_index = -1;
+        while ( slot_index < 0 )
+        {
+            for ( ssize_t i = 0; i < (ssize_t)m_Slots.size(); i++ )
+            {
+                if ( i != latest_slot && m_Slots[i]->refcount.load() == 0 )
+                {
+                    slot_index = i;
+                    break;
+                }
+            }
+            if ( slot_index < 0 )
+                std::this_thread::yield();
+        }
+
+        const mjModel* mjc_model = m_SimulationRef->mjc_model();
+        const mjData* mjc_data = m_SimulationRef->mjc_data();
+        auto& snapshot = m_Slots[slot_index]->snapshot;
+        snapshot.step_id = m_NumSteps.load();
+        snapshot.time = mjc_data->time;
+        mju_copy( snapshot.qpos.data(), mjc_data->qpos, mjc_model->nq );
+        mju_copy( snapshot.qvel.data(), mjc_data->qvel, mjc_model->nv );
+        mju_copy( snapshot.xpos.data(), mjc_data->xpos, 3 * mjc_model->nbody );
+        mju_copy( snapshot.xquat.data(), mjc_data->xquat, 4 * mjc_model->nbody );
+        snapshot.contacts.resize( mjc_data->ncon );
+        for ( ssize_t i = 0; i < mjc_data->ncon; i++ )
+        {
+            const mjContact& mjc_contact = mjc_data->contact[i];
+            auto& contact = snapshot.contacts[i];
+            contact.geom1_id = mjc_contact.geom1;
+            contact.geom2_id = mjc_contact.geom2;
+            contact.distance = mjc_contact.dist;
+            contact.position = TVec3( mjc_contact.pos[0], mjc_contact.pos[1], mjc_contact.pos[2] );
+            contact.normal = TVec3( mjc_contact.frame[0], mjc_contact.frame[1], mjc_contact.frame[2] );
+        }
+
+        m_LatestSlot.store( slot_index );
+    }
+}}
\ No newline at end of file
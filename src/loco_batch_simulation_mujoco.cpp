@@ -0,0 +1,378 @@
+#include <loco_batch_simulation_mujoco.h>
+
+namespace loco
+{
+    TMujocoBatchSimulation::TMujocoBatchSimulation( TScenario* scenarioRef, ssize_t num_envs, ssize_t num_threads )
+    {
+        LOCO_CORE_ASSERT( scenarioRef, "TMujocoBatchSimulation >>> must have a valid scenario reference (got nullptr)" );
+        LOCO_CORE_ASSERT( num_envs > 0, "TMujocoBatchSimulation >>> must have at least one environment (got {0})", num_envs );
+
+        m_NumEnvs = num_envs;
+        m_Initialized = false;
+        m_Simulation = std::make_unique<TMujocoSimulation>( scenarioRef );
+        m_MjcDataInit = nullptr;
+        m_ThreadPool = std::make_unique<mujoco::TMujocoThreadPool>( num_threads );
+
+    #if defined( LOCO_CORE_USE_TRACK_ALLOCS )
+        if ( tinyutils::Logger::IsActive() )
+            LOCO_CORE_TRACE( "Loco::Allocs: Created TMujocoBatchSimulation @ {0}", tinyutils::PointerToHexAddress( this ) );
+        else
+            std::cout << "Loco::Allocs: Created TMujocoBatchSimulation @ " << tinyutils::PointerToHexAddress( this ) << std::endl;
+    #endif
+    }
+
+    TMujocoBatchSimulation::~TMujocoBatchSimulation()
+    {
+        // Release per-env data and views before the model they were created against
+        m_MjcDatas.clear();
+        m_MjcModelOverlays.clear();
+        m_MjcDataInit = nullptr;
+        m_ThreadPool = nullptr;
+        m_Simulation = nullptr;
+
+    #if defined( LOCO_CORE_USE_TRACK_ALLOCS )
+        if ( tinyutils::Logger::IsActive() )
+            LOCO_CORE_TRACE( "Loco::Allocs: Destroyed TMujocoBatchSimulation @ {0}", tinyutils::PointerToHexAddress( this ) );
+        else
+            std::cout << "Loco::Allocs: Destroyed TMujocoBatchSimulation @ " << tinyutils::PointerToHexAddress( this ) << std::endl;
+    #endif
+    }
+
+    bool TMujocoBatchSimulation::Initialize()
+    {
+        // Compile the model only once (internal simulation), and grab its initial state
+        if ( !m_Simulation->Initialize() )
+        {
+            LOCO_CORE_ERROR( "TMujocoBatchSimulation::Initialize >>> couldn't initialize the internal simulation" );
+            return false;
+        }
+        _CreateEnvDatas();
+        m_Initialized = true;
+        Reset();
+
+        LOCO_CORE_TRACE( "TMujocoBatchSimulation::Initialize >>> created {0} environments, using {1} threads",
+                         m_NumEnvs, m_ThreadPool->num_threads() );
+        return true;
+    }
+
+    void TMujocoBatchSimulation::Step( const TScalar& dt )
+    {
+        LOCO_CORE_ASSERT( m_Initialized, "TMujocoBatchSimulation::Step >>> batch must be initialized first" );
+
+        _SyncEnvDatas();
+        const ssize_t num_substeps = _NumSubsteps( dt );
+        m_ThreadPool->ParallelFor( m_NumEnvs, [&]( ssize_t env_id )
+            {
+                _SyncEnvModel( env_id );
+                const mjModel* mjc_model = m_MjcModelOverlays[env_id]->mjc_model();
+                mjData* mjc_data = m_MjcDatas[env_id].get();
+                for ( ssize_t k = 0; k < num_substeps; k++ )
+                    mj_step( mjc_model, mjc_data );
+            } );
+    }
+
+    void TMujocoBatchSimulation::StepEnvs( const std::vector<ssize_t>& env_ids, const TScalar& dt )
+    {
+        LOCO_CORE_ASSERT( m_Initialized, "TMujocoBatchSimulation::StepEnvs >>> batch must be initialized first" );
+
+        _SyncEnvDatas();
+        const ssize_t num_substeps = _NumSubsteps( dt );
+        m_ThreadPool->ParallelFor( env_ids.size(), [&]( ssize_t i )
+            {
+                _SyncEnvModel( env_ids[i] );
+                const mjModel* mjc_model = m_MjcModelOverlays[env_ids[i]]->mjc_model();
+                mjData* mjc_data = m_MjcDatas[env_ids[i]].get();
+                for ( ssize_t k = 0; k < num_substeps; k++ )
+                    mj_step( mjc_model, mjc_data );
+            } );
+    }
+
+    void TMujocoBatchSimulation::Reset()
+    {
+        LOCO_CORE_ASSERT( m_Initialized, "TMujocoBatchSimulation::Reset >>> batch must be initialized first" );
+
+        _SyncEnvDatas();
+        const mjModel* mjc_model = m_Simulation->mjc_model();
+        m_ThreadPool->ParallelFor( m_NumEnvs, [&]( ssize_t env_id )
+            {
+                _SyncEnvModel( env_id );
+                mujoco::CopyMjcState( mjc_model, m_MjcDatas[env_id].get(), m_MjcDataInit.get() );
+                mj_forward( m_MjcModelOverlays[env_id]->mjc_model(), m_MjcDatas[env_id].get() );
+            } );
+    }
+
+    void TMujocoBatchSimulation::ResetEnvs( const std::vector<ssize_t>& env_ids )
+    {
+        LOCO_CORE_ASSERT( m_Initialized, "TMujocoBatchSimulation::ResetEnvs >>> batch must be initialized first" );
+
+        _SyncEnvDatas();
+        const mjModel* mjc_model = m_Simulation->mjc_model();
+        m_ThreadPool->ParallelFor( env_ids.size(), [&]( ssize_t i )
+            {
+                _SyncEnvModel( env_ids[i] );
+                mujoco::CopyMjcState( mjc_model, m_MjcDatas[env_ids[i]].get(), m_MjcDataInit.get() );
+                mj_forward( m_MjcModelOverlays[env_ids[i]]->mjc_model(), m_MjcDatas[env_ids[i]].get() );
+            } );
+    }
+
+    void TMujocoBatchSimulation::SetCtrl( ssize_t env_id, const std::vector<TScalar>& ctrl )
+    {
+        LOCO_CORE_ASSERT( m_Initialized, "TMujocoBatchSimulation::SetCtrl >>> batch must be initialized first" );
+        LOCO_CORE_ASSERT( env_id >= 0 && env_id < m_NumEnvs, "TMujocoBatchSimulation::SetCtrl >>> env-id {0} out of range [0,{1})",
+                          env_id, m_NumEnvs );
+
+        _SyncEnvDatas();
+        const ssize_t num_ctrl = m_Simulation->mjc_model()->nu;
+        if ( (ssize_t)ctrl.size() != num_ctrl )
+        {
+            LOCO_CORE_ERROR( "TMujocoBatchSimulation::SetCtrl >>> expected {0} controls, but got {1}", num_ctrl, ctrl.size() );
+            return;
+        }
+        mjData* mjc_data = m_MjcDatas[env_id].get();
+        for ( ssize_t j = 0; j < num_ctrl; j++ )
+            mjc_data->ctrl[j] = ctrl[j];
+    }
+
+    void TMujocoBatchSimulation::SetCtrlBatch( const std::vector<TScalar>& ctrl_batch )
+    {
+        LOCO_CORE_ASSERT( m_Initialized, "TMujocoBatchSimulation::SetCtrlBatch >>> batch must be initialized first" );
+
+        _SyncEnvDatas();
+        const ssize_t num_ctrl = m_Simulation->mjc_model()->nu;
+        if ( (ssize_t)ctrl_batch.size() != num_ctrl * m_NumEnvs )
+        {
+            LOCO_CORE_ERROR( "TMujocoBatchSimulation::SetCtrlBatch >>> expected {0} controls (num-envs x nu), but got {1}",
+                             num_ctrl * m_NumEnvs, ctrl_batch.size() );
+            return;
+        }
+        for ( ssize_t env_id = 0; env_id < m_NumEnvs; env_id++ )
+        {
+            mjData* mjc_data = m_MjcDatas[env_id].get();
+            for ( ssize_t j = 0; j < num_ctrl; j++ )
+                mjc_data->ctrl[j] = ctrl_batch[env_id * num_ctrl + j];
+        }
+    }
+
+    void TMujocoBatchSimulation::GatherQpos( std::vector<TScalar>& dst_qpos_batch ) const
+    {
+        _GatherArray( dst_qpos_batch, m_Simulation->mjc_model()->nq, []( const mjData* mjc_data ) { return mjc_data->qpos; } );
+    }
+
+    void TMujocoBatchSimulation::GatherQvel( std::vector<TScalar>& dst_qvel_batch ) const
+    {
+        _GatherArray( dst_qvel_batch, m_Simulation->mjc_model()->nv, []( const mjData* mjc_data ) { return mjc_data->qvel; } );
+    }
+
+    void TMujocoBatchSimulation::GatherSensorData( std::vector<TScalar>& dst_sensordata_batch ) const
+    {
+        _GatherArray( dst_sensordata_batch, m_Simulation->mjc_model()->nsensordata, []( const mjData* mjc_data ) { return mjc_data->sensordata; } );
+    }
+
+    void TMujocoBatchSimulation::SyncSimulationFromEnv( ssize_t env_id )
+    {
+        LOCO_CORE_ASSERT( m_Initialized, "TMujocoBatchSimulation::SyncSimulationFromEnv >>> batch must be initialized first" );
+        LOCO_CORE_ASSERT( env_id >= 0 && env_id < m_NumEnvs, "TMujocoBatchSimulation::SyncSimulationFromEnv >>> env-id {0} \
+                          out of range [0,{1})", env_id, m_NumEnvs );
+
+        _SyncEnvDatas();
+        mujoco::CopyMjcState( m_Simulation->mjc_model(), m_Simulation->mjc_data(), m_MjcDatas[env_id].get() );
+        mj_forward( m_Simulation->mjc_model(), m_Simulation->mjc_data() );
+    }
+
+    void TMujocoBatchSimulation::SetGeomFriction( ssize_t env_id, ssize_t geom_id, const TVec3& friction )
+    {
+        LOCO_CORE_ASSERT( m_Initialized, "TMujocoBatchSimulation::SetGeomFriction >>> batch must be initialized first" );
+        LOCO_CORE_ASSERT( env_id >= 0 && env_id < m_NumEnvs, "TMujocoBatchSimulation::SetGeomFriction >>> env-id {0} \
+                          out of range [0,{1})", env_id, m_NumEnvs );
+        LOCO_CORE_ASSERT( geom_id >= 0 && geom_id < m_Simulation->mjc_model()->ngeom, "TMujocoBatchSimulation::SetGeomFriction >>> \
+                          geom-id {0} out of range", geom_id );
+
+        _SyncEnvDatas();
+        _SyncEnvModel( env_id );
+        mjtNum* geom_friction = m_MjcModelOverlays[env_id]->Materialize( mujoco::eMujocoModelParam::GEOM_FRICTION );
+        geom_friction[3 * geom_id + 0] = friction.x();
+        geom_friction[3 * geom_id + 1] = friction.y();
+        geom_friction[3 * geom_id + 2] = friction.z();
+    }
+
+    void TMujocoBatchSimulation::SetGeomSize( ssize_t env_id, ssize_t geom_id, const TVec3& size )
+    {
+        LOCO_CORE_ASSERT( m_Initialized, "TMujocoBatchSimulation::SetGeomSize >>> batch must be initialized first" );
+        LOCO_CORE_ASSERT( env_id >= 0 && env_id < m_NumEnvs, "TMujocoBatchSimulation::SetGeomSize >>> env-id {0} \
+                          out of range [0,{1})", env_id, m_NumEnvs );
+        LOCO_CORE_ASSERT( geom_id >= 0 && geom_id < m_Simulation->mjc_model()->ngeom, "TMujocoBatchSimulation::SetGeomSize >>> \
+                          geom-id {0} out of range", geom_id );
+
+        const eShapeType shape = mujoco::mjcGeomType_to_shape( m_Simulation->mjc_model()->geom_type[geom_id] );
+        if ( shape == eShapeType::CONVEX_MESH || shape == eShapeType::HEIGHTFIELD || shape == eShapeType::PLANE )
+        {
+            LOCO_CORE_ERROR( "TMujocoBatchSimulation::SetGeomSize >>> only primitive geoms can be resized per environment \
+                              (got {0}), use MakeEnvModelPrivate instead", ToString( shape ) );
+            return;
+        }
+
+        _SyncEnvDatas();
+        _SyncEnvModel( env_id );
+        auto& overlay = m_MjcModelOverlays[env_id];
+        mjtNum* geom_size = overlay->Materialize( mujoco::eMujocoModelParam::GEOM_SIZE );
+        mjtNum* geom_rbound = overlay->Materialize( mujoco::eMujocoModelParam::GEOM_RBOUND );
+        const auto array_size = mujoco::size_to_mjcSize( shape, size );
+        for ( size_t i = 0; i < array_size.ndim; i++ )
+            geom_size[3 * geom_id + i] = array_size[i];
+        geom_rbound[geom_id] = mujoco::compute_primitive_rbound( shape, size );
+    }
+
+    void TMujocoBatchSimulation::SetBodyMass( ssize_t env_id, ssize_t body_id, const TScalar& mass )
+    {
+        LOCO_CORE_ASSERT( m_Initialized, "TMujocoBatchSimulation::SetBodyMass >>> batch must be initialized first" );
+        LOCO_CORE_ASSERT( env_id >= 0 && env_id < m_NumEnvs, "TMujocoBatchSimulation::SetBodyMass >>> env-id {0} \
+                          out of range [0,{1})", env_id, m_NumEnvs );
+        LOCO_CORE_ASSERT( body_id > 0 && body_id < m_Simulation->mjc_model()->nbody, "TMujocoBatchSimulation::SetBodyMass >>> \
+                          body-id {0} out of range (world-body can't be changed)", body_id );
+        if ( mass <= 0.0f )
+        {
+            LOCO_CORE_ERROR( "TMujocoBatchSimulation::SetBodyMass >>> mass must be positive (got {0})", mass );
+            return;
+        }
+
+        _SyncEnvDatas();
+        _SyncEnvModel( env_id );
+        auto& overlay = m_MjcModelOverlays[env_id];
+        mjtNum* body_mass = overlay->Materialize( mujoco::eMujocoModelParam::BODY_MASS );
+        mjtNum* body_subtreemass = overlay->Materialize( mujoco::eMujocoModelParam::BODY_SUBTREEMASS );
+        mjtNum* body_inertia = overlay->Materialize( mujoco::eMujocoModelParam::BODY_INERTIA );
+        const mjtNum mass_delta = mass - body_mass[body_id];
+        const mjtNum mass_scale = ( body_mass[body_id] > 0.0 ) ? mass / body_mass[body_id] : 1.0;
+        body_mass[body_id] = mass;
+        mju_scl3( body_inertia + 3 * body_id, body_inertia + 3 * body_id, mass_scale );
+        // Subtree masses are used to compute the subtrees' com (on every step), so update the whole chain up to the world
+        const mjModel* mjc_model = overlay->mjc_model();
+        for ( ssize_t id = body_id; id > 0; id = mjc_model->body_parentid[id] )
+            body_subtreemass[id] += mass_delta;
+        body_subtreemass[0] += mass_delta;
+    }
+
+    void TMujocoBatchSimulation::SetDofDamping( ssize_t env_id, ssize_t dof_id, const TScalar& damping )
+    {
+        LOCO_CORE_ASSERT( m_Initialized, "TMujocoBatchSimulation::SetDofDamping >>> batch must be initialized first" );
+        LOCO_CORE_ASSERT( env_id >= 0 && env_id < m_NumEnvs, "TMujocoBatchSimulation::SetDofDamping >>> env-id {0} \
+                          out of range [0,{1})", env_id, m_NumEnvs );
+        LOCO_CORE_ASSERT( dof_id >= 0 && dof_id < m_Simulation->mjc_model()->nv, "TMujocoBatchSimulation::SetDofDamping >>> \
+                          dof-id {0} out of range", dof_id );
+
+        _SyncEnvDatas();
+        _SyncEnvModel( env_id );
+        mjtNum* dof_damping = m_MjcModelOverlays[env_id]->Materialize( mujoco::eMujocoModelParam::DOF_DAMPING );
+        dof_damping[dof_id] = damping;
+    }
+
+    mjModel* TMujocoBatchSimulation::MakeEnvModelPrivate( ssize_t env_id )
+    {
+        LOCO_CORE_ASSERT( m_Initialized, "TMujocoBatchSimulation::MakeEnvModelPrivate >>> batch must be initialized first" );
+        LOCO_CORE_ASSERT( env_id >= 0 && env_id < m_NumEnvs, "TMujocoBatchSimulation::MakeEnvModelPrivate >>> env-id {0} \
+                          out of range [0,{1})", env_id, m_NumEnvs );
+
+        _SyncEnvDatas();
+        _SyncEnvModel( env_id );
+        return m_MjcModelOverlays[env_id]->MakePrivate();
+    }
+
+    void TMujocoBatchSimulation::ClearEnvParams( ssize_t env_id )
+    {
+        LOCO_CORE_ASSERT( m_Initialized, "TMujocoBatchSimulation::ClearEnvParams >>> batch must be initialized first" );
+        LOCO_CORE_ASSERT( env_id >= 0 && env_id < m_NumEnvs, "TMujocoBatchSimulation::ClearEnvParams >>> env-id {0} \
+                          out of range [0,{1})", env_id, m_NumEnvs );
+
+        _SyncEnvDatas();
+        _SyncEnvModel( env_id );
+        m_MjcModelOverlays[env_id]->Clear();
+    }
+
+    ssize_t TMujocoBatchSimulation::shared_model_num_bytes() const
+    {
+        const mjModel* mjc_model = m_Simulation->mjc_model();
+        return mjc_model ? sizeof( mjModel ) + mjc_model->nbuffer : 0;
+    }
+
+    void TMujocoBatchSimulation::_CreateEnvDatas()
+    {
+        const mjModel* mjc_model = m_Simulation->mjc_model();
+        m_MjcDataInit = std::unique_ptr<mjData, mujoco::MjcDataDeleter>( mj_makeData( mjc_model ) );
+        mujoco::CopyMjcState( mjc_model, m_MjcDataInit.get(), m_Simulation->mjc_data() );
+
+        m_MjcDatas.clear();
+        m_MjcModelOverlays.clear();
+        for ( ssize_t i = 0; i < m_NumEnvs; i++ )
+        {
+            m_MjcDatas.push_back( std::unique_ptr<mjData, mujoco::MjcDataDeleter>( mj_makeData( mjc_model ) ) );
+            m_MjcModelOverlays.push_back( std::make_unique<mujoco::TMujocoModelOverlay>( mjc_model ) );
+        }
+        m_MjcDatasLayout = _MjcDataLayout( mjc_model );
+    }
+
+    void TMujocoBatchSimulation::_SyncEnvDatas()
+    {
+        // A model replaced by a copy (e.g. copy-on-write) keeps its sizes, so only the views need a refresh (see
+        // _SyncEnvModel). A rebuilt one usually doesn't, and mjData sized for the old one can't be stepped with it
+        if ( _MjcDataLayout( m_Simulation->mjc_model() ) == m_MjcDatasLayout )
+            return;
+
+        LOCO_CORE_WARN( "TMujocoBatchSimulation::_SyncEnvDatas >>> the shared model changed its sizes, so the {0} \
+                         environments are re-created from the internal simulation's state (dropping their parameters)",
+                        m_NumEnvs );
+        _CreateEnvDatas();
+        m_ThreadPool->ParallelFor( m_NumEnvs, [&]( ssize_t env_id )
+            {
+                mujoco::CopyMjcState( m_Simulation->mjc_model(), m_MjcDatas[env_id].get(), m_MjcDataInit.get() );
+                mj_forward( m_MjcModelOverlays[env_id]->mjc_model(), m_MjcDatas[env_id].get() );
+            } );
+    }
+
+    void TMujocoBatchSimulation::_SyncEnvModel( ssize_t env_id )
+    {
+        // The internal simulation's model might have changed since (e.g. options) or been replaced, so refresh the view
+        m_MjcModelOverlays[env_id]->Sync( m_Simulation->mjc_model() );
+    }
+
+    std::vector<int> TMujocoBatchSimulation::_MjcDataLayout( const mjModel* mjc_model )
+    {
+        if ( !mjc_model )
+            return {};
+        return { mjc_model->nq, mjc_model->nv, mjc_model->nu, mjc_model->na, mjc_model->nbody, mjc_model->njnt,
+                 mjc_model->ngeom, mjc_model->nsite, mjc_model->ncam, mjc_model->nlight, mjc_model->ntendon,
+                 mjc_model->nwrap, mjc_model->neq, mjc_model->nmocap, mjc_model->nsensordata, mjc_model->nuserdata,
+                 mjc_model->nM, mjc_model->njmax, mjc_model->nconmax, mjc_model->nstack };
+    }
+
+    ssize_t TMujocoBatchSimulation::_NumSubsteps( const TScalar& dt ) const
+    {
+        const mjtNum time_step = m_Simulation->mjc_model()->opt.timestep;
+        if ( m_Simulation->num_substeps() > 0 )
+            return m_Simulation->num_substeps();
+        if ( dt <= 0.0f )
+            return 1;
+        return std::max<ssize_t>( 1, std::lround( dt / time_step ) );
+    }
+
+    void TMujocoBatchSimulation::_GatherArray( std::vector<TScalar>& dst_batch, ssize_t array_size,
+                                               const std::function<const mjtNum*( const mjData* )>& array_getter ) const
+    {
+        LOCO_CORE_ASSERT( m_Initialized, "TMujocoBatchSimulation::_GatherArray >>> batch must be initialized first" );
+        // Gathering doesn't modify the batch, so environments of a resized model aren't re-created here
+        if ( _MjcDataLayout( m_Simulation->mjc_model() ) != m_MjcDatasLayout )
+        {
+            LOCO_CORE_ERROR( "TMujocoBatchSimulation::_GatherArray >>> the shared model changed its sizes, so the \
+                              environments must be stepped|reset first (to re-create them)" );
+            dst_batch.clear();
+            return;
+        }
+
+        dst_batch.resize( m_NumEnvs * array_size );
+        m_ThreadPool->ParallelFor( m_NumEnvs, [&]( ssize_t env_id )
+            {
+                const mjtNum* src_array = array_getter( m_MjcDatas[env_id].get() );
+                for ( ssize_t j = 0; j < array_size; j++ )
+                    dst_batch[env_id * array_size + j] = (TScalar) src_array[j];
+            } );
+    }
+}
\ No newline at end of file
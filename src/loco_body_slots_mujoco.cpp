@@ -0,0 +1,246 @@
+#include <loco_body_slots_mujoco.h>
+#include <limits>
+
+namespace loco {
+namespace mujoco {
+
+    TMujocoBodySlotsManager::TMujocoBodySlotsManager( mjModel* mjc_model_ref, mjData* mjc_data_ref )
+        : m_MjcModelRef( mjc_model_ref ), m_MjcDataRef( mjc_data_ref )
+    {
+        LOCO_CORE_ASSERT( m_MjcModelRef, "TMujocoBodySlotsManager >>> requires a valid mjModel reference" );
+        LOCO_CORE_ASSERT( m_MjcDataRef, "TMujocoBodySlotsManager >>> requires a valid mjData reference" );
+    }
+
+    ssize_t TMujocoBodySlotsManager::ParkSingleBody( primitives::TMujocoSingleBodyAdapter* single_body_adapter )
+    {
+        const auto single_body = single_body_adapter->body();
+        TMujocoBodySlot slot;
+        slot.body_id = single_body_adapter->mjc_body_id();
+        slot.geom_id = single_body_adapter->mjc_geom_id();
+        slot.shape = single_body->collider()->shape();
+        slot.size = single_body->collider()->size();
+        if ( slot.body_id < 0 && slot.geom_id < 0 )
+        {
+            LOCO_CORE_WARN( "TMujocoBodySlotsManager::ParkSingleBody >>> single-body {0} isn't linked to \
+                             the model, can't park it", single_body->name() );
+            return -1;
+        }
+
+        const ssize_t joint_id = single_body_adapter->mjc_joint_id();
+        if ( joint_id >= 0 && m_MjcModelRef->jnt_type[joint_id] == mjJNT_FREE )
+        {
+            slot.joint_id = joint_id;
+            slot.qpos_adr = single_body_adapter->mjc_joint_qpos_adr();
+            slot.qvel_adr = single_body_adapter->mjc_joint_qvel_adr();
+        }
+        if ( slot.geom_id >= 0 )
+        {
+            slot.contype = m_MjcModelRef->geom_contype[slot.geom_id];
+            slot.conaffinity = m_MjcModelRef->geom_conaffinity[slot.geom_id];
+        }
+        if ( slot.body_id >= 0 )
+        {
+            const ssize_t dof_adr = m_MjcModelRef->body_dofadr[slot.body_id];
+            const ssize_t dof_num = std::min<ssize_t>( 6, m_MjcModelRef->body_dofnum[slot.body_id] );
+            for ( ssize_t i = 0; i < dof_num; i++ )
+                slot.dof_damping[i] = m_MjcModelRef->dof_damping[dof_adr + i];
+        }
+
+        const ssize_t slot_id = _AddParkedSlot( slot );
+        LOCO_CORE_TRACE( "TMujocoBodySlotsManager::ParkSingleBody >>> parked single-body {0} into slot {1} (rest-cell {2})",
+                         single_body->name(), slot_id, m_Slots[slot_id].rest_cell );
+        return slot_id;
+    }
+
+    ssize_t TMujocoBodySlotsManager::AddReservedSlot( ssize_t mjc_body_id, ssize_t mjc_geom_id, const eShapeType& shape, const TVec3& size )
+    {
+        LOCO_CORE_ASSERT( mjc_body_id > 0 && mjc_body_id < m_MjcModelRef->nbody, "TMujocoBodySlotsManager::AddReservedSlot >>> \
+                          mjc-body id {0} out of range", mjc_body_id );
+        LOCO_CORE_ASSERT( mjc_geom_id >= 0 && mjc_geom_id < m_MjcModelRef->ngeom, "TMujocoBodySlotsManager::AddReservedSlot >>> \
+                          mjc-geom id {0} out of range", mjc_geom_id );
+
+        TMujocoBodySlot slot;
+        slot.body_id = mjc_body_id;
+        slot.geom_id = mjc_geom_id;
+        slot.shape = shape;
+        slot.size = size;
+        slot.joint_id = m_MjcModelRef->body_jntadr[mjc_body_id];
+        if ( slot.joint_id < 0 || m_MjcModelRef->jnt_type[slot.joint_id] != mjJNT_FREE )
+        {
+            LOCO_CORE_ERROR( "TMujocoBodySlotsManager::AddReservedSlot >>> reserved mjc-body {0} must have a free-joint", mjc_body_id );
+            return -1;
+        }
+        slot.qpos_adr = m_MjcModelRef->jnt_qposadr[slot.joint_id];
+        slot.qvel_adr = m_MjcModelRef->jnt_dofadr[slot.joint_id];
+        // Reserved geoms are compiled without collisions, so give them the default collision bits once taken
+        slot.contype = 1;
+        slot.conaffinity = 1;
+        for ( ssize_t i = 0; i < 6; i++ )
+            slot.dof_damping[i] = m_MjcModelRef->dof_damping[slot.qvel_adr + i];
+        return _AddParkedSlot( slot );
+    }
+
+    ssize_t TMujocoBodySlotsManager::_AddParkedSlot( TMujocoBodySlot slot )
+    {
+        const ssize_t slot_id = m_Slots.size();
+        m_Slots.push_back( slot );
+        _Park( m_Slots.back() );
+
+        // Only free-bodies with primitive shapes can be reconfigured in place for another single-body
+        const bool is_primitive = ( slot.shape != eShapeType::CONVEX_MESH && slot.shape != eShapeType::HEIGHTFIELD &&
+                                    slot.shape != eShapeType::COMPOUND && slot.shape != eShapeType::PLANE );
+        if ( slot.joint_id >= 0 && slot.geom_id >= 0 && is_primitive )
+            m_FreeSlots.push_back( slot_id );
+        return slot_id;
+    }
+
+    ssize_t TMujocoBodySlotsManager::AcquireSlot( primitives::TSingleBody* single_body )
+    {
+        if ( single_body->dyntype() != eDynamicsType::DYNAMIC || single_body->constraint() )
+            return -1;
+
+        // Take the slot of the same shape whose size-class is the closest to the body's size
+        const eShapeType shape = single_body->collider()->shape();
+        const TVec3 size = single_body->collider()->size();
+        ssize_t best_index = -1;
+        TScalar best_distance = std::numeric_limits<TScalar>::max();
+        for ( ssize_t i = 0; i < m_FreeSlots.size(); i++ )
+        {
+            const auto& slot = m_Slots[m_FreeSlots[i]];
+            if ( slot.shape != shape )
+                continue;
+            const TScalar distance = std::abs( slot.size.x() - size.x() ) + std::abs( slot.size.y() - size.y() ) +
+                                     std::abs( slot.size.z() - size.z() );
+            if ( distance < best_distance )
+            {
+                best_distance = distance;
+                best_index = i;
+            }
+        }
+        if ( best_index < 0 )
+            return -1;
+
+        const ssize_t slot_id = m_FreeSlots[best_index];
+        m_FreeSlots.erase( m_FreeSlots.begin() + best_index );
+        _Unpark( m_Slots[slot_id] );
+        return slot_id;
+    }
+
+    void TMujocoBodySlotsManager::CopySlotsFrom( const TMujocoBodySlotsManager& other )
+    {
+        m_Slots = other.m_Slots;
+        m_FreeSlots = other.m_FreeSlots;
+        m_FreeRestCells = other.m_FreeRestCells;
+        m_NumRestCells = other.m_NumRestCells;
+    }
+
+    void TMujocoBodySlotsManager::RefreshParked()
+    {
+        for ( auto& slot : m_Slots )
+            if ( slot.rest_cell >= 0 )
+                _Park( slot );
+    }
+
+    void TMujocoBodySlotsManager::HoldParked()
+    {
+        for ( auto& slot : m_Slots )
+        {
+            if ( slot.rest_cell < 0 || slot.joint_id < 0 )
+                continue;
+            const TVec3 rest_position = RestCellPosition( slot.rest_cell );
+            mjtNum* qpos = m_MjcDataRef->qpos + slot.qpos_adr;
+            qpos[0] = rest_position.x(); qpos[1] = rest_position.y(); qpos[2] = rest_position.z();
+            qpos[3] = 1.0; qpos[4] = 0.0; qpos[5] = 0.0; qpos[6] = 0.0;
+            mju_zero( m_MjcDataRef->qvel + slot.qvel_adr, 6 );
+        }
+    }
+
+    void TMujocoBodySlotsManager::_Park( TMujocoBodySlot& slot )
+    {
+        if ( slot.rest_cell < 0 )
+        {
+            if ( m_FreeRestCells.size() > 0 )
+            {
+                slot.rest_cell = m_FreeRestCells.back();
+                m_FreeRestCells.pop_back();
+            }
+            else
+            {
+                slot.rest_cell = m_NumRestCells++;
+            }
+        }
+
+        const TVec3 rest_position = RestCellPosition( slot.rest_cell );
+        if ( slot.geom_id >= 0 )
+        {
+            _SetMjcModelValue( &mjModel::geom_contype, slot.geom_id, 0 );
+            _SetMjcModelValue( &mjModel::geom_conaffinity, slot.geom_id, 0 );
+        }
+
+        if ( slot.joint_id >= 0 )
+        {
+            mjtNum* qpos = m_MjcDataRef->qpos + slot.qpos_adr;
+            qpos[0] = rest_position.x(); qpos[1] = rest_position.y(); qpos[2] = rest_position.z();
+            qpos[3] = 1.0; qpos[4] = 0.0; qpos[5] = 0.0; qpos[6] = 0.0;
+        }
+        else if ( slot.body_id > 0 && m_MjcModelRef->body_dofnum[slot.body_id] == 0 )
+        {
+            for ( ssize_t i = 0; i < 3; i++ )
+                _SetMjcModelValue( &mjModel::body_pos, 3 * slot.body_id + i, rest_position[i] );
+        }
+        else if ( slot.body_id < 0 && slot.geom_id >= 0 )
+        {
+            for ( ssize_t i = 0; i < 3; i++ )
+                _SetMjcModelValue( &mjModel::geom_pos, 3 * slot.geom_id + i, rest_position[i] );
+        }
+
+        if ( slot.body_id > 0 )
+        {
+            // Freeze the dofs: no velocity, gravity cancelled at the com, and damping large enough to absorb the rest
+            const ssize_t dof_adr = m_MjcModelRef->body_dofadr[slot.body_id];
+            const ssize_t dof_num = m_MjcModelRef->body_dofnum[slot.body_id];
+            const bool implicit_damping = ( m_MjcModelRef->opt.integrator == mjINT_EULER );
+            for ( ssize_t i = 0; i < dof_num; i++ )
+            {
+                m_MjcDataRef->qvel[dof_adr + i] = 0.0;
+                if ( implicit_damping )
+                    _SetMjcModelValue( &mjModel::dof_damping, dof_adr + i, LOCO_MUJOCO_PARKED_DOF_DAMPING );
+            }
+            if ( dof_num > 0 )
+            {
+                mjtNum* xfrc = m_MjcDataRef->xfrc_applied + 6 * slot.body_id;
+                const mjtNum mass = m_MjcModelRef->body_mass[slot.body_id];
+                mju_scl3( xfrc, m_MjcModelRef->opt.gravity, -mass );
+                mju_zero3( xfrc + 3 );
+            }
+        }
+    }
+
+    void TMujocoBodySlotsManager::_Unpark( TMujocoBodySlot& slot )
+    {
+        if ( slot.geom_id >= 0 )
+        {
+            _SetMjcModelValue( &mjModel::geom_contype, slot.geom_id, slot.contype );
+            _SetMjcModelValue( &mjModel::geom_conaffinity, slot.geom_id, slot.conaffinity );
+        }
+        if ( slot.body_id > 0 )
+        {
+            const ssize_t dof_adr = m_MjcModelRef->body_dofadr[slot.body_id];
+            const ssize_t dof_num = std::min<ssize_t>( 6, m_MjcModelRef->body_dofnum[slot.body_id] );
+            for ( ssize_t i = 0; i < dof_num; i++ )
+                _SetMjcModelValue( &mjModel::dof_damping, dof_adr + i, slot.dof_damping[i] );
+            mju_zero( m_MjcDataRef->xfrc_applied + 6 * slot.body_id, 6 );
+        }
+        m_FreeRestCells.push_back( slot.rest_cell );
+        slot.rest_cell = -1;
+    }
+
+    TVec3 TMujocoBodySlotsManager::RestCellPosition( ssize_t rest_cell )
+    {
+        using namespace primitives;
+        return DETACHED_REST_GRID_START +
+               TVec3( ( rest_cell % DETACHED_REST_GRID_SIZE ) * DETACHED_REST_GRID_DELTA.x(),
+                      ( ( rest_cell / DETACHED_REST_GRID_SIZE ) % DETACHED_REST_GRID_SIZE ) * DETACHED_REST_GRID_DELTA.y(),
+                      ( rest_cell / DETACHED_REST_GRID_SIZE_POW2 ) * DETACHED_REST_GRID_DELTA.z() );
+    }
+}}
\ No newline at end of file
@@ -1,5 +1,10 @@
 
 #include <loco_common_mujoco.h>
+#include <cstring>
+#include <limits>
+#if defined( __AVX__ )
+    #include <immintrin.h>
+#endif
 
 namespace loco {
 namespace mujoco {
@@ -16,6 +21,156 @@ namespace mujoco {
         mj_deleteData( data );
     }
 
+    static ssize_t _NumObjectsOfType( const mjModel* mjc_model, const mjtObj& obj_type )
+    {
+        switch ( obj_type )
+        {
+            case mjOBJ_BODY     : return mjc_model->nbody;
+            case mjOBJ_XBODY    : return mjc_model->nbody;
+            case mjOBJ_JOINT    : return mjc_model->njnt;
+            case mjOBJ_GEOM     : return mjc_model->ngeom;
+            case mjOBJ_SITE     : return mjc_model->nsite;
+            case mjOBJ_CAMERA   : return mjc_model->ncam;
+            case mjOBJ_LIGHT    : return mjc_model->nlight;
+            case mjOBJ_MESH     : return mjc_model->nmesh;
+            case mjOBJ_SKIN     : return mjc_model->nskin;
+            case mjOBJ_HFIELD   : return mjc_model->nhfield;
+            case mjOBJ_TEXTURE  : return mjc_model->ntex;
+            case mjOBJ_MATERIAL : return mjc_model->nmat;
+            case mjOBJ_PAIR     : return mjc_model->npair;
+            case mjOBJ_EXCLUDE  : return mjc_model->nexclude;
+            case mjOBJ_EQUALITY : return mjc_model->neq;
+            case mjOBJ_TENDON   : return mjc_model->ntendon;
+            case mjOBJ_ACTUATOR : return mjc_model->nu;
+            case mjOBJ_SENSOR   : return mjc_model->nsensor;
+            case mjOBJ_NUMERIC  : return mjc_model->nnumeric;
+            case mjOBJ_TEXT     : return mjc_model->ntext;
+            case mjOBJ_TUPLE    : return mjc_model->ntuple;
+            case mjOBJ_KEY      : return mjc_model->nkey;
+            default             : return 0; // unknown and dofs don't have names
+        }
+    }
+
+    void TMujocoNameIndex::Build( const mjModel* mjc_model )
+    {
+        LOCO_CORE_ASSERT( mjc_model, "TMujocoNameIndex::Build >>> must have a valid mjModel reference, but got nullptr" );
+        Clear();
+        for ( ssize_t type = 0; type < LOCO_MUJOCO_NUM_OBJ_TYPES; type++ )
+        {
+            const ssize_t num_objects = _NumObjectsOfType( mjc_model, (mjtObj)type );
+            auto& names_to_ids = m_NamesToIds[type];
+            names_to_ids.reserve( num_objects );
+            for ( ssize_t id = 0; id < num_objects; id++ )
+            {
+                // mj_id2name is a direct lookup into the names buffer (no scan involved)
+                const char* obj_name = mj_id2name( mjc_model, type, id );
+                if ( obj_name && obj_name[0] != '\0' )
+                    names_to_ids.emplace( obj_name, id );
+            }
+        }
+        m_Built = true;
+    }
+
+    void TMujocoNameIndex::Clear()
+    {
+        for ( auto& names_to_ids : m_NamesToIds )
+            names_to_ids.clear();
+        m_Built = false;
+    }
+
+    ssize_t TMujocoNameIndex::GetId( const mjtObj& obj_type, const std::string& name ) const
+    {
+        const auto& names_to_ids = m_NamesToIds[obj_type];
+        auto it_name_id = names_to_ids.find( name );
+        return ( it_name_id != names_to_ids.end() ) ? it_name_id->second : -1;
+    }
+
+    ssize_t mjc_name2id( const mjModel* mjc_model, const TMujocoNameIndex* name_index,
+                         const mjtObj& obj_type, const std::string& name )
+    {
+        if ( name_index && name_index->built() )
+            return name_index->GetId( obj_type, name );
+        return mj_name2id( mjc_model, obj_type, name.c_str() );
+    }
+
+    void CopyMjcState( const mjModel* mjc_model, mjData* dst_mjc_data, const mjData* src_mjc_data )
+    {
+        LOCO_CORE_ASSERT( mjc_model, "CopyMjcState >>> must have a valid mjModel reference, but got nullptr" );
+        LOCO_CORE_ASSERT( dst_mjc_data && src_mjc_data, "CopyMjcState >>> must have valid mjData references, but got nullptr" );
+
+        dst_mjc_data->time = src_mjc_data->time;
+        mju_copy( dst_mjc_data->qpos, src_mjc_data->qpos, mjc_model->nq );
+        mju_copy( dst_mjc_data->qvel, src_mjc_data->qvel, mjc_model->nv );
+        mju_copy( dst_mjc_data->act, src_mjc_data->act, mjc_model->na );
+        mju_copy( dst_mjc_data->ctrl, src_mjc_data->ctrl, mjc_model->nu );
+        mju_copy( dst_mjc_data->qacc_warmstart, src_mjc_data->qacc_warmstart, mjc_model->nv );
+        mju_copy( dst_mjc_data->qfrc_applied, src_mjc_data->qfrc_applied, mjc_model->nv );
+        mju_copy( dst_mjc_data->xfrc_applied, src_mjc_data->xfrc_applied, 6 * mjc_model->nbody );
+        mju_copy( dst_mjc_data->mocap_pos, src_mjc_data->mocap_pos, 3 * mjc_model->nmocap );
+        mju_copy( dst_mjc_data->mocap_quat, src_mjc_data->mocap_quat, 4 * mjc_model->nmocap );
+        mju_copy( dst_mjc_data->userdata, src_mjc_data->userdata, mjc_model->nuserdata );
+    }
+
+    ssize_t TransferMjcStateByName( const mjModel* src_mjc_model, const mjData* src_mjc_data,
+                                    const mjModel* dst_mjc_model, mjData* dst_mjc_data, const TMujocoNameIndex* dst_name_index )
+    {
+        LOCO_CORE_ASSERT( src_mjc_model && dst_mjc_model, "TransferMjcStateByName >>> must have valid mjModel references, but got nullptr" );
+        LOCO_CORE_ASSERT( src_mjc_data && dst_mjc_data, "TransferMjcStateByName >>> must have valid mjData references, but got nullptr" );
+
+        ssize_t num_transferred = 0;
+        for ( ssize_t src_jnt_id = 0; src_jnt_id < src_mjc_model->njnt; src_jnt_id++ )
+        {
+            const char* jnt_name = mj_id2name( src_mjc_model, mjOBJ_JOINT, src_jnt_id );
+            if ( !jnt_name )
+                continue;
+            const ssize_t dst_jnt_id = mjc_name2id( dst_mjc_model, dst_name_index, mjOBJ_JOINT, jnt_name );
+            if ( dst_jnt_id < 0 || dst_mjc_model->jnt_type[dst_jnt_id] != src_mjc_model->jnt_type[src_jnt_id] )
+                continue;
+
+            const int jnt_type = src_mjc_model->jnt_type[src_jnt_id];
+            const ssize_t qpos_num = ( jnt_type == mjJNT_FREE ) ? 7 : ( ( jnt_type == mjJNT_BALL ) ? 4 : 1 );
+            const ssize_t qvel_num = ( jnt_type == mjJNT_FREE ) ? 6 : ( ( jnt_type == mjJNT_BALL ) ? 3 : 1 );
+            const ssize_t src_qposadr = src_mjc_model->jnt_qposadr[src_jnt_id];
+            const ssize_t dst_qposadr = dst_mjc_model->jnt_qposadr[dst_jnt_id];
+            const ssize_t src_dofadr = src_mjc_model->jnt_dofadr[src_jnt_id];
+            const ssize_t dst_dofadr = dst_mjc_model->jnt_dofadr[dst_jnt_id];
+            mju_copy( dst_mjc_data->qpos + dst_qposadr, src_mjc_data->qpos + src_qposadr, qpos_num );
+            mju_copy( dst_mjc_data->qvel + dst_dofadr, src_mjc_data->qvel + src_dofadr, qvel_num );
+            mju_copy( dst_mjc_data->qacc_warmstart + dst_dofadr, src_mjc_data->qacc_warmstart + src_dofadr, qvel_num );
+            mju_copy( dst_mjc_data->qfrc_applied + dst_dofadr, src_mjc_data->qfrc_applied + src_dofadr, qvel_num );
+            num_transferred++;
+        }
+
+        // Actuators with activations are placed last, so act[i] belongs to actuator (nu - na + i)
+        for ( ssize_t src_act_id = 0; src_act_id < src_mjc_model->nu; src_act_id++ )
+        {
+            const char* act_name = mj_id2name( src_mjc_model, mjOBJ_ACTUATOR, src_act_id );
+            if ( !act_name )
+                continue;
+            const ssize_t dst_act_id = mjc_name2id( dst_mjc_model, dst_name_index, mjOBJ_ACTUATOR, act_name );
+            if ( dst_act_id < 0 )
+                continue;
+            dst_mjc_data->ctrl[dst_act_id] = src_mjc_data->ctrl[src_act_id];
+            const ssize_t src_act_adr = src_act_id - ( src_mjc_model->nu - src_mjc_model->na );
+            const ssize_t dst_act_adr = dst_act_id - ( dst_mjc_model->nu - dst_mjc_model->na );
+            if ( src_act_adr >= 0 && dst_act_adr >= 0 )
+                dst_mjc_data->act[dst_act_adr] = src_mjc_data->act[src_act_adr];
+        }
+
+        for ( ssize_t src_body_id = 1; src_body_id < src_mjc_model->nbody; src_body_id++ )
+        {
+            const char* body_name = mj_id2name( src_mjc_model, mjOBJ_BODY, src_body_id );
+            if ( !body_name )
+                continue;
+            const ssize_t dst_body_id = mjc_name2id( dst_mjc_model, dst_name_index, mjOBJ_BODY, body_name );
+            if ( dst_body_id > 0 )
+                mju_copy( dst_mjc_data->xfrc_applied + 6 * dst_body_id, src_mjc_data->xfrc_applied + 6 * src_body_id, 6 );
+        }
+
+        dst_mjc_data->time = src_mjc_data->time;
+        return num_transferred;
+    }
+
     TVec4 quat_to_mjcQuat( const TVec4& quat )
     {
         return TVec4( quat.w(), quat.x(), quat.y(), quat.z() );
@@ -75,6 +230,24 @@ namespace mujoco {
         return "";
     }
 
+    eShapeType mjcGeomType_to_shape( int geom_type )
+    {
+        switch ( geom_type )
+        {
+            case mjGEOM_PLANE       : return eShapeType::PLANE;
+            case mjGEOM_HFIELD      : return eShapeType::HEIGHTFIELD;
+            case mjGEOM_SPHERE      : return eShapeType::SPHERE;
+            case mjGEOM_CAPSULE     : return eShapeType::CAPSULE;
+            case mjGEOM_ELLIPSOID   : return eShapeType::ELLIPSOID;
+            case mjGEOM_CYLINDER    : return eShapeType::CYLINDER;
+            case mjGEOM_BOX         : return eShapeType::BOX;
+            case mjGEOM_MESH        : return eShapeType::CONVEX_MESH;
+        }
+
+        LOCO_CORE_ERROR( "mjcGeomType_to_shape >>> unsupported mjc-geom type: {0}", geom_type );
+        return eShapeType::BOX;
+    }
+
     // @todo: move to loco-core
     // @todo: check against mujoco-rbound (at least, capsules are different)
     double compute_primitive_rbound( const eShapeType& shape, const TVec3& size )
@@ -110,6 +283,139 @@ namespace mujoco {
         return 1.0;
     }
 
+    TVec3 compute_primitive_inertia( const eShapeType& shape, const TVec3& size, double mass )
+    {
+        switch ( shape )
+        {
+            case eShapeType::BOX :
+            {
+                const double xx = size.x() * size.x(), yy = size.y() * size.y(), zz = size.z() * size.z();
+                return TVec3( mass * ( yy + zz ) / 12., mass * ( xx + zz ) / 12., mass * ( xx + yy ) / 12. );
+            }
+            case eShapeType::SPHERE :
+            {
+                const double ii = 0.4 * mass * size.x() * size.x();
+                return TVec3( ii, ii, ii );
+            }
+            case eShapeType::ELLIPSOID :
+            {
+                const double xx = size.x() * size.x(), yy = size.y() * size.y(), zz = size.z() * size.z();
+                return TVec3( mass * ( yy + zz ) / 5., mass * ( xx + zz ) / 5., mass * ( xx + yy ) / 5. );
+            }
+            case eShapeType::CYLINDER :
+            {
+                const double rr = size.x() * size.x(), hh = size.y() * size.y();
+                const double ii = mass * ( 3. * rr + hh ) / 12.;
+                return TVec3( ii, ii, 0.5 * mass * rr );
+            }
+            case eShapeType::CAPSULE :
+            {
+                // Cylinder plus two hemispheres (mass split by volume), hemispheres shifted to the cylinder's caps
+                const double r = size.x(), h = size.y();
+                const double vol_cylinder = loco::PI * r * r * h;
+                const double vol_sphere = (4. / 3.) * loco::PI * r * r * r;
+                const double mass_cylinder = mass * vol_cylinder / ( vol_cylinder + vol_sphere );
+                const double mass_sphere = mass - mass_cylinder;
+                const double ii = mass_cylinder * ( h * h / 12. + r * r / 4. ) +
+                                  mass_sphere * ( 0.4 * r * r + h * h / 4. + 3. * h * r / 8. );
+                return TVec3( ii, ii, 0.5 * mass_cylinder * r * r + 0.4 * mass_sphere * r * r );
+            }
+        }
+
+        LOCO_CORE_ERROR( "compute_primitive_inertia >>> unsupported shape: {0}", ToString( shape ) );
+        return TVec3( mass, mass, mass );
+    }
+
+    void hfield_normalize( float* dst, const float* heights, ssize_t num_samples, float inv_max_height )
+    {
+        ssize_t i = 0;
+    #if defined( __AVX__ )
+        const __m256 v_scale = _mm256_set1_ps( inv_max_height );
+        const __m256 v_zero = _mm256_setzero_ps();
+        for ( ; i + 8 <= num_samples; i += 8 )
+            _mm256_storeu_ps( dst + i, _mm256_max_ps( v_zero, _mm256_mul_ps( _mm256_loadu_ps( heights + i ), v_scale ) ) );
+    #endif
+        for ( ; i < num_samples; i++ )
+            dst[i] = std::max( 0.0f, heights[i] * inv_max_height );
+    }
+
+    float hfield_max( const float* heights, ssize_t num_samples )
+    {
+        LOCO_CORE_ASSERT( num_samples > 0, "hfield_max >>> requires at least one sample" );
+        float max_height = heights[0];
+        ssize_t i = 0;
+    #if defined( __AVX__ )
+        if ( num_samples >= 8 )
+        {
+            __m256 v_max = _mm256_loadu_ps( heights );
+            for ( i = 8; i + 8 <= num_samples; i += 8 )
+                v_max = _mm256_max_ps( v_max, _mm256_loadu_ps( heights + i ) );
+            // Horizontal reduction of the 8 lanes
+            __m128 v_max_4 = _mm_max_ps( _mm256_castps256_ps128( v_max ), _mm256_extractf128_ps( v_max, 1 ) );
+            v_max_4 = _mm_max_ps( v_max_4, _mm_movehl_ps( v_max_4, v_max_4 ) );
+            v_max_4 = _mm_max_ss( v_max_4, _mm_shuffle_ps( v_max_4, v_max_4, 1 ) );
+            max_height = _mm_cvtss_f32( v_max_4 );
+        }
+    #endif
+        for ( ; i < num_samples; i++ )
+            max_height = std::max( max_height, heights[i] );
+        return max_height;
+    }
+
+    void compute_vertices_aabb( const float* vertices, ssize_t num_vertices, TVec3& dst_aabb_min, TVec3& dst_aabb_max )
+    {
+        float aabb_min[3] = { std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+        float aabb_max[3] = { std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+        ssize_t i = 0;
+    #if defined( __AVX__ )
+        if ( num_vertices >= 8 )
+        {
+            // 8 vertices (24 floats) per iteration, as 3 registers whose lanes hold components (8 * k + lane) % 3
+            __m256 v_min[3], v_max[3];
+            for ( ssize_t k = 0; k < 3; k++ )
+                v_min[k] = v_max[k] = _mm256_loadu_ps( vertices + 8 * k );
+            for ( i = 8; i + 8 <= num_vertices; i += 8 )
+            {
+                for ( ssize_t k = 0; k < 3; k++ )
+                {
+                    const __m256 v_data = _mm256_loadu_ps( vertices + 3 * i + 8 * k );
+                    v_min[k] = _mm256_min_ps( v_min[k], v_data );
+                    v_max[k] = _mm256_max_ps( v_max[k], v_data );
+                }
+            }
+            float lanes_min[24], lanes_max[24];
+            for ( ssize_t k = 0; k < 3; k++ )
+            {
+                _mm256_storeu_ps( lanes_min + 8 * k, v_min[k] );
+                _mm256_storeu_ps( lanes_max + 8 * k, v_max[k] );
+            }
+            for ( ssize_t j = 0; j < 24; j++ )
+            {
+                aabb_min[j % 3] = std::min( aabb_min[j % 3], lanes_min[j] );
+                aabb_max[j % 3] = std::max( aabb_max[j % 3], lanes_max[j] );
+            }
+        }
+    #endif
+        for ( ; i < num_vertices; i++ )
+        {
+            for ( ssize_t k = 0; k < 3; k++ )
+            {
+                aabb_min[k] = std::min( aabb_min[k], vertices[3 * i + k] );
+                aabb_max[k] = std::max( aabb_max[k], vertices[3 * i + k] );
+            }
+        }
+        dst_aabb_min = { aabb_min[0], aabb_min[1], aabb_min[2] };
+        dst_aabb_max = { aabb_max[0], aabb_max[1], aabb_max[2] };
+    }
+
+    double compute_aabb_rbound( const TVec3& aabb_min, const TVec3& aabb_max )
+    {
+        const double extent_x = std::max( std::abs( aabb_min.x() ), std::abs( aabb_max.x() ) );
+        const double extent_y = std::max( std::abs( aabb_min.y() ), std::abs( aabb_max.y() ) );
+        const double extent_z = std::max( std::abs( aabb_min.z() ), std::abs( aabb_max.z() ) );
+        return std::sqrt( extent_x * extent_x + extent_y * extent_y + extent_z * extent_z );
+    }
+
     TSizef mjarray_to_sizef( const mjtNum* array_num, size_t array_size )
     {
         TSizef arr_sf;
@@ -126,37 +432,104 @@ namespace mujoco {
         return arr_sf;
     }
 
+    TMjcVirtualFileSystem::TMjcVirtualFileSystem()
+    {
+        m_MjcVfs = std::make_unique<mjVFS>();
+        mj_defaultVFS( m_MjcVfs.get() );
+    }
+
+    TMjcVirtualFileSystem::~TMjcVirtualFileSystem()
+    {
+        if ( m_MjcVfs )
+            mj_deleteVFS( m_MjcVfs.get() );
+        m_MjcVfs = nullptr;
+    }
+
+    bool TMjcVirtualFileSystem::AddFile( const std::string& filename, const void* data, size_t size )
+    {
+        const int ret_code = mj_makeEmptyFileVFS( m_MjcVfs.get(), filename.c_str(), (int)size );
+        if ( ret_code == 1 )
+        {
+            LOCO_CORE_ERROR( "TMjcVirtualFileSystem::AddFile >>> vfs is full, couldn't add file {0} ({1} files stored)",
+                             filename, m_MjcVfs->nfile );
+            return false;
+        }
+        else if ( ret_code == 2 )
+        {
+            LOCO_CORE_WARN( "TMjcVirtualFileSystem::AddFile >>> file {0} is already in the vfs, skipping it", filename );
+            return false;
+        }
+
+        if ( size > 0 )
+            std::memcpy( m_MjcVfs->filedata[m_MjcVfs->nfile - 1], data, size );
+        return true;
+    }
+
+    bool TMjcVirtualFileSystem::HasFile( const std::string& filename ) const
+    {
+        return mj_findFileVFS( m_MjcVfs.get(), filename.c_str() ) >= 0;
+    }
+
+    void TMjcVirtualFileSystem::Clear()
+    {
+        mj_deleteVFS( m_MjcVfs.get() );
+        mj_defaultVFS( m_MjcVfs.get() );
+    }
+
+    std::vector<uint8_t> SerializeMeshToBinary( const std::vector<float>& mesh_vertices,
+                                                const std::vector<int>& mesh_faces )
+    {
+        if ( mesh_vertices.size() % 3 != 0 )
+            LOCO_CORE_ERROR( "SerializeMeshToBinary >>> there must be 3 elements per vertex, got {0}/3", mesh_vertices.size() );
+        if ( mesh_faces.size() % 3 != 0 )
+            LOCO_CORE_ERROR( "SerializeMeshToBinary >>> there must be 3 elements per face, got {0}/3", mesh_faces.size() );
+
+        // Binary .msh layout: header (nvertex, nnormal, ntexcoord, nface), then vertex and face data
+        const int32_t header[4] = { (int32_t)( mesh_vertices.size() / 3 ), 0, 0, (int32_t)( mesh_faces.size() / 3 ) };
+        const size_t vertices_nbytes = sizeof( float ) * 3 * header[0];
+        const size_t faces_nbytes = sizeof( int ) * 3 * header[3];
+
+        std::vector<uint8_t> contents( sizeof( header ) + vertices_nbytes + faces_nbytes );
+        std::memcpy( contents.data(), header, sizeof( header ) );
+        std::memcpy( contents.data() + sizeof( header ), mesh_vertices.data(), vertices_nbytes );
+        std::memcpy( contents.data() + sizeof( header ) + vertices_nbytes, mesh_faces.data(), faces_nbytes );
+        return contents;
+    }
+
+    std::unique_ptr<TMjcVfsFile> CreateMeshVfsFile( const std::string& mesh_file,
+                                                    const std::vector<float>& mesh_vertices,
+                                                    const std::vector<int>& mesh_faces )
+    {
+        auto vfs_file = std::make_unique<TMjcVfsFile>();
+        vfs_file->filename = mesh_file;
+        vfs_file->contents = SerializeMeshToBinary( mesh_vertices, mesh_faces );
+        return vfs_file;
+    }
+
     void SaveMeshToBinary( const std::string& mesh_file,
                            const std::vector<float>& mesh_vertices,
                            const std::vector<int>& mesh_faces )
     {
-        std::ofstream fhandle( mesh_file.c_str(), std::ofstream::out | std::ofstream::binary );
+        TMjcVfsFile mesh_vfs_file;
+        mesh_vfs_file.filename = mesh_file;
+        mesh_vfs_file.contents = SerializeMeshToBinary( mesh_vertices, mesh_faces );
+        SaveVfsFileToDisk( mesh_file, mesh_vfs_file );
+    }
+
+    void SaveVfsFileToDisk( const std::string& filepath, const TMjcVfsFile& file )
+    {
+        std::ofstream fhandle( filepath.c_str(), std::ofstream::out | std::ofstream::binary );
         if ( !fhandle )
         {
-            LOCO_CORE_ERROR( "SaveMeshToBinary >>> couldn't save user-defined binary mesh to the \
-                              filepath {0}", mesh_file );
+            LOCO_CORE_ERROR( "SaveVfsFileToDisk >>> couldn't save in-memory file {0} to the filepath {1}",
+                             file.filename, filepath );
             return;
         }
 
-        if ( mesh_vertices.size() % 3 != 0 )
-            LOCO_CORE_ERROR( "SaveMeshToBinary >>> there must be 3 elements per vertex, got {0}/3 (mesh: {1})", mesh_vertices.size(), mesh_file );
-        if ( mesh_faces.size() % 3 != 0 )
-            LOCO_CORE_ERROR( "SaveMeshToBinary >>> there must be 3 elements per face, got {0}/3 (mesh: {1})", mesh_faces.size(), mesh_file );
-
-        const int32_t nvertex = mesh_vertices.size() / 3;
-        const int32_t nnormal = 0;
-        const int32_t ntexcoord = 0;
-        const int32_t nface = mesh_faces.size() / 3;
-
-        fhandle.write( (const char*)&nvertex, sizeof( int32_t ) );
-        fhandle.write( (const char*)&nnormal, sizeof( int32_t ) );
-        fhandle.write( (const char*)&ntexcoord, sizeof( int32_t ) );
-        fhandle.write( (const char*)&nface, sizeof( int32_t ) );
-        fhandle.write( (const char*)mesh_vertices.data(), sizeof( float ) * mesh_vertices.size() );
-        fhandle.write( (const char*)mesh_faces.data(), sizeof( int ) * mesh_faces.size() );
+        fhandle.write( (const char*)file.data(), file.size() );
         fhandle.close();
 
         if ( !fhandle.good() )
-            LOCO_CORE_ERROR( "SaveMeshToBinary >>> there was an error while trying to save mesh {0}", mesh_file );
+            LOCO_CORE_ERROR( "SaveVfsFileToDisk >>> there was an error while trying to save file {0}", filepath );
     }
 }}
\ No newline at end of file
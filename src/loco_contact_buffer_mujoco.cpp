@@ -0,0 +1,147 @@
+#include <loco_contact_buffer_mujoco.h>
+
+namespace loco {
+namespace mujoco {
+
+    void TMujocoContactBuffer::Resize( const mjModel* mjc_model )
+    {
+        LOCO_CORE_ASSERT( mjc_model, "TMujocoContactBuffer::Resize >>> must have a valid mjModel reference, but got nullptr" );
+
+        const ssize_t num_geoms = mjc_model->ngeom;
+        m_GeomNames.resize( num_geoms );
+        for ( ssize_t geom_id = 0; geom_id < num_geoms; geom_id++ )
+        {
+            const char* geom_name = mj_id2name( mjc_model, mjOBJ_GEOM, geom_id );
+            m_GeomNames[geom_id] = ( geom_name ) ? geom_name : "";
+        }
+        m_GeomCounts.assign( num_geoms, 0 );
+        m_GeomSpanStarts.assign( num_geoms + 1, 0 );
+        m_GeomCursors.assign( num_geoms, 0 );
+        m_GeomForceSubscribed.assign( num_geoms, 0 );
+        m_NumForceSubscribers = 0;
+        // Each contact is reported to both of the geoms involved
+        m_Entries.resize( 2 * std::max( mjc_model->nconmax, 0 ) );
+        m_NumContacts = 0;
+    }
+
+    void TMujocoContactBuffer::Collect( const mjModel* mjc_model, const mjData* mjc_data, bool allow_forces )
+    {
+        LOCO_CORE_ASSERT( mjc_model, "TMujocoContactBuffer::Collect >>> must have a valid mjModel reference, but got nullptr" );
+        LOCO_CORE_ASSERT( mjc_data, "TMujocoContactBuffer::Collect >>> must have a valid mjData reference, but got nullptr" );
+        LOCO_CORE_ASSERT( mjc_model->ngeom == (ssize_t)m_GeomCounts.size(), "TMujocoContactBuffer::Collect >>> buffer was sized \
+                          for {0} geoms, but model has {1} geoms. Perhaps forgot to call ->Resize()?", m_GeomCounts.size(), mjc_model->ngeom );
+
+        const ssize_t num_geoms = m_GeomCounts.size();
+        const ssize_t num_contacts = mjc_data->ncon;
+
+        // Counting-pass: number of entries per geom
+        std::fill( m_GeomCounts.begin(), m_GeomCounts.end(), 0 );
+        for ( ssize_t i = 0; i < num_contacts; i++ )
+        {
+            const auto& mjc_contact_info = mjc_data->contact[i];
+            if ( mjc_contact_info.geom1 < 0 || mjc_contact_info.geom2 < 0 )
+                continue;
+            m_GeomCounts[mjc_contact_info.geom1]++;
+            m_GeomCounts[mjc_contact_info.geom2]++;
+        }
+
+        // Prefix-sum: start of the span of each geom
+        m_GeomSpanStarts[0] = 0;
+        for ( ssize_t geom_id = 0; geom_id < num_geoms; geom_id++ )
+        {
+            m_GeomSpanStarts[geom_id + 1] = m_GeomSpanStarts[geom_id] + m_GeomCounts[geom_id];
+            m_GeomCursors[geom_id] = m_GeomSpanStarts[geom_id];
+        }
+        if ( m_GeomSpanStarts[num_geoms] > (ssize_t)m_Entries.size() )
+        {
+            LOCO_CORE_WARN( "TMujocoContactBuffer::Collect >>> number of contact-entries ({0}) exceeded the preallocated \
+                             capacity ({1}), growing buffer", m_GeomSpanStarts[num_geoms], m_Entries.size() );
+            m_Entries.resize( m_GeomSpanStarts[num_geoms] );
+        }
+
+        // Scatter-pass: fill the spans of both geoms involved in each contact
+        const bool compute_forces = ( allow_forces && m_NumForceSubscribers > 0 );
+        for ( ssize_t i = 0; i < num_contacts; i++ )
+        {
+            const auto& mjc_contact_info = mjc_data->contact[i];
+            if ( mjc_contact_info.geom1 < 0 || mjc_contact_info.geom2 < 0 )
+            {
+                LOCO_CORE_WARN( "TMujocoContactBuffer::Collect >>> got a contact without geom-id information" );
+                continue;
+            }
+
+            const TVec3 position = { (TScalar) mjc_contact_info.pos[0],
+                                     (TScalar) mjc_contact_info.pos[1],
+                                     (TScalar) mjc_contact_info.pos[2] };
+            // First row of the contact-frame is the normal, pointing from geom1 to geom2
+            const TVec3 normal = { (TScalar) mjc_contact_info.frame[0],
+                                   (TScalar) mjc_contact_info.frame[1],
+                                   (TScalar) mjc_contact_info.frame[2] };
+
+            auto& entry_1 = m_Entries[m_GeomCursors[mjc_contact_info.geom1]++];
+            entry_1.contact_id = i;
+            entry_1.other_geom_id = mjc_contact_info.geom2;
+            entry_1.position = position;
+            entry_1.normal = normal;
+
+            auto& entry_2 = m_Entries[m_GeomCursors[mjc_contact_info.geom2]++];
+            entry_2.contact_id = i;
+            entry_2.other_geom_id = mjc_contact_info.geom1;
+            entry_2.position = position;
+            entry_2.normal = normal.scaled( -1.0 );
+
+            if ( compute_forces && ( m_GeomForceSubscribed[mjc_contact_info.geom1] || m_GeomForceSubscribed[mjc_contact_info.geom2] ) )
+            {
+                // Wrench is given in the contact-frame (rows of frame are the axes), and acts on geom2 (opposite on geom1)
+                mjtNum wrench_local[6], force_world[3], torque_world[3];
+                mj_contactForce( mjc_model, mjc_data, i, wrench_local );
+                mju_mulMatTVec( force_world, mjc_contact_info.frame, wrench_local, 3, 3 );
+                mju_mulMatTVec( torque_world, mjc_contact_info.frame, wrench_local + 3, 3, 3 );
+
+                entry_2.force = { (TScalar) force_world[0], (TScalar) force_world[1], (TScalar) force_world[2] };
+                entry_2.torque = { (TScalar) torque_world[0], (TScalar) torque_world[1], (TScalar) torque_world[2] };
+                entry_1.force = entry_2.force.scaled( -1.0 );
+                entry_1.torque = entry_2.torque.scaled( -1.0 );
+            }
+        }
+        m_NumContacts = num_contacts;
+    }
+
+    void TMujocoContactBuffer::Clear()
+    {
+        std::fill( m_GeomCounts.begin(), m_GeomCounts.end(), 0 );
+        std::fill( m_GeomSpanStarts.begin(), m_GeomSpanStarts.end(), 0 );
+        m_NumContacts = 0;
+    }
+
+    void TMujocoContactBuffer::SetForceSubscription( ssize_t geom_id, bool subscribe )
+    {
+        if ( geom_id < 0 || geom_id >= (ssize_t)m_GeomForceSubscribed.size() )
+        {
+            LOCO_CORE_ERROR( "TMujocoContactBuffer::SetForceSubscription >>> geom-id {0} out of range [0,{1})",
+                             geom_id, m_GeomForceSubscribed.size() );
+            return;
+        }
+        if ( (bool)m_GeomForceSubscribed[geom_id] == subscribe )
+            return;
+        m_GeomForceSubscribed[geom_id] = ( subscribe ) ? 1 : 0;
+        m_NumForceSubscribers += ( subscribe ) ? 1 : -1;
+    }
+
+    bool TMujocoContactBuffer::force_subscribed( ssize_t geom_id ) const
+    {
+        if ( geom_id < 0 || geom_id >= (ssize_t)m_GeomForceSubscribed.size() )
+            return false;
+        return m_GeomForceSubscribed[geom_id] != 0;
+    }
+
+    TMujocoContactsView TMujocoContactBuffer::contacts( ssize_t geom_id ) const
+    {
+        TMujocoContactsView view;
+        if ( geom_id < 0 || geom_id >= (ssize_t)m_GeomCounts.size() )
+            return view;
+        view.data = m_Entries.data() + m_GeomSpanStarts[geom_id];
+        view.size = m_GeomCounts[geom_id];
+        return view;
+    }
+}}
\ No newline at end of file
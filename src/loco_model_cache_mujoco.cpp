@@ -0,0 +1,576 @@
+#include <loco_model_cache_mujoco.h>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <cctype>
+#include <cstring>
+#include <unordered_map>
+
+#if defined( __linux__ ) || defined( __APPLE__ )
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif /* __linux__ || __APPLE__ */
+
+namespace loco {
+namespace mujoco {
+
+    std::string TMujocoModelCache::s_CacheDirectory = "";
+    std::once_flag TMujocoModelCache::s_CacheDirectoryResolved;
+    std::atomic<ssize_t> TMujocoModelCache::s_NumHits( 0 );
+    std::atomic<ssize_t> TMujocoModelCache::s_NumMisses( 0 );
+
+    // FNV-1a (64-bit) constants, used to hash the contents that define a compiled model
+    const uint64_t LOCO_FNV1A_OFFSET_BASIS = 14695981039346656037ULL;
+    const uint64_t LOCO_FNV1A_PRIME = 1099511628211ULL;
+
+    static void _HashBytes( uint64_t& hash, const void* data, size_t size )
+    {
+        const uint8_t* bytes = (const uint8_t*)data;
+        for ( size_t i = 0; i < size; i++ )
+        {
+            hash ^= (uint64_t)bytes[i];
+            hash *= LOCO_FNV1A_PRIME;
+        }
+    }
+
+    static void _HashSegment( uint64_t& hash, const void* data, size_t size )
+    {
+        // Prefix each segment with its size, so different splits of the same bytes hash differently
+        const uint64_t segment_size = size;
+        _HashBytes( hash, &segment_size, sizeof( segment_size ) );
+        _HashBytes( hash, data, size );
+    }
+
+    static std::string _NormalizeDirpath( const std::string& dirpath )
+    {
+        if ( !dirpath.empty() && dirpath.back() != '/' && dirpath.back() != '\\' )
+            return dirpath + "/";
+        return dirpath;
+    }
+
+    // Reserves a unique temporary file next to the given one (unique across threads and processes sharing
+    // the cache directory), so entries can be written there first and then moved into place atomically
+    static std::string _MakeTmpFilepath( const std::string& filepath )
+    {
+    #if defined( __linux__ ) || defined( __APPLE__ )
+        std::string tmp_filepath = filepath + ".tmp" + std::to_string( getpid() ) + ".XXXXXX";
+        const int fd = mkstemp( &tmp_filepath[0] );
+        if ( fd < 0 )
+            return "";
+        // mkstemp creates the file as owner-only, but entries can be shared by other users of the cache
+        fchmod( fd, 0644 );
+        close( fd );
+        return tmp_filepath;
+    #else
+        return filepath + ".tmp" + std::to_string( std::hash<std::thread::id>()( std::this_thread::get_id() ) );
+    #endif /* __linux__ || __APPLE__ */
+    }
+
+    void TMujocoModelCache::SetCacheDirectory( const std::string& cache_dirpath )
+    {
+        // Mark as resolved, so the environment variable never overrides the user's choice
+        std::call_once( s_CacheDirectoryResolved, []() {} );
+        s_CacheDirectory = _NormalizeDirpath( cache_dirpath );
+    }
+
+    const std::string& TMujocoModelCache::cache_directory()
+    {
+        std::call_once( s_CacheDirectoryResolved, []()
+            {
+                if ( const char* cache_dirpath = std::getenv( "LOCO_MUJOCO_MODEL_CACHE_DIR" ) )
+                    s_CacheDirectory = _NormalizeDirpath( cache_dirpath );
+            } );
+        return s_CacheDirectory;
+    }
+
+    bool TMujocoModelCache::enabled()
+    {
+        return !cache_directory().empty();
+    }
+
+    std::string TMujocoModelCache::ComputeKey( const std::string& mjcf_xml_str,
+                                               const std::vector<const TMjcVfsFile*>& vfs_resources,
+                                               const std::vector<std::string>& asset_filepaths )
+    {
+        uint64_t hash = LOCO_FNV1A_OFFSET_BASIS;
+        // Binaries are only valid for the same mujoco version and floating-point precision
+        const int mjc_version = mj_version();
+        const uint64_t mjc_num_size = sizeof( mjtNum );
+        _HashSegment( hash, &mjc_version, sizeof( mjc_version ) );
+        _HashSegment( hash, &mjc_num_size, sizeof( mjc_num_size ) );
+        _HashSegment( hash, mjcf_xml_str.c_str(), mjcf_xml_str.size() );
+        for ( auto vfs_resource : vfs_resources )
+        {
+            _HashSegment( hash, vfs_resource->filename.c_str(), vfs_resource->filename.size() );
+            _HashSegment( hash, vfs_resource->data(), vfs_resource->size() );
+        }
+        for ( const auto& asset_filepath : asset_filepaths )
+        {
+            std::ifstream fhandle( asset_filepath.c_str(), std::ifstream::in | std::ifstream::binary );
+            if ( !fhandle )
+            {
+                LOCO_CORE_WARN( "TMujocoModelCache::ComputeKey >>> couldn't read asset {0}, the model won't be cached", asset_filepath );
+                return "";
+            }
+            const std::vector<char> asset_contents( ( std::istreambuf_iterator<char>( fhandle ) ),
+                                                    std::istreambuf_iterator<char>() );
+            _HashSegment( hash, asset_filepath.c_str(), asset_filepath.size() );
+            _HashSegment( hash, asset_contents.data(), asset_contents.size() );
+        }
+
+        char key_buffer[17];
+        std::snprintf( key_buffer, sizeof( key_buffer ), "%016llx", (unsigned long long)hash );
+        return std::string( key_buffer );
+    }
+
+    mjModel* TMujocoModelCache::Load( const std::string& key )
+    {
+        if ( !enabled() || key.empty() )
+            return nullptr;
+
+        const std::string entry_filepath = _GetEntryFilepath( key );
+        mjModel* mjc_model = nullptr;
+        if ( std::ifstream( entry_filepath.c_str(), std::ifstream::in | std::ifstream::binary ).good() )
+            mjc_model = mj_loadModel( entry_filepath.c_str(), nullptr );
+
+        if ( mjc_model )
+        {
+            s_NumHits++;
+            LOCO_CORE_TRACE( "TMujocoModelCache::Load >>> cache-hit for model {0}", entry_filepath );
+        }
+        else
+        {
+            s_NumMisses++;
+            LOCO_CORE_TRACE( "TMujocoModelCache::Load >>> cache-miss for model {0}", entry_filepath );
+        }
+        return mjc_model;
+    }
+
+    bool TMujocoModelCache::Store( const std::string& key, const mjModel* mjc_model )
+    {
+        if ( !enabled() || key.empty() || !mjc_model )
+            return false;
+
+        // Save into a temporary file first, and then move it into place, so that concurrent
+        // readers (e.g. other processes sharing the cache) never see a partially written entry
+        const std::string entry_filepath = _GetEntryFilepath( key );
+        const std::string tmp_filepath = _MakeTmpFilepath( entry_filepath );
+        if ( tmp_filepath.empty() )
+        {
+            LOCO_CORE_ERROR( "TMujocoModelCache::Store >>> couldn't create a temporary file for {0}", entry_filepath );
+            return false;
+        }
+        mj_saveModel( mjc_model, tmp_filepath.c_str(), nullptr, 0 );
+        std::ifstream tmp_fhandle( tmp_filepath.c_str(), std::ifstream::in | std::ifstream::binary | std::ifstream::ate );
+        if ( !tmp_fhandle.good() || tmp_fhandle.tellg() <= 0 )
+        {
+            LOCO_CORE_ERROR( "TMujocoModelCache::Store >>> couldn't save compiled model to {0}", tmp_filepath );
+            std::remove( tmp_filepath.c_str() );
+            return false;
+        }
+        tmp_fhandle.close();
+        if ( std::rename( tmp_filepath.c_str(), entry_filepath.c_str() ) != 0 )
+        {
+            LOCO_CORE_ERROR( "TMujocoModelCache::Store >>> couldn't move compiled model into {0}", entry_filepath );
+            std::remove( tmp_filepath.c_str() );
+            return false;
+        }
+
+        LOCO_CORE_TRACE( "TMujocoModelCache::Store >>> stored compiled model into {0}", entry_filepath );
+        return true;
+    }
+
+    void TMujocoModelCache::ResetStats()
+    {
+        s_NumHits = 0;
+        s_NumMisses = 0;
+    }
+
+    std::string TMujocoModelCache::_GetEntryFilepath( const std::string& key )
+    {
+        return cache_directory() + key + LOCO_MUJOCO_MODEL_CACHE_EXTENSION;
+    }
+
+    std::string TMujocoMeshCache::s_CacheDirectory = "";
+    std::once_flag TMujocoMeshCache::s_CacheDirectoryResolved;
+    std::atomic<ssize_t> TMujocoMeshCache::s_NumHits( 0 );
+    std::atomic<ssize_t> TMujocoMeshCache::s_NumMisses( 0 );
+
+    static std::string _HashToKey( uint64_t hash )
+    {
+        char key_buffer[17];
+        std::snprintf( key_buffer, sizeof( key_buffer ), "%016llx", (unsigned long long)hash );
+        return std::string( key_buffer );
+    }
+
+    static bool _ReadFileBytes( const std::string& filepath, std::vector<char>& dst_contents )
+    {
+        std::ifstream fhandle( filepath.c_str(), std::ifstream::in | std::ifstream::binary );
+        if ( !fhandle )
+            return false;
+        dst_contents.assign( ( std::istreambuf_iterator<char>( fhandle ) ), std::istreambuf_iterator<char>() );
+        return true;
+    }
+
+    static bool _EndsWith( const std::string& str, const std::string& suffix )
+    {
+        if ( str.size() < suffix.size() )
+            return false;
+        for ( size_t i = 0; i < suffix.size(); i++ )
+            if ( std::tolower( str[str.size() - suffix.size() + i] ) != suffix[i] )
+                return false;
+        return true;
+    }
+
+    // Volume enclosed by a (closed) triangle mesh, as the sum of the signed volumes of the tetrahedra formed
+    // by each face and the origin (same as mujoco's, so meshes enclosing the same solid give the same value)
+    static double _ComputeMeshVolume( const std::vector<float>& vertices, const std::vector<int>& faces )
+    {
+        double volume = 0.0;
+        for ( size_t i = 0; i + 2 < faces.size(); i += 3 )
+        {
+            const float* v0 = vertices.data() + 3 * faces[i + 0];
+            const float* v1 = vertices.data() + 3 * faces[i + 1];
+            const float* v2 = vertices.data() + 3 * faces[i + 2];
+            volume += ( (double)v0[0] * ( (double)v1[1] * v2[2] - (double)v1[2] * v2[1] ) -
+                        (double)v0[1] * ( (double)v1[0] * v2[2] - (double)v1[2] * v2[0] ) +
+                        (double)v0[2] * ( (double)v1[0] * v2[1] - (double)v1[1] * v2[0] ) ) / 6.0;
+        }
+        return std::abs( volume );
+    }
+
+    // Loads the vertices|faces of a mesh-file, in the same order mujoco (2.0) reads them (binary .msh and binary .stl)
+    static bool _LoadMeshFile( const std::string& mesh_filepath, std::vector<float>& dst_vertices, std::vector<int>& dst_faces )
+    {
+        std::vector<char> contents;
+        if ( !_ReadFileBytes( mesh_filepath, contents ) )
+            return false;
+
+        if ( _EndsWith( mesh_filepath, ".msh" ) )
+        {
+            int32_t header[4];
+            if ( contents.size() < sizeof( header ) )
+                return false;
+            std::memcpy( header, contents.data(), sizeof( header ) );
+            const size_t vertices_offset = sizeof( header );
+            const size_t faces_offset = vertices_offset + sizeof( float ) * ( 3 * header[0] + 3 * header[1] + 2 * header[2] );
+            if ( contents.size() != faces_offset + sizeof( int ) * 3 * header[3] )
+                return false;
+            dst_vertices.resize( 3 * header[0] );
+            dst_faces.resize( 3 * header[3] );
+            std::memcpy( dst_vertices.data(), contents.data() + vertices_offset, sizeof( float ) * dst_vertices.size() );
+            std::memcpy( dst_faces.data(), contents.data() + faces_offset, sizeof( int ) * dst_faces.size() );
+            return true;
+        }
+        else if ( _EndsWith( mesh_filepath, ".stl" ) )
+        {
+            // Binary stl: 80-byte header, number of triangles, then (normal, v0, v1, v2, attribute) per triangle.
+            // Vertices are not shared among triangles (mujoco 2.0 doesn't merge them either)
+            const size_t triangle_nbytes = 12 * sizeof( float ) + sizeof( uint16_t );
+            uint32_t num_triangles = 0;
+            if ( contents.size() < 84 )
+                return false;
+            std::memcpy( &num_triangles, contents.data() + 80, sizeof( num_triangles ) );
+            if ( contents.size() < 84 + num_triangles * triangle_nbytes )
+                return false;
+            dst_vertices.resize( 9 * num_triangles );
+            dst_faces.resize( 3 * num_triangles );
+            for ( size_t t = 0; t < num_triangles; t++ )
+            {
+                std::memcpy( dst_vertices.data() + 9 * t, contents.data() + 84 + t * triangle_nbytes + 3 * sizeof( float ), 9 * sizeof( float ) );
+                for ( size_t k = 0; k < 3; k++ )
+                    dst_faces[3 * t + k] = 3 * t + k;
+            }
+            return true;
+        }
+        return false;
+    }
+
+    TMujocoMeshCacheEntry::TMujocoMeshCacheEntry( void* data, size_t size )
+        : m_Data( data ), m_Size( size )
+    {
+    }
+
+    TMujocoMeshCacheEntry::~TMujocoMeshCacheEntry()
+    {
+    #if defined( __linux__ ) || defined( __APPLE__ )
+        if ( m_Data )
+            munmap( m_Data, m_Size );
+    #endif /* __linux__ || __APPLE__ */
+        m_Data = nullptr;
+        m_Size = 0;
+    }
+
+    void TMujocoMeshCache::SetCacheDirectory( const std::string& cache_dirpath )
+    {
+        // Mark as resolved, so the environment variable never overrides the user's choice
+        std::call_once( s_CacheDirectoryResolved, []() {} );
+        s_CacheDirectory = _NormalizeDirpath( cache_dirpath );
+    }
+
+    const std::string& TMujocoMeshCache::cache_directory()
+    {
+        std::call_once( s_CacheDirectoryResolved, []()
+            {
+                if ( const char* cache_dirpath = std::getenv( "LOCO_MUJOCO_MESH_CACHE_DIR" ) )
+                    s_CacheDirectory = _NormalizeDirpath( cache_dirpath );
+            } );
+        return s_CacheDirectory;
+    }
+
+    bool TMujocoMeshCache::enabled()
+    {
+        return !cache_directory().empty();
+    }
+
+    std::string TMujocoMeshCache::ComputeKey( const std::vector<float>& vertices, const std::vector<int>& faces, const TVec3& scale )
+    {
+        const float scale_xyz[3] = { scale.x(), scale.y(), scale.z() };
+        uint64_t hash = LOCO_FNV1A_OFFSET_BASIS;
+        _HashSegment( hash, &LOCO_MUJOCO_MESH_CACHE_VERSION, sizeof( LOCO_MUJOCO_MESH_CACHE_VERSION ) );
+        _HashSegment( hash, scale_xyz, sizeof( scale_xyz ) );
+        _HashSegment( hash, vertices.data(), sizeof( float ) * vertices.size() );
+        _HashSegment( hash, faces.data(), sizeof( int ) * faces.size() );
+        return _HashToKey( hash );
+    }
+
+    std::string TMujocoMeshCache::ComputeKeyFromFile( const std::string& mesh_filepath, const TVec3& scale )
+    {
+        std::vector<char> contents;
+        if ( !_ReadFileBytes( mesh_filepath, contents ) )
+            return "";
+
+        const float scale_xyz[3] = { scale.x(), scale.y(), scale.z() };
+        uint64_t hash = LOCO_FNV1A_OFFSET_BASIS;
+        _HashSegment( hash, &LOCO_MUJOCO_MESH_CACHE_VERSION, sizeof( LOCO_MUJOCO_MESH_CACHE_VERSION ) );
+        _HashSegment( hash, scale_xyz, sizeof( scale_xyz ) );
+        _HashSegment( hash, contents.data(), contents.size() );
+        return _HashToKey( hash );
+    }
+
+    std::shared_ptr<TMujocoMeshCacheEntry> TMujocoMeshCache::Load( const std::string& key )
+    {
+        if ( !enabled() || key.empty() )
+            return nullptr;
+
+        std::shared_ptr<TMujocoMeshCacheEntry> entry = nullptr;
+        size_t entry_size = 0;
+        const std::string entry_filepath = _GetEntryFilepath( key );
+    #if defined( __linux__ ) || defined( __APPLE__ )
+        const int fd = open( entry_filepath.c_str(), O_RDONLY );
+        if ( fd >= 0 )
+        {
+            struct stat file_stat;
+            if ( fstat( fd, &file_stat ) == 0 && (size_t)file_stat.st_size >= sizeof( TMujocoMeshCacheHeader ) )
+            {
+                void* data = mmap( nullptr, file_stat.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+                if ( data != MAP_FAILED )
+                {
+                    entry_size = file_stat.st_size;
+                    entry = std::make_shared<TMujocoMeshCacheEntry>( data, entry_size );
+                }
+            }
+            close( fd );
+        }
+
+        // Discard entries written by other versions (or truncated ones)
+        if ( entry )
+        {
+            const auto header = entry->header();
+            if ( header->magic != LOCO_MUJOCO_MESH_CACHE_MAGIC || header->version != LOCO_MUJOCO_MESH_CACHE_VERSION ||
+                 header->msh_offset < (int64_t)sizeof( TMujocoMeshCacheHeader ) ||
+                 (size_t)( header->msh_offset + header->msh_size ) > entry_size )
+                entry = nullptr;
+        }
+    #endif /* __linux__ || __APPLE__ */
+
+        if ( entry )
+        {
+            s_NumHits++;
+            LOCO_CORE_TRACE( "TMujocoMeshCache::Load >>> cache-hit for mesh {0}", entry_filepath );
+        }
+        else
+        {
+            s_NumMisses++;
+            LOCO_CORE_TRACE( "TMujocoMeshCache::Load >>> cache-miss for mesh {0}", entry_filepath );
+        }
+        return entry;
+    }
+
+    bool TMujocoMeshCache::Store( const std::string& key, const std::vector<float>& vertices, const std::vector<int>& faces,
+                                  const mjModel* mjc_model, ssize_t mjc_mesh_id )
+    {
+        if ( !enabled() || key.empty() || !mjc_model || mjc_mesh_id < 0 || mjc_mesh_id >= mjc_model->nmesh )
+            return false;
+
+        // Mujoco computes the hull over the vertices in the order they were given, so the hull-graph can
+        // be mapped back to the source vertices only if none were dropped during compilation
+        const ssize_t num_vertices = vertices.size() / 3;
+        const int graph_adr = mjc_model->mesh_graphadr[mjc_mesh_id];
+        if ( graph_adr < 0 || mjc_model->mesh_vertnum[mjc_mesh_id] != num_vertices )
+        {
+            LOCO_CORE_TRACE( "TMujocoMeshCache::Store >>> mesh {0} has no usable hull, it won't be cached", key );
+            return false;
+        }
+
+        // Graph layout: numvert, numface, vert_edgeadr[numvert], vert_globalid[numvert],
+        //               edge_localid[numvert + 3 * numface], face_globalid[3 * numface]
+        const int* graph = mjc_model->mesh_graph + graph_adr;
+        const int hull_num_vertices = graph[0];
+        const int hull_num_faces = graph[1];
+        const int* vert_globalid = graph + 2 + hull_num_vertices;
+        const int* face_globalid = graph + 2 + 3 * hull_num_vertices + 3 * hull_num_faces;
+
+        std::vector<float> hull_vertices( 3 * hull_num_vertices );
+        std::unordered_map<int, int> global_to_local;
+        for ( ssize_t i = 0; i < hull_num_vertices; i++ )
+        {
+            const int global_id = vert_globalid[i];
+            if ( global_id < 0 || global_id >= num_vertices )
+                return false;
+            global_to_local[global_id] = i;
+            for ( size_t k = 0; k < 3; k++ )
+                hull_vertices[3 * i + k] = vertices[3 * global_id + k];
+        }
+        std::vector<int> hull_faces( 3 * hull_num_faces );
+        for ( ssize_t i = 0; i < 3 * hull_num_faces; i++ )
+        {
+            auto it = global_to_local.find( face_globalid[i] );
+            if ( it == global_to_local.end() )
+                return false;
+            hull_faces[i] = it->second;
+        }
+
+        // Mass-properties are computed from the mesh handed to mujoco, so only meshes that enclose the same solid
+        // as their hull (i.e. convex ones) can be replaced by it
+        const double source_volume = _ComputeMeshVolume( vertices, faces );
+        const double hull_volume = _ComputeMeshVolume( hull_vertices, hull_faces );
+        if ( hull_volume <= 0.0 || std::abs( source_volume - hull_volume ) > 1e-4 * hull_volume )
+        {
+            LOCO_CORE_TRACE( "TMujocoMeshCache::Store >>> mesh {0} isn't convex (volume {1} vs hull-volume {2}), it won't \
+                              be cached", key, source_volume, hull_volume );
+            return false;
+        }
+
+        // Only the hull is stored, so later compilations run the hull and inertia computations over it alone
+        const ssize_t num_faces = faces.size() / 3;
+        const std::vector<uint8_t> msh_contents = SerializeMeshToBinary( hull_vertices, hull_faces );
+        TMujocoMeshCacheHeader header;
+        header.magic = LOCO_MUJOCO_MESH_CACHE_MAGIC;
+        header.version = LOCO_MUJOCO_MESH_CACHE_VERSION;
+        header.source_num_vertices = num_vertices;
+        header.source_num_faces = num_faces;
+        header.hull_num_vertices = hull_num_vertices;
+        header.hull_num_faces = hull_num_faces;
+        header.msh_offset = sizeof( TMujocoMeshCacheHeader );
+        header.msh_size = msh_contents.size();
+
+        // Same as for compiled models, write into a temporary file first and then move it into place
+        const std::string entry_filepath = _GetEntryFilepath( key );
+        const std::string tmp_filepath = _MakeTmpFilepath( entry_filepath );
+        if ( tmp_filepath.empty() )
+        {
+            LOCO_CORE_ERROR( "TMujocoMeshCache::Store >>> couldn't create a temporary file for {0}", entry_filepath );
+            return false;
+        }
+        std::ofstream fhandle( tmp_filepath.c_str(), std::ofstream::out | std::ofstream::binary );
+        fhandle.write( (const char*)&header, sizeof( header ) );
+        fhandle.write( (const char*)msh_contents.data(), msh_contents.size() );
+        fhandle.close();
+        if ( !fhandle.good() )
+        {
+            LOCO_CORE_ERROR( "TMujocoMeshCache::Store >>> couldn't save preprocessed mesh to {0}", tmp_filepath );
+            std::remove( tmp_filepath.c_str() );
+            return false;
+        }
+        if ( std::rename( tmp_filepath.c_str(), entry_filepath.c_str() ) != 0 )
+        {
+            LOCO_CORE_ERROR( "TMujocoMeshCache::Store >>> couldn't move preprocessed mesh into {0}", entry_filepath );
+            std::remove( tmp_filepath.c_str() );
+            return false;
+        }
+
+        LOCO_CORE_TRACE( "TMujocoMeshCache::Store >>> stored hull ({0} vertices, {1} faces) of mesh with {2} vertices into {3}",
+                         hull_num_vertices, hull_num_faces, num_vertices, entry_filepath );
+        return true;
+    }
+
+    bool TMujocoMeshCache::StoreFromFile( const std::string& key, const std::string& mesh_filepath,
+                                          const mjModel* mjc_model, ssize_t mjc_mesh_id )
+    {
+        if ( !enabled() || key.empty() )
+            return false;
+
+        std::vector<float> vertices;
+        std::vector<int> faces;
+        if ( !_LoadMeshFile( mesh_filepath, vertices, faces ) )
+        {
+            LOCO_CORE_WARN( "TMujocoMeshCache::StoreFromFile >>> couldn't read mesh-file {0}, it won't be cached", mesh_filepath );
+            return false;
+        }
+        return Store( key, vertices, faces, mjc_model, mjc_mesh_id );
+    }
+
+    std::unique_ptr<TMjcVfsFile> TMujocoMeshCache::CreateMeshVfsFile( const std::string& mesh_file,
+                                                                      const std::vector<float>& vertices,
+                                                                      const std::vector<int>& faces,
+                                                                      const TVec3& scale,
+                                                                      std::string& dst_pending_key )
+    {
+        dst_pending_key = "";
+        if ( !enabled() )
+            return mujoco::CreateMeshVfsFile( mesh_file, vertices, faces );
+
+        const std::string key = ComputeKey( vertices, faces, scale );
+        if ( auto entry = Load( key ) )
+        {
+            // The vfs-file views the mapped entry (and keeps it mapped), so the hull is only copied into the vfs
+            auto vfs_file = std::make_unique<TMjcVfsFile>();
+            vfs_file->filename = mesh_file;
+            vfs_file->external_data = entry->msh_data();
+            vfs_file->external_size = entry->msh_size();
+            vfs_file->external_owner = entry;
+            return vfs_file;
+        }
+        dst_pending_key = key;
+        return mujoco::CreateMeshVfsFile( mesh_file, vertices, faces );
+    }
+
+    std::unique_ptr<TMjcVfsFile> TMujocoMeshCache::CreateMeshVfsFileFromFile( const std::string& mesh_filepath,
+                                                                              const TVec3& scale,
+                                                                              std::string& dst_pending_key )
+    {
+        dst_pending_key = "";
+        if ( !enabled() || !( _EndsWith( mesh_filepath, ".msh" ) || _EndsWith( mesh_filepath, ".stl" ) ) )
+            return nullptr;
+
+        const std::string key = ComputeKeyFromFile( mesh_filepath, scale );
+        if ( key.empty() )
+            return nullptr;
+        if ( auto entry = Load( key ) )
+        {
+            // Entries are content-addressed, so meshes sharing the same file (and scale) also share the same vfs-file
+            auto vfs_file = std::make_unique<TMjcVfsFile>();
+            vfs_file->filename = key + ".msh";
+            vfs_file->external_data = entry->msh_data();
+            vfs_file->external_size = entry->msh_size();
+            vfs_file->external_owner = entry;
+            return vfs_file;
+        }
+        dst_pending_key = key;
+        return nullptr;
+    }
+
+    void TMujocoMeshCache::ResetStats()
+    {
+        s_NumHits = 0;
+        s_NumMisses = 0;
+    }
+
+    std::string TMujocoMeshCache::_GetEntryFilepath( const std::string& key )
+    {
+        return cache_directory() + key + LOCO_MUJOCO_MESH_CACHE_EXTENSION;
+    }
+}}
\ No newline at end of file
@@ -0,0 +1,120 @@
+#include <loco_model_overlay_mujoco.h>
+
+namespace loco {
+namespace mujoco {
+
+    TMujocoModelOverlay::TMujocoModelOverlay( const mjModel* base_mjc_model )
+        : m_MjcBaseModelRef( base_mjc_model )
+    {
+        LOCO_CORE_ASSERT( m_MjcBaseModelRef, "TMujocoModelOverlay >>> requires a valid base mjModel reference" );
+        m_MjcModelView = *m_MjcBaseModelRef;
+    }
+
+    mjtNum* TMujocoModelOverlay::Materialize( const eMujocoModelParam& param )
+    {
+        auto param_array = _ParamArray( param );
+        if ( m_MjcPrivateModel )
+            return m_MjcPrivateModel.get()->*param_array;
+
+        auto& array = m_Arrays[static_cast<ssize_t>( param )];
+        if ( array.empty() )
+        {
+            const ssize_t array_size = _ParamSize( m_MjcBaseModelRef, param );
+            const mjtNum* base_array = m_MjcBaseModelRef->*param_array;
+            array.assign( base_array, base_array + array_size );
+            m_MjcModelView.*param_array = array.data();
+        }
+        return array.data();
+    }
+
+    mjModel* TMujocoModelOverlay::MakePrivate()
+    {
+        if ( m_MjcPrivateModel )
+            return m_MjcPrivateModel.get();
+
+        m_MjcPrivateModel = std::unique_ptr<mjModel, MjcModelDeleter>( mj_copyModel( nullptr, m_MjcBaseModelRef ) );
+        for ( ssize_t i = 0; i < LOCO_MUJOCO_NUM_MODEL_PARAMS; i++ )
+        {
+            if ( m_Arrays[i].empty() )
+                continue;
+            auto param_array = _ParamArray( static_cast<eMujocoModelParam>( i ) );
+            mju_copy( m_MjcPrivateModel.get()->*param_array, m_Arrays[i].data(), m_Arrays[i].size() );
+            m_Arrays[i] = std::vector<mjtNum>();
+        }
+        _ResetView();
+        return m_MjcPrivateModel.get();
+    }
+
+    void TMujocoModelOverlay::Clear()
+    {
+        m_MjcPrivateModel = nullptr;
+        for ( auto& array : m_Arrays )
+            array = std::vector<mjtNum>();
+        _ResetView();
+    }
+
+    void TMujocoModelOverlay::Sync( const mjModel* base_mjc_model )
+    {
+        LOCO_CORE_ASSERT( base_mjc_model, "TMujocoModelOverlay::Sync >>> requires a valid base mjModel reference" );
+        // A private copy holds all its values (options included), so only the view follows the base model
+        m_MjcBaseModelRef = base_mjc_model;
+        if ( !m_MjcPrivateModel )
+            _ResetView();
+    }
+
+    ssize_t TMujocoModelOverlay::num_bytes() const
+    {
+        if ( m_MjcPrivateModel )
+            return sizeof( mjModel ) + m_MjcPrivateModel->nbuffer;
+
+        ssize_t num_bytes = sizeof( mjModel );
+        for ( const auto& array : m_Arrays )
+            num_bytes += array.capacity() * sizeof( mjtNum );
+        return num_bytes;
+    }
+
+    void TMujocoModelOverlay::_ResetView()
+    {
+        // Take every non-overridden value (scalars, options and array pointers) from the base model
+        m_MjcModelView = *m_MjcBaseModelRef;
+        for ( ssize_t i = 0; i < LOCO_MUJOCO_NUM_MODEL_PARAMS; i++ )
+        {
+            if ( m_Arrays[i].empty() )
+                continue;
+            const auto param = static_cast<eMujocoModelParam>( i );
+            LOCO_CORE_ASSERT( (ssize_t)m_Arrays[i].size() == _ParamSize( m_MjcBaseModelRef, param ), "TMujocoModelOverlay::_ResetView >>> \
+                              overridden parameter {0} doesn't match the size of the base model anymore", i );
+            m_MjcModelView.*_ParamArray( param ) = m_Arrays[i].data();
+        }
+    }
+
+    mjtNum* mjModel::* TMujocoModelOverlay::_ParamArray( const eMujocoModelParam& param )
+    {
+        switch ( param )
+        {
+            case eMujocoModelParam::GEOM_FRICTION : return &mjModel::geom_friction;
+            case eMujocoModelParam::GEOM_SIZE : return &mjModel::geom_size;
+            case eMujocoModelParam::GEOM_RBOUND : return &mjModel::geom_rbound;
+            case eMujocoModelParam::BODY_MASS : return &mjModel::body_mass;
+            case eMujocoModelParam::BODY_SUBTREEMASS : return &mjModel::body_subtreemass;
+            case eMujocoModelParam::BODY_INERTIA : return &mjModel::body_inertia;
+            case eMujocoModelParam::DOF_DAMPING : return &mjModel::dof_damping;
+        }
+        return nullptr;
+    }
+
+    ssize_t TMujocoModelOverlay::_ParamSize( const mjModel* mjc_model, const eMujocoModelParam& param )
+    {
+        switch ( param )
+        {
+            case eMujocoModelParam::GEOM_FRICTION : return 3 * mjc_model->ngeom;
+            case eMujocoModelParam::GEOM_SIZE : return 3 * mjc_model->ngeom;
+            case eMujocoModelParam::GEOM_RBOUND : return mjc_model->ngeom;
+            case eMujocoModelParam::BODY_MASS : return mjc_model->nbody;
+            case eMujocoModelParam::BODY_SUBTREEMASS : return mjc_model->nbody;
+            case eMujocoModelParam::BODY_INERTIA : return 3 * mjc_model->nbody;
+            case eMujocoModelParam::DOF_DAMPING : return mjc_model->nv;
+        }
+        return 0;
+    }
+}}
\ No newline at end of file
@@ -0,0 +1,411 @@
+#include <loco_shm_server_mujoco.h>
+#include <loco_simulation_mujoco.h>
+
+#if defined( __linux__ )
+
+#include <cerrno>
+#include <chrono>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+namespace loco {
+namespace mujoco {
+
+    // Offsets of the buffers are aligned to cache-lines
+    static int64_t _AlignToCacheLine( int64_t offset )
+    {
+        return ( ( offset + 63 ) / 64 ) * 64;
+    }
+
+    // Whether or not a process is running (only meaningful for processes in the same pid-namespace)
+    static bool _ProcessAlive( int64_t pid )
+    {
+        return pid > 0 && ( kill( pid, 0 ) == 0 || errno == EPERM );
+    }
+
+    // Whether or not a segment with the given name is being served by a running process
+    static bool _ShmServedByLiveProcess( const std::string& shm_name )
+    {
+        const int shm_fd = shm_open( shm_name.c_str(), O_RDONLY, 0600 );
+        if ( shm_fd < 0 )
+            return false;
+        struct stat shm_stat;
+        if ( fstat( shm_fd, &shm_stat ) != 0 || shm_stat.st_size < (off_t)sizeof( TMujocoShmHeader ) )
+        {
+            close( shm_fd );
+            return false;
+        }
+        void* shm_data = mmap( nullptr, sizeof( TMujocoShmHeader ), PROT_READ, MAP_SHARED, shm_fd, 0 );
+        close( shm_fd );
+        if ( shm_data == MAP_FAILED )
+            return false;
+
+        const auto header = static_cast<const TMujocoShmHeader*>( shm_data );
+        const uint32_t magic = header->magic.load( std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_acquire );
+        const bool served = ( magic == LOCO_MUJOCO_SHM_MAGIC && header->version == LOCO_MUJOCO_SHM_VERSION &&
+                              _ProcessAlive( header->server_pid ) );
+        munmap( shm_data, sizeof( TMujocoShmHeader ) );
+        return served;
+    }
+
+    bool ShmDoorbellWait( std::atomic<uint32_t>* doorbell, uint32_t value, int64_t timeout_ms )
+    {
+        // Spin for a while first (round-trips are usually in the order of microseconds)
+        for ( ssize_t i = 0; i < LOCO_MUJOCO_SHM_SPIN_ITERS; i++ )
+            if ( doorbell->load( std::memory_order_acquire ) != value )
+                return true;
+
+        // Shared (non-private) futex, as waiter and waker live in different processes
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds( std::max<int64_t>( 0, timeout_ms ) );
+        while ( doorbell->load( std::memory_order_acquire ) == value )
+        {
+            struct timespec timeout;
+            struct timespec* timeout_ref = nullptr;
+            if ( timeout_ms >= 0 )
+            {
+                // FUTEX_WAIT takes a relative timeout, so recompute it after every (possibly spurious) wake-up
+                const int64_t remaining_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                    deadline - std::chrono::steady_clock::now() ).count();
+                if ( remaining_ns <= 0 )
+                    return false;
+                timeout.tv_sec = remaining_ns / 1000000000;
+                timeout.tv_nsec = remaining_ns % 1000000000;
+                timeout_ref = &timeout;
+            }
+            syscall( SYS_futex, reinterpret_cast<uint32_t*>( doorbell ), FUTEX_WAIT, value, timeout_ref, nullptr, 0 );
+        }
+        return true;
+    }
+
+    void ShmDoorbellRing( std::atomic<uint32_t>* doorbell )
+    {
+        syscall( SYS_futex, reinterpret_cast<uint32_t*>( doorbell ), FUTEX_WAKE, INT32_MAX, nullptr, nullptr, 0 );
+    }
+
+    TMujocoShmServer::TMujocoShmServer( TMujocoSimulation* simulation_ref, const std::string& shm_name )
+    {
+        LOCO_CORE_ASSERT( simulation_ref, "TMujocoShmServer >>> must have a valid simulation reference (got nullptr)" );
+
+        m_SimulationRef = simulation_ref;
+        m_ShmName = shm_name;
+        m_ShmData = nullptr;
+        m_ShmSize = 0;
+        m_Header = nullptr;
+        m_LastRequestSeq = 0;
+        m_RewardFcn = nullptr;
+        m_RequestTimeoutMs = -1;
+    }
+
+    TMujocoShmServer::~TMujocoShmServer()
+    {
+        _Release();
+    }
+
+    bool TMujocoShmServer::Start()
+    {
+        const mjModel* mjc_model = m_SimulationRef->mjc_model();
+        if ( !mjc_model || !m_SimulationRef->mjc_data() )
+        {
+            LOCO_CORE_ERROR( "TMujocoShmServer::Start >>> simulation must be initialized before serving it" );
+            return false;
+        }
+
+        const int64_t qpos_offset = _AlignToCacheLine( sizeof( TMujocoShmHeader ) );
+        const int64_t qvel_offset = _AlignToCacheLine( qpos_offset + sizeof( mjtNum ) * mjc_model->nq );
+        const int64_t sensordata_offset = _AlignToCacheLine( qvel_offset + sizeof( mjtNum ) * mjc_model->nv );
+        const int64_t ctrl_offset = _AlignToCacheLine( sensordata_offset + sizeof( mjtNum ) * mjc_model->nsensordata );
+        const int64_t total_size = _AlignToCacheLine( ctrl_offset + sizeof( mjtNum ) * mjc_model->nu );
+
+        // Always create a fresh object: an existing one is either served by another process (can't be shared),
+        // or stale (e.g. left by a crashed server, with a layout and sequence numbers that can't be trusted)
+        int shm_fd = shm_open( m_ShmName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600 );
+        if ( shm_fd < 0 && errno == EEXIST )
+        {
+            if ( _ShmServedByLiveProcess( m_ShmName ) )
+            {
+                LOCO_CORE_ERROR( "TMujocoShmServer::Start >>> shared-memory object {0} is already being served \
+                                  by a running process", m_ShmName );
+                return false;
+            }
+            LOCO_CORE_WARN( "TMujocoShmServer::Start >>> replacing stale shared-memory object {0}", m_ShmName );
+            shm_unlink( m_ShmName.c_str() );
+            shm_fd = shm_open( m_ShmName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600 );
+        }
+        if ( shm_fd < 0 )
+        {
+            LOCO_CORE_ERROR( "TMujocoShmServer::Start >>> couldn't create shared-memory object {0}", m_ShmName );
+            return false;
+        }
+        if ( ftruncate( shm_fd, total_size ) != 0 )
+        {
+            LOCO_CORE_ERROR( "TMujocoShmServer::Start >>> couldn't resize shared-memory object {0} to {1} bytes", m_ShmName, total_size );
+            close( shm_fd );
+            shm_unlink( m_ShmName.c_str() );
+            return false;
+        }
+        void* shm_data = mmap( nullptr, total_size, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0 );
+        close( shm_fd );
+        if ( shm_data == MAP_FAILED )
+        {
+            LOCO_CORE_ERROR( "TMujocoShmServer::Start >>> couldn't map shared-memory object {0}", m_ShmName );
+            shm_unlink( m_ShmName.c_str() );
+            return false;
+        }
+
+        m_ShmData = shm_data;
+        m_ShmSize = total_size;
+        m_Header = new ( m_ShmData ) TMujocoShmHeader();
+        m_Header->server_pid = getpid();
+        m_Header->nq = mjc_model->nq;
+        m_Header->nv = mjc_model->nv;
+        m_Header->nu = mjc_model->nu;
+        m_Header->nsensordata = mjc_model->nsensordata;
+        m_Header->qpos_offset = qpos_offset;
+        m_Header->qvel_offset = qvel_offset;
+        m_Header->sensordata_offset = sensordata_offset;
+        m_Header->ctrl_offset = ctrl_offset;
+        m_Header->total_size = total_size;
+        m_Header->request_seq.store( 0 );
+        m_Header->command = static_cast<uint32_t>( eShmCommand::NONE );
+        m_Header->client_pid.store( 0 );
+        m_Header->response_seq.store( 0 );
+        m_Header->done = 0;
+        m_Header->reward = 0.0;
+        m_LastRequestSeq = 0;
+        _WriteObservations();
+        // Magic goes last, so clients never see a partially initialized header
+        m_Header->version = LOCO_MUJOCO_SHM_VERSION;
+        std::atomic_thread_fence( std::memory_order_release );
+        m_Header->magic.store( LOCO_MUJOCO_SHM_MAGIC, std::memory_order_relaxed );
+
+        LOCO_CORE_TRACE( "TMujocoShmServer::Start >>> serving simulation on {0} ({1} bytes)", m_ShmName, total_size );
+        return true;
+    }
+
+    void TMujocoShmServer::Serve()
+    {
+        while ( ServeOnce() ) {}
+    }
+
+    bool TMujocoShmServer::ServeOnce()
+    {
+        if ( !m_Header )
+        {
+            LOCO_CORE_ERROR( "TMujocoShmServer::ServeOnce >>> server must be started first" );
+            return false;
+        }
+
+        // Wait for the next request in slices, so a client that died mid-session doesn't block the server forever
+        const auto t_start = std::chrono::steady_clock::now();
+        while ( m_Header->request_seq.load( std::memory_order_acquire ) == m_LastRequestSeq )
+        {
+            int64_t wait_ms = LOCO_MUJOCO_SHM_LIVENESS_PERIOD_MS;
+            if ( m_RequestTimeoutMs >= 0 )
+            {
+                const int64_t elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                                std::chrono::steady_clock::now() - t_start ).count();
+                if ( elapsed_ms >= m_RequestTimeoutMs )
+                {
+                    LOCO_CORE_ERROR( "TMujocoShmServer::ServeOnce >>> no request arrived to {0} within {1} ms", m_ShmName, m_RequestTimeoutMs );
+                    return false;
+                }
+                wait_ms = std::min( wait_ms, m_RequestTimeoutMs - elapsed_ms );
+            }
+            if ( ShmDoorbellWait( &m_Header->request_seq, m_LastRequestSeq, wait_ms ) )
+                continue;
+            // Not connected yet is fine (only the timeout applies), but a client that died won't send anything
+            const int64_t client_pid = m_Header->client_pid.load( std::memory_order_acquire );
+            if ( client_pid != 0 && !_ProcessAlive( client_pid ) &&
+                 m_Header->request_seq.load( std::memory_order_acquire ) == m_LastRequestSeq )
+            {
+                LOCO_CORE_ERROR( "TMujocoShmServer::ServeOnce >>> client of {0} (pid {1}) is no longer running", m_ShmName, client_pid );
+                m_Header->client_pid.store( 0, std::memory_order_release );
+                return false;
+            }
+        }
+        const uint32_t request_seq = m_Header->request_seq.load( std::memory_order_acquire );
+        const auto command = static_cast<eShmCommand>( m_Header->command );
+        m_LastRequestSeq = request_seq;
+
+        mjData* mjc_data = m_SimulationRef->mjc_data();
+        if ( command == eShmCommand::STEP )
+        {
+            mju_copy( mjc_data->ctrl, _BufferCtrl(), m_Header->nu );
+            m_SimulationRef->Step();
+            bool done = false;
+            m_Header->reward = m_RewardFcn ? m_RewardFcn( m_SimulationRef, done ) : 0.0;
+            m_Header->done = done ? 1 : 0;
+        }
+        else if ( command == eShmCommand::RESET )
+        {
+            m_SimulationRef->Reset();
+            m_Header->reward = 0.0;
+            m_Header->done = 0;
+        }
+        _WriteObservations();
+
+        m_Header->response_seq.store( request_seq, std::memory_order_release );
+        ShmDoorbellRing( &m_Header->response_seq );
+        return command != eShmCommand::CLOSE;
+    }
+
+    void TMujocoShmServer::_WriteObservations()
+    {
+        const mjModel* mjc_model = m_SimulationRef->mjc_model();
+        const mjData* mjc_data = m_SimulationRef->mjc_data();
+        uint8_t* shm_bytes = static_cast<uint8_t*>( m_ShmData );
+        mju_copy( reinterpret_cast<mjtNum*>( shm_bytes + m_Header->qpos_offset ), mjc_data->qpos, mjc_model->nq );
+        mju_copy( reinterpret_cast<mjtNum*>( shm_bytes + m_Header->qvel_offset ), mjc_data->qvel, mjc_model->nv );
+        mju_copy( reinterpret_cast<mjtNum*>( shm_bytes + m_Header->sensordata_offset ), mjc_data->sensordata, mjc_model->nsensordata );
+        m_Header->time = mjc_data->time;
+    }
+
+    void TMujocoShmServer::_Release()
+    {
+        if ( m_ShmData )
+        {
+            munmap( m_ShmData, m_ShmSize );
+            shm_unlink( m_ShmName.c_str() );
+        }
+        m_ShmData = nullptr;
+        m_ShmSize = 0;
+        m_Header = nullptr;
+    }
+
+    TMujocoShmClient::TMujocoShmClient( const std::string& shm_name )
+    {
+        m_ShmName = shm_name;
+        m_ShmData = nullptr;
+        m_ShmSize = 0;
+        m_Header = nullptr;
+        m_RequestTimeoutMs = -1;
+    }
+
+    TMujocoShmClient::~TMujocoShmClient()
+    {
+        // Leave the segment free for other clients
+        int64_t client_pid = getpid();
+        if ( m_Header )
+            m_Header->client_pid.compare_exchange_strong( client_pid, 0, std::memory_order_acq_rel );
+        if ( m_ShmData )
+            munmap( m_ShmData, m_ShmSize );
+        m_ShmData = nullptr;
+        m_Header = nullptr;
+    }
+
+    bool TMujocoShmClient::Connect()
+    {
+        const int shm_fd = shm_open( m_ShmName.c_str(), O_RDWR, 0600 );
+        if ( shm_fd < 0 )
+        {
+            LOCO_CORE_ERROR( "TMujocoShmClient::Connect >>> couldn't open shared-memory object {0}", m_ShmName );
+            return false;
+        }
+        struct stat shm_stat;
+        if ( fstat( shm_fd, &shm_stat ) != 0 || shm_stat.st_size < (off_t)sizeof( TMujocoShmHeader ) )
+        {
+            LOCO_CORE_ERROR( "TMujocoShmClient::Connect >>> shared-memory object {0} isn't ready yet", m_ShmName );
+            close( shm_fd );
+            return false;
+        }
+        void* shm_data = mmap( nullptr, shm_stat.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0 );
+        close( shm_fd );
+        if ( shm_data == MAP_FAILED )
+        {
+            LOCO_CORE_ERROR( "TMujocoShmClient::Connect >>> couldn't map shared-memory object {0}", m_ShmName );
+            return false;
+        }
+
+        // Load the magic first, then fence (pairs with the server's release fence before publishing the magic)
+        auto header = static_cast<TMujocoShmHeader*>( shm_data );
+        const uint32_t magic = header->magic.load( std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_acquire );
+        if ( magic != LOCO_MUJOCO_SHM_MAGIC || header->version != LOCO_MUJOCO_SHM_VERSION )
+        {
+            LOCO_CORE_ERROR( "TMujocoShmClient::Connect >>> shared-memory object {0} wasn't created by a compatible \
+                             server (magic={1}, version={2})", m_ShmName, magic, header->version );
+            munmap( shm_data, shm_stat.st_size );
+            return false;
+        }
+
+        // Claim the segment, unless another client that is still running holds it
+        int64_t client_pid = header->client_pid.load( std::memory_order_acquire );
+        while ( client_pid != getpid() )
+        {
+            if ( client_pid != 0 && _ProcessAlive( client_pid ) )
+            {
+                LOCO_CORE_ERROR( "TMujocoShmClient::Connect >>> shared-memory object {0} is already used by client \
+                                  process {1}", m_ShmName, client_pid );
+                munmap( shm_data, shm_stat.st_size );
+                return false;
+            }
+            if ( header->client_pid.compare_exchange_weak( client_pid, getpid(), std::memory_order_acq_rel ) )
+                break;
+        }
+
+        m_ShmData = shm_data;
+        m_ShmSize = shm_stat.st_size;
+        m_Header = header;
+        return true;
+    }
+
+    bool TMujocoShmClient::Step()
+    {
+        return _Request( eShmCommand::STEP );
+    }
+
+    bool TMujocoShmClient::Reset()
+    {
+        return _Request( eShmCommand::RESET );
+    }
+
+    bool TMujocoShmClient::Close()
+    {
+        return _Request( eShmCommand::CLOSE );
+    }
+
+    bool TMujocoShmClient::_Request( const eShmCommand& command )
+    {
+        LOCO_CORE_ASSERT( m_Header, "TMujocoShmClient::_Request >>> client must be connected first" );
+
+        // A segment has a single client, which is the only writer of request_seq (so a load+store is enough)
+        m_Header->command = static_cast<uint32_t>( command );
+        const uint32_t request_seq = m_Header->request_seq.load( std::memory_order_relaxed ) + 1;
+        m_Header->request_seq.store( request_seq, std::memory_order_release );
+        ShmDoorbellRing( &m_Header->request_seq );
+
+        // Wait for the server to answer this very request, in slices, so a server that died is detected
+        const auto t_start = std::chrono::steady_clock::now();
+        uint32_t response_seq = m_Header->response_seq.load( std::memory_order_acquire );
+        while ( response_seq != request_seq )
+        {
+            int64_t wait_ms = LOCO_MUJOCO_SHM_LIVENESS_PERIOD_MS;
+            if ( m_RequestTimeoutMs >= 0 )
+            {
+                const int64_t elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                                std::chrono::steady_clock::now() - t_start ).count();
+                if ( elapsed_ms >= m_RequestTimeoutMs )
+                {
+                    LOCO_CORE_ERROR( "TMujocoShmClient::_Request >>> server of {0} didn't answer within {1} ms", m_ShmName, m_RequestTimeoutMs );
+                    return false;
+                }
+                wait_ms = std::min( wait_ms, m_RequestTimeoutMs - elapsed_ms );
+            }
+            if ( !ShmDoorbellWait( &m_Header->response_seq, response_seq, wait_ms ) && !_ProcessAlive( m_Header->server_pid ) )
+            {
+                LOCO_CORE_ERROR( "TMujocoShmClient::_Request >>> server of {0} (pid {1}) is no longer running", m_ShmName, m_Header->server_pid );
+                return false;
+            }
+            response_seq = m_Header->response_seq.load( std::memory_order_acquire );
+        }
+        return true;
+    }
+}}
+
+#endif /* __linux__ */
\ No newline at end of file
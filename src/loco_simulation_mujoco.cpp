@@ -9,10 +9,14 @@ namespace loco
     ////    * Within the _InitializeInternal method is where the bulk of the process happens :
     ////        > First we collect the mjcf-xml data from the adapters, created during their "Build" method.
     ////        > We then assemble these xml-data into a single xml-data object that represents the
-    ////          simulation-model. We save this xml-data into disk to load it later using the MuJoCo-API.
-    ////        > Finally, we load the simulation-model from the xml-data on disk using the MuJoCo-API,
-    ////          creating the internal mujoco-simulation, and pass the handle to the mujoco-internals
-    ////          (mjModel, mjData) to the adapters for their proper use.
+    ////          simulation-model. This xml-data, along with the in-memory assets generated by the
+    ////          adapters (e.g. user-defined binary meshes), is registered into a virtual file-system.
+    ////        > Finally, we compile the simulation-model from the virtual file-system using the MuJoCo-API
+    ////          (nothing is written to disk, unless a debug-dump was requested), creating the internal
+    ////          mujoco-simulation, and pass the handle to the mujoco-internals (mjModel, mjData) to
+    ////          the adapters for their proper use. If the model-cache is enabled, the compiled model is
+    ////          stored as a binary (.mjb) keyed by the contents of the xml and its assets, and later
+    ////          loaded directly from it (skipping xml-parsing and compilation) when the key matches.
 
     bool TMujocoSimulation::s_HasActivatedMujoco = false;
 
@@ -23,8 +27,22 @@ namespace loco
 
         m_MjcModel = nullptr;
         m_MjcData = nullptr;
+        m_MjcNameIndex = nullptr;
+        m_MjcContactBuffer = nullptr;
+        m_MjcStateRing = nullptr;
+        m_MjcResetImage = nullptr;
+        m_AsyncStepper = nullptr;
+    #if defined( __linux__ ) || defined( __APPLE__ )
+        m_TrajectoryRecorder = nullptr;
+        m_TrajectoryReader = nullptr;
+        m_MjcPreReplayImage = nullptr;
+    #endif
         m_MjcfSimulationElement = nullptr;
 
+        // Dumping the generated mjcf (and its assets) to disk is opt-in, as the model is compiled from memory
+        if ( const char* mjcf_dump_filepath = std::getenv( "LOCO_MUJOCO_MJCF_DUMP" ) )
+            m_MjcfDumpFilepath = mjcf_dump_filepath;
+
         _CreateSingleBodyAdapters();
         _CreateKinematicTreeAdapters();
 
@@ -60,8 +78,22 @@ namespace loco
 
     TMujocoSimulation::~TMujocoSimulation()
     {
+        // Stop stepping asynchronously before releasing the resources the worker uses
+        m_AsyncStepper = nullptr;
+        // Wait for a pending rebuild (the compile-job uses this simulation's resources), and drop its model
+        if ( m_PendingMjcModel.valid() )
+            mj_deleteModel( m_PendingMjcModel.get() );
+    #if defined( __linux__ ) || defined( __APPLE__ )
+        m_TrajectoryRecorder = nullptr;
+        m_TrajectoryReader = nullptr;
+        m_MjcPreReplayImage = nullptr;
+    #endif
         m_MjcModel = nullptr;
         m_MjcData = nullptr;
+        m_MjcNameIndex = nullptr;
+        m_MjcContactBuffer = nullptr;
+        m_MjcStateRing = nullptr;
+        m_MjcResetImage = nullptr;
         m_MjcfSimulationElement = nullptr;
 
     #if defined( LOCO_CORE_USE_TRACK_ALLOCS )
@@ -73,6 +105,37 @@ namespace loco
     }
 
     bool TMujocoSimulation::_InitializeInternal()
+    {
+        const std::string mjcf_xml_str = _AssembleMjcfXml();
+        const auto vfs_resources = _CollectVfsResources();
+        // Store the xml-resources for this simulation into disk (only if requested, for debugging)
+        if ( !m_MjcfDumpFilepath.empty() )
+            _DumpMjcfResources( mjcf_xml_str, vfs_resources );
+
+        if ( !TMujocoSimulation::s_HasActivatedMujoco )
+        {
+            mj_activate( loco::mujoco::LOCO_MUJOCO_LICENSE.c_str() );
+            TMujocoSimulation::s_HasActivatedMujoco = true;
+        }
+
+        // Load the simulation from the in-memory xml-resources created above (or model-cache) *****
+        m_MjcModel = std::unique_ptr<mjModel, mujoco::MjcModelDeleter>( _LoadMjcModel( mjcf_xml_str, vfs_resources ) );
+        if ( !m_MjcModel )
+            return false;
+        _LinkMjcModel();
+
+        LOCO_CORE_TRACE( "MuJoCo-backend >>> total-nq: {0}", m_MjcModel->nq );
+        LOCO_CORE_TRACE( "MuJoCo-backend >>> total-nv: {0}", m_MjcModel->nv );
+        LOCO_CORE_TRACE( "MuJoCo-backend >>> total-nu: {0}", m_MjcModel->nu );
+        LOCO_CORE_TRACE( "MuJoCo-backend >>> total-nbody: {0}", m_MjcModel->nbody );
+        LOCO_CORE_TRACE( "MuJoCo-backend >>> total-njnt: {0}", m_MjcModel->njnt );
+        LOCO_CORE_TRACE( "MuJoCo-backend >>> total-ngeom: {0}", m_MjcModel->ngeom );
+        LOCO_CORE_TRACE( "MuJoCo-backend >>> total-nsensor: {0}", m_MjcModel->nsensor );
+
+        return true;
+    }
+
+    std::string TMujocoSimulation::_AssembleMjcfXml()
     {
         // Create empty mjcf-xml structure to store the simulation resources
         const std::string empty_mjcf_str =
@@ -100,27 +163,31 @@ namespace loco
 
         _CollectResourcesFromSingleBodies();
         _CollectResourcesFromKinematicTrees();
+        _CollectResourcesFromReservedSlots();
 
-        // Store the xml-resources for this simulation into disk
-        m_MjcfSimulationElement->SaveToXml( "simulation.xml" );
-
-        if ( !TMujocoSimulation::s_HasActivatedMujoco )
-        {
-            mj_activate( loco::mujoco::LOCO_MUJOCO_LICENSE.c_str() );
-            TMujocoSimulation::s_HasActivatedMujoco = true;
-        }
+        return m_MjcfSimulationElement->ToString();
+    }
 
-        // Load the simulation from the xml-file created above *************************************
-        const size_t error_buffer_size = 1000;
-        char error_buffer[error_buffer_size];
-        m_MjcModel = std::unique_ptr<mjModel, mujoco::MjcModelDeleter>( mj_loadXML( "simulation.xml", nullptr, error_buffer, error_buffer_size ) );
-        if ( !m_MjcModel )
-        {
-            LOCO_CORE_ERROR( "TMujocoSimulation::_InitializeInternal >>> Couldn't initialize mujoco-API" );
-            LOCO_CORE_ERROR( "\tError-message   : {0}", error_buffer );
-            return false;
-        }
+    void TMujocoSimulation::_LinkMjcModel()
+    {
         m_MjcData = std::unique_ptr<mjData, mujoco::MjcDataDeleter>( mj_makeData( m_MjcModel.get() ) );
+        // Index all names once, so adapters don't have to linearly scan for them (mj_name2id)
+        m_MjcNameIndex = std::make_unique<mujoco::TMujocoNameIndex>();
+        m_MjcNameIndex->Build( m_MjcModel.get() );
+        // Allocate all storage required for contacts collection up-front
+        m_MjcContactBuffer = std::make_unique<mujoco::TMujocoContactBuffer>();
+        m_MjcContactBuffer->Resize( m_MjcModel.get() );
+        for ( const auto& collider_name : m_ContactForcesSubscriptions )
+            SetContactForcesSubscription( collider_name, true );
+        // Allocate the ring of checkpoints up-front (saving|restoring a state doesn't allocate)
+        m_MjcStateRing = std::make_unique<mujoco::TMujocoStateRing>();
+        m_MjcStateRing->Resize( m_MjcModel.get(), m_StateRingCapacity );
+        m_MjcResetImage = std::make_unique<mujoco::TMujocoStateImage>();
+        m_MjcResetImage->Allocate( m_MjcModel.get() );
+        m_MjcBodySlots = std::make_unique<mujoco::TMujocoBodySlotsManager>( m_MjcModel.get(), m_MjcData.get() );
+        m_MjcBodySlots->SetMjcModelUniqueFn( _MjcModelUniqueFn() );
+        m_NumRecycledParked = 0;
+        _RegisterReservedSlots();
         //******************************************************************************************
 
         for ( auto& single_body_adapter : m_SingleBodyAdapters )
@@ -129,6 +196,8 @@ namespace loco
             {
                 mjc_adapter->SetMjcModel( m_MjcModel.get() );
                 mjc_adapter->SetMjcData( m_MjcData.get() );
+                mjc_adapter->SetMjcNameIndex( m_MjcNameIndex.get() );
+                mjc_adapter->SetMjcModelUniqueFn( _MjcModelUniqueFn() );
             }
         }
         for ( auto& kinematic_tree_adapter : m_KinematicTreeAdapters )
@@ -137,23 +206,73 @@ namespace loco
             {
                 mjc_adapter->SetMjcModel( m_MjcModel.get() );
                 mjc_adapter->SetMjcData( m_MjcData.get() );
+                mjc_adapter->SetMjcNameIndex( m_MjcNameIndex.get() );
+                mjc_adapter->SetMjcModelUniqueFn( _MjcModelUniqueFn() );
             }
         }
 
         // Take a single step of kinematics computation (to put everything in place)
         mj_kinematics( m_MjcModel.get(), m_MjcData.get() );
+    }
 
-        LOCO_CORE_TRACE( "MuJoCo-backend >>> total-nq: {0}", m_MjcModel->nq );
-        LOCO_CORE_TRACE( "MuJoCo-backend >>> total-nv: {0}", m_MjcModel->nv );
-        LOCO_CORE_TRACE( "MuJoCo-backend >>> total-nu: {0}", m_MjcModel->nu );
-        LOCO_CORE_TRACE( "MuJoCo-backend >>> total-nbody: {0}", m_MjcModel->nbody );
-        LOCO_CORE_TRACE( "MuJoCo-backend >>> total-njnt: {0}", m_MjcModel->njnt );
-        LOCO_CORE_TRACE( "MuJoCo-backend >>> total-ngeom: {0}", m_MjcModel->ngeom );
-        LOCO_CORE_TRACE( "MuJoCo-backend >>> total-nsensor: {0}", m_MjcModel->nsensor );
+    ssize_t TMujocoSimulation::SaveState()
+    {
+        if ( _BlockedByAsync( "TMujocoSimulation::SaveState" ) )
+            return -1;
+        if ( !m_MjcModel || !m_MjcData || !m_MjcStateRing )
+        {
+            LOCO_CORE_ERROR( "TMujocoSimulation::SaveState >>> simulation must be initialized before saving its state" );
+            return -1;
+        }
+        return m_MjcStateRing->Save( m_MjcModel.get(), m_MjcData.get(), m_WorldTime );
+    }
+
+    bool TMujocoSimulation::RestoreState( ssize_t checkpoint_id, bool recompute_derived )
+    {
+        if ( _BlockedByAsync( "TMujocoSimulation::RestoreState" ) )
+            return false;
+        if ( !m_MjcModel || !m_MjcData || !m_MjcStateRing )
+        {
+            LOCO_CORE_ERROR( "TMujocoSimulation::RestoreState >>> simulation must be initialized before restoring a state" );
+            return false;
+        }
 
+        const auto state_image = m_MjcStateRing->Get( checkpoint_id );
+        if ( !state_image )
+        {
+            LOCO_CORE_ERROR( "TMujocoSimulation::RestoreState >>> checkpoint {0} is not available (either never saved, \
+                             or already overwritten; ring-capacity={1})", checkpoint_id, m_MjcStateRing->capacity() );
+            return false;
+        }
+        state_image->Restore( m_MjcModel.get(), m_MjcData.get() );
+        m_WorldTime = state_image->world_time;
+        // A pending phase-1 was computed from the state just overwritten
+        m_StepPhase1Done = false;
+    #if defined( __linux__ ) || defined( __APPLE__ )
+        // The state jumped, so the next record must be a keyframe (replays can't integrate across the jump)
+        if ( m_TrajectoryRecorder )
+            m_TrajectoryRecorder->MarkDiscontinuity();
+    #endif
+        // Recompute derived quantities (kinematics, contacts, ...) from the restored state
+        if ( recompute_derived )
+            mj_forward( m_MjcModel.get(), m_MjcData.get() );
+        m_ContactsDirty = true;
         return true;
     }
 
+    void TMujocoSimulation::SetStateRingCapacity( ssize_t capacity )
+    {
+        if ( capacity < 1 )
+        {
+            LOCO_CORE_WARN( "TMujocoSimulation::SetStateRingCapacity >>> capacity must be at least 1 (got {0})", capacity );
+            return;
+        }
+        m_StateRingCapacity = capacity;
+        // Resizing drops all checkpoints saved so far
+        if ( m_MjcStateRing )
+            m_MjcStateRing->Resize( m_MjcModel.get(), m_StateRingCapacity );
+    }
+
     void TMujocoSimulation::_CollectResourcesFromSingleBodies()
     {
         LOCO_CORE_ASSERT( m_MjcfSimulationElement, "TMujocoSimulation::_CollectResourcesFromSingleBodies >>> \
@@ -167,7 +286,8 @@ namespace loco
         LOCO_CORE_ASSERT( assets_element, "TMujocoSimulation::_CollectResourcesFromSingleBodies >>> \
                           there is no asset element in the mjcf-simulation-element" );
 
-        for ( auto& single_body_adapter : m_SingleBodyAdapters )
+        for ( auto adapters_list : { &m_SingleBodyAdapters, &m_PendingSingleBodyAdapters } )
+        for ( auto& single_body_adapter : *adapters_list )
         {
             if ( !single_body_adapter )
             {
@@ -261,7 +381,8 @@ namespace loco
         LOCO_CORE_ASSERT( assets_element, "TMujocoSimulation::_CollectResourcesFromKinematicTrees >>> \
                           there is no asset element in the mjcf-simulation-element" );
 
-        for ( auto& kinematic_tree_adapter : m_KinematicTreeAdapters )
+        for ( auto adapters_list : { &m_KinematicTreeAdapters, &m_PendingKinematicTreeAdapters } )
+        for ( auto& kinematic_tree_adapter : *adapters_list )
         {
             if ( !kinematic_tree_adapter )
             {
@@ -275,69 +396,286 @@ namespace loco
             LOCO_CORE_ASSERT( mjcf_element, "TMujocoSimulation::_CollectResourcesFromKinematicTrees >>> \
                               kinematic-tree mjc-adapter must have a mjcf-element with its resources on it (got nullptr instead)" );
             simulation_element->Add( parsing::TElement::CloneElement( mjcf_element ) );
+
+            if ( auto mjcf_assets_element = mjc_adapter->element_assets_resources() )
+            {
+                for ( ssize_t i = 0; i < mjcf_assets_element->num_children(); i++ )
+                {
+                    auto asset_element = mjcf_assets_element->get_child( i );
+                    const std::string asset_id = asset_element->GetString( "name" );
+                    if ( m_MjcfAssetsNames.find( asset_id ) != m_MjcfAssetsNames.end() )
+                        continue; // asset-id already cached
+                    m_MjcfAssetsNames.emplace( asset_id );
+                    assets_element->Add( parsing::TElement::CloneElement( asset_element ) );
+                }
+            }
         }
     }
 
-    void TMujocoSimulation::_CollectContacts()
+    void TMujocoSimulation::ReserveBodySlots( const eShapeType& shape, const TVec3& size, ssize_t num_slots )
     {
-        LOCO_CORE_ASSERT( m_MjcModel, "TMujocoSimulation::_CollectContacts >>> mjModel struct is required \
-                          for collecting the contacts from the internal engine" );
-        LOCO_CORE_ASSERT( m_MjcModel, "TMujocoSimulation::_CollectContacts >>> mjData struct is required \
-                          for collecting the contacts from the internal engine" );
+        if ( m_MjcModel )
+        {
+            LOCO_CORE_WARN( "TMujocoSimulation::ReserveBodySlots >>> slots must be reserved before initialization, \
+                             these will only be added on the next one" );
+        }
+        if ( shape == eShapeType::CONVEX_MESH || shape == eShapeType::HEIGHTFIELD ||
+             shape == eShapeType::COMPOUND || shape == eShapeType::PLANE )
+        {
+            LOCO_CORE_ERROR( "TMujocoSimulation::ReserveBodySlots >>> only primitive shapes can be reserved, got {0}", ToString( shape ) );
+            return;
+        }
+        if ( num_slots < 1 )
+            return;
+
+        mujoco::TMujocoBodySlotsReservation reservation;
+        reservation.shape = shape;
+        reservation.size = size;
+        reservation.num_slots = num_slots;
+        m_BodySlotsReservations.push_back( reservation );
+    }
 
-        std::map< std::string, std::vector<TContactData> > detected_contacts;
-        ssize_t num_contacts = m_MjcData->ncon;
-        for ( ssize_t i = 0; i < num_contacts; i++ )
+    void TMujocoSimulation::_CollectResourcesFromReservedSlots()
+    {
+        auto world_body_element = m_MjcfSimulationElement->GetFirstChildOfType( mujoco::LOCO_MJCF_WORLDBODY_TAG );
+        LOCO_CORE_ASSERT( world_body_element, "TMujocoSimulation::_CollectResourcesFromReservedSlots >>> \
+                          there is no world-body element in the mjcf-simulation-element" );
+
+        // Hidden bodies start at the first cells of the rest-grid, without collisions (parked once registered)
+        ssize_t rest_cell = 0;
+        for ( ssize_t r = 0; r < m_BodySlotsReservations.size(); r++ )
         {
-            auto& mjc_contact_info = m_MjcData->contact[i];
-            if ( mjc_contact_info.geom1 == -1 || mjc_contact_info.geom2 == -1 )
+            const auto& reservation = m_BodySlotsReservations[r];
+            for ( ssize_t i = 0; i < reservation.num_slots; i++ )
             {
-                LOCO_CORE_WARN( "TMujocoSimulation::_CollectContacts >>> got a contact without geom-id information" );
-                continue;
+                const std::string slot_name = mujoco::LOCO_MUJOCO_RESERVED_SLOT_PREFIX + std::to_string( r ) + "_" + std::to_string( i );
+                auto body_element = world_body_element->Add( mujoco::LOCO_MJCF_BODY_TAG );
+                body_element->SetString( "name", slot_name );
+                body_element->SetVec3( "pos", mujoco::TMujocoBodySlotsManager::RestCellPosition( rest_cell++ ) );
+                auto joint_element = body_element->Add( "freejoint" );
+                joint_element->SetString( "name", slot_name + "_freejnt" );
+                auto geom_element = body_element->Add( mujoco::LOCO_MJCF_GEOM_TAG );
+                geom_element->SetString( "name", slot_name + "_geom" );
+                geom_element->SetString( "type", mujoco::enumShape_to_mjcShape( reservation.shape ) );
+                geom_element->SetArrayFloat( "size", mujoco::size_to_mjcSize( reservation.shape, reservation.size ) );
+                geom_element->SetInt( "contype", 0 );
+                geom_element->SetInt( "conaffinity", 0 );
             }
+        }
+    }
 
-            const std::string collider_1 = mj_id2name( m_MjcModel.get(), mjOBJ_GEOM, mjc_contact_info.geom1 );
-            const std::string collider_2 = mj_id2name( m_MjcModel.get(), mjOBJ_GEOM, mjc_contact_info.geom2 );
+    void TMujocoSimulation::_RegisterReservedSlots()
+    {
+        for ( ssize_t r = 0; r < m_BodySlotsReservations.size(); r++ )
+        {
+            const auto& reservation = m_BodySlotsReservations[r];
+            for ( ssize_t i = 0; i < reservation.num_slots; i++ )
+            {
+                const std::string slot_name = mujoco::LOCO_MUJOCO_RESERVED_SLOT_PREFIX + std::to_string( r ) + "_" + std::to_string( i );
+                const ssize_t body_id = mujoco::mjc_name2id( m_MjcModel.get(), m_MjcNameIndex.get(), mjOBJ_BODY, slot_name );
+                const ssize_t geom_id = mujoco::mjc_name2id( m_MjcModel.get(), m_MjcNameIndex.get(), mjOBJ_GEOM, slot_name + "_geom" );
+                if ( body_id < 0 || geom_id < 0 )
+                {
+                    LOCO_CORE_ERROR( "TMujocoSimulation::_RegisterReservedSlots >>> couldn't find reserved slot {0}", slot_name );
+                    continue;
+                }
+                m_MjcBodySlots->AddReservedSlot( body_id, geom_id, reservation.shape, reservation.size );
+            }
+        }
+    }
+
+    std::vector<const mujoco::TMjcVfsFile*> TMujocoSimulation::_CollectVfsResources() const
+    {
+        std::vector<const mujoco::TMjcVfsFile*> vfs_resources;
+        for ( auto adapters_list : { &m_SingleBodyAdapters, &m_PendingSingleBodyAdapters } )
+        for ( auto& single_body_adapter : *adapters_list )
+        {
+            auto mjc_adapter = dynamic_cast<primitives::TMujocoSingleBodyAdapter*>( single_body_adapter.get() );
+            if ( !mjc_adapter )
+                continue;
+            if ( auto vfs_mesh_resource = mjc_adapter->vfs_mesh_resource() )
+                vfs_resources.push_back( vfs_mesh_resource );
+        }
+        for ( auto adapters_list : { &m_KinematicTreeAdapters, &m_PendingKinematicTreeAdapters } )
+        for ( auto& kinematic_tree_adapter : *adapters_list )
+        {
+            auto mjc_adapter = dynamic_cast<kintree::TMujocoKinematicTreeAdapter*>( kinematic_tree_adapter.get() );
+            if ( !mjc_adapter )
+                continue;
+            auto kintree_vfs_resources = mjc_adapter->vfs_resources();
+            vfs_resources.insert( vfs_resources.end(), kintree_vfs_resources.begin(), kintree_vfs_resources.end() );
+        }
+        return vfs_resources;
+    }
+
+    std::vector<std::string> TMujocoSimulation::_CollectAssetFilepaths( const std::vector<const mujoco::TMjcVfsFile*>& vfs_resources ) const
+    {
+        std::set<std::string> vfs_filenames;
+        for ( auto vfs_resource : vfs_resources )
+            vfs_filenames.emplace( vfs_resource->filename );
+
+        std::vector<std::string> asset_filepaths;
+        auto assets_element = m_MjcfSimulationElement->GetFirstChildOfType( mujoco::LOCO_MJCF_ASSET_TAG );
+        for ( ssize_t i = 0; i < assets_element->num_children(); i++ )
+        {
+            auto asset_element = assets_element->get_child( i );
+            if ( !asset_element->HasAttributeString( "file" ) )
+                continue;
+            const std::string asset_file = asset_element->GetString( "file" );
+            if ( vfs_filenames.find( asset_file ) == vfs_filenames.end() )
+                asset_filepaths.push_back( asset_file );
+        }
+        return asset_filepaths;
+    }
 
-            const TVec3 position = { (TScalar) mjc_contact_info.pos[0],
-                                     (TScalar) mjc_contact_info.pos[1],
-                                     (TScalar) mjc_contact_info.pos[2] };
-            const TVec3 normal = { (TScalar) mjc_contact_info.frame[0],
-                                   (TScalar) mjc_contact_info.frame[1],
-                                   (TScalar) mjc_contact_info.frame[2] };
+    mjModel* TMujocoSimulation::_LoadMjcModel( const std::string& mjcf_xml_str,
+                                               const std::vector<const mujoco::TMjcVfsFile*>& vfs_resources ) const
+    {
+        std::string cache_key = "";
+        if ( mujoco::TMujocoModelCache::enabled() )
+        {
+            // Key depends on the final mjcf-xml, and the contents of all assets it references
+            cache_key = mujoco::TMujocoModelCache::ComputeKey( mjcf_xml_str, vfs_resources, _CollectAssetFilepaths( vfs_resources ) );
+            if ( auto mjc_model = mujoco::TMujocoModelCache::Load( cache_key ) )
+                return mjc_model;
+        }
 
-            if ( detected_contacts.find( collider_1 ) == detected_contacts.end() )
-                detected_contacts[collider_1] = std::vector<TContactData>();
-            if ( detected_contacts.find( collider_2 ) == detected_contacts.end() )
-                detected_contacts[collider_2] = std::vector<TContactData>();
+        auto mjc_model = _CompileMjcModel( mjcf_xml_str, vfs_resources );
+        if ( mjc_model && !cache_key.empty() )
+            mujoco::TMujocoModelCache::Store( cache_key, mjc_model );
+        return mjc_model;
+    }
 
-            TContactData contact_1, contact_2;
-            contact_1.position = position;  contact_2.position = position;
-            contact_1.normal = normal;      contact_2.normal = normal.scaled( -1.0 );
-            contact_1.name = collider_2;    contact_2.name = collider_1;
+    mjModel* TMujocoSimulation::_CompileMjcModel( const std::string& mjcf_xml_str,
+                                                  const std::vector<const mujoco::TMjcVfsFile*>& vfs_resources ) const
+    {
+        auto mjc_vfs = std::make_unique<mujoco::TMjcVirtualFileSystem>();
+        mjc_vfs->AddFile( mujoco::LOCO_MUJOCO_VFS_MODEL_FILE, mjcf_xml_str );
+        for ( auto vfs_resource : vfs_resources )
+        {
+            if ( mjc_vfs->HasFile( vfs_resource->filename ) )
+                continue;
+            // Duplicates are skipped above, so the only way to fail is running out of vfs slots
+            if ( !mjc_vfs->AddFile( *vfs_resource ) )
+            {
+                LOCO_CORE_ERROR( "TMujocoSimulation::_CompileMjcModel >>> couldn't add asset {0} to the vfs, as mujoco \
+                                  supports at most {1} files (mjMAXVFS, model included) and the scene has {2} assets",
+                                 vfs_resource->filename, mjMAXVFS, vfs_resources.size() );
+                return nullptr;
+            }
+        }
 
-            detected_contacts[collider_1].push_back( contact_1 );
-            detected_contacts[collider_2].push_back( contact_2 );
+        const size_t error_buffer_size = 1000;
+        char error_buffer[error_buffer_size];
+        mjModel* mjc_model = mj_loadXML( mujoco::LOCO_MUJOCO_VFS_MODEL_FILE.c_str(), mjc_vfs->mjc_vfs(),
+                                         error_buffer, error_buffer_size );
+        if ( !mjc_model )
+        {
+            LOCO_CORE_ERROR( "TMujocoSimulation::_CompileMjcModel >>> Couldn't initialize mujoco-API" );
+            LOCO_CORE_ERROR( "\tError-message   : {0}", error_buffer );
         }
+        return mjc_model;
+    }
 
-        auto single_bodies = m_ScenarioRef->GetSingleBodiesList();
-        for ( auto single_body : single_bodies )
+    void TMujocoSimulation::_DumpMjcfResources( const std::string& mjcf_xml_str,
+                                                const std::vector<const mujoco::TMjcVfsFile*>& vfs_resources ) const
+    {
+        // Generated assets are placed next to the dumped xml, so the dump can be loaded as is
+        const size_t separator_pos = m_MjcfDumpFilepath.find_last_of( "/\\" );
+        const std::string dump_folderpath = ( separator_pos != std::string::npos ) ?
+                                                m_MjcfDumpFilepath.substr( 0, separator_pos + 1 ) : "";
+        for ( auto vfs_resource : vfs_resources )
+            mujoco::SaveVfsFileToDisk( dump_folderpath + vfs_resource->filename, *vfs_resource );
+
+        std::ofstream fhandle( m_MjcfDumpFilepath.c_str(), std::ofstream::out );
+        if ( !fhandle )
         {
-            auto collider = single_body->collider();
-            auto collider_name = collider->name();
+            LOCO_CORE_ERROR( "TMujocoSimulation::_DumpMjcfResources >>> couldn't dump mjcf-xml to {0}", m_MjcfDumpFilepath );
+            return;
+        }
+        fhandle << mjcf_xml_str;
+        fhandle.close();
+        LOCO_CORE_TRACE( "TMujocoSimulation::_DumpMjcfResources >>> dumped mjcf-xml to {0}", m_MjcfDumpFilepath );
+    }
+
+    void TMujocoSimulation::_CollectContacts()
+    {
+        LOCO_CORE_ASSERT( m_MjcModel, "TMujocoSimulation::_CollectContacts >>> mjModel struct is required \
+                          for collecting the contacts from the internal engine" );
+        LOCO_CORE_ASSERT( m_MjcData, "TMujocoSimulation::_CollectContacts >>> mjData struct is required \
+                          for collecting the contacts from the internal engine" );
+        LOCO_CORE_ASSERT( m_MjcContactBuffer, "TMujocoSimulation::_CollectContacts >>> contact-buffer is required \
+                          for collecting the contacts from the internal engine" );
+
+        // Single pass over mjData::contact into the preallocated geom-indexed buffer (no allocations)
+    #if defined( __linux__ ) || defined( __APPLE__ )
+        // Replayed records have contacts (if requested) but no constraint solution, so no forces either
+        m_MjcContactBuffer->Collect( m_MjcModel.get(), m_MjcData.get(), m_TrajectoryReader == nullptr );
+    #else
+        m_MjcContactBuffer->Collect( m_MjcModel.get(), m_MjcData.get() );
+    #endif
 
-            collider->contacts().clear();
-            if ( detected_contacts.find( collider_name ) != detected_contacts.end() )
-                collider->contacts() = detected_contacts[collider_name];
+        for ( auto& single_body_adapter : m_SingleBodyAdapters )
+            if ( auto mjc_adapter = dynamic_cast<primitives::TMujocoSingleBodyAdapter*>( single_body_adapter.get() ) )
+                mjc_adapter->UpdateContacts( *m_MjcContactBuffer );
+        for ( auto& kinematic_tree_adapter : m_KinematicTreeAdapters )
+            if ( auto mjc_adapter = dynamic_cast<kintree::TMujocoKinematicTreeAdapter*>( kinematic_tree_adapter.get() ) )
+                mjc_adapter->UpdateContacts( *m_MjcContactBuffer );
+        m_ContactsDirty = false;
+    }
+
+    void TMujocoSimulation::CollectContacts()
+    {
+        if ( !m_ContactsDirty || !m_MjcModel || !m_MjcData )
+            return;
+        _CollectContacts();
+    }
+
+    void TMujocoSimulation::SetContactForcesSubscription( const std::string& collider_name, bool subscribe )
+    {
+        if ( subscribe )
+            m_ContactForcesSubscriptions.emplace( collider_name );
+        else
+            m_ContactForcesSubscriptions.erase( collider_name );
+
+        // If not initialized yet, the subscription is applied once the contact-buffer is created
+        if ( !m_MjcModel || !m_MjcContactBuffer )
+            return;
+
+        const ssize_t geom_id = mujoco::mjc_name2id( m_MjcModel.get(), m_MjcNameIndex.get(), mjOBJ_GEOM, collider_name );
+        if ( geom_id < 0 )
+        {
+            LOCO_CORE_ERROR( "TMujocoSimulation::SetContactForcesSubscription >>> couldn't find mjc-geom for collider {0}", collider_name );
+            return;
         }
+        m_MjcContactBuffer->SetForceSubscription( geom_id, subscribe );
+        // Forces of the last step (if requested) have to be computed on the next request
+        m_ContactsDirty = true;
+    }
+
+    mujoco::TMujocoContactsView TMujocoSimulation::GetMjcContacts( const std::string& collider_name )
+    {
+        if ( !m_MjcModel || !m_MjcContactBuffer )
+            return mujoco::TMujocoContactsView();
+        CollectContacts();
+        const ssize_t geom_id = mujoco::mjc_name2id( m_MjcModel.get(), m_MjcNameIndex.get(), mjOBJ_GEOM, collider_name );
+        return m_MjcContactBuffer->contacts( geom_id );
     }
 
     void TMujocoSimulation::_PreStepInternal()
     {
-        // Make sure recycled objects are not being simulated
-        for ( ssize_t i = 0; i < m_SingleBodyAdaptersRecycled.size(); i++ )
+        // Swap in a model rebuilt in the background only at step boundaries, once it's done compiling
+        if ( m_PendingMjcModel.valid() && m_PendingMjcModel.wait_for( std::chrono::seconds( 0 ) ) == std::future_status::ready )
+            _SwapRebuiltModel();
+
+        // Park recycled objects only once (parked bodies don't collide nor move, so they need nothing per step)
+        if ( !m_MjcBodySlots )
+            return;
+        m_NumRecycledParked = std::min<ssize_t>( m_NumRecycledParked, m_SingleBodyAdaptersRecycled.size() );
+        for ( ssize_t i = m_NumRecycledParked; i < m_SingleBodyAdaptersRecycled.size(); i++ )
             if ( auto mjc_single_body_adapter = dynamic_cast<primitives::TMujocoSingleBodyAdapter*>( m_SingleBodyAdaptersRecycled[i].get() ) )
-                mjc_single_body_adapter->HideMjcObject();
+                m_MjcBodySlots->ParkSingleBody( mjc_single_body_adapter );
+        m_NumRecycledParked = m_SingleBodyAdaptersRecycled.size();
     }
 
     void TMujocoSimulation::_SimStepInternal( const TScalar& dt )
@@ -356,29 +694,747 @@ namespace loco
             return;
         }
 
+        // Backstop for steps requested through the base class while running asynchronously
+        if ( _BlockedByAsync( "TMujocoSimulation::_SimStepInternal" ) )
+            return;
+
+    #if defined( __linux__ ) || defined( __APPLE__ )
+        // While replaying, a step just moves to the next record (stays at the last one once the log ends)
+        if ( m_TrajectoryReader )
+        {
+            _ReplayRecord( m_ReplayRecordId + 1 );
+            return;
+        }
+    #endif
+
+        // Take a fixed number of physics steps per call (deterministic cost, unlike comparing accumulated times)
+        const ssize_t num_substeps = _NumSubsteps( dt );
+        for ( ssize_t i = 0; i < num_substeps; i++ )
+            mj_step( m_MjcModel.get(), m_MjcData.get() );
+        m_WorldTime += num_substeps * m_MjcModel->opt.timestep;
+        // Parked bodies are only frozen by the implicit damping of the Euler integrator, so hold them otherwise
+        if ( m_MjcBodySlots && m_MjcModel->opt.integrator != mjINT_EULER )
+            m_MjcBodySlots->HoldParked();
+    }
+
+    bool TMujocoSimulation::_BlockedByAsync( const std::string& caller ) const
+    {
+        // The stepping thread itself goes through the regular entry-points (e.g. Step), so only others are refused
+        if ( !m_AsyncStepper || m_AsyncStepper->in_worker_thread() )
+            return false;
+        LOCO_CORE_ERROR( "{0} >>> can't be called while stepping asynchronously (use StepAsync, or call StopAsync first)", caller );
+        return true;
+    }
+
+    ssize_t TMujocoSimulation::_NumSubsteps( const TScalar& dt ) const
+    {
+        if ( m_NumSubsteps > 0 )
+            return m_NumSubsteps;
         const mjtNum sim_step_time = ( dt <= 0 ) ? m_FixedTimeStep : dt;
-        const mjtNum sim_start_time = m_MjcData->time;
-        while ( ( m_MjcData->time - sim_start_time ) < sim_step_time )
+        return std::max<ssize_t>( 1, std::lround( sim_step_time / m_MjcModel->opt.timestep ) );
+    }
+
+    void TMujocoSimulation::Step( const TScalar& dt )
+    {
+        if ( _BlockedByAsync( "TMujocoSimulation::Step" ) )
+            return;
+        TISimulation::Step( dt );
+    }
+
+    void TMujocoSimulation::Reset()
+    {
+        if ( _BlockedByAsync( "TMujocoSimulation::Reset" ) )
+            return;
+        TISimulation::Reset();
+    }
+
+    void TMujocoSimulation::StepN( ssize_t num_periods, const TScalar& dt )
+    {
+        if ( !m_Running || num_periods < 1 || _BlockedByAsync( "TMujocoSimulation::StepN" ) )
+            return;
+
+        // Hooks (and contacts collection) run only at the boundaries, not once per control period
+        m_ScenarioRef->PreStep();
+        _PreStepInternal();
+        for ( ssize_t k = 0; k < num_periods; k++ )
+            _SimStepInternal( dt );
+        _PostStepInternal();
+        m_ScenarioRef->PostStep();
+    }
+
+    void TMujocoSimulation::StepPhase1()
+    {
+        if ( !m_Running || !m_MjcModel || !m_MjcData || _BlockedByAsync( "TMujocoSimulation::StepPhase1" ) )
+            return;
+        if ( m_StepPhase1Done )
+        {
+            LOCO_CORE_WARN( "TMujocoSimulation::StepPhase1 >>> phase-1 already taken, call StepPhase2 first" );
+            return;
+        }
+    #if defined( __linux__ ) || defined( __APPLE__ )
+        if ( m_TrajectoryReader )
+        {
+            LOCO_CORE_WARN( "TMujocoSimulation::StepPhase1 >>> split-phase steps aren't available while replaying, use Step instead" );
+            return;
+        }
+    #endif
+
+        m_ScenarioRef->PreStep();
+        _PreStepInternal();
+        // Computes kinematics, collisions, passive and actuation-independent forces (up to mj_fwdVelocity),
+        // so controls can be computed from up-to-date data without an extra mj_forward
+        mj_step1( m_MjcModel.get(), m_MjcData.get() );
+        m_StepPhase1Done = true;
+    }
+
+    void TMujocoSimulation::StepPhase2( const TScalar& dt )
+    {
+        if ( !m_Running || !m_MjcModel || !m_MjcData || _BlockedByAsync( "TMujocoSimulation::StepPhase2" ) )
+            return;
+        if ( !m_StepPhase1Done )
         {
+            LOCO_CORE_WARN( "TMujocoSimulation::StepPhase2 >>> phase-1 hasn't been taken, call StepPhase1 first" );
+            return;
+        }
+
+        // Note: mujoco integrates the split-phase step with semi-implicit Euler (even if RK4 is selected)
+        mj_step2( m_MjcModel.get(), m_MjcData.get() );
+        // Remaining substeps of the control period use the same controls (as in a regular step)
+        const ssize_t num_substeps = _NumSubsteps( dt );
+        for ( ssize_t i = 1; i < num_substeps; i++ )
             mj_step( m_MjcModel.get(), m_MjcData.get() );
-            m_WorldTime += m_FixedTimeStep;
+        m_WorldTime += num_substeps * m_MjcModel->opt.timestep;
+        if ( m_MjcBodySlots && m_MjcModel->opt.integrator != mjINT_EULER )
+            m_MjcBodySlots->HoldParked();
+        m_StepPhase1Done = false;
+
+        _PostStepInternal();
+        m_ScenarioRef->PostStep();
+    }
+
+    void TMujocoSimulation::StartAsync( ssize_t num_snapshot_slots )
+    {
+        if ( !m_MjcModel || !m_MjcData )
+        {
+            LOCO_CORE_ERROR( "TMujocoSimulation::StartAsync >>> simulation must be initialized before running asynchronously" );
+            return;
         }
+        if ( m_AsyncStepper )
+        {
+            LOCO_CORE_WARN( "TMujocoSimulation::StartAsync >>> simulation is already running asynchronously" );
+            return;
+        }
+        // The swap happens at a step boundary of the thread that steps, which would then be the worker
+        if ( rebuild_pending() )
+        {
+            LOCO_CORE_ERROR( "TMujocoSimulation::StartAsync >>> can't run asynchronously while a rebuild is pending \
+                              (call WaitRebuild first)" );
+            return;
+        }
+        m_AsyncStepper = std::make_unique<mujoco::TMujocoAsyncStepper>( this, num_snapshot_slots );
+    }
+
+    void TMujocoSimulation::StopAsync()
+    {
+        if ( !m_AsyncStepper )
+            return;
+        m_AsyncStepper->Wait();
+        m_AsyncStepper = nullptr;
+    }
+
+    std::future<void> TMujocoSimulation::StepAsync( const TScalar& dt )
+    {
+        if ( !m_AsyncStepper )
+        {
+            // Not running asynchronously, so just step right away and hand back a ready future
+            Step( dt );
+            std::promise<void> done;
+            done.set_value();
+            return done.get_future();
+        }
+        return m_AsyncStepper->StepAsync( dt );
+    }
+
+    mujoco::TMujocoSnapshotHandle TMujocoSimulation::AcquireSnapshot() const
+    {
+        if ( !m_AsyncStepper )
+        {
+            LOCO_CORE_WARN( "TMujocoSimulation::AcquireSnapshot >>> snapshots are only available while running asynchronously" );
+            return mujoco::TMujocoSnapshotHandle();
+        }
+        return m_AsyncStepper->AcquireSnapshot();
+    }
+
+    void TMujocoSimulation::SetNumSubsteps( ssize_t num_substeps )
+    {
+        if ( num_substeps < 0 )
+        {
+            LOCO_CORE_WARN( "TMujocoSimulation::SetNumSubsteps >>> number of substeps must be non-negative (got {0})", num_substeps );
+            return;
+        }
+        m_NumSubsteps = num_substeps;
+    }
+
+#if defined( __linux__ ) || defined( __APPLE__ )
+    bool TMujocoSimulation::StartRecording( const std::string& filepath, ssize_t keyframe_interval )
+    {
+        if ( _BlockedByAsync( "TMujocoSimulation::StartRecording" ) )
+            return false;
+        if ( !m_MjcModel || !m_MjcData )
+        {
+            LOCO_CORE_ERROR( "TMujocoSimulation::StartRecording >>> simulation must be initialized before recording" );
+            return false;
+        }
+        if ( m_TrajectoryReader )
+        {
+            LOCO_CORE_ERROR( "TMujocoSimulation::StartRecording >>> can't record while replaying a trajectory" );
+            return false;
+        }
+        // Records of the current and the rebuilt model wouldn't be compatible
+        if ( rebuild_pending() )
+        {
+            LOCO_CORE_ERROR( "TMujocoSimulation::StartRecording >>> can't record while a rebuild is pending (call WaitRebuild first)" );
+            return false;
+        }
+        auto trajectory_recorder = std::make_unique<mujoco::TMujocoTrajectoryRecorder>();
+        if ( !trajectory_recorder->Open( filepath, m_MjcModel.get(), keyframe_interval ) )
+            return false;
+        // The current state is the first record (and keyframe), so the log starts at a known state
+        trajectory_recorder->Record( m_MjcModel.get(), m_MjcData.get() );
+        m_TrajectoryRecorder = std::move( trajectory_recorder );
+        return true;
+    }
+
+    void TMujocoSimulation::StopRecording()
+    {
+        // Closing the recorder trims and flushes the log to disk
+        m_TrajectoryRecorder = nullptr;
+    }
+
+    bool TMujocoSimulation::StartReplay( const std::string& filepath, bool compute_contacts )
+    {
+        if ( !m_MjcModel || !m_MjcData )
+        {
+            LOCO_CORE_ERROR( "TMujocoSimulation::StartReplay >>> simulation must be initialized before replaying" );
+            return false;
+        }
+        if ( m_TrajectoryRecorder || m_AsyncStepper )
+        {
+            LOCO_CORE_ERROR( "TMujocoSimulation::StartReplay >>> can't replay while recording or running asynchronously" );
+            return false;
+        }
+        if ( rebuild_pending() )
+        {
+            LOCO_CORE_ERROR( "TMujocoSimulation::StartReplay >>> can't replay while a rebuild is pending (call WaitRebuild first)" );
+            return false;
+        }
+        auto trajectory_reader = std::make_unique<mujoco::TMujocoTrajectoryReader>();
+        if ( !trajectory_reader->Open( filepath ) )
+            return false;
+        const auto header = trajectory_reader->header();
+        if ( !trajectory_reader->matches_model( m_MjcModel.get() ) )
+        {
+            LOCO_CORE_ERROR( "TMujocoSimulation::StartReplay >>> trajectory {0} was recorded with a different model "
+                             "(nq={1}, nv={2}, nu={3}, nbody={4}, na={5}, nmocap={6}, nuserdata={7})", filepath,
+                             header->nq, header->nv, header->nu, header->nbody, header->na, header->nmocap, header->nuserdata );
+            return false;
+        }
+
+        if ( !m_MjcPreReplayImage )
+            m_MjcPreReplayImage = std::make_unique<mujoco::TMujocoStateImage>();
+        m_MjcPreReplayImage->Allocate( m_MjcModel.get() );
+        m_MjcPreReplayImage->Capture( m_MjcModel.get(), m_MjcData.get() );
+        m_MjcPreReplayImage->world_time = m_WorldTime;
+
+        m_TrajectoryReader = std::move( trajectory_reader );
+        m_ReplayContacts = compute_contacts;
+        m_ReplayRecordId = -1;
+        return true;
     }
 
+    void TMujocoSimulation::StopReplay()
+    {
+        if ( !m_TrajectoryReader )
+            return;
+        m_TrajectoryReader = nullptr;
+        m_ReplayRecordId = -1;
+
+        // Back to the state before the replay (derived quantities were overwritten by the replayed kinematics)
+        m_MjcPreReplayImage->Restore( m_MjcModel.get(), m_MjcData.get() );
+        m_WorldTime = m_MjcPreReplayImage->world_time;
+        mj_forward( m_MjcModel.get(), m_MjcData.get() );
+        m_ContactsDirty = true;
+    }
+
+    bool TMujocoSimulation::ReplaySeek( ssize_t record_id )
+    {
+        if ( !m_TrajectoryReader )
+        {
+            LOCO_CORE_WARN( "TMujocoSimulation::ReplaySeek >>> no trajectory is being replayed (see StartReplay)" );
+            return false;
+        }
+        if ( !_ReplayRecord( record_id ) )
+            return false;
+        // Same hooks as a regular step, so bodies (and their adapters) pick up the replayed transforms
+        _PostStepInternal();
+        m_ScenarioRef->PostStep();
+        return true;
+    }
+
+    bool TMujocoSimulation::_ReplayRecord( ssize_t record_id )
+    {
+        if ( record_id < 0 || record_id >= m_TrajectoryReader->num_records() )
+            return false;
+
+        // Only positions are needed for kinematics (velocities are loaded too, so mjData matches the record)
+        mjData* mjc_data = m_MjcData.get();
+        std::memcpy( mjc_data->qpos, m_TrajectoryReader->record_qpos( record_id ), sizeof( mjtNum ) * m_MjcModel->nq );
+        std::memcpy( mjc_data->qvel, m_TrajectoryReader->record_qvel( record_id ), sizeof( mjtNum ) * m_MjcModel->nv );
+        mjc_data->time = m_TrajectoryReader->record_time( record_id );
+        mj_kinematics( m_MjcModel.get(), mjc_data );
+        if ( m_ReplayContacts )
+            mj_collision( m_MjcModel.get(), mjc_data );
+        else
+            mjc_data->ncon = 0;
+
+        m_ReplayRecordId = record_id;
+        m_WorldTime = mjc_data->time;
+        return true;
+    }
+#endif
+
     void TMujocoSimulation::_PostStepInternal()
     {
-        _CollectContacts();
+    #if defined( __linux__ ) || defined( __APPLE__ )
+        if ( m_TrajectoryRecorder )
+            m_TrajectoryRecorder->Record( m_MjcModel.get(), m_MjcData.get() );
+    #endif
+
+        // Contacts are materialized right away only if required, otherwise on the first request
+        m_ContactsDirty = true;
+        if ( m_ContactsCollectionMode == mujoco::eContactsCollectionMode::EAGER || m_NumContactsConsumers > 0 )
+            _CollectContacts();
     }
 
     void TMujocoSimulation::_ResetInternal()
     {
-        // Do nothing here, as call to adapters is enough (made in base)
+        if ( _BlockedByAsync( "TMujocoSimulation::_ResetInternal" ) )
+            return;
+        // A pending phase-1 was computed from the state just overwritten
+        m_StepPhase1Done = false;
+    #if defined( __linux__ ) || defined( __APPLE__ )
+        // The state jumps back to the initial one, so the next record must be a keyframe
+        if ( m_TrajectoryRecorder )
+            m_TrajectoryRecorder->MarkDiscontinuity();
+    #endif
+        // Without bulk-resets, the call to adapters is enough (made in base)
+        if ( m_BulkResetEnabled && m_MjcModel && m_MjcData && m_MjcResetImage )
+            _BulkReset();
+
+        // Resets write the initial state of the parked bodies (and clear their applied forces), so park these again
+        if ( m_MjcBodySlots )
+            m_MjcBodySlots->RefreshParked();
+    }
+
+    void TMujocoSimulation::_BulkReset()
+    {
+        if ( !m_MjcResetImage->valid() )
+        {
+            // First reset: go through every adapter (from a clean mjData), and keep the resulting state as image
+            mj_resetData( m_MjcModel.get(), m_MjcData.get() );
+            for ( auto& single_body_adapter : m_SingleBodyAdapters )
+                if ( auto mjc_adapter = dynamic_cast<primitives::TMujocoSingleBodyAdapter*>( single_body_adapter.get() ) )
+                    mjc_adapter->ResetInitialConditions();
+            for ( auto& kinematic_tree_adapter : m_KinematicTreeAdapters )
+                if ( auto mjc_adapter = dynamic_cast<kintree::TMujocoKinematicTreeAdapter*>( kinematic_tree_adapter.get() ) )
+                    mjc_adapter->ResetInitialConditions();
+            m_MjcResetImage->Capture( m_MjcModel.get(), m_MjcData.get() );
+            _SetAdaptersBulkResetEnabled( true );
+        }
+        else
+        {
+            // Following resets: restore the image, and write only what the user changed since (tf0, vel0, qpos0)
+            m_MjcResetImage->Restore( m_MjcModel.get(), m_MjcData.get() );
+            for ( auto& single_body_adapter : m_SingleBodyAdapters )
+                if ( auto mjc_adapter = dynamic_cast<primitives::TMujocoSingleBodyAdapter*>( single_body_adapter.get() ) )
+                    mjc_adapter->ApplyResetOverrides();
+            for ( auto& kinematic_tree_adapter : m_KinematicTreeAdapters )
+                if ( auto mjc_adapter = dynamic_cast<kintree::TMujocoKinematicTreeAdapter*>( kinematic_tree_adapter.get() ) )
+                    mjc_adapter->ApplyResetOverrides();
+        }
+        m_ContactsDirty = true;
+    }
+
+    primitives::TSingleBody* TMujocoSimulation::SpawnSingleBody( std::unique_ptr<primitives::TSingleBody> single_body )
+    {
+        if ( !m_MjcBodySlots )
+        {
+            LOCO_CORE_ERROR( "TMujocoSimulation::SpawnSingleBody >>> simulation must be initialized before spawning bodies" );
+            return nullptr;
+        }
+        // Spawning writes into the current model, which is about to be replaced by the rebuilt one
+        if ( rebuild_pending() )
+        {
+            LOCO_CORE_ERROR( "TMujocoSimulation::SpawnSingleBody >>> can't spawn single-body {0} while a rebuild is pending \
+                              (call WaitRebuild first)", single_body->name() );
+            return nullptr;
+        }
+
+        // Park what got detached since the last step, so its slot can already be reused
+        _PreStepInternal();
+        const ssize_t slot_id = m_MjcBodySlots->AcquireSlot( single_body.get() );
+        if ( slot_id < 0 )
+        {
+            LOCO_CORE_WARN( "TMujocoSimulation::SpawnSingleBody >>> there's no parked slot compatible with single-body {0} \
+                             (requires a rebuild of the model instead)", single_body->name() );
+            return nullptr;
+        }
+
+        auto single_body_ref = m_ScenarioRef->AddSingleBody( std::move( single_body ) );
+        auto single_body_adapter = std::make_unique<primitives::TMujocoSingleBodyAdapter>( single_body_ref );
+        single_body_ref->SetBodyAdapter( single_body_adapter.get() );
+        single_body_adapter->Build();
+        single_body_adapter->SetMjcModel( m_MjcModel.get() );
+        single_body_adapter->SetMjcData( m_MjcData.get() );
+        single_body_adapter->SetMjcNameIndex( m_MjcNameIndex.get() );
+        single_body_adapter->SetMjcModelUniqueFn( _MjcModelUniqueFn() );
+        const auto& slot = m_MjcBodySlots->slot( slot_id );
+        single_body_adapter->InitializeFromMjcIds( slot.body_id, slot.geom_id );
+        m_SingleBodyAdapters.push_back( std::move( single_body_adapter ) );
+
+        // The set of bodies changed, so the initial-state image is retaken on the next reset
+        if ( m_MjcResetImage )
+            m_MjcResetImage->Invalidate();
+        _SetAdaptersBulkResetEnabled( false );
+        mj_kinematics( m_MjcModel.get(), m_MjcData.get() );
+        m_ContactsDirty = true;
+        return single_body_ref;
+    }
+
+    bool TMujocoSimulation::RebuildAsync()
+    {
+        if ( !m_MjcModel || !m_MjcData )
+        {
+            LOCO_CORE_ERROR( "TMujocoSimulation::RebuildAsync >>> simulation must be initialized before rebuilding its model" );
+            return false;
+        }
+        if ( m_PendingMjcModel.valid() )
+        {
+            LOCO_CORE_WARN( "TMujocoSimulation::RebuildAsync >>> there's already a rebuild in progress" );
+            return false;
+        }
+        if ( m_AsyncStepper )
+        {
+            LOCO_CORE_ERROR( "TMujocoSimulation::RebuildAsync >>> can't rebuild the model while stepping asynchronously" );
+            return false;
+        }
+    #if defined( __linux__ ) || defined( __APPLE__ )
+        if ( m_TrajectoryRecorder || m_TrajectoryReader )
+        {
+            LOCO_CORE_ERROR( "TMujocoSimulation::RebuildAsync >>> can't rebuild the model while recording or replaying \
+                              a trajectory (records of both models wouldn't be compatible)" );
+            return false;
+        }
+    #endif
+
+        // Only objects without an adapter are built, the others reuse the mjcf-resources they already built
+        std::set<primitives::TSingleBody*> adapted_single_bodies;
+        for ( auto& single_body_adapter : m_SingleBodyAdapters )
+            adapted_single_bodies.emplace( single_body_adapter->body() );
+        for ( auto single_body : m_ScenarioRef->GetSingleBodiesList() )
+        {
+            if ( adapted_single_bodies.find( single_body ) != adapted_single_bodies.end() )
+                continue;
+            auto single_body_adapter = std::make_unique<primitives::TMujocoSingleBodyAdapter>( single_body );
+            single_body_adapter->Build();
+            m_PendingSingleBodyAdapters.push_back( std::move( single_body_adapter ) );
+        }
+        std::set<kintree::TKinematicTree*> adapted_kintrees;
+        for ( auto& kinematic_tree_adapter : m_KinematicTreeAdapters )
+            adapted_kintrees.emplace( kinematic_tree_adapter->kintree() );
+        for ( auto kinematic_tree : m_ScenarioRef->GetKinematicTreesList() )
+        {
+            if ( adapted_kintrees.find( kinematic_tree ) != adapted_kintrees.end() )
+                continue;
+            auto kinematic_tree_adapter = std::make_unique<kintree::TMujocoKinematicTreeAdapter>( kinematic_tree );
+            kinematic_tree_adapter->Build();
+            m_PendingKinematicTreeAdapters.push_back( std::move( kinematic_tree_adapter ) );
+        }
+
+        // The xml is assembled here, and the compile-job gets its own copy of the vfs-files (adapters might
+        // be detached while it runs), so the job only reads the (untouched until swap) mjcf-element if caching
+        const std::string mjcf_xml_str = _AssembleMjcfXml();
+        auto vfs_files = std::make_shared<std::vector<mujoco::TMjcVfsFile>>();
+        for ( auto vfs_resource : _CollectVfsResources() )
+            vfs_files->push_back( *vfs_resource );
+        m_PendingMjcModel = std::async( std::launch::async, [this, mjcf_xml_str, vfs_files]()
+            {
+                std::vector<const mujoco::TMjcVfsFile*> vfs_resources;
+                for ( const auto& vfs_file : *vfs_files )
+                    vfs_resources.push_back( &vfs_file );
+                return _LoadMjcModel( mjcf_xml_str, vfs_resources );
+            } );
+        return true;
+    }
+
+    bool TMujocoSimulation::WaitRebuild()
+    {
+        if ( !m_PendingMjcModel.valid() )
+            return false;
+        m_PendingMjcModel.wait();
+        return _SwapRebuiltModel();
+    }
+
+    bool TMujocoSimulation::_SwapRebuiltModel()
+    {
+        auto rebuilt_mjc_model = std::unique_ptr<mjModel, mujoco::MjcModelDeleter>( m_PendingMjcModel.get() );
+        if ( !rebuilt_mjc_model )
+        {
+            LOCO_CORE_ERROR( "TMujocoSimulation::_SwapRebuiltModel >>> couldn't compile the rebuilt model, so the \
+                              current one is kept (objects added since the last build remain without adapters)" );
+            m_PendingSingleBodyAdapters.clear();
+            m_PendingKinematicTreeAdapters.clear();
+            return false;
+        }
+
+        // Keep the current model alive until its state has been transferred into the rebuilt one
+        auto old_mjc_model = std::move( m_MjcModel );
+        auto old_mjc_data = std::move( m_MjcData );
+        auto old_mjc_name_index = std::move( m_MjcNameIndex );
+        // Free-joints of single-bodies are transferred by adapter (spawned ones live in slots under other names)
+        std::vector<std::tuple<primitives::TMujocoSingleBodyAdapter*, ssize_t, ssize_t>> old_free_joints;
+        for ( auto& single_body_adapter : m_SingleBodyAdapters )
+            if ( auto mjc_adapter = dynamic_cast<primitives::TMujocoSingleBodyAdapter*>( single_body_adapter.get() ) )
+                if ( mjc_adapter->mjc_joint_id() >= 0 && mjc_adapter->mjc_joint_qpos_num() == 7 )
+                    old_free_joints.emplace_back( mjc_adapter, mjc_adapter->mjc_joint_qpos_adr(), mjc_adapter->mjc_joint_qvel_adr() );
+
+        for ( auto& single_body_adapter : m_PendingSingleBodyAdapters )
+        {
+            single_body_adapter->body()->SetBodyAdapter( single_body_adapter.get() );
+            m_SingleBodyAdapters.push_back( std::move( single_body_adapter ) );
+        }
+        for ( auto& kinematic_tree_adapter : m_PendingKinematicTreeAdapters )
+        {
+            kinematic_tree_adapter->kintree()->SetKintreeAdapter( kinematic_tree_adapter.get() );
+            m_KinematicTreeAdapters.push_back( std::move( kinematic_tree_adapter ) );
+        }
+        m_PendingSingleBodyAdapters.clear();
+        m_PendingKinematicTreeAdapters.clear();
+
+        m_MjcModel = std::move( rebuilt_mjc_model );
+        _LinkMjcModel();
+        for ( auto& single_body_adapter : m_SingleBodyAdapters )
+            single_body_adapter->Initialize();
+        for ( auto& kinematic_tree_adapter : m_KinematicTreeAdapters )
+        {
+            kinematic_tree_adapter->Initialize();
+            if ( auto mjc_adapter = dynamic_cast<kintree::TMujocoKinematicTreeAdapter*>( kinematic_tree_adapter.get() ) )
+                mjc_adapter->InitializeBodies();
+        }
+
+        const ssize_t num_transferred = mujoco::TransferMjcStateByName( old_mjc_model.get(), old_mjc_data.get(),
+                                                                        m_MjcModel.get(), m_MjcData.get(), m_MjcNameIndex.get() );
+        for ( const auto& old_free_joint : old_free_joints )
+        {
+            auto mjc_adapter = std::get<0>( old_free_joint );
+            if ( mjc_adapter->mjc_joint_id() < 0 || mjc_adapter->mjc_joint_qpos_num() != 7 )
+                continue;
+            const ssize_t qposadr = mjc_adapter->mjc_joint_qpos_adr();
+            const ssize_t qveladr = mjc_adapter->mjc_joint_qvel_adr();
+            mju_copy( m_MjcData->qpos + qposadr, old_mjc_data->qpos + std::get<1>( old_free_joint ), 7 );
+            mju_copy( m_MjcData->qvel + qveladr, old_mjc_data->qvel + std::get<2>( old_free_joint ), 6 );
+            mju_copy( m_MjcData->qacc_warmstart + qveladr, old_mjc_data->qacc_warmstart + std::get<2>( old_free_joint ), 6 );
+        }
+
+        // Detached bodies aren't part of the rebuilt model, so there's nothing left to park for them
+        m_NumRecycledParked = m_SingleBodyAdaptersRecycled.size();
+        // The set of bodies changed, so the initial-state image is retaken on the next reset
+        m_MjcResetImage->Invalidate();
+        _SetAdaptersBulkResetEnabled( false );
+        mj_kinematics( m_MjcModel.get(), m_MjcData.get() );
+        m_ContactsDirty = true;
+        // A pending phase-1 was computed against the old model (e.g. WaitRebuild in between phases)
+        m_StepPhase1Done = false;
+
+        LOCO_CORE_TRACE( "TMujocoSimulation::_SwapRebuiltModel >>> swapped in rebuilt model (nbody: {0} -> {1}, \
+                          joints transferred: {2})", old_mjc_model->nbody, m_MjcModel->nbody, num_transferred );
+        return true;
+    }
+
+    std::unique_ptr<TMujocoSimulation> TMujocoSimulation::Clone( TScenario* scenario_clone ) const
+    {
+        if ( !m_MjcModel || !m_MjcData )
+        {
+            LOCO_CORE_ERROR( "TMujocoSimulation::Clone >>> simulation must be initialized before cloning it" );
+            return nullptr;
+        }
+        if ( m_AsyncStepper || m_PendingMjcModel.valid() )
+        {
+            LOCO_CORE_ERROR( "TMujocoSimulation::Clone >>> can't clone while stepping asynchronously, or while rebuilding the model" );
+            return nullptr;
+        }
+    #if defined( __linux__ ) || defined( __APPLE__ )
+        if ( m_TrajectoryReader )
+        {
+            LOCO_CORE_ERROR( "TMujocoSimulation::Clone >>> can't clone while replaying a trajectory" );
+            return nullptr;
+        }
+    #endif
+        if ( !scenario_clone || scenario_clone == m_ScenarioRef )
+        {
+            LOCO_CORE_ERROR( "TMujocoSimulation::Clone >>> a clone requires its own scenario (with the same objects)" );
+            return nullptr;
+        }
+
+        // Adapters are created (and built) as usual, but linked to the shared model without compiling it again
+        auto simulation = std::make_unique<TMujocoSimulation>( scenario_clone );
+        for ( auto& single_body_adapter : simulation->m_SingleBodyAdapters )
+            single_body_adapter->Build();
+        for ( auto& kinematic_tree_adapter : simulation->m_KinematicTreeAdapters )
+            kinematic_tree_adapter->Build();
+        if ( !simulation->_CloneFrom( *this ) )
+            return nullptr;
+        return simulation;
+    }
+
+    bool TMujocoSimulation::_CloneFrom( const TMujocoSimulation& other )
+    {
+        m_FixedTimeStep = other.m_FixedTimeStep;
+        m_Gravity = other.m_Gravity;
+        m_WorldTime = other.m_WorldTime;
+        m_Running = other.m_Running;
+        m_NumSubsteps = other.m_NumSubsteps;
+        m_StateRingCapacity = other.m_StateRingCapacity;
+        m_BulkResetEnabled = other.m_BulkResetEnabled;
+        m_ContactsCollectionMode = other.m_ContactsCollectionMode;
+        m_BodySlotsReservations = other.m_BodySlotsReservations;
+
+        m_MjcModel = other.m_MjcModel;
+        m_MjcNameIndex = other.m_MjcNameIndex;
+        m_MjcData = std::unique_ptr<mjData, mujoco::MjcDataDeleter>( mj_copyData( nullptr, m_MjcModel.get(), other.m_MjcData.get() ) );
+        m_MjcContactBuffer = std::make_unique<mujoco::TMujocoContactBuffer>();
+        m_MjcContactBuffer->Resize( m_MjcModel.get() );
+        for ( const auto& collider_name : other.m_ContactForcesSubscriptions )
+            SetContactForcesSubscription( collider_name, true );
+        m_MjcStateRing = std::make_unique<mujoco::TMujocoStateRing>();
+        m_MjcStateRing->Resize( m_MjcModel.get(), m_StateRingCapacity );
+        m_MjcResetImage = std::make_unique<mujoco::TMujocoStateImage>( *other.m_MjcResetImage );
+        // Parking-state of the slots is part of the shared model and the copied data, so only the bookkeeping is copied
+        m_MjcBodySlots = std::make_unique<mujoco::TMujocoBodySlotsManager>( m_MjcModel.get(), m_MjcData.get() );
+        m_MjcBodySlots->SetMjcModelUniqueFn( _MjcModelUniqueFn() );
+        m_MjcBodySlots->CopySlotsFrom( *other.m_MjcBodySlots );
+        m_NumRecycledParked = 0;
+
+        // Adapters are paired by object name, and take the ids cached by the other simulation's adapters (no lookups)
+        std::unordered_map<std::string, const primitives::TMujocoSingleBodyAdapter*> other_single_body_adapters;
+        for ( const auto& single_body_adapter : other.m_SingleBodyAdapters )
+            if ( auto mjc_adapter = dynamic_cast<const primitives::TMujocoSingleBodyAdapter*>( single_body_adapter.get() ) )
+                other_single_body_adapters[single_body_adapter->body()->name()] = mjc_adapter;
+        for ( auto& single_body_adapter : m_SingleBodyAdapters )
+        {
+            auto mjc_adapter = dynamic_cast<primitives::TMujocoSingleBodyAdapter*>( single_body_adapter.get() );
+            auto other_mjc_adapter = other_single_body_adapters.find( single_body_adapter->body()->name() );
+            if ( !mjc_adapter || other_mjc_adapter == other_single_body_adapters.end() )
+            {
+                LOCO_CORE_ERROR( "TMujocoSimulation::_CloneFrom >>> single-body {0} of the clone's scenario isn't part of the \
+                                  simulation being cloned", single_body_adapter->body()->name() );
+                return false;
+            }
+            mjc_adapter->SetMjcModel( m_MjcModel.get() );
+            mjc_adapter->SetMjcData( m_MjcData.get() );
+            mjc_adapter->SetMjcNameIndex( m_MjcNameIndex.get() );
+            mjc_adapter->SetMjcModelUniqueFn( _MjcModelUniqueFn() );
+            mjc_adapter->InitializeFromAdapter( *other_mjc_adapter->second );
+        }
+        std::unordered_map<std::string, const kintree::TMujocoKinematicTreeAdapter*> other_kinematic_tree_adapters;
+        for ( const auto& kinematic_tree_adapter : other.m_KinematicTreeAdapters )
+            if ( auto mjc_adapter = dynamic_cast<const kintree::TMujocoKinematicTreeAdapter*>( kinematic_tree_adapter.get() ) )
+                other_kinematic_tree_adapters[kinematic_tree_adapter->kintree()->name()] = mjc_adapter;
+        for ( auto& kinematic_tree_adapter : m_KinematicTreeAdapters )
+        {
+            auto mjc_adapter = dynamic_cast<kintree::TMujocoKinematicTreeAdapter*>( kinematic_tree_adapter.get() );
+            auto other_mjc_adapter = other_kinematic_tree_adapters.find( kinematic_tree_adapter->kintree()->name() );
+            if ( !mjc_adapter || other_mjc_adapter == other_kinematic_tree_adapters.end() )
+            {
+                LOCO_CORE_ERROR( "TMujocoSimulation::_CloneFrom >>> kintree {0} of the clone's scenario isn't part of the \
+                                  simulation being cloned", kinematic_tree_adapter->kintree()->name() );
+                return false;
+            }
+            mjc_adapter->SetMjcModel( m_MjcModel.get() );
+            mjc_adapter->SetMjcData( m_MjcData.get() );
+            mjc_adapter->SetMjcNameIndex( m_MjcNameIndex.get() );
+            mjc_adapter->SetMjcModelUniqueFn( _MjcModelUniqueFn() );
+            if ( !mjc_adapter->InitializeFromAdapter( *other_mjc_adapter->second ) )
+                return false;
+        }
+        if ( m_SingleBodyAdapters.size() != other.m_SingleBodyAdapters.size() ||
+             m_KinematicTreeAdapters.size() != other.m_KinematicTreeAdapters.size() )
+        {
+            LOCO_CORE_ERROR( "TMujocoSimulation::_CloneFrom >>> the clone's scenario is missing objects of the simulation being cloned" );
+            return false;
+        }
+
+        // Bulk-resets continue from the copied initial-state image (if taken already)
+        _SetAdaptersBulkResetEnabled( m_BulkResetEnabled && m_MjcResetImage->valid() );
+        m_ContactsDirty = true;
+        return true;
+    }
+
+    mjModel* TMujocoSimulation::MakeMjcModelUnique()
+    {
+        if ( !m_MjcModel || !mjc_model_shared() )
+            return m_MjcModel.get();
+
+        // Ids don't change on copies, so adapters (and the name-index) only have to point to the copy
+        m_MjcModel = std::shared_ptr<mjModel>( mj_copyModel( nullptr, m_MjcModel.get() ), mujoco::MjcModelDeleter() );
+        _RebindMjcModel();
+        return m_MjcModel.get();
+    }
+
+    mujoco::FnMjcModelUnique TMujocoSimulation::_MjcModelUniqueFn()
+    {
+        return [this]() { return MakeMjcModelUnique(); };
+    }
+
+    void TMujocoSimulation::_RebindMjcModel()
+    {
+        for ( auto& single_body_adapter : m_SingleBodyAdapters )
+            if ( auto mjc_adapter = dynamic_cast<primitives::TMujocoSingleBodyAdapter*>( single_body_adapter.get() ) )
+                mjc_adapter->SetMjcModel( m_MjcModel.get() );
+        for ( auto& single_body_adapter : m_SingleBodyAdaptersRecycled )
+            if ( auto mjc_adapter = dynamic_cast<primitives::TMujocoSingleBodyAdapter*>( single_body_adapter.get() ) )
+                mjc_adapter->SetMjcModel( m_MjcModel.get() );
+        for ( auto& kinematic_tree_adapter : m_KinematicTreeAdapters )
+            if ( auto mjc_adapter = dynamic_cast<kintree::TMujocoKinematicTreeAdapter*>( kinematic_tree_adapter.get() ) )
+                mjc_adapter->SetMjcModel( m_MjcModel.get() );
+        if ( m_MjcBodySlots )
+            m_MjcBodySlots->SetMjcModel( m_MjcModel.get() );
+    }
+
+    void TMujocoSimulation::SetBulkResetEnabled( bool enabled )
+    {
+        m_BulkResetEnabled = enabled;
+        // The image is (re)taken on the next reset after enabling, so it reflects the current initial conditions
+        if ( m_MjcResetImage )
+            m_MjcResetImage->Invalidate();
+        _SetAdaptersBulkResetEnabled( false );
+    }
+
+    void TMujocoSimulation::_SetAdaptersBulkResetEnabled( bool enabled )
+    {
+        for ( auto& single_body_adapter : m_SingleBodyAdapters )
+            if ( auto mjc_adapter = dynamic_cast<primitives::TMujocoSingleBodyAdapter*>( single_body_adapter.get() ) )
+                mjc_adapter->SetBulkResetEnabled( enabled );
+        for ( auto& kinematic_tree_adapter : m_KinematicTreeAdapters )
+            if ( auto mjc_adapter = dynamic_cast<kintree::TMujocoKinematicTreeAdapter*>( kinematic_tree_adapter.get() ) )
+                mjc_adapter->SetBulkResetEnabled( enabled );
     }
 
     void TMujocoSimulation::_SetTimeStepInternal( const TScalar& time_step )
     {
         LOCO_CORE_ASSERT( m_MjcModel, "TMujocoSimulation::_SetTimeStepInternal >>> mjModel struct is required \
                           for taking a simulation step, but got nullptr instead" );
+        MakeMjcModelUnique();
         m_MjcModel->opt.timestep = time_step;
     }
 
@@ -386,9 +1442,13 @@ namespace loco
     {
         LOCO_CORE_ASSERT( m_MjcModel, "TMujocoSimulation::_SetGravityInternal >>> mjModel struct is required \
                           for taking a simulation step, but got nullptr instead" );
+        MakeMjcModelUnique();
         m_MjcModel->opt.gravity[0] = gravity.x();
         m_MjcModel->opt.gravity[1] = gravity.y();
         m_MjcModel->opt.gravity[2] = gravity.z();
+        // Gravity-compensation of parked bodies depends on the gravity
+        if ( m_MjcBodySlots )
+            m_MjcBodySlots->RefreshParked();
     }
 
     extern "C" TISimulation* simulation_create( loco::TScenario* scenarioRef )
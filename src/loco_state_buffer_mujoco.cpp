@@ -0,0 +1,113 @@
+#include <loco_state_buffer_mujoco.h>
+
+namespace loco {
+namespace mujoco {
+
+    std::array<ssize_t, 10> TMujocoStateImage::_FieldSizes( const mjModel* mjc_model )
+    {
+        return { mjc_model->nq,                 // qpos
+                 mjc_model->nv,                 // qvel
+                 mjc_model->na,                 // act
+                 mjc_model->nu,                 // ctrl
+                 mjc_model->nv,                 // qacc_warmstart
+                 mjc_model->nv,                 // qfrc_applied
+                 6 * mjc_model->nbody,          // xfrc_applied
+                 3 * mjc_model->nmocap,         // mocap_pos
+                 4 * mjc_model->nmocap,         // mocap_quat
+                 mjc_model->nuserdata };        // userdata
+    }
+
+    void TMujocoStateImage::Allocate( const mjModel* mjc_model )
+    {
+        LOCO_CORE_ASSERT( mjc_model, "TMujocoStateImage::Allocate >>> must have a valid mjModel reference, but got nullptr" );
+
+        const auto fields_sizes = _FieldSizes( mjc_model );
+        ssize_t buffer_size = 0;
+        for ( ssize_t i = 0; i < (ssize_t)fields_sizes.size(); i++ )
+        {
+            m_FieldsOffsets[i] = buffer_size;
+            buffer_size += fields_sizes[i];
+        }
+        m_Buffer.assign( buffer_size, 0.0 );
+        m_Valid = false;
+    }
+
+    void TMujocoStateImage::Capture( const mjModel* mjc_model, const mjData* mjc_data )
+    {
+        LOCO_CORE_ASSERT( mjc_model && mjc_data, "TMujocoStateImage::Capture >>> must have valid mjModel and mjData references" );
+
+        const mjtNum* src_fields[] = { mjc_data->qpos, mjc_data->qvel, mjc_data->act, mjc_data->ctrl,
+                                       mjc_data->qacc_warmstart, mjc_data->qfrc_applied, mjc_data->xfrc_applied,
+                                       mjc_data->mocap_pos, mjc_data->mocap_quat, mjc_data->userdata };
+        const auto fields_sizes = _FieldSizes( mjc_model );
+        for ( ssize_t i = 0; i < (ssize_t)fields_sizes.size(); i++ )
+            if ( fields_sizes[i] > 0 )
+                std::memcpy( m_Buffer.data() + m_FieldsOffsets[i], src_fields[i], sizeof( mjtNum ) * fields_sizes[i] );
+        m_Time = mjc_data->time;
+        m_Valid = true;
+    }
+
+    void TMujocoStateImage::Restore( const mjModel* mjc_model, mjData* mjc_data ) const
+    {
+        LOCO_CORE_ASSERT( mjc_model && mjc_data, "TMujocoStateImage::Restore >>> must have valid mjModel and mjData references" );
+        LOCO_CORE_ASSERT( m_Valid, "TMujocoStateImage::Restore >>> tried restoring from an image without a captured state" );
+
+        mjtNum* dst_fields[] = { mjc_data->qpos, mjc_data->qvel, mjc_data->act, mjc_data->ctrl,
+                                 mjc_data->qacc_warmstart, mjc_data->qfrc_applied, mjc_data->xfrc_applied,
+                                 mjc_data->mocap_pos, mjc_data->mocap_quat, mjc_data->userdata };
+        const auto fields_sizes = _FieldSizes( mjc_model );
+        for ( ssize_t i = 0; i < (ssize_t)fields_sizes.size(); i++ )
+            if ( fields_sizes[i] > 0 )
+                std::memcpy( dst_fields[i], m_Buffer.data() + m_FieldsOffsets[i], sizeof( mjtNum ) * fields_sizes[i] );
+        mjc_data->time = m_Time;
+    }
+
+    void TMujocoStateImage::Assign( mjtNum time, const mjtNum* values )
+    {
+        LOCO_CORE_ASSERT( values, "TMujocoStateImage::Assign >>> must have valid values to assign from, but got nullptr" );
+
+        std::memcpy( m_Buffer.data(), values, sizeof( mjtNum ) * m_Buffer.size() );
+        m_Time = time;
+        m_Valid = true;
+    }
+
+    void TMujocoStateRing::Resize( const mjModel* mjc_model, ssize_t capacity )
+    {
+        LOCO_CORE_ASSERT( capacity > 0, "TMujocoStateRing::Resize >>> capacity must be at least 1 (got {0})", capacity );
+
+        m_Images.resize( capacity );
+        for ( auto& image : m_Images )
+            image.Allocate( mjc_model );
+        Clear();
+    }
+
+    ssize_t TMujocoStateRing::Save( const mjModel* mjc_model, const mjData* mjc_data, const TScalar& world_time )
+    {
+        LOCO_CORE_ASSERT( m_Images.size() > 0, "TMujocoStateRing::Save >>> ring must be allocated first (see Resize)" );
+
+        const ssize_t checkpoint_id = m_NextCheckpointId++;
+        auto& image = m_Images[checkpoint_id % m_Images.size()];
+        image.Capture( mjc_model, mjc_data );
+        image.world_time = world_time;
+        return checkpoint_id;
+    }
+
+    const TMujocoStateImage* TMujocoStateRing::Get( ssize_t checkpoint_id ) const
+    {
+        if ( checkpoint_id < 0 )
+            checkpoint_id = m_NextCheckpointId - 1;
+        // Either never saved, or already overwritten by newer checkpoints
+        if ( checkpoint_id < m_FirstCheckpointId || checkpoint_id >= m_NextCheckpointId ||
+             checkpoint_id < m_NextCheckpointId - (ssize_t)m_Images.size() )
+            return nullptr;
+        return &m_Images[checkpoint_id % m_Images.size()];
+    }
+
+    void TMujocoStateRing::Clear()
+    {
+        // Ids keep increasing, so ids handed out before clearing are never valid again
+        m_FirstCheckpointId = m_NextCheckpointId;
+        for ( auto& image : m_Images )
+            image.Invalidate();
+    }
+}}
\ No newline at end of file
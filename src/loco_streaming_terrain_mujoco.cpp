@@ -0,0 +1,174 @@
+#include <loco_streaming_terrain_mujoco.h>
+#include <loco_simulation_mujoco.h>
+
+namespace loco {
+namespace mujoco {
+
+    TMujocoStreamingTerrain::TMujocoStreamingTerrain( TScenario* scenario_ref,
+                                                      const std::string& name,
+                                                      ssize_t num_tiles_per_side,
+                                                      TScalar tile_size,
+                                                      ssize_t num_samples_per_side,
+                                                      TScalar height_scale,
+                                                      const FnTerrainTileGenerator& generator )
+    {
+        LOCO_CORE_ASSERT( scenario_ref, "TMujocoStreamingTerrain >>> must have a valid scenario reference (got nullptr)" );
+        LOCO_CORE_ASSERT( generator, "TMujocoStreamingTerrain >>> terrain {0} requires a tile generator", name );
+        LOCO_CORE_ASSERT( num_tiles_per_side > 0, "TMujocoStreamingTerrain >>> terrain {0} requires at least one \
+                          tile per side (got {1})", name, num_tiles_per_side );
+        LOCO_CORE_ASSERT( num_samples_per_side > 1, "TMujocoStreamingTerrain >>> terrain {0} requires at least two \
+                          samples per side (got {1})", name, num_samples_per_side );
+
+        if ( num_tiles_per_side % 2 == 0 )
+        {
+            LOCO_CORE_WARN( "TMujocoStreamingTerrain >>> terrain {0} requires an odd number of tiles per side, so the window \
+                             is centered on the agent's tile (got {1}, using {2})", name, num_tiles_per_side, num_tiles_per_side + 1 );
+            num_tiles_per_side++;
+        }
+
+        m_Name = name;
+        m_NumTilesPerSide = num_tiles_per_side;
+        m_TileSize = tile_size;
+        m_NumSamplesPerSide = num_samples_per_side;
+        m_HeightScale = height_scale;
+        m_Generator = generator;
+        m_ScratchHeights.resize( m_NumSamplesPerSide * m_NumSamplesPerSide );
+        m_SlotsBodies.resize( m_NumTilesPerSide * m_NumTilesPerSide, nullptr );
+        m_SlotsTiles.resize( m_NumTilesPerSide * m_NumTilesPerSide );
+
+        // Initial window is centered at the origin, and each tile is created with its actual heights (mujoco
+        // requires a valid heightfield on compilation, and it saves a round of streaming on initialization)
+        const ssize_t half_tiles = m_NumTilesPerSide / 2;
+        for ( ssize_t iy = -half_tiles; iy <= half_tiles; iy++ )
+        {
+            for ( ssize_t ix = -half_tiles; ix <= half_tiles; ix++ )
+            {
+                const ssize_t slot_index = _SlotIndex( ix, iy );
+                const auto tile = _MakeTile( ix, iy );
+                m_Generator( tile, m_ScratchHeights );
+
+                auto col_data = TCollisionData();
+                col_data.type = eShapeType::HEIGHTFIELD;
+                col_data.size = { m_TileSize, m_TileSize, m_HeightScale };
+                col_data.hfield_data.nWidthSamples = m_NumSamplesPerSide;
+                col_data.hfield_data.nDepthSamples = m_NumSamplesPerSide;
+                col_data.hfield_data.heights = m_ScratchHeights;
+                auto vis_data = TVisualData();
+                vis_data.type = eShapeType::HEIGHTFIELD;
+                vis_data.size = col_data.size;
+                vis_data.hfield_data = col_data.hfield_data;
+                auto body_data = TBodyData();
+                body_data.dyntype = eDynamicsType::STATIC;
+                body_data.collision = col_data;
+                body_data.visual = vis_data;
+
+                const std::string body_name = LOCO_MUJOCO_STREAMING_TERRAIN_TILE_PREFIX + m_Name + "_" + std::to_string( slot_index );
+                const TVec3 body_position = { ix * m_TileSize, iy * m_TileSize, 0.0f };
+                m_SlotsBodies[slot_index] = scenario_ref->AddSingleBody(
+                        std::make_unique<primitives::TSingleBody>( body_name, body_data, body_position, TMat3() ) );
+                m_SlotsTiles[slot_index] = tile;
+                m_NumTilesStreamed++;
+            }
+        }
+    }
+
+    bool TMujocoStreamingTerrain::Initialize()
+    {
+        m_SlotsBodiesAdapters.resize( m_SlotsBodies.size(), nullptr );
+        m_SlotsAdapters.resize( m_SlotsBodies.size(), nullptr );
+        for ( ssize_t i = 0; i < m_SlotsBodies.size(); i++ )
+        {
+            auto collider_adapter = m_SlotsBodies[i]->collider()->collider_adapter();
+            m_SlotsBodiesAdapters[i] = dynamic_cast<primitives::TMujocoSingleBodyAdapter*>( m_SlotsBodies[i]->adapter() );
+            m_SlotsAdapters[i] = dynamic_cast<primitives::TMujocoSingleBodyColliderAdapter*>( collider_adapter );
+            if ( !m_SlotsBodiesAdapters[i] || !m_SlotsAdapters[i] || m_SlotsAdapters[i]->mjc_geom_hfield_id() < 0 )
+            {
+                LOCO_CORE_ERROR( "TMujocoStreamingTerrain::Initialize >>> tile {0} of terrain {1} isn't linked to a mjc-hfield, "
+                                 "was the simulation initialized?", m_SlotsBodies[i]->name(), m_Name );
+                m_SlotsBodiesAdapters.clear();
+                m_SlotsAdapters.clear();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void TMujocoStreamingTerrain::Update()
+    {
+        if ( m_TrackedKintreeRef )
+            Update( m_TrackedKintreeRef->pos() );
+    }
+
+    void TMujocoStreamingTerrain::Update( const TVec3& position )
+    {
+        if ( m_SlotsAdapters.empty() )
+        {
+            LOCO_CORE_WARN( "TMujocoStreamingTerrain::Update >>> terrain {0} must be initialized first", m_Name );
+            return;
+        }
+
+        // Offset from the center-tile, in tiles (recenter only once clearly inside a neighbouring tile)
+        const TScalar offset_x = position.x() / m_TileSize - m_CenterIx;
+        const TScalar offset_y = position.y() / m_TileSize - m_CenterIy;
+        const TScalar threshold = 0.5f + m_RecenterMargin;
+        if ( std::abs( offset_x ) <= threshold && std::abs( offset_y ) <= threshold )
+            return;
+
+        m_CenterIx = std::lround( position.x() / m_TileSize );
+        m_CenterIy = std::lround( position.y() / m_TileSize );
+
+        // Tiles that remain in the window are already in their slots, so only the ones that left are recycled
+        const ssize_t half_tiles = m_NumTilesPerSide / 2;
+        for ( ssize_t iy = m_CenterIy - half_tiles; iy <= m_CenterIy + half_tiles; iy++ )
+        {
+            for ( ssize_t ix = m_CenterIx - half_tiles; ix <= m_CenterIx + half_tiles; ix++ )
+            {
+                const ssize_t slot_index = _SlotIndex( ix, iy );
+                if ( m_SlotsTiles[slot_index].ix != ix || m_SlotsTiles[slot_index].iy != iy )
+                    _StreamTile( slot_index, ix, iy );
+            }
+        }
+    }
+
+    TMujocoTerrainTile TMujocoStreamingTerrain::_MakeTile( ssize_t ix, ssize_t iy ) const
+    {
+        TMujocoTerrainTile tile;
+        tile.ix = ix;
+        tile.iy = iy;
+        tile.x_min = ( ix - 0.5f ) * m_TileSize;
+        tile.y_min = ( iy - 0.5f ) * m_TileSize;
+        tile.sample_spacing = m_TileSize / ( m_NumSamplesPerSide - 1 );
+        tile.num_samples = m_NumSamplesPerSide;
+        return tile;
+    }
+
+    ssize_t TMujocoStreamingTerrain::_SlotIndex( ssize_t ix, ssize_t iy ) const
+    {
+        const ssize_t slot_x = ( ( ix % m_NumTilesPerSide ) + m_NumTilesPerSide ) % m_NumTilesPerSide;
+        const ssize_t slot_y = ( ( iy % m_NumTilesPerSide ) + m_NumTilesPerSide ) % m_NumTilesPerSide;
+        return slot_y * m_NumTilesPerSide + slot_x;
+    }
+
+    void TMujocoStreamingTerrain::_StreamTile( ssize_t slot_index, ssize_t ix, ssize_t iy )
+    {
+        const auto tile = _MakeTile( ix, iy );
+        m_Generator( tile, m_ScratchHeights );
+        if ( m_ScratchHeights.size() != m_NumSamplesPerSide * m_NumSamplesPerSide )
+        {
+            LOCO_CORE_ERROR( "TMujocoStreamingTerrain::_StreamTile >>> generator of terrain {0} returned {1} heights for \
+                              tile ({2}, {3}), expected {4}", m_Name, m_ScratchHeights.size(), ix, iy,
+                             m_NumSamplesPerSide * m_NumSamplesPerSide );
+            m_ScratchHeights.resize( m_NumSamplesPerSide * m_NumSamplesPerSide );
+            return;
+        }
+
+        // Rewrite the samples in place (hfield_data of the compiled model), then move the tile's geom. Resets
+        // don't restore hfield_data, so the tile must also stay at its new placement when the simulation resets
+        const TVec3 tile_position = { ix * m_TileSize, iy * m_TileSize, 0.0f };
+        m_SlotsAdapters[slot_index]->ChangeElevationData( m_ScratchHeights );
+        m_SlotsBodies[slot_index]->SetPosition( tile_position );
+        m_SlotsBodiesAdapters[slot_index]->SetStaticResetPlacement( tile_position, m_SlotsBodies[slot_index]->quat0() );
+        m_SlotsTiles[slot_index] = tile;
+        m_NumTilesStreamed++;
+    }
+}}
\ No newline at end of file
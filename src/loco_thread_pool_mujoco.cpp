@@ -0,0 +1,168 @@
+#include <loco_thread_pool_mujoco.h>
+
+namespace loco {
+namespace mujoco {
+
+    TMujocoThreadPool::TMujocoThreadPool( ssize_t num_threads )
+    {
+        if ( num_threads <= 0 )
+            num_threads = std::max<ssize_t>( 1, std::thread::hardware_concurrency() );
+
+        for ( ssize_t i = 0; i < num_threads; i++ )
+            m_Queues.push_back( std::make_unique<TWorkerQueue>() );
+        for ( ssize_t i = 0; i < num_threads; i++ )
+            m_Workers.push_back( std::thread( &TMujocoThreadPool::_WorkerLoop, this, i ) );
+    }
+
+    TMujocoThreadPool::~TMujocoThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock( m_Mutex );
+            m_Stop = true;
+        }
+        m_CondVarBatch.notify_all();
+        for ( auto& worker : m_Workers )
+            if ( worker.joinable() )
+                worker.join();
+        m_Workers.clear();
+        m_Queues.clear();
+    }
+
+    void TMujocoThreadPool::ParallelFor( ssize_t num_tasks, const std::function<void( ssize_t )>& task )
+    {
+        if ( num_tasks <= 0 )
+            return;
+        // Not worth waking up the workers for a single task (the caller runs the batch, accounted as worker 0)
+        if ( num_tasks == 1 || m_Workers.size() < 2 )
+        {
+            const auto t_start = std::chrono::steady_clock::now();
+            for ( ssize_t i = 0; i < num_tasks; i++ )
+                task( i );
+            const auto t_end = std::chrono::steady_clock::now();
+            const double batch_time_ms = std::chrono::duration<double, std::milli>( t_end - t_start ).count();
+            m_Queues[0]->stats.busy_time_ms += batch_time_ms;
+            m_Queues[0]->stats.num_tasks += num_tasks;
+            m_BatchesWallTimeMs += batch_time_ms;
+            return;
+        }
+
+        // Seed each worker's queue with its contiguous share of the batch, split into chunks
+        const ssize_t num_workers = m_Workers.size();
+        for ( ssize_t w = 0; w < num_workers; w++ )
+        {
+            const ssize_t share_start = ( w * num_tasks ) / num_workers;
+            const ssize_t share_end = ( ( w + 1 ) * num_tasks ) / num_workers;
+            std::lock_guard<std::mutex> queue_lock( m_Queues[w]->mutex );
+            for ( ssize_t start = share_start; start < share_end; start += m_ChunkSize )
+                m_Queues[w]->chunks.push_back( { start, std::min( start + m_ChunkSize, share_end ) } );
+        }
+
+        const auto t_start = std::chrono::steady_clock::now();
+        std::unique_lock<std::mutex> lock( m_Mutex );
+        m_Task = &task;
+        m_NumWorkersDone = 0;
+        m_BatchId++;
+        m_CondVarBatch.notify_all();
+        m_CondVarDone.wait( lock, [this, num_workers]() { return m_NumWorkersDone == num_workers; } );
+        m_Task = nullptr;
+        const auto t_end = std::chrono::steady_clock::now();
+        m_BatchesWallTimeMs += std::chrono::duration<double, std::milli>( t_end - t_start ).count();
+    }
+
+    void TMujocoThreadPool::SetChunkSize( ssize_t chunk_size )
+    {
+        if ( chunk_size < 1 )
+        {
+            LOCO_CORE_WARN( "TMujocoThreadPool::SetChunkSize >>> chunk-size must be at least 1 (got {0})", chunk_size );
+            return;
+        }
+        m_ChunkSize = chunk_size;
+    }
+
+    void TMujocoThreadPool::ResetStats()
+    {
+        for ( auto& queue : m_Queues )
+            queue->stats = TMujocoWorkerStats();
+        m_BatchesWallTimeMs = 0.0;
+    }
+
+    std::vector<TMujocoWorkerStats> TMujocoThreadPool::GetWorkerStats() const
+    {
+        // Stats are only written by the workers while a batch is running (i.e. inside ParallelFor)
+        std::vector<TMujocoWorkerStats> workers_stats;
+        for ( const auto& queue : m_Queues )
+        {
+            workers_stats.push_back( queue->stats );
+            workers_stats.back().utilization = ( m_BatchesWallTimeMs > 0.0 ) ? queue->stats.busy_time_ms / m_BatchesWallTimeMs : 0.0;
+        }
+        return workers_stats;
+    }
+
+    void TMujocoThreadPool::_WorkerLoop( ssize_t worker_id )
+    {
+        uint64_t last_batch_id = 0;
+        while ( true )
+        {
+            std::unique_lock<std::mutex> lock( m_Mutex );
+            m_CondVarBatch.wait( lock, [this, last_batch_id]() { return m_Stop || m_BatchId != last_batch_id; } );
+            if ( m_Stop )
+                return;
+            last_batch_id = m_BatchId;
+            const auto task = m_Task;
+            const ssize_t num_workers = m_Workers.size();
+            lock.unlock();
+
+            auto& stats = m_Queues[worker_id]->stats;
+            TTaskChunk chunk;
+            while ( true )
+            {
+                if ( !_PopChunk( worker_id, chunk ) )
+                {
+                    if ( !_StealChunk( worker_id, chunk ) )
+                        break;
+                    stats.num_steals++;
+                }
+
+                const auto t_start = std::chrono::steady_clock::now();
+                for ( ssize_t i = chunk.start; i < chunk.end; i++ )
+                    ( *task )( i );
+                const auto t_end = std::chrono::steady_clock::now();
+                stats.busy_time_ms += std::chrono::duration<double, std::milli>( t_end - t_start ).count();
+                stats.num_tasks += chunk.end - chunk.start;
+            }
+
+            // Chunks are never re-queued, so once all queues are empty the remaining in-flight chunks
+            // belong to workers that haven't reported yet; the batch is done once every worker reports
+            lock.lock();
+            if ( ++m_NumWorkersDone == num_workers )
+                m_CondVarDone.notify_one();
+        }
+    }
+
+    bool TMujocoThreadPool::_PopChunk( ssize_t worker_id, TTaskChunk& dst_chunk )
+    {
+        auto& queue = *m_Queues[worker_id];
+        std::lock_guard<std::mutex> queue_lock( queue.mutex );
+        if ( queue.chunks.empty() )
+            return false;
+        dst_chunk = queue.chunks.front();
+        queue.chunks.pop_front();
+        return true;
+    }
+
+    bool TMujocoThreadPool::_StealChunk( ssize_t worker_id, TTaskChunk& dst_chunk )
+    {
+        const ssize_t num_workers = m_Queues.size();
+        for ( ssize_t k = 1; k < num_workers; k++ )
+        {
+            auto& victim = *m_Queues[( worker_id + k ) % num_workers];
+            std::lock_guard<std::mutex> queue_lock( victim.mutex );
+            if ( victim.chunks.empty() )
+                continue;
+            dst_chunk = victim.chunks.back();
+            victim.chunks.pop_back();
+            return true;
+        }
+        return false;
+    }
+}}
\ No newline at end of file
@@ -0,0 +1,391 @@
+#include <loco_trajectory_recorder_mujoco.h>
+
+#if defined( __linux__ ) || defined( __APPLE__ )
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace loco {
+namespace mujoco {
+
+    // Records start at a cache-line boundary right after the header
+    static size_t _TrajectoryHeaderSize()
+    {
+        return ( ( sizeof( TMujocoTrajectoryHeader ) + 63 ) / 64 ) * 64;
+    }
+
+    TMujocoTrajectoryRecorder::TMujocoTrajectoryRecorder()
+    {
+        m_Fd = -1;
+        m_Data = nullptr;
+        m_MappedSize = 0;
+        m_HeaderSize = _TrajectoryHeaderSize();
+        m_RecordStride = 0;
+        m_NumRecords = 0;
+        m_NumKeyframes = 0;
+        m_KeyframeInterval = 0;
+        m_LastKeyframeRecordId = -1;
+        m_ForceKeyframe = false;
+        m_KeyframesFile = nullptr;
+        m_FlushIntervalMs = 0;
+        m_StopFlush = false;
+    }
+
+    TMujocoTrajectoryRecorder::~TMujocoTrajectoryRecorder()
+    {
+        Close();
+    }
+
+    bool TMujocoTrajectoryRecorder::Open( const std::string& filepath, const mjModel* mjc_model,
+                                          ssize_t keyframe_interval, ssize_t flush_interval_ms )
+    {
+        LOCO_CORE_ASSERT( mjc_model, "TMujocoTrajectoryRecorder::Open >>> must have a valid mjModel (got nullptr)" );
+        LOCO_CORE_ASSERT( keyframe_interval > 0, "TMujocoTrajectoryRecorder::Open >>> keyframe interval must be "
+                          "at least 1 (got {0})", keyframe_interval );
+
+        if ( is_open() )
+            Close();
+
+        m_Filepath = filepath;
+        m_Fd = open( filepath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644 );
+        if ( m_Fd < 0 )
+        {
+            LOCO_CORE_ERROR( "TMujocoTrajectoryRecorder::Open >>> couldn't open file {0}", filepath );
+            return false;
+        }
+        m_KeyframesFile = fopen( ( filepath + LOCO_MUJOCO_TRAJECTORY_KEYFRAMES_EXTENSION ).c_str(), "wb" );
+        if ( !m_KeyframesFile )
+        {
+            LOCO_CORE_ERROR( "TMujocoTrajectoryRecorder::Open >>> couldn't open keyframes file {0}{1}",
+                             filepath, LOCO_MUJOCO_TRAJECTORY_KEYFRAMES_EXTENSION );
+            close( m_Fd );
+            m_Fd = -1;
+            return false;
+        }
+
+        m_KeyframeImage.Allocate( mjc_model );
+        m_RecordStride = sizeof( mjtNum ) * ( 1 + mjc_model->nq + mjc_model->nv + mjc_model->nu + 6 * mjc_model->nbody );
+        m_KeyframeInterval = keyframe_interval;
+        m_FlushIntervalMs = std::max<ssize_t>( 1, flush_interval_ms );
+        m_NumRecords = 0;
+        m_NumKeyframes = 0;
+        m_LastKeyframeRecordId = -1;
+        m_ForceKeyframe = false;
+        if ( !_Grow( m_HeaderSize + LOCO_MUJOCO_TRAJECTORY_GROW_RECORDS * m_RecordStride ) )
+        {
+            Close();
+            return false;
+        }
+
+        auto header = _Header();
+        header->magic = LOCO_MUJOCO_TRAJECTORY_MAGIC;
+        header->version = LOCO_MUJOCO_TRAJECTORY_VERSION;
+        header->nq = mjc_model->nq;
+        header->nv = mjc_model->nv;
+        header->nu = mjc_model->nu;
+        header->nbody = mjc_model->nbody;
+        header->na = mjc_model->na;
+        header->nmocap = mjc_model->nmocap;
+        header->nuserdata = mjc_model->nuserdata;
+        header->record_num_values = m_RecordStride / sizeof( mjtNum );
+        header->keyframe_num_values = 2 + m_KeyframeImage.num_values();
+        header->keyframe_interval = keyframe_interval;
+        header->num_records = 0;
+        header->num_keyframes = 0;
+        header->time_step = mjc_model->opt.timestep;
+
+        m_StopFlush = false;
+        m_FlushThread = std::thread( &TMujocoTrajectoryRecorder::_FlushLoop, this );
+        return true;
+    }
+
+    void TMujocoTrajectoryRecorder::Record( const mjModel* mjc_model, const mjData* mjc_data )
+    {
+        if ( !is_open() )
+            return;
+
+        const size_t record_offset = m_HeaderSize + m_NumRecords * m_RecordStride;
+        if ( record_offset + m_RecordStride > m_MappedSize )
+        {
+            if ( !_Grow( m_HeaderSize + ( 2 * m_NumRecords + LOCO_MUJOCO_TRAJECTORY_GROW_RECORDS ) * m_RecordStride ) )
+                return;
+        }
+
+        mjtNum* record = reinterpret_cast<mjtNum*>( m_Data + record_offset );
+        record[0] = mjc_data->time;
+        record += 1;
+        std::memcpy( record, mjc_data->qpos, sizeof( mjtNum ) * mjc_model->nq );
+        record += mjc_model->nq;
+        std::memcpy( record, mjc_data->qvel, sizeof( mjtNum ) * mjc_model->nv );
+        record += mjc_model->nv;
+        std::memcpy( record, mjc_data->ctrl, sizeof( mjtNum ) * mjc_model->nu );
+        record += mjc_model->nu;
+        std::memcpy( record, mjc_data->xfrc_applied, sizeof( mjtNum ) * 6 * mjc_model->nbody );
+
+        if ( m_ForceKeyframe || m_LastKeyframeRecordId < 0 || m_NumRecords - m_LastKeyframeRecordId >= m_KeyframeInterval )
+        {
+            m_KeyframeImage.Capture( mjc_model, mjc_data );
+            const mjtNum keyframe_info[2] = { static_cast<mjtNum>( m_NumRecords ), mjc_data->time };
+            fwrite( keyframe_info, sizeof( mjtNum ), 2, m_KeyframesFile );
+            fwrite( m_KeyframeImage.data(), sizeof( mjtNum ), m_KeyframeImage.num_values(), m_KeyframesFile );
+            _Header()->num_keyframes = ++m_NumKeyframes;
+            m_LastKeyframeRecordId = m_NumRecords;
+            m_ForceKeyframe = false;
+        }
+
+        _Header()->num_records = ++m_NumRecords;
+    }
+
+    void TMujocoTrajectoryRecorder::Close()
+    {
+        if ( m_FlushThread.joinable() )
+        {
+            {
+                std::lock_guard<std::mutex> lock( m_FlushMutex );
+                m_StopFlush = true;
+            }
+            m_FlushCondVar.notify_one();
+            m_FlushThread.join();
+        }
+
+        if ( m_Data )
+        {
+            msync( m_Data, m_MappedSize, MS_SYNC );
+            munmap( m_Data, m_MappedSize );
+            m_Data = nullptr;
+            m_MappedSize = 0;
+        }
+        if ( m_Fd >= 0 )
+        {
+            // Trim the geometric growth, so the file holds exactly the header and the recorded steps
+            if ( ftruncate( m_Fd, m_HeaderSize + m_NumRecords * m_RecordStride ) != 0 )
+                LOCO_CORE_WARN( "TMujocoTrajectoryRecorder::Close >>> couldn't trim file {0}", m_Filepath );
+            close( m_Fd );
+            m_Fd = -1;
+        }
+        if ( m_KeyframesFile )
+        {
+            fclose( m_KeyframesFile );
+            m_KeyframesFile = nullptr;
+        }
+    }
+
+    bool TMujocoTrajectoryRecorder::_Grow( size_t min_size )
+    {
+        // Dirty pages are flushed from the background thread, so hold it off while remapping
+        std::lock_guard<std::mutex> lock( m_FlushMutex );
+        const size_t new_size = std::max( min_size, 2 * m_MappedSize );
+        if ( ftruncate( m_Fd, new_size ) != 0 )
+        {
+            LOCO_CORE_ERROR( "TMujocoTrajectoryRecorder::_Grow >>> couldn't grow file {0} to {1} bytes", m_Filepath, new_size );
+            return false;
+        }
+        if ( m_Data )
+            munmap( m_Data, m_MappedSize );
+
+        void* data = mmap( nullptr, new_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_Fd, 0 );
+        if ( data == MAP_FAILED )
+        {
+            LOCO_CORE_ERROR( "TMujocoTrajectoryRecorder::_Grow >>> couldn't map file {0} ({1} bytes)", m_Filepath, new_size );
+            m_Data = nullptr;
+            m_MappedSize = 0;
+            return false;
+        }
+        m_Data = reinterpret_cast<uint8_t*>( data );
+        m_MappedSize = new_size;
+        return true;
+    }
+
+    void TMujocoTrajectoryRecorder::_FlushLoop()
+    {
+        std::unique_lock<std::mutex> lock( m_FlushMutex );
+        while ( !m_StopFlush )
+        {
+            m_FlushCondVar.wait_for( lock, std::chrono::milliseconds( m_FlushIntervalMs ) );
+            if ( m_StopFlush || !m_Data )
+                continue;
+            // Only dirty pages are written back, so this is cheap when nothing new was recorded
+            msync( m_Data, m_MappedSize, MS_ASYNC );
+            fflush( m_KeyframesFile );
+        }
+    }
+
+    TMujocoTrajectoryReader::TMujocoTrajectoryReader()
+    {
+        m_Data = nullptr;
+        m_DataSize = 0;
+        m_Header = nullptr;
+        m_KeyframesData = nullptr;
+        m_KeyframesDataSize = 0;
+        m_NumKeyframes = 0;
+    }
+
+    TMujocoTrajectoryReader::~TMujocoTrajectoryReader()
+    {
+        Close();
+    }
+
+    // Maps a whole file read-only (returns nullptr for missing or empty files)
+    static void* _MapFileReadOnly( const std::string& filepath, size_t& dst_size )
+    {
+        dst_size = 0;
+        const int fd = open( filepath.c_str(), O_RDONLY );
+        if ( fd < 0 )
+            return nullptr;
+
+        struct stat file_stat;
+        if ( fstat( fd, &file_stat ) != 0 || file_stat.st_size == 0 )
+        {
+            close( fd );
+            return nullptr;
+        }
+        void* data = mmap( nullptr, file_stat.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+        close( fd );
+        if ( data == MAP_FAILED )
+            return nullptr;
+        dst_size = file_stat.st_size;
+        return data;
+    }
+
+    bool TMujocoTrajectoryReader::Open( const std::string& filepath )
+    {
+        Close();
+
+        m_Data = _MapFileReadOnly( filepath, m_DataSize );
+        if ( !m_Data || m_DataSize < _TrajectoryHeaderSize() )
+        {
+            LOCO_CORE_ERROR( "TMujocoTrajectoryReader::Open >>> couldn't map trajectory file {0}", filepath );
+            Close();
+            return false;
+        }
+        m_Header = reinterpret_cast<const TMujocoTrajectoryHeader*>( m_Data );
+        if ( m_Header->magic != LOCO_MUJOCO_TRAJECTORY_MAGIC || m_Header->version != LOCO_MUJOCO_TRAJECTORY_VERSION )
+        {
+            LOCO_CORE_ERROR( "TMujocoTrajectoryReader::Open >>> file {0} is not a trajectory log (or has an "
+                             "unsupported version {1})", filepath, m_Header->version );
+            Close();
+            return false;
+        }
+        const size_t records_size = m_Header->num_records * m_Header->record_num_values * sizeof( mjtNum );
+        if ( _TrajectoryHeaderSize() + records_size > m_DataSize )
+        {
+            LOCO_CORE_ERROR( "TMujocoTrajectoryReader::Open >>> file {0} is truncated (expected {1} records)",
+                             filepath, m_Header->num_records );
+            Close();
+            return false;
+        }
+
+        // Keyframes might lag behind (if the recorder wasn't closed properly), so count the complete ones
+        m_KeyframesData = _MapFileReadOnly( filepath + LOCO_MUJOCO_TRAJECTORY_KEYFRAMES_EXTENSION, m_KeyframesDataSize );
+        m_NumKeyframes = std::min<ssize_t>( m_Header->num_keyframes,
+                                            m_KeyframesDataSize / ( m_Header->keyframe_num_values * sizeof( mjtNum ) ) );
+        return true;
+    }
+
+    void TMujocoTrajectoryReader::Close()
+    {
+        if ( m_Data )
+            munmap( m_Data, m_DataSize );
+        if ( m_KeyframesData )
+            munmap( m_KeyframesData, m_KeyframesDataSize );
+        m_Data = nullptr;
+        m_DataSize = 0;
+        m_Header = nullptr;
+        m_KeyframesData = nullptr;
+        m_KeyframesDataSize = 0;
+        m_NumKeyframes = 0;
+    }
+
+    bool TMujocoTrajectoryReader::RestoreState( const mjModel* mjc_model, mjData* mjc_data, ssize_t record_id ) const
+    {
+        LOCO_CORE_ASSERT( mjc_model && mjc_data, "TMujocoTrajectoryReader::RestoreState >>> must have valid "
+                          "mjModel and mjData (got nullptr)" );
+
+        if ( !is_open() || record_id < 0 || record_id >= num_records() )
+        {
+            LOCO_CORE_ERROR( "TMujocoTrajectoryReader::RestoreState >>> record {0} out of range [0, {1})",
+                             record_id, num_records() );
+            return false;
+        }
+        if ( !matches_model( mjc_model ) )
+        {
+            LOCO_CORE_ERROR( "TMujocoTrajectoryReader::RestoreState >>> model doesn't match the recorded one "
+                             "(nq={0}, nv={1}, nu={2}, nbody={3}, na={4}, nmocap={5}, nuserdata={6})",
+                             m_Header->nq, m_Header->nv, m_Header->nu, m_Header->nbody,
+                             m_Header->na, m_Header->nmocap, m_Header->nuserdata );
+            return false;
+        }
+
+        const ssize_t keyframe_id = _FindKeyframe( record_id );
+        if ( keyframe_id < 0 )
+        {
+            LOCO_CORE_ERROR( "TMujocoTrajectoryReader::RestoreState >>> no keyframes available to restore from" );
+            return false;
+        }
+        const mjtNum* keyframe = _Keyframe( keyframe_id );
+        const ssize_t keyframe_record_id = static_cast<ssize_t>( keyframe[0] );
+
+        TMujocoStateImage image;
+        image.Allocate( mjc_model );
+        image.Assign( keyframe[1], keyframe + 2 );
+        image.Restore( mjc_model, mjc_data );
+
+        // Replay the recorded inputs up to the requested record (each record might span several substeps)
+        for ( ssize_t i = keyframe_record_id + 1; i <= record_id; i++ )
+        {
+            std::memcpy( mjc_data->ctrl, record_ctrl( i ), sizeof( mjtNum ) * mjc_model->nu );
+            std::memcpy( mjc_data->xfrc_applied, record_xfrc_applied( i ), sizeof( mjtNum ) * 6 * mjc_model->nbody );
+            const ssize_t num_substeps = std::max<ssize_t>( 1, std::lround( ( record_time( i ) - record_time( i - 1 ) ) / mjc_model->opt.timestep ) );
+            for ( ssize_t j = 0; j < num_substeps; j++ )
+                mj_step( mjc_model, mjc_data );
+        }
+        mj_forward( mjc_model, mjc_data );
+        return true;
+    }
+
+    const mjtNum* TMujocoTrajectoryReader::_Record( ssize_t record_id ) const
+    {
+        LOCO_CORE_ASSERT( record_id >= 0 && record_id < num_records(), "TMujocoTrajectoryReader::_Record >>> "
+                          "record {0} out of range [0, {1})", record_id, num_records() );
+        const uint8_t* records = reinterpret_cast<const uint8_t*>( m_Data ) + _TrajectoryHeaderSize();
+        return reinterpret_cast<const mjtNum*>( records ) + record_id * m_Header->record_num_values;
+    }
+
+    const mjtNum* TMujocoTrajectoryReader::_Keyframe( ssize_t keyframe_id ) const
+    {
+        return reinterpret_cast<const mjtNum*>( m_KeyframesData ) + keyframe_id * m_Header->keyframe_num_values;
+    }
+
+    ssize_t TMujocoTrajectoryReader::_FindKeyframe( ssize_t record_id ) const
+    {
+        // Keyframes are sorted by record-id, but not evenly spaced (discontinuities force extra ones), so
+        // look for the last one at or before the requested record
+        ssize_t lo = 0, hi = m_NumKeyframes - 1, keyframe_id = -1;
+        while ( lo <= hi )
+        {
+            const ssize_t mid = ( lo + hi ) / 2;
+            if ( static_cast<ssize_t>( _Keyframe( mid )[0] ) <= record_id )
+            {
+                keyframe_id = mid;
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid - 1;
+            }
+        }
+        return keyframe_id;
+    }
+
+    bool TMujocoTrajectoryReader::matches_model( const mjModel* mjc_model ) const
+    {
+        return m_Header && mjc_model->nq == m_Header->nq && mjc_model->nv == m_Header->nv &&
+               mjc_model->nu == m_Header->nu && mjc_model->nbody == m_Header->nbody &&
+               mjc_model->na == m_Header->na && mjc_model->nmocap == m_Header->nmocap &&
+               mjc_model->nuserdata == m_Header->nuserdata;
+    }
+}}
+
+#endif /* __linux__ || __APPLE__ */
\ No newline at end of file
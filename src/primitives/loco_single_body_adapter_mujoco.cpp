@@ -4,8 +4,6 @@
 namespace loco {
 namespace primitives {
 
-    ssize_t TMujocoSingleBodyAdapter::s_DetachedNum = 0;
-
     TMujocoSingleBodyAdapter::TMujocoSingleBodyAdapter( TSingleBody* bodyRef )
         : TISingleBodyAdapter( bodyRef )
     {
@@ -16,6 +14,7 @@ namespace primitives {
 
         m_mjcModelRef = nullptr;
         m_mjcDataRef = nullptr;
+        m_mjcNameIndexRef = nullptr;
 
         m_mjcBodyId = -1;
         m_mjcJointId = -1;
@@ -25,6 +24,10 @@ namespace primitives {
         m_mjcJointQvelNum = -1;
         m_mjcGeomId = -1;
 
+        m_mjcBulkResetEnabled = false;
+        m_mjcResetSignature = {};
+        m_mjcHasStaticResetPlacement = false;
+
         m_mjcfElementResources = nullptr;
         m_mjcfElementAssetResources = nullptr;
 
@@ -44,6 +47,7 @@ namespace primitives {
 
         m_mjcModelRef = nullptr;
         m_mjcDataRef = nullptr;
+        m_mjcNameIndexRef = nullptr;
         m_mjcBodyId = -1;
         m_mjcJointId = -1;
         m_mjcJointQposAdr = -1;
@@ -219,7 +223,7 @@ namespace primitives {
                                       m_BodyRef->collider()->shape() == eShapeType::CONVEX_MESH );
         if ( m_BodyRef->dyntype() == eDynamicsType::DYNAMIC || is_static_mesh )
         {
-            m_mjcBodyId = mj_name2id( m_mjcModelRef, mjOBJ_BODY, m_BodyRef->name().c_str() );
+            m_mjcBodyId = mujoco::mjc_name2id( m_mjcModelRef, m_mjcNameIndexRef, mjOBJ_BODY, m_BodyRef->name() );
             if ( m_mjcBodyId < 0 )
             {
                 LOCO_CORE_ERROR( "TMujocoSingleBodyAdapter::Initialize >>> couldn't find associated \
@@ -248,37 +252,12 @@ namespace primitives {
                 }
                 else
                 {
-                    m_mjcJointQposAdr = m_mjcModelRef->jnt_qposadr[m_mjcJointId];
-                    m_mjcJointQvelAdr = m_mjcModelRef->jnt_dofadr[m_mjcJointId];
-                    m_mjcJointQposNum = 7;
-                    m_mjcJointQvelNum = 6;
-
-                    // @todo: is this required? (qpos0 should be computed from pos|quat in xml, which is our desired qpos0)
-                    // Set the body's initial configuration
-                    const TVec3 position0 = m_BodyRef->pos0();
-                    m_mjcModelRef->qpos0[m_mjcJointQposAdr + 0] = position0.x();
-                    m_mjcModelRef->qpos0[m_mjcJointQposAdr + 1] = position0.y();
-                    m_mjcModelRef->qpos0[m_mjcJointQposAdr + 2] = position0.z();
-                    const TVec4 quaternion0 = m_BodyRef->quat0();
-                    m_mjcModelRef->qpos0[m_mjcJointQposAdr + 3] = quaternion0.w();
-                    m_mjcModelRef->qpos0[m_mjcJointQposAdr + 4] = quaternion0.x();
-                    m_mjcModelRef->qpos0[m_mjcJointQposAdr + 5] = quaternion0.y();
-                    m_mjcModelRef->qpos0[m_mjcJointQposAdr + 6] = quaternion0.z();
-                    SetLinearVelocity( m_BodyRef->linear_vel0() );
-                    SetAngularVelocity( m_BodyRef->angular_vel0() );
+                    _InitializeFreeJoint();
                 }
             }
             else
             {
-                const TVec3 position0 = m_BodyRef->pos0();
-                m_mjcModelRef->body_pos[3 * m_mjcBodyId + 0] = position0.x();
-                m_mjcModelRef->body_pos[3 * m_mjcBodyId + 1] = position0.y();
-                m_mjcModelRef->body_pos[3 * m_mjcBodyId + 2] = position0.z();
-                const TVec4 quaternion0 = m_BodyRef->quat0();
-                m_mjcModelRef->body_quat[4 * m_mjcBodyId + 0] = quaternion0.w();
-                m_mjcModelRef->body_quat[4 * m_mjcBodyId + 1] = quaternion0.x();
-                m_mjcModelRef->body_quat[4 * m_mjcBodyId + 2] = quaternion0.y();
-                m_mjcModelRef->body_quat[4 * m_mjcBodyId + 3] = quaternion0.z();
+                _SetMjcStaticPlacement( true, m_BodyRef->pos0(), m_BodyRef->quat0() );
             }
         }
         else
@@ -286,15 +265,7 @@ namespace primitives {
             m_mjcGeomId = mjc_collider_adapter->mjc_geom_id();
             LOCO_CORE_ASSERT( m_mjcGeomId != -1, "TMujocoSingleBodyAdapter::Initialize >>> static-body {0} must have \
                               a valid mjc-geom associated with it", m_BodyRef->name() );
-            const TVec3 position0 = m_BodyRef->pos0();
-            m_mjcModelRef->geom_pos[3 * m_mjcGeomId + 0] = position0.x();
-            m_mjcModelRef->geom_pos[3 * m_mjcGeomId + 1] = position0.y();
-            m_mjcModelRef->geom_pos[3 * m_mjcGeomId + 2] = position0.z();
-            const TVec4 quaternion0 = m_BodyRef->quat0();
-            m_mjcModelRef->geom_quat[4 * m_mjcGeomId + 0] = quaternion0.w();
-            m_mjcModelRef->geom_quat[4 * m_mjcGeomId + 1] = quaternion0.x();
-            m_mjcModelRef->geom_quat[4 * m_mjcGeomId + 2] = quaternion0.y();
-            m_mjcModelRef->geom_quat[4 * m_mjcGeomId + 3] = quaternion0.z();
+            _SetMjcStaticPlacement( false, m_BodyRef->pos0(), m_BodyRef->quat0() );
         }
     }
 
@@ -304,6 +275,40 @@ namespace primitives {
         LOCO_CORE_ASSERT( m_mjcDataRef, "TMujocoSingleBodyAdapter::Reset >>> {0} must have a valid mjData reference", m_BodyRef->name() );
         LOCO_CORE_ASSERT( m_mjcBodyId, "TMujocoSingleBodyAdapter::Reset >>> {0} must be linked to a valid mjc-body", m_BodyRef->name() );
 
+        // On bulk-resets the simulation restores the initial-state image, and then applies overrides (if any).
+        // Static bodies are placed through the model (not part of the state-image), so these are always written
+        if ( m_mjcBulkResetEnabled && m_BodyRef->dyntype() == eDynamicsType::DYNAMIC )
+            return;
+
+        ResetInitialConditions();
+    }
+
+    void TMujocoSingleBodyAdapter::ApplyResetOverrides()
+    {
+        if ( m_BodyRef->dyntype() != eDynamicsType::DYNAMIC )
+            return;
+
+        // Only bodies whose initial conditions changed since the initial-state image was taken are written
+        if ( _InitialConditionsSignature() != m_mjcResetSignature )
+            ResetInitialConditions();
+    }
+
+    std::array<TScalar, 13> TMujocoSingleBodyAdapter::_InitialConditionsSignature() const
+    {
+        const TVec3 pos0 = m_BodyRef->pos0();
+        const TVec4 quat0 = m_BodyRef->quat0();
+        const TVec3 linear_vel0 = m_BodyRef->linear_vel0();
+        const TVec3 angular_vel0 = m_BodyRef->angular_vel0();
+        return { pos0.x(), pos0.y(), pos0.z(), quat0.x(), quat0.y(), quat0.z(), quat0.w(),
+                 linear_vel0.x(), linear_vel0.y(), linear_vel0.z(), angular_vel0.x(), angular_vel0.y(), angular_vel0.z() };
+    }
+
+    void TMujocoSingleBodyAdapter::ResetInitialConditions()
+    {
+        LOCO_CORE_ASSERT( m_mjcModelRef, "TMujocoSingleBodyAdapter::ResetInitialConditions >>> {0} must have a valid mjModel reference", m_BodyRef->name() );
+        LOCO_CORE_ASSERT( m_mjcDataRef, "TMujocoSingleBodyAdapter::ResetInitialConditions >>> {0} must have a valid mjData reference", m_BodyRef->name() );
+
+        m_mjcResetSignature = _InitialConditionsSignature();
         const bool is_static_mesh = ( m_BodyRef->dyntype() == eDynamicsType::STATIC &&
                                       m_BodyRef->collider()->shape() == eShapeType::CONVEX_MESH );
         if ( m_BodyRef->dyntype() == eDynamicsType::DYNAMIC || is_static_mesh )
@@ -321,41 +326,60 @@ namespace primitives {
             }
             else
             {
-                const TVec3 position0 = m_BodyRef->pos0();
-                m_mjcModelRef->body_pos[3 * m_mjcBodyId + 0] = position0.x();
-                m_mjcModelRef->body_pos[3 * m_mjcBodyId + 1] = position0.y();
-                m_mjcModelRef->body_pos[3 * m_mjcBodyId + 2] = position0.z();
-                const TVec4 quaternion0 = m_BodyRef->quat0();
-                m_mjcModelRef->body_quat[4 * m_mjcBodyId + 0] = quaternion0.w();
-                m_mjcModelRef->body_quat[4 * m_mjcBodyId + 1] = quaternion0.x();
-                m_mjcModelRef->body_quat[4 * m_mjcBodyId + 2] = quaternion0.y();
-                m_mjcModelRef->body_quat[4 * m_mjcBodyId + 3] = quaternion0.z();
+                TVec3 position0; TVec4 quaternion0;
+                _GetStaticResetPlacement( position0, quaternion0 );
+                _SetMjcStaticPlacement( true, position0, quaternion0 );
             }
         }
         else
         {
-            const TVec3 position0 = m_BodyRef->pos0();
-            m_mjcModelRef->geom_pos[3 * m_mjcGeomId + 0] = position0.x();
-            m_mjcModelRef->geom_pos[3 * m_mjcGeomId + 1] = position0.y();
-            m_mjcModelRef->geom_pos[3 * m_mjcGeomId + 2] = position0.z();
-            const TVec4 quaternion0 = m_BodyRef->quat0();
-            m_mjcModelRef->geom_quat[4 * m_mjcGeomId + 0] = quaternion0.w();
-            m_mjcModelRef->geom_quat[4 * m_mjcGeomId + 1] = quaternion0.x();
-            m_mjcModelRef->geom_quat[4 * m_mjcGeomId + 2] = quaternion0.y();
-            m_mjcModelRef->geom_quat[4 * m_mjcGeomId + 3] = quaternion0.z();
+            TVec3 position0; TVec4 quaternion0;
+            _GetStaticResetPlacement( position0, quaternion0 );
+            _SetMjcStaticPlacement( false, position0, quaternion0 );
         }
     }
 
-    void TMujocoSingleBodyAdapter::OnDetach()
+    void TMujocoSingleBodyAdapter::SetStaticResetPlacement( const TVec3& position, const TVec4& quaternion )
     {
-        TISingleBodyAdapter::OnDetach();
-
-        const TVec3 grid_rest_position = DETACHED_REST_GRID_START + 
-                                         TVec3( (s_DetachedNum % DETACHED_REST_GRID_SIZE) * DETACHED_REST_GRID_DELTA.x(),
-                                                (s_DetachedNum / DETACHED_REST_GRID_SIZE) * DETACHED_REST_GRID_DELTA.y(),
-                                                (s_DetachedNum / DETACHED_REST_GRID_SIZE_POW2) * DETACHED_REST_GRID_DELTA.z() );
-        m_DetachedRestTransform.set( grid_rest_position, 3 );
-        s_DetachedNum++;
+        if ( m_BodyRef->dyntype() != eDynamicsType::STATIC )
+        {
+            LOCO_CORE_WARN( "TMujocoSingleBodyAdapter::SetStaticResetPlacement >>> body {0} isn't static, so it's placed \
+                             on resets from its initial conditions", m_BodyRef->name() );
+            return;
+        }
+        m_mjcHasStaticResetPlacement = true;
+        m_mjcStaticResetPosition = position;
+        m_mjcStaticResetQuaternion = quaternion;
+    }
+
+    void TMujocoSingleBodyAdapter::_GetStaticResetPlacement( TVec3& dst_position, TVec4& dst_quaternion ) const
+    {
+        dst_position = ( m_mjcHasStaticResetPlacement ) ? m_mjcStaticResetPosition : m_BodyRef->pos0();
+        dst_quaternion = ( m_mjcHasStaticResetPlacement ) ? m_mjcStaticResetQuaternion : m_BodyRef->quat0();
+    }
+
+    void TMujocoSingleBodyAdapter::_SetMjcStaticPlacement( bool through_body, const TVec3& position, const TVec4& quaternion )
+    {
+        const ssize_t id = ( through_body ) ? m_mjcBodyId : m_mjcGeomId;
+        const mjtNum placement[7] = { position.x(), position.y(), position.z(),
+                                      quaternion.w(), quaternion.x(), quaternion.y(), quaternion.z() };
+        // Resets mostly place static bodies where they already are, which shouldn't copy a model shared with clones
+        const mjtNum* mjc_pos = ( ( through_body ) ? m_mjcModelRef->body_pos : m_mjcModelRef->geom_pos ) + 3 * id;
+        const mjtNum* mjc_quat = ( ( through_body ) ? m_mjcModelRef->body_quat : m_mjcModelRef->geom_quat ) + 4 * id;
+        if ( std::equal( placement, placement + 3, mjc_pos ) && std::equal( placement + 3, placement + 7, mjc_quat ) )
+            return;
+
+        mjModel* mjc_model = _MjcModelUnique();
+        mju_copy( ( ( through_body ) ? mjc_model->body_pos : mjc_model->geom_pos ) + 3 * id, placement, 3 );
+        mju_copy( ( ( through_body ) ? mjc_model->body_quat : mjc_model->geom_quat ) + 4 * id, placement + 3, 4 );
+    }
+
+    mjModel* TMujocoSingleBodyAdapter::_MjcModelUnique()
+    {
+        // The simulation rebinds all adapters when it copies the model, so m_mjcModelRef also points to the copy afterwards
+        if ( m_mjcModelUniqueFn )
+            return m_mjcModelUniqueFn();
+        return m_mjcModelRef;
     }
 
     void TMujocoSingleBodyAdapter::SetTransform( const TMat4& transform )
@@ -382,26 +406,14 @@ namespace primitives {
             }
             else
             {
-                m_mjcModelRef->body_pos[3 * m_mjcBodyId + 0] = position.x();
-                m_mjcModelRef->body_pos[3 * m_mjcBodyId + 1] = position.y();
-                m_mjcModelRef->body_pos[3 * m_mjcBodyId + 2] = position.z();
-                m_mjcModelRef->body_quat[4 * m_mjcBodyId + 0] = quaternion.w();
-                m_mjcModelRef->body_quat[4 * m_mjcBodyId + 1] = quaternion.x();
-                m_mjcModelRef->body_quat[4 * m_mjcBodyId + 2] = quaternion.y();
-                m_mjcModelRef->body_quat[4 * m_mjcBodyId + 3] = quaternion.z();
+                _SetMjcStaticPlacement( true, position, quaternion );
             }
         }
         else
         {
             LOCO_CORE_ASSERT( m_mjcGeomId >= 0, "TMujocoSingleBodyAdapter::SetTransform >>> {0} must be \
                               linked to a mjc-geom", m_BodyRef->name() );
-            m_mjcModelRef->geom_pos[3 * m_mjcGeomId + 0] = position.x();
-            m_mjcModelRef->geom_pos[3 * m_mjcGeomId + 1] = position.y();
-            m_mjcModelRef->geom_pos[3 * m_mjcGeomId + 2] = position.z();
-            m_mjcModelRef->geom_quat[4 * m_mjcGeomId + 0] = quaternion.w();
-            m_mjcModelRef->geom_quat[4 * m_mjcGeomId + 1] = quaternion.x();
-            m_mjcModelRef->geom_quat[4 * m_mjcGeomId + 2] = quaternion.y();
-            m_mjcModelRef->geom_quat[4 * m_mjcGeomId + 3] = quaternion.z();
+            _SetMjcStaticPlacement( false, position, quaternion );
         }
     }
 
@@ -550,6 +562,16 @@ namespace primitives {
             mjc_constraint_adapter->SetMjcModel( m_mjcModelRef );
     }
 
+    void TMujocoSingleBodyAdapter::SetMjcModelUniqueFn( const mujoco::FnMjcModelUnique& mjc_model_unique_fn )
+    {
+        m_mjcModelUniqueFn = mjc_model_unique_fn;
+        if ( auto mjc_collider_adapter = dynamic_cast<TMujocoSingleBodyColliderAdapter*>( m_ColliderAdapter.get() ) )
+            mjc_collider_adapter->SetMjcModelUniqueFn( m_mjcModelUniqueFn );
+
+        if ( auto mjc_constraint_adapter = dynamic_cast<TIMujocoSingleBodyConstraintAdapter*>( m_ConstraintAdapter.get() ) )
+            mjc_constraint_adapter->SetMjcModelUniqueFn( m_mjcModelUniqueFn );
+    }
+
     void TMujocoSingleBodyAdapter::SetMjcData( mjData* mjDataRef )
     {
         m_mjcDataRef = mjDataRef;
@@ -560,44 +582,155 @@ namespace primitives {
             mjc_constraint_adapter->SetMjcData( m_mjcDataRef );
     }
 
-    void TMujocoSingleBodyAdapter::HideMjcObject()
+    void TMujocoSingleBodyAdapter::SetMjcNameIndex( const mujoco::TMujocoNameIndex* mjcNameIndexRef )
     {
-        const auto position = TVec3( m_DetachedRestTransform.col( 3 ) );
-        const auto quaternion = tinymath::quaternion( m_DetachedRestTransform );
-
-        LOCO_CORE_ASSERT( m_mjcModelRef, "TMujocoSingleBodyAdapter::HideMjcObject >>> recycled adapter must have \
-                          a valid mjModel reference" );
-        LOCO_CORE_ASSERT( m_mjcDataRef, "TMujocoSingleBodyAdapter::HideMjcObject >>> recycled adapter must have \
-                          a valid mjData reference" );
-        if ( m_mjcJointId != -1 ) // Is a dynamic body
-        {
-            m_mjcDataRef->qpos[m_mjcJointQposAdr + 0] = position.x();
-            m_mjcDataRef->qpos[m_mjcJointQposAdr + 1] = position.y();
-            m_mjcDataRef->qpos[m_mjcJointQposAdr + 2] = position.z();
-            m_mjcDataRef->qpos[m_mjcJointQposAdr + 3] = quaternion.w();
-            m_mjcDataRef->qpos[m_mjcJointQposAdr + 4] = quaternion.x();
-            m_mjcDataRef->qpos[m_mjcJointQposAdr + 5] = quaternion.y();
-            m_mjcDataRef->qpos[m_mjcJointQposAdr + 6] = quaternion.z();
-        }
-        else if ( m_mjcBodyId != -1 )
+        m_mjcNameIndexRef = mjcNameIndexRef;
+        if ( auto mjc_collider_adapter = dynamic_cast<TMujocoSingleBodyColliderAdapter*>( m_ColliderAdapter.get() ) )
+            mjc_collider_adapter->SetMjcNameIndex( m_mjcNameIndexRef );
+
+        if ( auto mjc_constraint_adapter = dynamic_cast<TIMujocoSingleBodyConstraintAdapter*>( m_ConstraintAdapter.get() ) )
+            mjc_constraint_adapter->SetMjcNameIndex( m_mjcNameIndexRef );
+    }
+
+    void TMujocoSingleBodyAdapter::UpdateContacts( const mujoco::TMujocoContactBuffer& contactBuffer )
+    {
+        if ( auto mjc_collider_adapter = dynamic_cast<TMujocoSingleBodyColliderAdapter*>( m_ColliderAdapter.get() ) )
+            mjc_collider_adapter->UpdateContacts( contactBuffer );
+    }
+
+    const mujoco::TMjcVfsFile* TMujocoSingleBodyAdapter::vfs_mesh_resource() const
+    {
+        if ( auto mjc_collider_adapter = dynamic_cast<const TMujocoSingleBodyColliderAdapter*>( m_ColliderAdapter.get() ) )
+            return mjc_collider_adapter->vfs_mesh_resource();
+        return nullptr;
+    }
+
+    void TMujocoSingleBodyAdapter::InitializeFromMjcIds( ssize_t mjc_body_id, ssize_t mjc_geom_id )
+    {
+        LOCO_CORE_ASSERT( m_mjcModelRef, "TMujocoSingleBodyAdapter::InitializeFromMjcIds >>> body {0} must have \
+                          a valid mjModel reference", m_BodyRef->name() );
+        LOCO_CORE_ASSERT( m_mjcDataRef, "TMujocoSingleBodyAdapter::InitializeFromMjcIds >>> body {0} must have \
+                          a valid mjData reference", m_BodyRef->name() );
+        LOCO_CORE_ASSERT( m_ColliderAdapter, "TMujocoSingleBodyAdapter::InitializeFromMjcIds >>> body {0} must have \
+                          a related mjc-collider-adapter for its collider. Perhaps forgot to call ->Build()?", m_BodyRef->name() );
+        LOCO_CORE_ASSERT( m_BodyRef->dyntype() == eDynamicsType::DYNAMIC && !m_BodyRef->constraint(), "TMujocoSingleBodyAdapter:: \
+                          InitializeFromMjcIds >>> only free single-bodies can be linked to existing mjc-bodies, got {0}", m_BodyRef->name() );
+
+        auto mjc_collider_adapter = static_cast<TMujocoSingleBodyColliderAdapter*>( m_ColliderAdapter.get() );
+        mjc_collider_adapter->InitializeFromMjcGeom( mjc_geom_id );
+
+        m_mjcBodyId = mjc_body_id;
+        m_mjcJointId = m_mjcModelRef->body_jntadr[m_mjcBodyId];
+        if ( m_mjcJointId < 0 || m_mjcModelRef->jnt_type[m_mjcJointId] != mjJNT_FREE )
         {
-            m_mjcModelRef->body_pos[3 * m_mjcBodyId + 0] = position.x();
-            m_mjcModelRef->body_pos[3 * m_mjcBodyId + 1] = position.y();
-            m_mjcModelRef->body_pos[3 * m_mjcBodyId + 2] = position.z();
-            m_mjcModelRef->body_quat[4 * m_mjcBodyId + 0] = quaternion.w();
-            m_mjcModelRef->body_quat[4 * m_mjcBodyId + 1] = quaternion.x();
-            m_mjcModelRef->body_quat[4 * m_mjcBodyId + 2] = quaternion.y();
-            m_mjcModelRef->body_quat[4 * m_mjcBodyId + 3] = quaternion.z();
+            LOCO_CORE_ERROR( "TMujocoSingleBodyAdapter::InitializeFromMjcIds >>> mjc-body {0} given to single-body {1} \
+                              doesn't have a free-joint", mjc_body_id, m_BodyRef->name() );
+            m_mjcJointId = -1;
+            return;
         }
-        else if ( m_mjcGeomId != -1 ) // If not, then it's a static body
+
+        _SetMjcMassProperties();
+        _InitializeFreeJoint();
+        // The body was compiled somewhere else, so place it at its initial configuration right away
+        mju_copy( m_mjcDataRef->qpos + m_mjcJointQposAdr, m_mjcModelRef->qpos0 + m_mjcJointQposAdr, m_mjcJointQposNum );
+    }
+
+    void TMujocoSingleBodyAdapter::InitializeFromAdapter( const TMujocoSingleBodyAdapter& other )
+    {
+        LOCO_CORE_ASSERT( m_mjcModelRef, "TMujocoSingleBodyAdapter::InitializeFromAdapter >>> body {0} must have \
+                          a valid mjModel reference", m_BodyRef->name() );
+        LOCO_CORE_ASSERT( m_mjcDataRef, "TMujocoSingleBodyAdapter::InitializeFromAdapter >>> body {0} must have \
+                          a valid mjData reference", m_BodyRef->name() );
+        LOCO_CORE_ASSERT( m_ColliderAdapter, "TMujocoSingleBodyAdapter::InitializeFromAdapter >>> body {0} must have \
+                          a related mjc-collider-adapter for its collider. Perhaps forgot to call ->Build()?", m_BodyRef->name() );
+
+        auto mjc_collider_adapter = static_cast<TMujocoSingleBodyColliderAdapter*>( m_ColliderAdapter.get() );
+        if ( auto other_mjc_collider_adapter = dynamic_cast<const TMujocoSingleBodyColliderAdapter*>( other.m_ColliderAdapter.get() ) )
+            mjc_collider_adapter->InitializeFromAdapter( *other_mjc_collider_adapter );
+
+        m_mjcBodyId = other.m_mjcBodyId;
+        m_mjcJointId = other.m_mjcJointId;
+        m_mjcJointQposAdr = other.m_mjcJointQposAdr;
+        m_mjcJointQvelAdr = other.m_mjcJointQvelAdr;
+        m_mjcJointQposNum = other.m_mjcJointQposNum;
+        m_mjcJointQvelNum = other.m_mjcJointQvelNum;
+        m_mjcGeomId = other.m_mjcGeomId;
+        m_mjcResetSignature = other.m_mjcResetSignature;
+        // Constraints resolve their ids through the name-index (these only read from the model)
+        if ( m_BodyRef->constraint() && m_mjcBodyId >= 0 )
+            m_ConstraintAdapter->Initialize();
+    }
+
+    ssize_t TMujocoSingleBodyAdapter::mjc_geom_id() const
+    {
+        if ( m_mjcGeomId >= 0 )
+            return m_mjcGeomId;
+        if ( auto mjc_collider_adapter = dynamic_cast<const TMujocoSingleBodyColliderAdapter*>( m_ColliderAdapter.get() ) )
+            return mjc_collider_adapter->mjc_geom_id();
+        return -1;
+    }
+
+    void TMujocoSingleBodyAdapter::_InitializeFreeJoint()
+    {
+        m_mjcJointQposAdr = m_mjcModelRef->jnt_qposadr[m_mjcJointId];
+        m_mjcJointQvelAdr = m_mjcModelRef->jnt_dofadr[m_mjcJointId];
+        m_mjcJointQposNum = 7;
+        m_mjcJointQvelNum = 6;
+
+        // @todo: is this required? (qpos0 should be computed from pos|quat in xml, which is our desired qpos0)
+        // Set the body's initial configuration
+        mjModel* mjc_model = _MjcModelUnique();
+        const TVec3 position0 = m_BodyRef->pos0();
+        mjc_model->qpos0[m_mjcJointQposAdr + 0] = position0.x();
+        mjc_model->qpos0[m_mjcJointQposAdr + 1] = position0.y();
+        mjc_model->qpos0[m_mjcJointQposAdr + 2] = position0.z();
+        const TVec4 quaternion0 = m_BodyRef->quat0();
+        mjc_model->qpos0[m_mjcJointQposAdr + 3] = quaternion0.w();
+        mjc_model->qpos0[m_mjcJointQposAdr + 4] = quaternion0.x();
+        mjc_model->qpos0[m_mjcJointQposAdr + 5] = quaternion0.y();
+        mjc_model->qpos0[m_mjcJointQposAdr + 6] = quaternion0.z();
+        SetLinearVelocity( m_BodyRef->linear_vel0() );
+        SetAngularVelocity( m_BodyRef->angular_vel0() );
+    }
+
+    void TMujocoSingleBodyAdapter::_SetMjcMassProperties()
+    {
+        // Single-primitive bodies are compiled with the com at the origin and principal axes along the geom's axes
+        const auto shape = m_BodyRef->collider()->shape();
+        const auto size = m_BodyRef->collider()->size();
+        const auto& inertia = m_BodyRef->data().inertia;
+        const double mass = ( inertia.mass > loco::EPS ) ? inertia.mass :
+                                mujoco::LOCO_MUJOCO_DEFAULT_DENSITY * mujoco::compute_primitive_volume( shape, size );
+        const TVec3 principal_inertia = ( inertia.ixx > loco::EPS && inertia.iyy > loco::EPS && inertia.izz > loco::EPS ) ?
+                                            TVec3( inertia.ixx, inertia.iyy, inertia.izz ) :
+                                            mujoco::compute_primitive_inertia( shape, size, mass );
+
+        mjModel* mjc_model = _MjcModelUnique();
+        const mjtNum mass_delta = mass - mjc_model->body_mass[m_mjcBodyId];
+        mjc_model->body_mass[m_mjcBodyId] = mass;
+        mjc_model->body_inertia[3 * m_mjcBodyId + 0] = principal_inertia.x();
+        mjc_model->body_inertia[3 * m_mjcBodyId + 1] = principal_inertia.y();
+        mjc_model->body_inertia[3 * m_mjcBodyId + 2] = principal_inertia.z();
+        mju_zero3( mjc_model->body_ipos + 3 * m_mjcBodyId );
+        mju_unit4( mjc_model->body_iquat + 4 * m_mjcBodyId );
+        // Subtree masses are used to compute the subtrees' com (on every step), so update the whole chain up to the world
+        for ( ssize_t id = m_mjcBodyId; id > 0; id = mjc_model->body_parentid[id] )
+            mjc_model->body_subtreemass[id] += mass_delta;
+        mjc_model->body_subtreemass[0] += mass_delta;
+
+        // The constraint solver scales impedances by the inverse weights computed at compile time (mj_setConst), which
+        // still correspond to the body previously linked. For a free-body with its com at the origin, the mass-matrix
+        // is diag(m, m, m, ixx, iyy, izz), so these are the averages of the inverse translational|rotational terms
+        const mjtNum translational_invweight = 1.0 / mass;
+        const mjtNum rotational_invweight = ( 1.0 / principal_inertia.x() + 1.0 / principal_inertia.y() +
+                                              1.0 / principal_inertia.z() ) / 3.0;
+        mjc_model->body_invweight0[2 * m_mjcBodyId + 0] = translational_invweight;
+        mjc_model->body_invweight0[2 * m_mjcBodyId + 1] = rotational_invweight;
+        const ssize_t dof_adr = mjc_model->body_dofadr[m_mjcBodyId];
+        for ( ssize_t i = 0; i < 3 && mjc_model->body_dofnum[m_mjcBodyId] == 6; i++ )
         {
-            m_mjcModelRef->geom_pos[3 * m_mjcGeomId + 0] = position.x();
-            m_mjcModelRef->geom_pos[3 * m_mjcGeomId + 1] = position.y();
-            m_mjcModelRef->geom_pos[3 * m_mjcGeomId + 2] = position.z();
-            m_mjcModelRef->geom_quat[4 * m_mjcGeomId + 0] = quaternion.w();
-            m_mjcModelRef->geom_quat[4 * m_mjcGeomId + 1] = quaternion.x();
-            m_mjcModelRef->geom_quat[4 * m_mjcGeomId + 2] = quaternion.y();
-            m_mjcModelRef->geom_quat[4 * m_mjcGeomId + 3] = quaternion.z();
+            mjc_model->dof_invweight0[dof_adr + i] = translational_invweight;
+            mjc_model->dof_invweight0[dof_adr + 3 + i] = rotational_invweight;
         }
     }
 }}
\ No newline at end of file
@@ -1,5 +1,9 @@
 
 #include <primitives/loco_single_body_collider_adapter_mujoco.h>
+#include <loco_model_cache_mujoco.h>
+#include <limits>
+#include <numeric>
+#include <cstring>
 
 namespace loco {
 namespace primitives {
@@ -9,14 +13,20 @@ namespace primitives {
     {
         m_mjcModelRef = nullptr;
         m_mjcDataRef = nullptr;
+        m_mjcNameIndexRef = nullptr;
 
         m_mjcGeomId = -1;
         m_mjcGeomMeshId = -1;
+        m_mjcGeomMeshVertCapacity = 0;
+        m_mjcGeomMeshFaceCapacity = 0;
         m_mjcGeomHFieldId = -1;
         m_mjcGeomHFieldStartAddr = -1;
         m_mjcGeomHFieldNRows = -1;
         m_mjcGeomHFieldNCols = -1;
         m_mjcGeomRbound = 0.0;
+        m_mjcHFieldNormHeight = 1.0f;
+        m_mjcHFieldNBlockRows = 0;
+        m_mjcHFieldNBlockCols = 0;
 
         m_size = m_ColliderRef->size();
         m_size0 = m_ColliderRef->size();
@@ -34,6 +44,7 @@ namespace primitives {
     {
         m_mjcModelRef = nullptr;
         m_mjcDataRef = nullptr;
+        m_mjcNameIndexRef = nullptr;
 
         m_mjcGeomId = -1;
         m_mjcGeomMeshId = -1;
@@ -45,6 +56,7 @@ namespace primitives {
 
         m_mjcfElementsResources.clear();
         m_mjcfElementAssetResources = nullptr;
+        m_mjcVfsMeshResource = nullptr;
 
     #if defined( LOCO_CORE_USE_TRACK_ALLOCS )
         const std::string name = ( m_ColliderRef ) ? m_ColliderRef->name() : "undefined";
@@ -118,9 +130,12 @@ namespace primitives {
                     const std::string mesh_id = tinyutils::GetFilenameNoExtension( mesh_file );
                     const auto mesh_scale = m_ColliderRef->size();
 
+                    // Hand mujoco the cached hull of the mesh-file if available (stored on Initialize otherwise)
+                    m_mjcVfsMeshResource = mujoco::TMujocoMeshCache::CreateMeshVfsFileFromFile( mesh_file, mesh_scale, m_mjcMeshCachePendingKey );
+
                     m_mjcfElementAssetResources = std::make_unique<parsing::TElement>( mujoco::LOCO_MJCF_MESH_TAG, parsing::eSchemaType::MJCF );
                     m_mjcfElementAssetResources->SetString( "name", mesh_id );
-                    m_mjcfElementAssetResources->SetString( "file", mesh_file );
+                    m_mjcfElementAssetResources->SetString( "file", m_mjcVfsMeshResource ? m_mjcVfsMeshResource->filename : mesh_file );
                     m_mjcfElementAssetResources->SetVec3( "scale", mesh_scale );
                     mjcf_element_resource->SetString( "mesh", mesh_id );
                 }
@@ -131,7 +146,8 @@ namespace primitives {
                     const auto mesh_scale = m_ColliderRef->size();
                     const auto& mesh_vertices = mesh_data.vertices;
                     const auto& mesh_faces = mesh_data.faces;
-                    mujoco::SaveMeshToBinary( mesh_file, mesh_vertices, mesh_faces );
+                    m_mjcVfsMeshResource = mujoco::TMujocoMeshCache::CreateMeshVfsFile( mesh_file, mesh_vertices, mesh_faces,
+                                                                                       mesh_scale, m_mjcMeshCachePendingKey );
 
                     m_mjcfElementAssetResources = std::make_unique<parsing::TElement>( mujoco::LOCO_MJCF_MESH_TAG, parsing::eSchemaType::MJCF );
                     m_mjcfElementAssetResources->SetString( "name", mesh_id );
@@ -158,7 +174,7 @@ namespace primitives {
                                         0, 3, 2 };
                     const auto& mesh_vertices = mesh_data.vertices;
                     const auto& mesh_faces = mesh_data.faces;
-                    mujoco::SaveMeshToBinary( mesh_file, mesh_vertices, mesh_faces );
+                    m_mjcVfsMeshResource = mujoco::CreateMeshVfsFile( mesh_file, mesh_vertices, mesh_faces );
 
                     m_mjcfElementAssetResources = std::make_unique<parsing::TElement>( mujoco::LOCO_MJCF_MESH_TAG, parsing::eSchemaType::MJCF );
                     m_mjcfElementAssetResources->SetString( "name", mesh_id );
@@ -222,7 +238,7 @@ namespace primitives {
         if ( m_ColliderRef->shape() == eShapeType::COMPOUND )
             return;
 
-        m_mjcGeomId = mj_name2id( m_mjcModelRef, mjOBJ_GEOM, m_ColliderRef->name().c_str() );
+        m_mjcGeomId = mujoco::mjc_name2id( m_mjcModelRef, m_mjcNameIndexRef, mjOBJ_GEOM, m_ColliderRef->name() );
         if ( m_mjcGeomId < 0 )
         {
             LOCO_CORE_ERROR( "TMujocoSingleBodyColliderAdapter::Initialize >>> couldn't find associated \
@@ -241,10 +257,22 @@ namespace primitives {
                 return;
             }
 
+            if ( !m_mjcMeshCachePendingKey.empty() )
+            {
+                const auto& mesh_data = m_ColliderRef->data().mesh_data;
+                if ( mesh_data.filename != "" )
+                    mujoco::TMujocoMeshCache::StoreFromFile( m_mjcMeshCachePendingKey, mesh_data.filename, m_mjcModelRef, m_mjcGeomMeshId );
+                else
+                    mujoco::TMujocoMeshCache::Store( m_mjcMeshCachePendingKey, mesh_data.vertices, mesh_data.faces, m_mjcModelRef, m_mjcGeomMeshId );
+                m_mjcMeshCachePendingKey = "";
+            }
+
             m_mjcGeomMeshVertNum = m_mjcModelRef->mesh_vertnum[m_mjcGeomMeshId];
             m_mjcGeomMeshFaceNum = m_mjcModelRef->mesh_facenum[m_mjcGeomMeshId];
             m_mjcGeomMeshVertStartAddr = m_mjcModelRef->mesh_vertadr[m_mjcGeomMeshId];
             m_mjcGeomMeshFaceStartAddr = m_mjcModelRef->mesh_faceadr[m_mjcGeomMeshId];
+            m_mjcGeomMeshVertCapacity = m_mjcGeomMeshVertNum;
+            m_mjcGeomMeshFaceCapacity = m_mjcGeomMeshFaceNum;
         }
         else if ( m_ColliderRef->data().type == eShapeType::HEIGHTFIELD )
         {
@@ -299,6 +327,77 @@ namespace primitives {
 #endif
     }
 
+    void TMujocoSingleBodyColliderAdapter::UpdateContacts( const mujoco::TMujocoContactBuffer& contactBuffer )
+    {
+        m_mjcContacts = contactBuffer.contacts( m_mjcGeomId );
+
+        // Update the collider's contacts in place (reuses the vector's and strings' storage)
+        auto& contacts = m_ColliderRef->contacts();
+        contacts.resize( m_mjcContacts.size );
+        for ( ssize_t i = 0; i < m_mjcContacts.size; i++ )
+        {
+            const auto& mjc_contact = m_mjcContacts[i];
+            contacts[i].position = mjc_contact.position;
+            contacts[i].normal = mjc_contact.normal;
+            contacts[i].name = contactBuffer.geom_name( mjc_contact.other_geom_id );
+        }
+    }
+
+    void TMujocoSingleBodyColliderAdapter::InitializeFromMjcGeom( ssize_t mjc_geom_id )
+    {
+        LOCO_CORE_ASSERT( m_mjcModelRef, "TMujocoSingleBodyColliderAdapter::InitializeFromMjcGeom >>> must have a valid mjModel reference" );
+        LOCO_CORE_ASSERT( m_mjcDataRef, "TMujocoSingleBodyColliderAdapter::InitializeFromMjcGeom >>> must have a valid mjData reference" );
+        LOCO_CORE_ASSERT( mjc_geom_id >= 0 && mjc_geom_id < m_mjcModelRef->ngeom, "TMujocoSingleBodyColliderAdapter::InitializeFromMjcGeom >>> \
+                          mjc-geom id {0} out of range for collider {1}", mjc_geom_id, m_ColliderRef->name() );
+
+        const eShapeType shape = m_ColliderRef->shape();
+        if ( shape == eShapeType::CONVEX_MESH || shape == eShapeType::HEIGHTFIELD || shape == eShapeType::COMPOUND )
+        {
+            LOCO_CORE_ERROR( "TMujocoSingleBodyColliderAdapter::InitializeFromMjcGeom >>> only primitive colliders can be \
+                              linked to existing mjc-geoms, got shape {0} for collider {1}", ToString( shape ), m_ColliderRef->name() );
+            return;
+        }
+
+        m_mjcGeomId = mjc_geom_id;
+        mjModel* mjc_model = _mjc_model_unique();
+        _resize_primitive( m_ColliderRef->size() );
+        m_mjcGeomRbound = mjc_model->geom_rbound[m_mjcGeomId];
+        mjc_model->geom_contype[m_mjcGeomId] = m_ColliderRef->collisionGroup();
+        mjc_model->geom_conaffinity[m_mjcGeomId] = m_ColliderRef->collisionMask();
+        const auto& friction = m_ColliderRef->data().friction;
+        mjc_model->geom_friction[3 * m_mjcGeomId + 0] = friction.x();
+        mjc_model->geom_friction[3 * m_mjcGeomId + 1] = friction.y();
+        mjc_model->geom_friction[3 * m_mjcGeomId + 2] = friction.z();
+    }
+
+    void TMujocoSingleBodyColliderAdapter::InitializeFromAdapter( const TMujocoSingleBodyColliderAdapter& other )
+    {
+        LOCO_CORE_ASSERT( m_mjcModelRef, "TMujocoSingleBodyColliderAdapter::InitializeFromAdapter >>> must have a valid mjModel reference" );
+        LOCO_CORE_ASSERT( m_mjcDataRef, "TMujocoSingleBodyColliderAdapter::InitializeFromAdapter >>> must have a valid mjData reference" );
+
+        // The model already holds this collider (as compiled and modified through the other adapter), so nothing is written into it
+        m_mjcGeomId = other.m_mjcGeomId;
+        m_mjcGeomMeshId = other.m_mjcGeomMeshId;
+        m_mjcGeomMeshVertNum = other.m_mjcGeomMeshVertNum;
+        m_mjcGeomMeshFaceNum = other.m_mjcGeomMeshFaceNum;
+        m_mjcGeomMeshVertStartAddr = other.m_mjcGeomMeshVertStartAddr;
+        m_mjcGeomMeshFaceStartAddr = other.m_mjcGeomMeshFaceStartAddr;
+        m_mjcGeomMeshVertCapacity = other.m_mjcGeomMeshVertCapacity;
+        m_mjcGeomMeshFaceCapacity = other.m_mjcGeomMeshFaceCapacity;
+        m_mjcGeomHFieldId = other.m_mjcGeomHFieldId;
+        m_mjcGeomHFieldStartAddr = other.m_mjcGeomHFieldStartAddr;
+        m_mjcGeomHFieldNRows = other.m_mjcGeomHFieldNRows;
+        m_mjcGeomHFieldNCols = other.m_mjcGeomHFieldNCols;
+        m_mjcGeomRbound = other.m_mjcGeomRbound;
+        m_mjcHFieldNormHeight = other.m_mjcHFieldNormHeight;
+        m_mjcHFieldBlocksMax = other.m_mjcHFieldBlocksMax;
+        m_mjcHFieldNBlockRows = other.m_mjcHFieldNBlockRows;
+        m_mjcHFieldNBlockCols = other.m_mjcHFieldNBlockCols;
+        m_size = other.m_size;
+        m_size0 = other.m_size0;
+        m_mjcMeshCachePendingKey = "";
+    }
+
     void TMujocoSingleBodyColliderAdapter::ChangeSize( const TVec3& newSize )
     {
         m_size = newSize;
@@ -323,71 +422,117 @@ namespace primitives {
     }
 
     void TMujocoSingleBodyColliderAdapter::ChangeVertexData( const std::vector<float>& vertices, const std::vector<int>& faces )
+    {
+        ChangeVertexData( vertices.data(), vertices.size() / 3, faces.data(), faces.size() / 3 );
+    }
+
+    bool TMujocoSingleBodyColliderAdapter::ChangeVertexData( const float* vertices, ssize_t num_vertices,
+                                                             const int* faces, ssize_t num_faces )
+    {
+        if ( !_upload_vertex_data( vertices, num_vertices, faces, num_faces ) )
+            return false;
+
+        LOCO_CORE_TRACE( "TMujocoSingleBodyColliderAdapter::ChangeVertexData >>> collider {0}: {1}/{2} vertices, \
+                          {3}/{4} faces, rbound {5}", m_ColliderRef->name(), num_vertices, m_mjcGeomMeshVertCapacity,
+                         num_faces, m_mjcGeomMeshFaceCapacity, m_mjcModelRef->geom_rbound[m_mjcGeomId] );
+        return true;
+    }
+
+    bool TMujocoSingleBodyColliderAdapter::ChangeVertexDataBatch( const std::vector<TMujocoSingleBodyColliderAdapter*>& colliders_adapters,
+                                                                  const std::vector<float>& vertices,
+                                                                  const std::vector<int>& faces,
+                                                                  const std::vector<ssize_t>& num_vertices_per_mesh,
+                                                                  const std::vector<ssize_t>& num_faces_per_mesh )
+    {
+        const ssize_t num_meshes = colliders_adapters.size();
+        if ( (ssize_t)num_vertices_per_mesh.size() != num_meshes || (ssize_t)num_faces_per_mesh.size() != num_meshes )
+        {
+            LOCO_CORE_ERROR( "TMujocoSingleBodyColliderAdapter::ChangeVertexDataBatch >>> expected vertex|face counts \
+                              for {0} meshes, but got {1}|{2}", num_meshes, num_vertices_per_mesh.size(), num_faces_per_mesh.size() );
+            return false;
+        }
+        const ssize_t total_vertices = std::accumulate( num_vertices_per_mesh.begin(), num_vertices_per_mesh.end(), ssize_t( 0 ) );
+        const ssize_t total_faces = std::accumulate( num_faces_per_mesh.begin(), num_faces_per_mesh.end(), ssize_t( 0 ) );
+        if ( 3 * total_vertices != (ssize_t)vertices.size() || 3 * total_faces != (ssize_t)faces.size() )
+        {
+            LOCO_CORE_ERROR( "TMujocoSingleBodyColliderAdapter::ChangeVertexDataBatch >>> buffers hold {0} vertices and {1} \
+                              faces, but counts add up to {2} vertices and {3} faces", vertices.size() / 3, faces.size() / 3,
+                             total_vertices, total_faces );
+            return false;
+        }
+
+        // Each mesh is bounds-checked on its own, so a bad slice doesn't prevent the others from being uploaded
+        bool all_uploaded = true;
+        const float* vertices_slice = vertices.data();
+        const int* faces_slice = faces.data();
+        for ( ssize_t i = 0; i < num_meshes; i++ )
+        {
+            if ( !colliders_adapters[i] || !colliders_adapters[i]->_upload_vertex_data( vertices_slice, num_vertices_per_mesh[i],
+                                                                                         faces_slice, num_faces_per_mesh[i] ) )
+                all_uploaded = false;
+            vertices_slice += 3 * num_vertices_per_mesh[i];
+            faces_slice += 3 * num_faces_per_mesh[i];
+        }
+
+        LOCO_CORE_TRACE( "TMujocoSingleBodyColliderAdapter::ChangeVertexDataBatch >>> uploaded {0} meshes ({1} vertices, \
+                          {2} faces), all-succeeded={3}", num_meshes, total_vertices, total_faces, all_uploaded );
+        return all_uploaded;
+    }
+
+    bool TMujocoSingleBodyColliderAdapter::_upload_vertex_data( const float* vertices, ssize_t num_vertices,
+                                                                const int* faces, ssize_t num_faces )
     {
         if ( m_ColliderRef->shape() != eShapeType::CONVEX_MESH )
         {
             LOCO_CORE_WARN( "TMujocoSingleBodyColliderAdapter::ChangeVertexData >>> tried to set vertex-data \
                              to the non-mesh collider {0}", m_ColliderRef->name() );
-            return;
+            return false;
         }
 
         if ( m_mjcGeomId < 0 )
         {
             LOCO_CORE_ERROR( "TMujocoSingleBodyColliderAdapter::ChangeVertexData >>> collider {0} not linked \
                               to a valid mjc-geom (geom-id = -1)", m_ColliderRef->name() );
-            return;
+            return false;
         }
 
         LOCO_CORE_ASSERT( m_mjcGeomMeshId != -1, "TMujocoSingleBodyColliderAdapter::ChangeVertexData >>> something \
                           went wrong initializing the mesh-collider {0}", m_ColliderRef->name() );
 
-        const ssize_t num_vertices = vertices.size() / 3;
-        const ssize_t num_faces = faces.size() / 3;
-
-        LOCO_CORE_INFO( "Changing vertex-data for mesh-collider {0}", m_ColliderRef->name() );
-        LOCO_CORE_TRACE( "old-num-vertices  : {0}", m_mjcModelRef->mesh_vertnum[m_mjcGeomMeshId] );
-        LOCO_CORE_TRACE( "old-num-faces     : {0}", m_mjcModelRef->mesh_facenum[m_mjcGeomMeshId] );
-        LOCO_CORE_TRACE( "new-num-vertices  : {0}", num_vertices );
-        LOCO_CORE_TRACE( "new-num-faces     : {0}", num_faces );
-        TVec3 aabb_min = { 1e6f, 1e6f, 1e6f };
-        TVec3 aabb_max = { -1e6f, -1e6f, -1e6f };
-        m_mjcModelRef->mesh_vertnum[m_mjcGeomMeshId] = num_vertices;
-        for ( ssize_t i = 0; i < num_vertices; i++ )
+        // Meshes are packed one after the other in mesh_vert|mesh_face, so going beyond the compiled sizes would
+        // overwrite the next mesh
+        if ( num_vertices < 1 || num_vertices > m_mjcGeomMeshVertCapacity || num_faces < 0 || num_faces > m_mjcGeomMeshFaceCapacity )
         {
-            LOCO_CORE_TRACE( "old-vert {0} >>> {1}", 3 * i + 0, m_mjcModelRef->mesh_vert[m_mjcGeomMeshVertStartAddr + 3 * i + 0] );
-            LOCO_CORE_TRACE( "old-vert {0} >>> {1}", 3 * i + 1, m_mjcModelRef->mesh_vert[m_mjcGeomMeshVertStartAddr + 3 * i + 1] );
-            LOCO_CORE_TRACE( "old-vert {0} >>> {1}", 3 * i + 2, m_mjcModelRef->mesh_vert[m_mjcGeomMeshVertStartAddr + 3 * i + 2] );
-            LOCO_CORE_TRACE( "new-vert {0} >>> {1}", 3 * i + 0, vertices[3 * i + 0] );
-            LOCO_CORE_TRACE( "new-vert {0} >>> {1}", 3 * i + 1, vertices[3 * i + 1] );
-            LOCO_CORE_TRACE( "new-vert {0} >>> {1}", 3 * i + 2, vertices[3 * i + 2] );
-            m_mjcModelRef->mesh_vert[m_mjcGeomMeshVertStartAddr + 3 * i + 0] = vertices[3 * i + 0];
-            m_mjcModelRef->mesh_vert[m_mjcGeomMeshVertStartAddr + 3 * i + 1] = vertices[3 * i + 1];
-            m_mjcModelRef->mesh_vert[m_mjcGeomMeshVertStartAddr + 3 * i + 2] = vertices[3 * i + 2];
-
-            aabb_min.x() = std::min( aabb_min.x(), m_mjcModelRef->mesh_vert[m_mjcGeomMeshVertStartAddr + 3 * i + 0] );
-            aabb_min.y() = std::min( aabb_min.y(), m_mjcModelRef->mesh_vert[m_mjcGeomMeshVertStartAddr + 3 * i + 1] );
-            aabb_min.z() = std::min( aabb_min.z(), m_mjcModelRef->mesh_vert[m_mjcGeomMeshVertStartAddr + 3 * i + 2] );
-
-            aabb_max.x() = std::max( aabb_max.x(), m_mjcModelRef->mesh_vert[m_mjcGeomMeshVertStartAddr + 3 * i + 0] );
-            aabb_max.y() = std::max( aabb_max.y(), m_mjcModelRef->mesh_vert[m_mjcGeomMeshVertStartAddr + 3 * i + 1] );
-            aabb_max.z() = std::max( aabb_max.z(), m_mjcModelRef->mesh_vert[m_mjcGeomMeshVertStartAddr + 3 * i + 2] );
+            LOCO_CORE_ERROR( "TMujocoSingleBodyColliderAdapter::ChangeVertexData >>> collider {0} was compiled for up to {1} \
+                              vertices and {2} faces, but got {3} vertices and {4} faces", m_ColliderRef->name(),
+                             m_mjcGeomMeshVertCapacity, m_mjcGeomMeshFaceCapacity, num_vertices, num_faces );
+            return false;
         }
-        m_mjcModelRef->geom_rbound[m_mjcGeomId] = 0.5f * ( aabb_max - aabb_min ).length();
-
-        m_mjcModelRef->mesh_facenum[m_mjcGeomMeshId] = num_faces;
-        for ( ssize_t i = 0; i < num_faces; i++ )
+        for ( ssize_t i = 0; i < 3 * num_faces; i++ )
         {
-            LOCO_CORE_TRACE( "old-face {0} >>> {1}", 3 * i + 0, m_mjcModelRef->mesh_face[m_mjcGeomMeshVertStartAddr + 3 * i + 0] );
-            LOCO_CORE_TRACE( "old-face {0} >>> {1}", 3 * i + 1, m_mjcModelRef->mesh_face[m_mjcGeomMeshVertStartAddr + 3 * i + 1] );
-            LOCO_CORE_TRACE( "old-face {0} >>> {1}", 3 * i + 2, m_mjcModelRef->mesh_face[m_mjcGeomMeshVertStartAddr + 3 * i + 2] );
-            LOCO_CORE_TRACE( "new-face {0} >>> {1}", 3 * i + 0, faces[3 * i + 0] );
-            LOCO_CORE_TRACE( "new-face {0} >>> {1}", 3 * i + 1, faces[3 * i + 1] );
-            LOCO_CORE_TRACE( "new-face {0} >>> {1}", 3 * i + 2, faces[3 * i + 2] );
-            m_mjcModelRef->mesh_face[m_mjcGeomMeshVertStartAddr + 3 * i + 0] = faces[3 * i + 0];
-            m_mjcModelRef->mesh_face[m_mjcGeomMeshVertStartAddr + 3 * i + 1] = faces[3 * i + 1];
-            m_mjcModelRef->mesh_face[m_mjcGeomMeshVertStartAddr + 3 * i + 2] = faces[3 * i + 2];
+            if ( faces[i] < 0 || faces[i] >= num_vertices )
+            {
+                LOCO_CORE_ERROR( "TMujocoSingleBodyColliderAdapter::ChangeVertexData >>> face {0} of collider {1} references \
+                                  vertex {2}, but only {3} vertices were given", i / 3, m_ColliderRef->name(), faces[i], num_vertices );
+                return false;
+            }
         }
 
+        mjModel* mjc_model = _mjc_model_unique();
+        std::memcpy( mjc_model->mesh_vert + 3 * m_mjcGeomMeshVertStartAddr, vertices, sizeof( float ) * 3 * num_vertices );
+        std::memcpy( mjc_model->mesh_face + 3 * m_mjcGeomMeshFaceStartAddr, faces, sizeof( int ) * 3 * num_faces );
+        mjc_model->mesh_vertnum[m_mjcGeomMeshId] = num_vertices;
+        mjc_model->mesh_facenum[m_mjcGeomMeshId] = num_faces;
+        m_mjcGeomMeshVertNum = num_vertices;
+        m_mjcGeomMeshFaceNum = num_faces;
+        // The compiled hull-graph (used to speed up convex collisions) still describes the old vertices, and can't be
+        // rebuilt in place (its size depends on the hull), so drop it and let collisions go through every vertex instead
+        mjc_model->mesh_graphadr[m_mjcGeomMeshId] = -1;
+
+        TVec3 aabb_min, aabb_max;
+        mujoco::compute_vertices_aabb( mjc_model->mesh_vert + 3 * m_mjcGeomMeshVertStartAddr, num_vertices, aabb_min, aabb_max );
+        mjc_model->geom_rbound[m_mjcGeomId] = mujoco::compute_aabb_rbound( aabb_min, aabb_max );
+        return true;
     }
 
     void TMujocoSingleBodyColliderAdapter::ChangeElevationData( const std::vector<float>& heights )
@@ -417,33 +562,133 @@ namespace primitives {
             return;
         }
 
-        const float max_height = *std::max_element( heights.cbegin(), heights.cend() );
-        const size_t nx_samples = m_mjcGeomHFieldNCols;
-        const size_t ny_samples = m_mjcGeomHFieldNRows;
-        for ( size_t i = 0; i < ny_samples; i++ )
+        // Keep the collider's samples in sync, as region updates read back from them to recompute blocks max-heights
+        auto& collider_heights = m_ColliderRef->data().hfield_data.heights;
+        if ( &collider_heights != &heights )
+            collider_heights = heights;
+
+        m_mjcHFieldNBlockRows = ( m_mjcGeomHFieldNRows + LOCO_MUJOCO_HFIELD_BLOCK_SIZE - 1 ) / LOCO_MUJOCO_HFIELD_BLOCK_SIZE;
+        m_mjcHFieldNBlockCols = ( m_mjcGeomHFieldNCols + LOCO_MUJOCO_HFIELD_BLOCK_SIZE - 1 ) / LOCO_MUJOCO_HFIELD_BLOCK_SIZE;
+        m_mjcHFieldBlocksMax.resize( m_mjcHFieldNBlockRows * m_mjcHFieldNBlockCols );
+        _update_hfield_blocks_max( 0, 0, m_mjcGeomHFieldNRows, m_mjcGeomHFieldNCols );
+
+        const float max_height = *std::max_element( m_mjcHFieldBlocksMax.cbegin(), m_mjcHFieldBlocksMax.cend() );
+        m_mjcHFieldNormHeight = std::max( max_height, std::numeric_limits<float>::epsilon() );
+        mjModel* mjc_model = _mjc_model_unique();
+        mujoco::hfield_normalize( mjc_model->hfield_data + m_mjcGeomHFieldStartAddr, heights.data(),
+                                  heights.size(), 1.0f / m_mjcHFieldNormHeight );
+        mjc_model->hfield_size[4 * m_mjcGeomHFieldId + 2] = m_mjcHFieldNormHeight * m_size.z();
+        _update_hfield_rbound();
+    }
+
+    void TMujocoSingleBodyColliderAdapter::ChangeElevationDataRegion( ssize_t row_start, ssize_t col_start,
+                                                                      ssize_t region_nrows, ssize_t region_ncols,
+                                                                      const std::vector<float>& heights )
+    {
+        if ( m_ColliderRef->shape() != eShapeType::HEIGHTFIELD )
+        {
+            LOCO_CORE_WARN( "TMujocoSingleBodyColliderAdapter::ChangeElevationDataRegion >>> tried to set heightfield \
+                             data to the non-heightfield collider {0}", m_ColliderRef->name() );
+            return;
+        }
+
+        if ( m_mjcGeomId < 0 || m_mjcHFieldBlocksMax.empty() )
+        {
+            LOCO_CORE_ERROR( "TMujocoSingleBodyColliderAdapter::ChangeElevationDataRegion >>> collider {0} not linked \
+                              to a valid mjc-geom (geom-id = -1)", m_ColliderRef->name() );
+            return;
+        }
+
+        if ( row_start < 0 || col_start < 0 || region_nrows < 1 || region_ncols < 1 ||
+             row_start + region_nrows > m_mjcGeomHFieldNRows || col_start + region_ncols > m_mjcGeomHFieldNCols ||
+             region_nrows * region_ncols != (ssize_t)heights.size() )
+        {
+            LOCO_CORE_WARN( "TMujocoSingleBodyColliderAdapter::ChangeElevationDataRegion >>> invalid region for \
+                             collider {0}", m_ColliderRef->name() );
+            LOCO_CORE_WARN( "\tregion-start         : ({0}, {1})", row_start, col_start );
+            LOCO_CORE_WARN( "\tregion-samples       : {0} x {1}", region_nrows, region_ncols );
+            LOCO_CORE_WARN( "\thfield-samples       : {0} x {1}", m_mjcGeomHFieldNRows, m_mjcGeomHFieldNCols );
+            LOCO_CORE_WARN( "\tgiven buffer-size    : {0}", heights.size() );
+            return;
+        }
+
+        auto& collider_heights = m_ColliderRef->data().hfield_data.heights;
+        for ( ssize_t i = 0; i < region_nrows; i++ )
+            std::copy( heights.begin() + i * region_ncols, heights.begin() + ( i + 1 ) * region_ncols,
+                       collider_heights.begin() + ( row_start + i ) * m_mjcGeomHFieldNCols + col_start );
+
+        // Only the blocks overlapping the region are rescanned, so the max-height stays exact without a full pass
+        _update_hfield_blocks_max( row_start, col_start, region_nrows, region_ncols );
+        const float max_height = *std::max_element( m_mjcHFieldBlocksMax.cbegin(), m_mjcHFieldBlocksMax.cend() );
+
+        // Samples are stored normalized by the normalization height (the geom's elevation being that height), so
+        // a larger one keeps the geometry exact. Everything is renormalized only if the max-height goes beyond it, or
+        // drops far below it (with some headroom, so gradual changes don't trigger a full pass on every update)
+        if ( max_height > m_mjcHFieldNormHeight || max_height < LOCO_MUJOCO_HFIELD_NORM_SHRINK_RATIO * m_mjcHFieldNormHeight )
+        {
+            m_mjcHFieldNormHeight = std::max( LOCO_MUJOCO_HFIELD_NORM_HEADROOM * max_height, std::numeric_limits<float>::epsilon() );
+            mjModel* mjc_model = _mjc_model_unique();
+            mjc_model->hfield_size[4 * m_mjcGeomHFieldId + 2] = m_mjcHFieldNormHeight * m_size.z();
+            _update_hfield_rbound();
+            _normalize_hfield_region( 0, 0, m_mjcGeomHFieldNRows, m_mjcGeomHFieldNCols );
+        }
+        else
+        {
+            _normalize_hfield_region( row_start, col_start, region_nrows, region_ncols );
+        }
+    }
+
+    void TMujocoSingleBodyColliderAdapter::_update_hfield_blocks_max( ssize_t row_start, ssize_t col_start,
+                                                                      ssize_t region_nrows, ssize_t region_ncols )
+    {
+        const auto& heights = m_ColliderRef->data().hfield_data.heights;
+        const ssize_t block_row_start = row_start / LOCO_MUJOCO_HFIELD_BLOCK_SIZE;
+        const ssize_t block_row_end = ( row_start + region_nrows - 1 ) / LOCO_MUJOCO_HFIELD_BLOCK_SIZE;
+        const ssize_t block_col_start = col_start / LOCO_MUJOCO_HFIELD_BLOCK_SIZE;
+        const ssize_t block_col_end = ( col_start + region_ncols - 1 ) / LOCO_MUJOCO_HFIELD_BLOCK_SIZE;
+        for ( ssize_t bi = block_row_start; bi <= block_row_end; bi++ )
         {
-            for ( size_t j = 0; j < nx_samples; j++ )
+            for ( ssize_t bj = block_col_start; bj <= block_col_end; bj++ )
             {
-                const size_t index = i * nx_samples + j;
-                m_mjcModelRef->hfield_data[m_mjcGeomHFieldStartAddr + index] =
-                    std::max( 0.0f, heights[index] / max_height );
+                const ssize_t row_begin = bi * LOCO_MUJOCO_HFIELD_BLOCK_SIZE;
+                const ssize_t row_end = std::min( row_begin + LOCO_MUJOCO_HFIELD_BLOCK_SIZE, m_mjcGeomHFieldNRows );
+                const ssize_t col_begin = bj * LOCO_MUJOCO_HFIELD_BLOCK_SIZE;
+                const ssize_t col_end = std::min( col_begin + LOCO_MUJOCO_HFIELD_BLOCK_SIZE, m_mjcGeomHFieldNCols );
+                float block_max = -std::numeric_limits<float>::max();
+                for ( ssize_t i = row_begin; i < row_end; i++ )
+                    block_max = std::max( block_max, mujoco::hfield_max( heights.data() + i * m_mjcGeomHFieldNCols + col_begin,
+                                                                         col_end - col_begin ) );
+                m_mjcHFieldBlocksMax[bi * m_mjcHFieldNBlockCols + bj] = block_max;
             }
         }
-        m_mjcModelRef->hfield_size[4 * m_mjcGeomHFieldId + 2] = max_height * m_size.z();
+    }
+
+    void TMujocoSingleBodyColliderAdapter::_normalize_hfield_region( ssize_t row_start, ssize_t col_start,
+                                                                     ssize_t region_nrows, ssize_t region_ncols )
+    {
+        const auto& heights = m_ColliderRef->data().hfield_data.heights;
+        const float inv_norm_height = 1.0f / m_mjcHFieldNormHeight;
+        mjModel* mjc_model = _mjc_model_unique();
+        for ( ssize_t i = row_start; i < row_start + region_nrows; i++ )
+        {
+            const ssize_t index = i * m_mjcGeomHFieldNCols + col_start;
+            mujoco::hfield_normalize( mjc_model->hfield_data + m_mjcGeomHFieldStartAddr + index,
+                                      heights.data() + index, region_ncols, inv_norm_height );
+        }
     }
 
     void TMujocoSingleBodyColliderAdapter::ChangeCollisionGroup( int collisionGroup )
     {
         if ( m_mjcGeomId < 0 )
             return;
-        m_mjcModelRef->geom_contype[m_mjcGeomId] = collisionGroup;
+        _mjc_model_unique()->geom_contype[m_mjcGeomId] = collisionGroup;
     }
 
     void TMujocoSingleBodyColliderAdapter::ChangeCollisionMask( int collisionMask )
     {
         if ( m_mjcGeomId < 0 )
             return;
-        m_mjcModelRef->geom_conaffinity[m_mjcGeomId] = collisionMask;
+        _mjc_model_unique()->geom_conaffinity[m_mjcGeomId] = collisionMask;
     }
 
     void TMujocoSingleBodyColliderAdapter::ChangeFriction( const TScalar& friction )
@@ -451,7 +696,15 @@ namespace primitives {
         if ( m_mjcGeomId < 0 )
             return;
         // Update only sliding friction (leave rolling and torsional as defaults)
-        m_mjcModelRef->geom_friction[3 * m_mjcGeomId + 0] = friction;
+        _mjc_model_unique()->geom_friction[3 * m_mjcGeomId + 0] = friction;
+    }
+
+    mjModel* TMujocoSingleBodyColliderAdapter::_mjc_model_unique()
+    {
+        // Copies the model first if shared with clones (the simulation then rebinds m_mjcModelRef to the copy)
+        if ( m_mjcModelUniqueFn )
+            return m_mjcModelUniqueFn();
+        return m_mjcModelRef;
     }
 
     std::vector<const parsing::TElement*> TMujocoSingleBodyColliderAdapter::elements_resources() const
@@ -469,23 +722,18 @@ namespace primitives {
                                         std::max( 1e-3f, new_size.y() / m_size0.y() ),
                                         std::max( 1e-3f, new_size.z() / m_size0.z() ) };
 
-        TVec3 aabb_min = { 1e6f, 1e6f, 1e6f };
-        TVec3 aabb_max = { -1e6f, -1e6f, -1e6f };
-        for ( size_t i = 0; i < m_mjcGeomMeshVertNum; i++ )
+        // mesh_vertadr is given in vertices (3 floats each), not in floats
+        mjModel* mjc_model = _mjc_model_unique();
+        float* mesh_vertices = mjc_model->mesh_vert + 3 * m_mjcGeomMeshVertStartAddr;
+        for ( ssize_t i = 0; i < m_mjcGeomMeshVertNum; i++ )
         {
-            m_mjcModelRef->mesh_vert[m_mjcGeomMeshVertStartAddr + 3 * i + 0] *= effective_scale.x();
-            m_mjcModelRef->mesh_vert[m_mjcGeomMeshVertStartAddr + 3 * i + 1] *= effective_scale.y();
-            m_mjcModelRef->mesh_vert[m_mjcGeomMeshVertStartAddr + 3 * i + 2] *= effective_scale.z();
-
-            aabb_min.x() = std::min( aabb_min.x(), m_mjcModelRef->mesh_vert[m_mjcGeomMeshVertStartAddr + 3 * i + 0] );
-            aabb_min.y() = std::min( aabb_min.y(), m_mjcModelRef->mesh_vert[m_mjcGeomMeshVertStartAddr + 3 * i + 1] );
-            aabb_min.z() = std::min( aabb_min.z(), m_mjcModelRef->mesh_vert[m_mjcGeomMeshVertStartAddr + 3 * i + 2] );
-
-            aabb_max.x() = std::max( aabb_max.x(), m_mjcModelRef->mesh_vert[m_mjcGeomMeshVertStartAddr + 3 * i + 0] );
-            aabb_max.y() = std::max( aabb_max.y(), m_mjcModelRef->mesh_vert[m_mjcGeomMeshVertStartAddr + 3 * i + 1] );
-            aabb_max.z() = std::max( aabb_max.z(), m_mjcModelRef->mesh_vert[m_mjcGeomMeshVertStartAddr + 3 * i + 2] );
+            mesh_vertices[3 * i + 0] *= effective_scale.x();
+            mesh_vertices[3 * i + 1] *= effective_scale.y();
+            mesh_vertices[3 * i + 2] *= effective_scale.z();
         }
-        m_mjcModelRef->geom_rbound[m_mjcGeomId] = 0.5f * ( aabb_max - aabb_min ).length();
+        TVec3 aabb_min, aabb_max;
+        mujoco::compute_vertices_aabb( mesh_vertices, m_mjcGeomMeshVertNum, aabb_min, aabb_max );
+        mjc_model->geom_rbound[m_mjcGeomId] = mujoco::compute_aabb_rbound( aabb_min, aabb_max );
         // New size becomes previous size for next resizing operation
         m_size0 = new_size;
 
@@ -495,23 +743,34 @@ namespace primitives {
     void TMujocoSingleBodyColliderAdapter::_resize_hfield( const TVec3& new_size )
     {
         // Size given by user are [x(width),y(depth),height-scale]
-        const auto& heights = m_ColliderRef->data().hfield_data.heights;
-        const float max_height = *std::max_element( heights.cbegin(), heights.cend() );
-        m_mjcModelRef->hfield_size[4 * m_mjcGeomHFieldId + 0] = new_size.x();
-        m_mjcModelRef->hfield_size[4 * m_mjcGeomHFieldId + 1] = new_size.y();
-        m_mjcModelRef->hfield_size[4 * m_mjcGeomHFieldId + 2] = max_height * new_size.z();
-
-        TVec3 aabb_min = { -0.5f * new_size.x(), -0.5f * new_size.y(), -LOCO_MUJOCO_HFIELD_BASE };
-        TVec3 aabb_max = { 0.5f * new_size.x(), 0.5f * new_size.y(), max_height * new_size.z() };
-        //// m_mjcModelRef->geom_rbound[m_mjcGeomId] = 0.5f * ( aabb_max - aabb_min ).length();
+        // Samples are normalized by the normalization height, which is at least the max-height (see region updates)
+        const float max_height = m_mjcHFieldNormHeight;
+        mjModel* mjc_model = _mjc_model_unique();
+        mjc_model->hfield_size[4 * m_mjcGeomHFieldId + 0] = new_size.x();
+        mjc_model->hfield_size[4 * m_mjcGeomHFieldId + 1] = new_size.y();
+        mjc_model->hfield_size[4 * m_mjcGeomHFieldId + 2] = max_height * new_size.z();
+        _update_hfield_rbound();
+    }
+
+    void TMujocoSingleBodyColliderAdapter::_update_hfield_rbound()
+    {
+        // Mujoco computes the bounding radius at compile-time and uses it in the broadphase, so it has to follow
+        // the hfield's extents [radius-x, radius-y, elevation, base], otherwise raised terrain loses its contacts
+        mjModel* mjc_model = _mjc_model_unique();
+        const mjtNum* hfield_size = mjc_model->hfield_size + 4 * m_mjcGeomHFieldId;
+        const TVec3 aabb_min = { (float)-hfield_size[0], (float)-hfield_size[1], (float)-hfield_size[3] };
+        const TVec3 aabb_max = { (float)hfield_size[0], (float)hfield_size[1], (float)hfield_size[2] };
+        mjc_model->geom_rbound[m_mjcGeomId] = mujoco::compute_aabb_rbound( aabb_min, aabb_max );
+        m_mjcGeomRbound = mjc_model->geom_rbound[m_mjcGeomId];
     }
 
     void TMujocoSingleBodyColliderAdapter::_resize_primitive( const TVec3& new_size )
     {
         const auto shape = m_ColliderRef->shape();
         const auto array_size = mujoco::size_to_mjcSize( shape, new_size );
+        mjModel* mjc_model = _mjc_model_unique();
         for ( size_t i = 0; i < array_size.ndim; i++ )
-            m_mjcModelRef->geom_size[3 * m_mjcGeomId + i] = array_size[i];
-        m_mjcModelRef->geom_rbound[m_mjcGeomId] = mujoco::compute_primitive_rbound( shape, new_size );
+            mjc_model->geom_size[3 * m_mjcGeomId + i] = array_size[i];
+        mjc_model->geom_rbound[m_mjcGeomId] = mujoco::compute_primitive_rbound( shape, new_size );
     }
 }}
\ No newline at end of file
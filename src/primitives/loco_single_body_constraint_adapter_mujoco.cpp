@@ -12,6 +12,7 @@ namespace primitives {
     {
         m_MjcModelRef = nullptr;
         m_MjcDataRef = nullptr;
+        m_MjcNameIndexRef = nullptr;
 
         m_MjcJointQposNum = -1;
         m_MjcJointQvelNum = -1;
@@ -21,6 +22,7 @@ namespace primitives {
     {
         m_MjcModelRef = nullptr;
         m_MjcDataRef = nullptr;
+        m_MjcNameIndexRef = nullptr;
 
         m_MjcJointQposNum = -1;
         m_MjcJointQvelNum = -1;
@@ -44,6 +46,14 @@ namespace primitives {
         return mjcf_elements;
     }
 
+    mjModel* TIMujocoSingleBodyConstraintAdapter::_MjcModelUnique()
+    {
+        // Copies the model first if shared with clones (the simulation then rebinds m_MjcModelRef to the copy)
+        if ( m_MjcModelUniqueFn )
+            return m_MjcModelUniqueFn();
+        return m_MjcModelRef;
+    }
+
     //********************************************************************************************//
     //                              Revolute-constraint Adapter Impl                              //
     //********************************************************************************************//
@@ -70,7 +80,7 @@ namespace primitives {
         LOCO_CORE_ASSERT( m_MjcDataRef, "TMujocoSingleBodyRevoluteConstraintAdapter::Initialize >>> \
                           constraint {0} must have a valid mjData reference", m_ConstraintRef->name() );
 
-        m_MjcJointId = mj_name2id( m_MjcModelRef, mjOBJ_JOINT, m_ConstraintRef->name().c_str() );
+        m_MjcJointId = mujoco::mjc_name2id( m_MjcModelRef, m_MjcNameIndexRef, mjOBJ_JOINT, m_ConstraintRef->name() );
         LOCO_CORE_ASSERT( m_MjcJointId >= 0, "TMujocoSingleBodyRevoluteConstraintAdapter::Initialize >>> couldn't find \
                           associated mjc-joint for constraint {0}", m_ConstraintRef->name() );
         LOCO_CORE_ASSERT( m_MjcModelRef->jnt_type[m_MjcJointId] == mjJNT_HINGE, "TMujocoSingleBodyRevoluteConstraintAdapter::Initialize >>> \
@@ -105,11 +115,12 @@ namespace primitives {
                           constraint \"{0}\" must be linked to a valid mjc-joint", m_ConstraintRef->name() );
 
         const bool limited = ( limits.x() > limits.y() );
-        m_MjcModelRef->jnt_limited[m_MjcJointId] = limited ? 0 : 1;
+        mjModel* mjc_model = _MjcModelUnique();
+        mjc_model->jnt_limited[m_MjcJointId] = limited ? 0 : 1;
         if ( limited )
         {
-            m_MjcModelRef->jnt_range[2 * m_MjcJointId + 0] = limits.x();
-            m_MjcModelRef->jnt_range[2 * m_MjcJointId + 1] = limits.y();
+            mjc_model->jnt_range[2 * m_MjcJointId + 0] = limits.x();
+            mjc_model->jnt_range[2 * m_MjcJointId + 1] = limits.y();
         }
     }
 
@@ -147,7 +158,7 @@ namespace primitives {
         LOCO_CORE_ASSERT( m_MjcDataRef, "TMujocoSingleBodyPrismaticConstraintAdapter::Initialize >>> \
                           constraint {0} must have a valid mjData reference", m_ConstraintRef->name() );
 
-        m_MjcJointId = mj_name2id( m_MjcModelRef, mjOBJ_JOINT, m_ConstraintRef->name().c_str() );
+        m_MjcJointId = mujoco::mjc_name2id( m_MjcModelRef, m_MjcNameIndexRef, mjOBJ_JOINT, m_ConstraintRef->name() );
         LOCO_CORE_ASSERT( m_MjcJointId >= 0, "TMujocoSingleBodyPrismaticConstraintAdapter::Initialize >>> couldn't find \
                           associated mjc-joint for constraint {0}", m_ConstraintRef->name() );
         LOCO_CORE_ASSERT( m_MjcModelRef->jnt_type[m_MjcJointId] == mjJNT_SLIDE, "TMujocoSingleBodyPrismaticConstraintAdapter::Initialize >>> \
@@ -182,11 +193,12 @@ namespace primitives {
                           constraint \"{0}\" must be linked to a valid mjc-joint", m_ConstraintRef->name() );
 
         const bool limited = ( limits.x() > limits.y() );
-        m_MjcModelRef->jnt_limited[m_MjcJointId] = limited ? 0 : 1;
+        mjModel* mjc_model = _MjcModelUnique();
+        mjc_model->jnt_limited[m_MjcJointId] = limited ? 0 : 1;
         if ( limited )
         {
-            m_MjcModelRef->jnt_range[2 * m_MjcJointId + 0] = limits.x();
-            m_MjcModelRef->jnt_range[2 * m_MjcJointId + 1] = limits.y();
+            mjc_model->jnt_range[2 * m_MjcJointId + 0] = limits.x();
+            mjc_model->jnt_range[2 * m_MjcJointId + 1] = limits.y();
         }
     }
 
@@ -220,7 +232,7 @@ namespace primitives {
         LOCO_CORE_ASSERT( m_MjcDataRef, "TMujocoSingleBodySphericalConstraintAdapter::Initialize >>> \
                           constraint {0} must have a valid mjData reference", m_ConstraintRef->name() );
 
-        m_MjcJointId = mj_name2id( m_MjcModelRef, mjOBJ_JOINT, m_ConstraintRef->name().c_str() );
+        m_MjcJointId = mujoco::mjc_name2id( m_MjcModelRef, m_MjcNameIndexRef, mjOBJ_JOINT, m_ConstraintRef->name() );
         LOCO_CORE_ASSERT( m_MjcJointId >= 0, "TMujocoSingleBodySphericalConstraintAdapter::Initialize >>> couldn't find \
                           associated mjc-joint for constraint {0}", m_ConstraintRef->name() );
         LOCO_CORE_ASSERT( m_MjcModelRef->jnt_type[m_MjcJointId] == mjJNT_BALL, "TMujocoSingleBodySphericalConstraintAdapter::Initialize >>> \
@@ -283,9 +295,9 @@ namespace primitives {
         LOCO_CORE_ASSERT( m_MjcDataRef, "TMujocoSingleBodyTranslational3dConstraintAdapter::Initialize >>> \
                           constraint {0} must have a valid mjData reference", m_ConstraintRef->name() );
 
-        m_MjcJointIdSlideX = mj_name2id( m_MjcModelRef, mjOBJ_JOINT, ( m_ConstraintRef->name() + "_trans_x" ).c_str() );
-        m_MjcJointIdSlideY = mj_name2id( m_MjcModelRef, mjOBJ_JOINT, ( m_ConstraintRef->name() + "_trans_y" ).c_str() );
-        m_MjcJointIdSlideZ = mj_name2id( m_MjcModelRef, mjOBJ_JOINT, ( m_ConstraintRef->name() + "_trans_z" ).c_str() );
+        m_MjcJointIdSlideX = mujoco::mjc_name2id( m_MjcModelRef, m_MjcNameIndexRef, mjOBJ_JOINT, ( m_ConstraintRef->name() + "_trans_x" ) );
+        m_MjcJointIdSlideY = mujoco::mjc_name2id( m_MjcModelRef, m_MjcNameIndexRef, mjOBJ_JOINT, ( m_ConstraintRef->name() + "_trans_y" ) );
+        m_MjcJointIdSlideZ = mujoco::mjc_name2id( m_MjcModelRef, m_MjcNameIndexRef, mjOBJ_JOINT, ( m_ConstraintRef->name() + "_trans_z" ) );
 
         LOCO_CORE_ASSERT( m_MjcJointIdSlideX >= 0, "TMujocoSingleBodyTranslational3dConstraintAdapter::Initialize >>> couldn't find \
                           associated mjc-joint for constraint {0}", ( m_ConstraintRef->name() + "_trans_x" ) );
@@ -372,10 +384,10 @@ namespace primitives {
         LOCO_CORE_ASSERT( m_MjcDataRef, "TMujocoSingleBodyUniversal3dConstraintAdapter::Initialize >>> \
                           constraint {0} must have a valid mjData reference", m_ConstraintRef->name() );
 
-        m_MjcJointIdSlideX = mj_name2id( m_MjcModelRef, mjOBJ_JOINT, ( m_ConstraintRef->name() + "_trans_x" ).c_str() );
-        m_MjcJointIdSlideY = mj_name2id( m_MjcModelRef, mjOBJ_JOINT, ( m_ConstraintRef->name() + "_trans_y" ).c_str() );
-        m_MjcJointIdSlideZ = mj_name2id( m_MjcModelRef, mjOBJ_JOINT, ( m_ConstraintRef->name() + "_trans_z" ).c_str() );
-        m_MjcJointIdHingeZ = mj_name2id( m_MjcModelRef, mjOBJ_JOINT, ( m_ConstraintRef->name() + "_rot_z" ).c_str() );
+        m_MjcJointIdSlideX = mujoco::mjc_name2id( m_MjcModelRef, m_MjcNameIndexRef, mjOBJ_JOINT, ( m_ConstraintRef->name() + "_trans_x" ) );
+        m_MjcJointIdSlideY = mujoco::mjc_name2id( m_MjcModelRef, m_MjcNameIndexRef, mjOBJ_JOINT, ( m_ConstraintRef->name() + "_trans_y" ) );
+        m_MjcJointIdSlideZ = mujoco::mjc_name2id( m_MjcModelRef, m_MjcNameIndexRef, mjOBJ_JOINT, ( m_ConstraintRef->name() + "_trans_z" ) );
+        m_MjcJointIdHingeZ = mujoco::mjc_name2id( m_MjcModelRef, m_MjcNameIndexRef, mjOBJ_JOINT, ( m_ConstraintRef->name() + "_rot_z" ) );
 
         LOCO_CORE_ASSERT( m_MjcJointIdSlideX >= 0, "TMujocoSingleBodyUniversal3dConstraintAdapter::Initialize >>> couldn't find \
                           associated mjc-joint for constraint {0}", ( m_ConstraintRef->name() + "_trans_x" ) );
@@ -463,9 +475,9 @@ namespace primitives {
         LOCO_CORE_ASSERT( m_MjcDataRef, "TMujocoSingleBodyPlanarConstraintAdapter::Initialize >>> \
                           constraint {0} must have a valid mjData reference", m_ConstraintRef->name() );
 
-        m_MjcJointIdSlideX = mj_name2id( m_MjcModelRef, mjOBJ_JOINT, ( m_ConstraintRef->name() + "_trans_x" ).c_str() );
-        m_MjcJointIdSlideZ = mj_name2id( m_MjcModelRef, mjOBJ_JOINT, ( m_ConstraintRef->name() + "_trans_z" ).c_str() );
-        m_MjcJointIdHingeY = mj_name2id( m_MjcModelRef, mjOBJ_JOINT, ( m_ConstraintRef->name() + "_rot_y" ).c_str() );
+        m_MjcJointIdSlideX = mujoco::mjc_name2id( m_MjcModelRef, m_MjcNameIndexRef, mjOBJ_JOINT, ( m_ConstraintRef->name() + "_trans_x" ) );
+        m_MjcJointIdSlideZ = mujoco::mjc_name2id( m_MjcModelRef, m_MjcNameIndexRef, mjOBJ_JOINT, ( m_ConstraintRef->name() + "_trans_z" ) );
+        m_MjcJointIdHingeY = mujoco::mjc_name2id( m_MjcModelRef, m_MjcNameIndexRef, mjOBJ_JOINT, ( m_ConstraintRef->name() + "_rot_y" ) );
 
         LOCO_CORE_ASSERT( m_MjcJointIdSlideX >= 0, "TMujocoSingleBodyPlanarConstraintAdapter::Initialize >>> couldn't find \
                           associated mjc-joint for constraint {0}", ( m_ConstraintRef->name() + "_trans_x" ) );
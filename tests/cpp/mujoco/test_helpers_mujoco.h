@@ -0,0 +1,35 @@
+#pragma once
+
+#include <loco.h>
+#include <cstdio>
+#include <string>
+#include <dirent.h>
+#include <unistd.h>
+
+// Removes a (flat) temporary directory created by a test, along with its contents
+inline void remove_tmp_directory( const std::string& dirpath )
+{
+    if ( DIR* dir = opendir( dirpath.c_str() ) )
+    {
+        while ( struct dirent* entry = readdir( dir ) )
+        {
+            const std::string entry_name = entry->d_name;
+            if ( entry_name != "." && entry_name != ".." )
+                std::remove( ( dirpath + "/" + entry_name ).c_str() );
+        }
+        closedir( dir );
+    }
+    rmdir( dirpath.c_str() );
+}
+
+// Body-data of a dynamic box, using the same shape for collisions and visuals
+inline loco::TBodyData create_box_data( const loco::TVec3& size = { 0.2f, 0.2f, 0.2f } )
+{
+    auto box_data = loco::TBodyData();
+    box_data.dyntype = loco::eDynamicsType::DYNAMIC;
+    box_data.collision.type = loco::eShapeType::BOX;
+    box_data.collision.size = size;
+    box_data.visual.type = loco::eShapeType::BOX;
+    box_data.visual.size = size;
+    return box_data;
+}
\ No newline at end of file
@@ -1,8 +1,18 @@
 
 #include <loco.h>
 #include <gtest/gtest.h>
+#include "test_helpers_mujoco.h"
 
 #include <loco_simulation_mujoco.h>
+#include <loco_batch_simulation_mujoco.h>
+#include <loco_streaming_terrain_mujoco.h>
+#include <loco_shm_server_mujoco.h>
+#include <atomic>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
 
 TEST( TestLocoMujocoSimulation, TestMujocoSimulationFunctionality )
 {
@@ -18,15 +28,927 @@ TEST( TestLocoMujocoSimulation, TestMujocoSimulationFunctionality )
     body_data.collision = col_data;
     body_data.visual = vis_data;
 
-    auto body_obj = std::make_unique<loco::TSingleBody>( "body_0", body_data, tinymath::Vector3f( 1.0, 1.0, 1.0 ), tinymath::Matrix3f() );
+    auto body_obj = std::make_unique<loco::primitives::TSingleBody>( "body_0", body_data, tinymath::Vector3f( 1.0, 1.0, 1.0 ), tinymath::Matrix3f() );
     auto scenario = std::make_unique<loco::TScenario>();
     scenario->AddSingleBody( std::move( body_obj ) );
 
-    auto simulation = std::make_unique<loco::mujoco::TMujocoSimulation>( scenario.get() );
+    auto simulation = std::make_unique<loco::TMujocoSimulation>( scenario.get() );
     simulation->Initialize();
     simulation->Step();
     simulation->Reset();
     simulation->Pause();
     simulation->Resume();
     EXPECT_EQ( simulation->backendId(), "MUJOCO" );
+}
+
+TEST( TestLocoMujocoSimulation, TestMujocoSimulationModelCache )
+{
+    auto create_scenario = []()
+        {
+            auto col_data = loco::TCollisionData();
+            col_data.type = loco::eShapeType::BOX;
+            col_data.size = { 0.2, 0.2, 0.2 };
+            auto body_data = loco::TBodyData();
+            body_data.dyntype = loco::eDynamicsType::DYNAMIC;
+            body_data.collision = col_data;
+            body_data.visual.type = loco::eShapeType::BOX;
+            body_data.visual.size = { 0.2, 0.2, 0.2 };
+
+            auto scenario = std::make_unique<loco::TScenario>();
+            scenario->AddSingleBody( std::make_unique<loco::primitives::TSingleBody>( "body_0", body_data, tinymath::Vector3f( 0.0, 0.0, 1.0 ), tinymath::Matrix3f() ) );
+            return scenario;
+        };
+
+    const std::string key_1 = loco::mujoco::TMujocoModelCache::ComputeKey( "<mujoco/>", {}, {} );
+    const std::string key_2 = loco::mujoco::TMujocoModelCache::ComputeKey( "<mujoco/>", {}, {} );
+    const std::string key_3 = loco::mujoco::TMujocoModelCache::ComputeKey( "<mujoco></mujoco>", {}, {} );
+    EXPECT_EQ( key_1, key_2 );
+    EXPECT_NE( key_1, key_3 );
+
+    char cache_dirpath[] = "/tmp/loco_mjb_cache_XXXXXX";
+    ASSERT_TRUE( mkdtemp( cache_dirpath ) != nullptr );
+    loco::mujoco::TMujocoModelCache::SetCacheDirectory( cache_dirpath );
+    loco::mujoco::TMujocoModelCache::ResetStats();
+
+    auto scenario_1 = create_scenario();
+    auto simulation_1 = std::make_unique<loco::TMujocoSimulation>( scenario_1.get() );
+    ASSERT_TRUE( simulation_1->Initialize() );
+
+    auto scenario_2 = create_scenario();
+    auto simulation_2 = std::make_unique<loco::TMujocoSimulation>( scenario_2.get() );
+    ASSERT_TRUE( simulation_2->Initialize() );
+
+    // Cache starts empty, so the first simulation compiles its model, and the second one (same mjcf) loads it
+    EXPECT_EQ( loco::mujoco::TMujocoModelCache::num_misses(), 1 );
+    EXPECT_EQ( loco::mujoco::TMujocoModelCache::num_hits(), 1 );
+    EXPECT_EQ( simulation_1->mjc_model()->nbody, simulation_2->mjc_model()->nbody );
+    EXPECT_EQ( simulation_1->mjc_model()->ngeom, simulation_2->mjc_model()->ngeom );
+    simulation_2->Step();
+
+    loco::mujoco::TMujocoModelCache::SetCacheDirectory( "" );
+    remove_tmp_directory( cache_dirpath );
+}
+
+TEST( TestLocoMujocoSimulation, TestMujocoSimulationNameIndex )
+{
+    auto scenario = std::make_unique<loco::TScenario>();
+    for ( ssize_t i = 0; i < 10; i++ )
+    {
+        auto col_data = loco::TCollisionData();
+        col_data.type = loco::eShapeType::SPHERE;
+        col_data.size = { 0.1, 0.1, 0.1 };
+        auto body_data = loco::TBodyData();
+        body_data.dyntype = loco::eDynamicsType::DYNAMIC;
+        body_data.collision = col_data;
+        body_data.visual.type = loco::eShapeType::SPHERE;
+        body_data.visual.size = { 0.1, 0.1, 0.1 };
+        scenario->AddSingleBody( std::make_unique<loco::primitives::TSingleBody>( "body_" + std::to_string( i ), body_data,
+                                                                      tinymath::Vector3f( 0.5 * i, 0.0, 1.0 ), tinymath::Matrix3f() ) );
+    }
+
+    auto simulation = std::make_unique<loco::TMujocoSimulation>( scenario.get() );
+    ASSERT_TRUE( simulation->Initialize() );
+
+    auto name_index = simulation->mjc_name_index();
+    ASSERT_TRUE( name_index != nullptr );
+    ASSERT_TRUE( name_index->built() );
+    for ( ssize_t i = 0; i < 10; i++ )
+    {
+        const std::string body_name = "body_" + std::to_string( i );
+        EXPECT_EQ( name_index->GetId( mjOBJ_BODY, body_name ), mj_name2id( simulation->mjc_model(), mjOBJ_BODY, body_name.c_str() ) );
+        EXPECT_GE( name_index->GetId( mjOBJ_BODY, body_name ), 0 );
+    }
+    EXPECT_EQ( name_index->GetId( mjOBJ_BODY, "not_a_body" ), -1 );
+    EXPECT_EQ( name_index->GetId( mjOBJ_GEOM, "body_0" ), -1 );
+}
+
+TEST( TestLocoMujocoSimulation, TestMujocoSimulationContactForces )
+{
+    auto scenario = std::make_unique<loco::TScenario>();
+
+    auto floor_data = loco::TBodyData();
+    floor_data.dyntype = loco::eDynamicsType::STATIC;
+    floor_data.collision.type = loco::eShapeType::PLANE;
+    floor_data.collision.size = { 10.0, 10.0, 1.0 };
+    floor_data.visual.type = loco::eShapeType::PLANE;
+    floor_data.visual.size = { 10.0, 10.0, 1.0 };
+    scenario->AddSingleBody( std::make_unique<loco::primitives::TSingleBody>( "floor", floor_data, tinymath::Vector3f( 0.0, 0.0, 0.0 ), tinymath::Matrix3f() ) );
+
+    auto box_data = create_box_data();
+    scenario->AddSingleBody( std::make_unique<loco::primitives::TSingleBody>( "box", box_data, tinymath::Vector3f( 0.0, 0.0, 0.1 ), tinymath::Matrix3f() ) );
+
+    auto simulation = std::make_unique<loco::TMujocoSimulation>( scenario.get() );
+    simulation->SetContactForcesSubscription( "box", true );
+    ASSERT_TRUE( simulation->Initialize() );
+    for ( ssize_t i = 0; i < 200; i++ )
+        simulation->Step();
+
+    const auto box_contacts = simulation->GetMjcContacts( "box" );
+    ASSERT_GT( box_contacts.size, 0 );
+    EXPECT_EQ( box_contacts.size, scenario->GetSingleBodyByName( "box" )->collider()->contacts().size() );
+
+    // At rest, the floor supports the whole weight of the box
+    const ssize_t box_body_id = mj_name2id( simulation->mjc_model(), mjOBJ_BODY, "box" );
+    const double box_weight = simulation->mjc_model()->body_mass[box_body_id] * 9.81;
+    double total_support_force = 0.0;
+    for ( const auto& contact : box_contacts )
+        total_support_force += contact.force.z();
+    EXPECT_NEAR( total_support_force, box_weight, 0.05 * box_weight );
+}
+
+TEST( TestLocoMujocoSimulation, TestMujocoSimulationLazyContacts )
+{
+    auto scenario = std::make_unique<loco::TScenario>();
+
+    auto floor_data = loco::TBodyData();
+    floor_data.dyntype = loco::eDynamicsType::STATIC;
+    floor_data.collision.type = loco::eShapeType::PLANE;
+    floor_data.collision.size = { 10.0, 10.0, 1.0 };
+    floor_data.visual.type = loco::eShapeType::PLANE;
+    floor_data.visual.size = { 10.0, 10.0, 1.0 };
+    scenario->AddSingleBody( std::make_unique<loco::primitives::TSingleBody>( "floor", floor_data, tinymath::Vector3f( 0.0, 0.0, 0.0 ), tinymath::Matrix3f() ) );
+
+    auto box_data = create_box_data();
+    scenario->AddSingleBody( std::make_unique<loco::primitives::TSingleBody>( "box", box_data, tinymath::Vector3f( 0.0, 0.0, 0.1 ), tinymath::Matrix3f() ) );
+
+    auto simulation = std::make_unique<loco::TMujocoSimulation>( scenario.get() );
+    simulation->SetContactsCollectionMode( loco::mujoco::eContactsCollectionMode::LAZY );
+    ASSERT_TRUE( simulation->Initialize() );
+    auto box_collider = scenario->GetSingleBodyByName( "box" )->collider();
+
+    // Lazy mode: steps only mark the contacts as dirty, nothing gets collected
+    for ( ssize_t i = 0; i < 50; i++ )
+        simulation->Step();
+    EXPECT_TRUE( simulation->contacts_dirty() );
+    EXPECT_EQ( simulation->mjc_contact_buffer()->num_contacts(), 0 );
+    EXPECT_EQ( box_collider->contacts().size(), 0 );
+    ASSERT_GT( simulation->mjc_data()->ncon, 0 );
+
+    // First request materializes the contacts of the last step, following requests reuse them
+    const auto box_contacts = simulation->GetMjcContacts( "box" );
+    EXPECT_FALSE( simulation->contacts_dirty() );
+    EXPECT_EQ( simulation->mjc_contact_buffer()->num_contacts(), simulation->mjc_data()->ncon );
+    ASSERT_GT( box_contacts.size, 0 );
+    EXPECT_EQ( box_contacts.size, box_collider->contacts().size() );
+    simulation->CollectContacts();
+    EXPECT_EQ( simulation->GetMjcContacts( "box" ).size, box_contacts.size );
+
+    // Changing a force subscription requires a new collection (forces weren't computed before)
+    simulation->SetContactForcesSubscription( "box", true );
+    EXPECT_TRUE( simulation->contacts_dirty() );
+    EXPECT_GT( simulation->GetMjcContacts( "box" )[0].force.z(), 0.0 );
+
+    // Registered consumers get the contacts collected after every step, even in lazy mode
+    simulation->RegisterContactsConsumer();
+    EXPECT_EQ( simulation->num_contacts_consumers(), 1 );
+    simulation->Step();
+    EXPECT_FALSE( simulation->contacts_dirty() );
+    simulation->UnregisterContactsConsumer();
+    EXPECT_EQ( simulation->num_contacts_consumers(), 0 );
+    simulation->Step();
+    EXPECT_TRUE( simulation->contacts_dirty() );
+
+    // Eager mode collects right after each step
+    simulation->SetContactsCollectionMode( loco::mujoco::eContactsCollectionMode::EAGER );
+    simulation->Step();
+    EXPECT_FALSE( simulation->contacts_dirty() );
+}
+
+TEST( TestLocoMujocoSimulation, TestMujocoBatchSimulation )
+{
+    auto scenario = std::make_unique<loco::TScenario>();
+    auto box_data = create_box_data();
+    scenario->AddSingleBody( std::make_unique<loco::primitives::TSingleBody>( "box", box_data, tinymath::Vector3f( 0.0, 0.0, 1.0 ), tinymath::Matrix3f() ) );
+
+    const ssize_t num_envs = 8;
+    auto batch = std::make_unique<loco::TMujocoBatchSimulation>( scenario.get(), num_envs, 4 );
+    ASSERT_TRUE( batch->Initialize() );
+    EXPECT_EQ( batch->num_envs(), num_envs );
+    EXPECT_NE( batch->mjc_data( 0 ), batch->mjc_data( 1 ) );
+
+    // Step only the even environments, so the odd ones keep their initial state
+    std::vector<ssize_t> even_envs;
+    for ( ssize_t i = 0; i < num_envs; i += 2 )
+        even_envs.push_back( i );
+    for ( ssize_t k = 0; k < 50; k++ )
+        batch->StepEnvs( even_envs );
+
+    const ssize_t nq = batch->mjc_model()->nq;
+    std::vector<loco::TScalar> qpos_batch;
+    batch->GatherQpos( qpos_batch );
+    ASSERT_EQ( qpos_batch.size(), num_envs * nq );
+    // Free-joint qpos = (x, y, z, qw, qx, qy, qz): the box falls in stepped environments only
+    EXPECT_LT( qpos_batch[0 * nq + 2], 1.0f );
+    EXPECT_FLOAT_EQ( qpos_batch[1 * nq + 2], 1.0f );
+    EXPECT_FLOAT_EQ( qpos_batch[0 * nq + 2], qpos_batch[2 * nq + 2] );
+
+    batch->Reset();
+    batch->GatherQpos( qpos_batch );
+    for ( ssize_t i = 0; i < num_envs; i++ )
+        EXPECT_FLOAT_EQ( qpos_batch[i * nq + 2], 1.0f );
+}
+
+TEST( TestLocoMujocoSimulation, TestMujocoThreadPoolWorkStealing )
+{
+    const ssize_t num_workers = 4;
+    const ssize_t num_tasks = 64;
+    auto thread_pool = std::make_unique<loco::mujoco::TMujocoThreadPool>( num_workers );
+    std::vector<std::atomic<ssize_t>> num_runs( num_tasks );
+    for ( auto& num_run : num_runs )
+        num_run = 0;
+
+    // Only the first quarter of the batch is expensive, i.e. the initial share of worker 0
+    thread_pool->ParallelFor( num_tasks, [&]( ssize_t task_id )
+        {
+            if ( task_id < num_tasks / num_workers )
+                std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
+            num_runs[task_id]++;
+        } );
+    for ( ssize_t i = 0; i < num_tasks; i++ )
+        EXPECT_EQ( num_runs[i], 1 );
+
+    // Idle workers steal the expensive chunks, so the busy-time ends up balanced (without stealing,
+    // worker 0 would be busy for the whole batch while the others are almost idle)
+    const auto workers_stats = thread_pool->GetWorkerStats();
+    ASSERT_EQ( workers_stats.size(), num_workers );
+    ssize_t total_tasks = 0, total_steals = 0;
+    double total_busy_time_ms = 0.0, max_busy_time_ms = 0.0;
+    for ( const auto& worker_stats : workers_stats )
+    {
+        total_tasks += worker_stats.num_tasks;
+        total_steals += worker_stats.num_steals;
+        total_busy_time_ms += worker_stats.busy_time_ms;
+        max_busy_time_ms = std::max( max_busy_time_ms, worker_stats.busy_time_ms );
+        EXPECT_GT( worker_stats.utilization, 0.0 );
+        EXPECT_LE( worker_stats.utilization, 1.0 );
+    }
+    EXPECT_EQ( total_tasks, num_tasks );
+    EXPECT_GT( total_steals, 0 );
+    EXPECT_LT( workers_stats[0].num_tasks, num_tasks / num_workers );
+    EXPECT_LT( max_busy_time_ms, 2.0 * total_busy_time_ms / num_workers );
+
+    // Batches run inline (single task) are accounted too
+    thread_pool->ResetStats();
+    thread_pool->ParallelFor( 1, [&]( ssize_t task_id ) { std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) ); } );
+    EXPECT_EQ( thread_pool->GetWorkerStats()[0].num_tasks, 1 );
+    EXPECT_GT( thread_pool->batches_wall_time_ms(), 0.0 );
+    EXPECT_DOUBLE_EQ( thread_pool->GetWorkerStats()[0].utilization, 1.0 );
+}
+
+TEST( TestLocoMujocoSimulation, TestMujocoSimulationSaveRestoreState )
+{
+    auto scenario = std::make_unique<loco::TScenario>();
+    auto box_data = create_box_data();
+    scenario->AddSingleBody( std::make_unique<loco::primitives::TSingleBody>( "box", box_data, tinymath::Vector3f( 0.0, 0.0, 1.0 ), tinymath::Matrix3f() ) );
+
+    auto simulation = std::make_unique<loco::TMujocoSimulation>( scenario.get() );
+    simulation->SetStateRingCapacity( 2 );
+    ASSERT_TRUE( simulation->Initialize() );
+    for ( ssize_t i = 0; i < 10; i++ )
+        simulation->Step();
+
+    const ssize_t checkpoint_id = simulation->SaveState();
+    const std::vector<mjtNum> qpos_saved( simulation->mjc_data()->qpos, simulation->mjc_data()->qpos + simulation->mjc_model()->nq );
+    const mjtNum time_saved = simulation->mjc_data()->time;
+    for ( ssize_t i = 0; i < 10; i++ )
+        simulation->Step();
+    EXPECT_NE( simulation->mjc_data()->qpos[2], qpos_saved[2] );
+
+    ASSERT_TRUE( simulation->RestoreState( checkpoint_id ) );
+    EXPECT_DOUBLE_EQ( simulation->mjc_data()->time, time_saved );
+    for ( ssize_t i = 0; i < simulation->mjc_model()->nq; i++ )
+        EXPECT_DOUBLE_EQ( simulation->mjc_data()->qpos[i], qpos_saved[i] );
+
+    // Checkpoints older than the ring's capacity are overwritten, and can't be restored anymore
+    simulation->SaveState();
+    simulation->SaveState();
+    EXPECT_FALSE( simulation->RestoreState( checkpoint_id ) );
+    EXPECT_TRUE( simulation->RestoreState() );
+}
+
+TEST( TestLocoMujocoSimulation, TestMujocoSimulationBulkReset )
+{
+    auto scenario = std::make_unique<loco::TScenario>();
+    auto box_data = create_box_data();
+    scenario->AddSingleBody( std::make_unique<loco::primitives::TSingleBody>( "box", box_data, tinymath::Vector3f( 0.0, 0.0, 1.0 ), tinymath::Matrix3f() ) );
+
+    auto simulation = std::make_unique<loco::TMujocoSimulation>( scenario.get() );
+    ASSERT_TRUE( simulation->Initialize() );
+    ASSERT_TRUE( simulation->bulk_reset_enabled() );
+
+    // First reset goes through the adapters (and takes the image), following ones restore the image
+    for ( ssize_t k = 0; k < 3; k++ )
+    {
+        for ( ssize_t i = 0; i < 20; i++ )
+            simulation->Step();
+        EXPECT_LT( simulation->mjc_data()->qpos[2], 1.0 );
+        simulation->Reset();
+        EXPECT_DOUBLE_EQ( simulation->mjc_data()->qpos[2], 1.0 );
+        EXPECT_DOUBLE_EQ( simulation->mjc_data()->qvel[2], 0.0 );
+        EXPECT_DOUBLE_EQ( simulation->mjc_data()->time, 0.0 );
+    }
+}
+
+TEST( TestLocoMujocoSimulation, TestMujocoSimulationSubsteps )
+{
+    auto scenario = std::make_unique<loco::TScenario>();
+    auto box_data = create_box_data();
+    scenario->AddSingleBody( std::make_unique<loco::primitives::TSingleBody>( "box", box_data, tinymath::Vector3f( 0.0, 0.0, 1.0 ), tinymath::Matrix3f() ) );
+
+    auto simulation = std::make_unique<loco::TMujocoSimulation>( scenario.get() );
+    ASSERT_TRUE( simulation->Initialize() );
+    const mjtNum time_step = simulation->mjc_model()->opt.timestep;
+
+    // Without explicit substeps, the number of physics steps is derived from dt (and is always the same)
+    simulation->Step( 10 * time_step );
+    EXPECT_NEAR( simulation->mjc_data()->time, 10 * time_step, 1e-9 );
+
+    // Explicit frameskip: every control period takes exactly num_substeps physics steps
+    simulation->SetNumSubsteps( 4 );
+    const mjtNum time_start = simulation->mjc_data()->time;
+    simulation->StepN( 5 );
+    EXPECT_NEAR( simulation->mjc_data()->time - time_start, 20 * time_step, 1e-9 );
+}
+
+TEST( TestLocoMujocoSimulation, TestMujocoSimulationSplitPhaseStep )
+{
+    auto scenario = std::make_unique<loco::TScenario>();
+    auto box_data = create_box_data();
+    scenario->AddSingleBody( std::make_unique<loco::primitives::TSingleBody>( "box", box_data, tinymath::Vector3f( 0.0, 0.0, 1.0 ), tinymath::Matrix3f() ) );
+
+    auto simulation = std::make_unique<loco::TMujocoSimulation>( scenario.get() );
+    ASSERT_TRUE( simulation->Initialize() );
+
+    // A split-phase step must match a regular step (default integrator is Euler)
+    const ssize_t checkpoint_id = simulation->SaveState();
+    simulation->Step();
+    const std::vector<mjtNum> qpos_step( simulation->mjc_data()->qpos, simulation->mjc_data()->qpos + simulation->mjc_model()->nq );
+
+    ASSERT_TRUE( simulation->RestoreState( checkpoint_id ) );
+    simulation->StepPhase1();
+    EXPECT_TRUE( simulation->step_phase1_done() );
+    simulation->StepPhase2();
+    EXPECT_FALSE( simulation->step_phase1_done() );
+    for ( ssize_t i = 0; i < simulation->mjc_model()->nq; i++ )
+        EXPECT_DOUBLE_EQ( simulation->mjc_data()->qpos[i], qpos_step[i] );
+
+    // Overwriting the state in between phases discards the pending phase-1 (it's stale)
+    simulation->StepPhase1();
+    ASSERT_TRUE( simulation->RestoreState( checkpoint_id ) );
+    EXPECT_FALSE( simulation->step_phase1_done() );
+    simulation->StepPhase1();
+    simulation->Reset();
+    EXPECT_FALSE( simulation->step_phase1_done() );
+}
+
+TEST( TestLocoMujocoSimulation, TestMujocoSimulationAsyncStepping )
+{
+    auto scenario = std::make_unique<loco::TScenario>();
+    auto box_data = create_box_data();
+    scenario->AddSingleBody( std::make_unique<loco::primitives::TSingleBody>( "box", box_data, tinymath::Vector3f( 0.0, 0.0, 1.0 ), tinymath::Matrix3f() ) );
+
+    auto simulation = std::make_unique<loco::TMujocoSimulation>( scenario.get() );
+    ASSERT_TRUE( simulation->Initialize() );
+    simulation->StartAsync( 4 );
+    ASSERT_TRUE( simulation->async_running() );
+
+    auto snapshot_0 = simulation->AcquireSnapshot();
+    ASSERT_TRUE( snapshot_0.valid() );
+    EXPECT_EQ( snapshot_0->step_id, 0 );
+    const mjtNum height_0 = snapshot_0->qpos[2];
+
+    std::vector<std::future<void>> requests;
+    for ( ssize_t i = 0; i < 10; i++ )
+        requests.push_back( simulation->StepAsync() );
+    for ( auto& request : requests )
+        request.get();
+
+    // Snapshots handed out before are immutable, newer ones reflect the steps taken
+    auto snapshot_1 = simulation->AcquireSnapshot();
+    EXPECT_EQ( snapshot_0->step_id, 0 );
+    EXPECT_DOUBLE_EQ( snapshot_0->qpos[2], height_0 );
+    EXPECT_EQ( snapshot_1->step_id, 10 );
+    EXPECT_LT( snapshot_1->qpos[2], height_0 );
+
+    // Synchronous entry-points are refused while the stepping thread owns mjData
+    const mjtNum time_async = simulation->mjc_data()->time;
+    simulation->Step();
+    simulation->StepN( 2 );
+    simulation->StepPhase1();
+    simulation->Reset();
+    EXPECT_FALSE( simulation->step_phase1_done() );
+    EXPECT_EQ( simulation->SaveState(), -1 );
+    EXPECT_FALSE( simulation->RestoreState() );
+    char dirpath[] = "/tmp/loco_async_XXXXXX";
+    ASSERT_TRUE( mkdtemp( dirpath ) != nullptr );
+    const std::string refused_filepath = std::string( dirpath ) + "/refused.bin";
+    EXPECT_FALSE( simulation->StartRecording( refused_filepath ) );
+    EXPECT_NE( access( refused_filepath.c_str(), F_OK ), 0 );
+    remove_tmp_directory( dirpath );
+    EXPECT_DOUBLE_EQ( simulation->mjc_data()->time, time_async );
+
+    // Handles keep their snapshots alive (and readable) after the stepper is gone
+    snapshot_0.Release();
+    simulation->StopAsync();
+    EXPECT_FALSE( simulation->async_running() );
+    EXPECT_EQ( snapshot_1->step_id, 10 );
+    snapshot_1.Release();
+    EXPECT_FALSE( snapshot_1.valid() );
+
+    simulation->Step();
+    EXPECT_GT( simulation->mjc_data()->time, time_async );
+}
+
+#if defined( __linux__ )
+TEST( TestLocoMujocoSimulation, TestMujocoShmServerRoundTrip )
+{
+    auto scenario = std::make_unique<loco::TScenario>();
+    auto box_data = create_box_data();
+    scenario->AddSingleBody( std::make_unique<loco::primitives::TSingleBody>( "box", box_data, tinymath::Vector3f( 0.0, 0.0, 1.0 ), tinymath::Matrix3f() ) );
+
+    auto simulation = std::make_unique<loco::TMujocoSimulation>( scenario.get() );
+    ASSERT_TRUE( simulation->Initialize() );
+    const ssize_t nq = simulation->mjc_model()->nq;
+    const std::string shm_name = "/loco_test_shm_" + std::to_string( getpid() );
+
+    // Stale object (e.g. left by a crashed server) is replaced instead of being reused as is
+    const int stale_fd = shm_open( shm_name.c_str(), O_CREAT | O_RDWR, 0600 );
+    ASSERT_GE( stale_fd, 0 );
+    ASSERT_EQ( ftruncate( stale_fd, 64 ), 0 );
+    close( stale_fd );
+
+    auto server = std::make_unique<loco::mujoco::TMujocoShmServer>( simulation.get(), shm_name );
+    ASSERT_TRUE( server->Start() );
+    // Whereas an object served by a running process is never taken over
+    auto server_duplicate = std::make_unique<loco::mujoco::TMujocoShmServer>( simulation.get(), shm_name );
+    EXPECT_FALSE( server_duplicate->Start() );
+
+    std::thread server_thread( [&]() { server->Serve(); } );
+    auto client = std::make_unique<loco::mujoco::TMujocoShmClient>( shm_name );
+    ASSERT_TRUE( client->Connect() );
+    ASSERT_EQ( client->nq(), nq );
+    EXPECT_DOUBLE_EQ( client->qpos()[2], 1.0 );
+
+    for ( ssize_t i = 0; i < 10; i++ )
+        EXPECT_TRUE( client->Step() );
+    EXPECT_LT( client->qpos()[2], 1.0 );
+    EXPECT_GT( client->time(), 0.0 );
+    EXPECT_TRUE( client->Reset() );
+    EXPECT_DOUBLE_EQ( client->qpos()[2], 1.0 );
+    EXPECT_TRUE( client->Close() );
+    server_thread.join();
+
+    // Nobody answers anymore (server stopped serving), so requests time out instead of blocking forever
+    client->SetRequestTimeout( 50 );
+    EXPECT_FALSE( client->Step() );
+    // The server still answers that late request, but gives up on requests that never arrive
+    EXPECT_TRUE( server->ServeOnce() );
+    server->SetRequestTimeout( 50 );
+    EXPECT_FALSE( server->ServeOnce() );
+
+    // Only one client at a time, until it goes away (a client that dies also stops the server from waiting on it)
+    const pid_t other_pid = fork();
+    ASSERT_GE( other_pid, 0 );
+    if ( other_pid == 0 )
+        _exit( loco::mujoco::TMujocoShmClient( shm_name ).Connect() ? 1 : 0 );
+    int other_status = -1;
+    ASSERT_EQ( waitpid( other_pid, &other_status, 0 ), other_pid );
+    EXPECT_EQ( WEXITSTATUS( other_status ), 0 );
+
+    client = nullptr;
+    const pid_t dying_pid = fork();
+    ASSERT_GE( dying_pid, 0 );
+    if ( dying_pid == 0 )
+    {
+        loco::mujoco::TMujocoShmClient dying_client( shm_name );
+        _exit( dying_client.Connect() ? 0 : 1 );
+    }
+    int dying_status = -1;
+    ASSERT_EQ( waitpid( dying_pid, &dying_status, 0 ), dying_pid );
+    EXPECT_EQ( WEXITSTATUS( dying_status ), 0 );
+    server->SetRequestTimeout( -1 );
+    EXPECT_FALSE( server->ServeOnce() );
+}
+#endif /* __linux__ */
+
+TEST( TestLocoMujocoSimulation, TestMujocoSimulationTrajectoryRecording )
+{
+    auto scenario = std::make_unique<loco::TScenario>();
+    auto box_data = create_box_data();
+    scenario->AddSingleBody( std::make_unique<loco::primitives::TSingleBody>( "box", box_data, tinymath::Vector3f( 0.0, 0.0, 1.0 ), tinymath::Matrix3f() ) );
+
+    auto simulation = std::make_unique<loco::TMujocoSimulation>( scenario.get() );
+    ASSERT_TRUE( simulation->Initialize() );
+
+    char dirpath[] = "/tmp/loco_trajectory_XXXXXX";
+    ASSERT_TRUE( mkdtemp( dirpath ) != nullptr );
+    const std::string filepath = std::string( dirpath ) + "/trajectory.bin";
+    ASSERT_TRUE( simulation->StartRecording( filepath, 8 ) );
+    std::vector<std::vector<mjtNum>> qpos_history;
+    for ( ssize_t i = 0; i < 50; i++ )
+    {
+        simulation->Step();
+        qpos_history.push_back( std::vector<mjtNum>( simulation->mjc_data()->qpos, simulation->mjc_data()->qpos + simulation->mjc_model()->nq ) );
+    }
+    simulation->StopRecording();
+
+    // Initial state plus one record per step, with records read in place and states recovered from keyframes
+    loco::mujoco::TMujocoTrajectoryReader reader;
+    ASSERT_TRUE( reader.Open( filepath ) );
+    ASSERT_EQ( reader.num_records(), 51 );
+    EXPECT_EQ( reader.num_keyframes(), 7 );
+    EXPECT_DOUBLE_EQ( reader.record_qpos( 30 )[2], qpos_history[29][2] );
+
+    std::unique_ptr<mjData, loco::mujoco::MjcDataDeleter> mjc_data( mj_makeData( simulation->mjc_model() ) );
+    ASSERT_TRUE( reader.RestoreState( simulation->mjc_model(), mjc_data.get(), 45 ) );
+    for ( ssize_t i = 0; i < simulation->mjc_model()->nq; i++ )
+        EXPECT_DOUBLE_EQ( mjc_data->qpos[i], qpos_history[44][i] );
+    reader.Close();
+
+    // A reset while recording forces a keyframe on the next record, so states after it aren't replayed across the jump
+    simulation->Reset();
+    qpos_history.clear();
+    ASSERT_TRUE( simulation->StartRecording( filepath, 8 ) );
+    for ( ssize_t i = 0; i < 30; i++ )
+    {
+        if ( i == 20 )
+            simulation->Reset();
+        simulation->Step();
+        qpos_history.push_back( std::vector<mjtNum>( simulation->mjc_data()->qpos, simulation->mjc_data()->qpos + simulation->mjc_model()->nq ) );
+    }
+    simulation->StopRecording();
+
+    // Keyframes at records 0, 8, 16, 21 (forced by the reset) and 29
+    ASSERT_TRUE( reader.Open( filepath ) );
+    ASSERT_EQ( reader.num_records(), 31 );
+    EXPECT_EQ( reader.num_keyframes(), 5 );
+    for ( ssize_t record_id : { 20, 21, 25 } )
+    {
+        ASSERT_TRUE( reader.RestoreState( simulation->mjc_model(), mjc_data.get(), record_id ) );
+        for ( ssize_t i = 0; i < simulation->mjc_model()->nq; i++ )
+            EXPECT_DOUBLE_EQ( mjc_data->qpos[i], qpos_history[record_id - 1][i] );
+    }
+
+    reader.Close();
+    remove_tmp_directory( dirpath );
+}
+
+TEST( TestLocoMujocoSimulation, TestMujocoSimulationReplay )
+{
+    auto scenario = std::make_unique<loco::TScenario>();
+    auto box_data = create_box_data();
+    auto box_ref = scenario->AddSingleBody( std::make_unique<loco::primitives::TSingleBody>( "box", box_data, tinymath::Vector3f( 0.0, 0.0, 1.0 ), tinymath::Matrix3f() ) );
+
+    auto simulation = std::make_unique<loco::TMujocoSimulation>( scenario.get() );
+    ASSERT_TRUE( simulation->Initialize() );
+
+    char dirpath[] = "/tmp/loco_replay_XXXXXX";
+    ASSERT_TRUE( mkdtemp( dirpath ) != nullptr );
+    const std::string filepath = std::string( dirpath ) + "/replay.bin";
+    ASSERT_TRUE( simulation->StartRecording( filepath ) );
+    std::vector<mjtNum> height_history;
+    for ( ssize_t i = 0; i < 20; i++ )
+    {
+        simulation->Step();
+        height_history.push_back( simulation->mjc_data()->qpos[2] );
+    }
+    simulation->StopRecording();
+    const mjtNum height_before_replay = simulation->mjc_data()->qpos[2];
+
+    // Seeking (and stepping) load the recorded positions, and bodies report the recorded transforms
+    ASSERT_TRUE( simulation->StartReplay( filepath ) );
+    ASSERT_TRUE( simulation->ReplaySeek( 10 ) );
+    EXPECT_EQ( simulation->replay_record_id(), 10 );
+    EXPECT_NEAR( box_ref->pos().z(), height_history[9], 1e-5 );
+    simulation->Step();
+    EXPECT_EQ( simulation->replay_record_id(), 11 );
+    EXPECT_NEAR( box_ref->pos().z(), height_history[10], 1e-5 );
+    EXPECT_FALSE( simulation->ReplaySeek( 100 ) );
+
+    simulation->StopReplay();
+    EXPECT_FALSE( simulation->replaying() );
+    EXPECT_DOUBLE_EQ( simulation->mjc_data()->qpos[2], height_before_replay );
+
+    remove_tmp_directory( dirpath );
+}
+
+TEST( TestLocoMujocoSimulation, TestMujocoSimulationStreamingTerrain )
+{
+    auto scenario = std::make_unique<loco::TScenario>();
+    auto generator = []( const loco::mujoco::TMujocoTerrainTile& tile, std::vector<float>& dst_heights )
+        {
+            for ( ssize_t i = 0; i < tile.num_samples; i++ )
+                for ( ssize_t j = 0; j < tile.num_samples; j++ )
+                    dst_heights[i * tile.num_samples + j] = 1.0f + 0.1f * std::sin( tile.x_min + j * tile.sample_spacing );
+        };
+    auto terrain = std::make_unique<loco::mujoco::TMujocoStreamingTerrain>( scenario.get(), "ground", 3, 4.0f, 9, 0.5f, generator );
+    EXPECT_EQ( terrain->num_tiles_streamed(), 9 );
+
+    auto simulation = std::make_unique<loco::TMujocoSimulation>( scenario.get() );
+    ASSERT_TRUE( simulation->Initialize() );
+    ASSERT_TRUE( terrain->Initialize() );
+    // The compiled model holds only the tiles of the window
+    EXPECT_EQ( simulation->mjc_model()->nhfield, 9 );
+
+    // Small motions within the center-tile (plus margin) don't recycle anything
+    terrain->Update( { 2.5f, 0.0f, 0.0f } );
+    EXPECT_EQ( terrain->num_tiles_streamed(), 9 );
+
+    // Moving into the next tile recycles only the column of tiles that left the window
+    terrain->Update( { 5.0f, 0.0f, 0.0f } );
+    EXPECT_EQ( terrain->center_ix(), 1 );
+    EXPECT_EQ( terrain->num_tiles_streamed(), 12 );
+    ssize_t num_new_column_tiles = 0;
+    for ( ssize_t i = 0; i < 9; i++ )
+        num_new_column_tiles += ( terrain->slot_tile( i ).ix == 2 ) ? 1 : 0;
+    EXPECT_EQ( num_new_column_tiles, 3 );
+    EXPECT_EQ( simulation->mjc_model()->nhfield, 9 );
+
+    // Resets don't restore the streamed heights, so every tile must stay where its heights were streamed for
+    simulation->Reset();
+    for ( ssize_t i = 0; i < 9; i++ )
+    {
+        auto tile_body = scenario->GetSingleBodyByName( loco::mujoco::LOCO_MUJOCO_STREAMING_TERRAIN_TILE_PREFIX + "ground_" + std::to_string( i ) );
+        auto tile_collider_adapter = dynamic_cast<loco::primitives::TMujocoSingleBodyColliderAdapter*>( tile_body->collider()->collider_adapter() );
+        const ssize_t geom_id = tile_collider_adapter->mjc_geom_id();
+        EXPECT_NEAR( simulation->mjc_model()->geom_pos[3 * geom_id + 0], terrain->slot_tile( i ).ix * 4.0, 1e-5 );
+        EXPECT_NEAR( simulation->mjc_model()->geom_pos[3 * geom_id + 1], terrain->slot_tile( i ).iy * 4.0, 1e-5 );
+    }
+}
+
+TEST( TestLocoMujocoSimulation, TestMujocoSimulationStreamingTerrainTallTile )
+{
+    auto scenario = std::make_unique<loco::TScenario>();
+    auto generator = []( const loco::mujoco::TMujocoTerrainTile& tile, std::vector<float>& dst_heights )
+        {
+            std::fill( dst_heights.begin(), dst_heights.end(), ( tile.ix >= 2 ) ? 10.0f : 1.0f );
+        };
+    auto terrain = std::make_unique<loco::mujoco::TMujocoStreamingTerrain>( scenario.get(), "ground", 3, 4.0f, 9, 0.5f, generator );
+    // Resting just above the tall tile, which is far outside the bounding radius of the compiled (low) tiles
+    auto box_data = create_box_data();
+    auto box_ref = scenario->AddSingleBody( std::make_unique<loco::primitives::TSingleBody>( "box", box_data, tinymath::Vector3f( 8.0, 0.0, 5.2 ), tinymath::Matrix3f() ) );
+
+    auto simulation = std::make_unique<loco::TMujocoSimulation>( scenario.get() );
+    ASSERT_TRUE( simulation->Initialize() );
+    ASSERT_TRUE( terrain->Initialize() );
+    terrain->Update( { 5.0f, 0.0f, 0.0f } );
+    ASSERT_EQ( terrain->center_ix(), 1 );
+
+    // The recycled tile is taller than any compiled one, yet the box still lands on it instead of falling through
+    for ( ssize_t i = 0; i < 200; i++ )
+        simulation->Step();
+    EXPECT_GT( simulation->mjc_data()->ncon, 0 );
+    EXPECT_NEAR( box_ref->pos().z(), 5.1, 0.05 );
+}
+
+TEST( TestLocoMujocoSimulation, TestMujocoSimulationRebuildAsync )
+{
+    auto scenario = std::make_unique<loco::TScenario>();
+    auto box_data = create_box_data();
+    scenario->AddSingleBody( std::make_unique<loco::primitives::TSingleBody>( "box_0", box_data, tinymath::Vector3f( 0.0, 0.0, 1.0 ), tinymath::Matrix3f() ) );
+    auto kintree = std::make_unique<loco::kintree::TKinematicTree>( "tree_0", tinymath::Vector3f( 2.0, 0.0, 1.0 ), tinymath::Matrix3f() );
+    auto kintree_root = std::make_unique<loco::kintree::TKinematicTreeBody>( "tree_0_root", loco::kintree::TKinematicTreeBodyData() );
+    kintree_root->SetCollider( std::make_unique<loco::kintree::TKinematicTreeBoxCollider>( "tree_0_root_col", tinymath::Vector3f( 0.2, 0.2, 0.2 ) ), loco::TMat4() );
+    kintree_root->SetJoint( std::make_unique<loco::kintree::TKinematicTreeFreeJoint>( "tree_0_root_jnt" ), loco::TMat4() );
+    kintree->SetRoot( std::move( kintree_root ) );
+    auto kintree_ref = scenario->AddKinematicTree( std::move( kintree ) );
+
+    auto simulation = std::make_unique<loco::TMujocoSimulation>( scenario.get() );
+    ASSERT_TRUE( simulation->Initialize() );
+    for ( ssize_t i = 0; i < 10; i++ )
+        simulation->Step();
+    const ssize_t num_bodies_before = simulation->mjc_model()->nbody;
+
+    // The current model keeps stepping while the one with the new body is compiled
+    scenario->AddSingleBody( std::make_unique<loco::primitives::TSingleBody>( "box_1", box_data, tinymath::Vector3f( 1.0, 0.0, 1.0 ), tinymath::Matrix3f() ) );
+    ASSERT_TRUE( simulation->RebuildAsync() );
+    EXPECT_TRUE( simulation->rebuild_pending() );
+    EXPECT_FALSE( simulation->RebuildAsync() );
+    // Running asynchronously or recording would straddle the swap, so both are refused until it happens
+    simulation->StartAsync();
+    EXPECT_FALSE( simulation->async_running() );
+    char dirpath[] = "/tmp/loco_rebuild_XXXXXX";
+    ASSERT_TRUE( mkdtemp( dirpath ) != nullptr );
+    const std::string refused_filepath = std::string( dirpath ) + "/refused.bin";
+    EXPECT_FALSE( simulation->StartRecording( refused_filepath ) );
+    EXPECT_NE( access( refused_filepath.c_str(), F_OK ), 0 );
+    remove_tmp_directory( dirpath );
+    EXPECT_FALSE( simulation->recording() );
+    simulation->Step();
+    auto kintree_adapter = static_cast<loco::kintree::TMujocoKinematicTreeAdapter*>( kintree_ref->adapter() );
+    const ssize_t kintree_qposadr_before_swap = kintree_adapter->mjc_root_joint_qpos_adr();
+    const mjtNum height_before_swap = simulation->mjc_data()->qpos[2];
+    const mjtNum kintree_height_before_swap = simulation->mjc_data()->qpos[kintree_qposadr_before_swap + 2];
+    const mjtNum time_before_swap = simulation->mjc_data()->time;
+    ASSERT_TRUE( simulation->WaitRebuild() );
+    EXPECT_FALSE( simulation->rebuild_pending() );
+
+    // Existing objects carry their state over into the rebuilt model, new ones start at their initial conditions
+    EXPECT_EQ( simulation->mjc_model()->nbody, num_bodies_before + 1 );
+    EXPECT_DOUBLE_EQ( simulation->mjc_data()->time, time_before_swap );
+    auto box_0 = static_cast<loco::primitives::TMujocoSingleBodyAdapter*>( scenario->GetSingleBodyByName( "box_0" )->adapter() );
+    auto box_1 = static_cast<loco::primitives::TMujocoSingleBodyAdapter*>( scenario->GetSingleBodyByName( "box_1" )->adapter() );
+    ASSERT_NE( box_1, nullptr );
+    EXPECT_DOUBLE_EQ( simulation->mjc_data()->qpos[box_0->mjc_joint_qpos_adr() + 2], height_before_swap );
+    EXPECT_DOUBLE_EQ( simulation->mjc_data()->qpos[box_1->mjc_joint_qpos_adr() + 2], 1.0 );
+    // The kintree adapter is re-linked against the rebuilt model, and its root keeps its state
+    EXPECT_EQ( kintree_ref->adapter(), kintree_adapter );
+    EXPECT_EQ( kintree_adapter->mjc_model(), simulation->mjc_model() );
+    EXPECT_EQ( kintree_adapter->mjc_data(), simulation->mjc_data() );
+    EXPECT_EQ( kintree_adapter->mjc_root_body_id(), mj_name2id( simulation->mjc_model(), mjOBJ_BODY, "tree_0_root" ) );
+    const ssize_t kintree_root_joint_id = mj_name2id( simulation->mjc_model(), mjOBJ_JOINT, "tree_0_root_jnt" );
+    ASSERT_GE( kintree_root_joint_id, 0 );
+    EXPECT_EQ( kintree_adapter->mjc_root_joint_qpos_adr(), simulation->mjc_model()->jnt_qposadr[kintree_root_joint_id] );
+    EXPECT_DOUBLE_EQ( simulation->mjc_data()->qpos[kintree_adapter->mjc_root_joint_qpos_adr() + 2], kintree_height_before_swap );
+    EXPECT_LT( kintree_height_before_swap, 1.0 );
+    simulation->Step();
+}
+
+TEST( TestLocoMujocoSimulation, TestMujocoSimulationClone )
+{
+    auto create_scenario = []()
+        {
+            auto scenario = std::make_unique<loco::TScenario>();
+            auto box_data = create_box_data();
+            scenario->AddSingleBody( std::make_unique<loco::primitives::TSingleBody>( "box", box_data, tinymath::Vector3f( 0.0, 0.0, 1.0 ), tinymath::Matrix3f() ) );
+            return scenario;
+        };
+
+    auto scenario = create_scenario();
+    auto simulation = std::make_unique<loco::TMujocoSimulation>( scenario.get() );
+    ASSERT_TRUE( simulation->Initialize() );
+    for ( ssize_t i = 0; i < 10; i++ )
+        simulation->Step();
+
+    // The clone shares the compiled model, and starts from a copy of the state
+    auto scenario_clone = create_scenario();
+    auto simulation_clone = simulation->Clone( scenario_clone.get() );
+    ASSERT_NE( simulation_clone, nullptr );
+    EXPECT_EQ( simulation_clone->mjc_model(), simulation->mjc_model() );
+    EXPECT_TRUE( simulation->mjc_model_shared() );
+    EXPECT_NE( simulation_clone->mjc_data(), simulation->mjc_data() );
+    EXPECT_DOUBLE_EQ( simulation_clone->mjc_data()->time, simulation->mjc_data()->time );
+    for ( ssize_t i = 0; i < simulation->mjc_model()->nq; i++ )
+        EXPECT_DOUBLE_EQ( simulation_clone->mjc_data()->qpos[i], simulation->mjc_data()->qpos[i] );
+    auto box_adapter = dynamic_cast<loco::primitives::TMujocoSingleBodyAdapter*>( scenario->GetSingleBodyByName( "box" )->adapter() );
+    auto box_clone_adapter = dynamic_cast<loco::primitives::TMujocoSingleBodyAdapter*>( scenario_clone->GetSingleBodyByName( "box" )->adapter() );
+    ASSERT_NE( box_clone_adapter, nullptr );
+    EXPECT_EQ( box_clone_adapter->mjc_body_id(), box_adapter->mjc_body_id() );
+    EXPECT_EQ( box_clone_adapter->mjc_joint_qpos_adr(), box_adapter->mjc_joint_qpos_adr() );
+    EXPECT_EQ( box_clone_adapter->mjc_data(), simulation_clone->mjc_data() );
+
+    // Stepping the clone doesn't touch the original simulation
+    const mjtNum height_original = simulation->mjc_data()->qpos[2];
+    for ( ssize_t i = 0; i < 10; i++ )
+        simulation_clone->Step();
+    EXPECT_DOUBLE_EQ( simulation->mjc_data()->qpos[2], height_original );
+    EXPECT_LT( simulation_clone->mjc_data()->qpos[2], height_original );
+
+    // Changing model parameters on the clone gives it a private copy of the model first
+    simulation_clone->SetGravity( { 0.0, 0.0, -1.0 } );
+    EXPECT_NE( simulation_clone->mjc_model(), simulation->mjc_model() );
+    EXPECT_FALSE( simulation->mjc_model_shared() );
+    EXPECT_NEAR( simulation->mjc_model()->opt.gravity[2], -9.81, 1e-5 );
+    EXPECT_DOUBLE_EQ( simulation_clone->mjc_model()->opt.gravity[2], -1.0 );
+    EXPECT_EQ( box_clone_adapter->mjc_model(), simulation_clone->mjc_model() );
+}
+
+TEST( TestLocoMujocoSimulation, TestMujocoSimulationCloneCopyOnWrite )
+{
+    auto create_scenario = []()
+        {
+            auto scenario = std::make_unique<loco::TScenario>();
+            auto box_data = create_box_data();
+            scenario->AddSingleBody( std::make_unique<loco::primitives::TSingleBody>( "box", box_data, tinymath::Vector3f( 0.0, 0.0, 1.0 ), tinymath::Matrix3f() ) );
+            auto platform_data = box_data;
+            platform_data.dyntype = loco::eDynamicsType::STATIC;
+            platform_data.collision.size = { 1.0, 1.0, 0.1 };
+            platform_data.visual.size = { 1.0, 1.0, 0.1 };
+            scenario->AddSingleBody( std::make_unique<loco::primitives::TSingleBody>( "platform", platform_data, tinymath::Vector3f( 3.0, 0.0, 0.05 ), tinymath::Matrix3f() ) );
+            return scenario;
+        };
+
+    auto scenario = create_scenario();
+    auto simulation = std::make_unique<loco::TMujocoSimulation>( scenario.get() );
+    simulation->ReserveBodySlots( loco::eShapeType::SPHERE, { 0.1f, 0.1f, 0.1f }, 2 );
+    ASSERT_TRUE( simulation->Initialize() );
+    auto scenario_clone = create_scenario();
+    auto simulation_clone = simulation->Clone( scenario_clone.get() );
+    ASSERT_NE( simulation_clone, nullptr );
+    ASSERT_EQ( simulation_clone->mjc_model(), simulation->mjc_model() );
+    const mjModel* mjc_model_source = simulation->mjc_model();
+    const std::vector<mjtNum> geom_pos_source( mjc_model_source->geom_pos, mjc_model_source->geom_pos + 3 * mjc_model_source->ngeom );
+    const std::vector<mjtNum> geom_size_source( mjc_model_source->geom_size, mjc_model_source->geom_size + 3 * mjc_model_source->ngeom );
+
+    // Resetting the clone places static bodies and parked slots where they already are, so the model stays shared
+    for ( ssize_t i = 0; i < 10; i++ )
+        simulation_clone->Step();
+    simulation_clone->Reset();
+    EXPECT_EQ( simulation_clone->mjc_model(), simulation->mjc_model() );
+    EXPECT_TRUE( simulation->mjc_model_shared() );
+
+    // Resizing a collider of the clone writes into a private copy of the model, never into the source one
+    auto platform_clone_adapter = dynamic_cast<loco::primitives::TMujocoSingleBodyColliderAdapter*>(
+                                        scenario_clone->GetSingleBodyByName( "platform" )->collider()->collider_adapter() );
+    ASSERT_NE( platform_clone_adapter, nullptr );
+    const ssize_t platform_geom_id = platform_clone_adapter->mjc_geom_id();
+    platform_clone_adapter->ChangeSize( { 2.0, 2.0, 0.1 } );
+    EXPECT_NE( simulation_clone->mjc_model(), simulation->mjc_model() );
+    EXPECT_FALSE( simulation->mjc_model_shared() );
+    EXPECT_EQ( simulation->mjc_model(), mjc_model_source );
+    EXPECT_DOUBLE_EQ( simulation_clone->mjc_model()->geom_size[3 * platform_geom_id + 0], 1.0 );
+    for ( ssize_t i = 0; i < 3 * mjc_model_source->ngeom; i++ )
+    {
+        EXPECT_DOUBLE_EQ( mjc_model_source->geom_pos[i], geom_pos_source[i] );
+        EXPECT_DOUBLE_EQ( mjc_model_source->geom_size[i], geom_size_source[i] );
+    }
+
+    // Further resets of the clone keep writing only into its own copy
+    simulation_clone->Reset();
+    for ( ssize_t i = 0; i < 3 * mjc_model_source->ngeom; i++ )
+        EXPECT_DOUBLE_EQ( mjc_model_source->geom_size[i], geom_size_source[i] );
+    simulation->Step();
+}
+
+TEST( TestLocoMujocoSimulation, TestMujocoBatchSimulationEnvParams )
+{
+    auto scenario = std::make_unique<loco::TScenario>();
+    auto box_data = create_box_data();
+    scenario->AddSingleBody( std::make_unique<loco::primitives::TSingleBody>( "box", box_data, tinymath::Vector3f( 0.0, 0.0, 1.0 ), tinymath::Matrix3f() ) );
+
+    auto batch = std::make_unique<loco::TMujocoBatchSimulation>( scenario.get(), 2, 2 );
+    ASSERT_TRUE( batch->Initialize() );
+    const mjModel* shared_model = batch->mjc_model();
+    const ssize_t box_body_id = mj_name2id( shared_model, mjOBJ_BODY, "box" );
+    const ssize_t box_geom_id = shared_model->body_geomadr[box_body_id];
+    const double box_mass = shared_model->body_mass[box_body_id];
+    EXPECT_EQ( batch->env_model_num_bytes( 0 ), batch->env_model_num_bytes( 1 ) );
+
+    batch->SetGeomFriction( 0, box_geom_id, { 0.5, 0.01, 0.001 } );
+    batch->SetBodyMass( 0, box_body_id, 2.0 * box_mass );
+    batch->SetGeomSize( 0, box_geom_id, { 0.4, 0.4, 0.4 } );
+    // Only the parameters of environment 0 change, the shared model and other environments are untouched
+    EXPECT_DOUBLE_EQ( batch->env_mjc_model( 0 )->geom_friction[3 * box_geom_id], 0.5 );
+    EXPECT_DOUBLE_EQ( batch->env_mjc_model( 0 )->body_mass[box_body_id], 2.0 * box_mass );
+    EXPECT_DOUBLE_EQ( batch->env_mjc_model( 0 )->body_subtreemass[0], shared_model->body_subtreemass[0] + box_mass );
+    EXPECT_NEAR( batch->env_mjc_model( 0 )->geom_size[3 * box_geom_id], 0.2, 1e-5 );
+    EXPECT_DOUBLE_EQ( batch->env_mjc_model( 1 )->body_mass[box_body_id], box_mass );
+    EXPECT_DOUBLE_EQ( shared_model->body_mass[box_body_id], box_mass );
+    EXPECT_NEAR( shared_model->geom_size[3 * box_geom_id], 0.1, 1e-5 );
+    // Parameters that weren't set are still read from the shared model (no copy)
+    EXPECT_EQ( batch->env_mjc_model( 0 )->dof_damping, shared_model->dof_damping );
+    EXPECT_GT( batch->env_model_num_bytes( 0 ), batch->env_model_num_bytes( 1 ) );
+    EXPECT_LT( batch->env_model_num_bytes( 0 ), batch->shared_model_num_bytes() );
+
+    for ( ssize_t k = 0; k < 10; k++ )
+        batch->Step();
+
+    // Options changed on the shared model afterwards reach the views on the next step, keeping their overrides
+    batch->simulation()->SetGravity( { 0.0, 0.0, -1.0 } );
+    batch->Step();
+    EXPECT_DOUBLE_EQ( batch->env_mjc_model( 0 )->opt.gravity[2], -1.0 );
+    EXPECT_DOUBLE_EQ( batch->env_mjc_model( 1 )->opt.gravity[2], -1.0 );
+    EXPECT_DOUBLE_EQ( batch->env_mjc_model( 0 )->body_mass[box_body_id], 2.0 * box_mass );
+
+    mjModel* private_model = batch->MakeEnvModelPrivate( 1 );
+    ASSERT_NE( private_model, nullptr );
+    EXPECT_NE( private_model, shared_model );
+    EXPECT_EQ( batch->env_mjc_model( 1 ), private_model );
+    EXPECT_GE( batch->env_model_num_bytes( 1 ), batch->shared_model_num_bytes() );
+
+    batch->ClearEnvParams( 0 );
+    batch->ClearEnvParams( 1 );
+    EXPECT_DOUBLE_EQ( batch->env_mjc_model( 0 )->body_mass[box_body_id], box_mass );
+    EXPECT_EQ( batch->env_model_num_bytes( 0 ), batch->env_model_num_bytes( 1 ) );
+}
+
+TEST( TestLocoMujocoSimulation, TestMujocoBatchSimulationModelResized )
+{
+    auto scenario = std::make_unique<loco::TScenario>();
+    auto box_data = create_box_data();
+    scenario->AddSingleBody( std::make_unique<loco::primitives::TSingleBody>( "box_0", box_data, tinymath::Vector3f( 0.0, 0.0, 1.0 ), tinymath::Matrix3f() ) );
+
+    auto batch = std::make_unique<loco::TMujocoBatchSimulation>( scenario.get(), 3, 2 );
+    ASSERT_TRUE( batch->Initialize() );
+    const ssize_t nq_before = batch->mjc_model()->nq;
+    for ( ssize_t i = 0; i < 5; i++ )
+        batch->Step();
+
+    // Rebuilding the internal simulation resizes the shared model, so the environments' data can't be reused
+    scenario->AddSingleBody( std::make_unique<loco::primitives::TSingleBody>( "box_1", box_data, tinymath::Vector3f( 1.0, 0.0, 1.0 ), tinymath::Matrix3f() ) );
+    ASSERT_TRUE( batch->simulation()->RebuildAsync() );
+    ASSERT_TRUE( batch->simulation()->WaitRebuild() );
+    ASSERT_EQ( batch->mjc_model()->nq, nq_before + 7 );
+    std::vector<loco::TScalar> qpos_batch;
+    batch->GatherQpos( qpos_batch );
+    EXPECT_TRUE( qpos_batch.empty() );
+
+    // The next step re-creates them (from the internal simulation's state) before stepping the resized model
+    batch->Step();
+    batch->GatherQpos( qpos_batch );
+    ASSERT_EQ( qpos_batch.size(), 3 * ( nq_before + 7 ) );
+    auto box_1 = static_cast<loco::primitives::TMujocoSingleBodyAdapter*>( scenario->GetSingleBodyByName( "box_1" )->adapter() );
+    const ssize_t box_1_qposadr = box_1->mjc_joint_qpos_adr();
+    for ( ssize_t env_id = 0; env_id < 3; env_id++ )
+        EXPECT_LT( qpos_batch[env_id * ( nq_before + 7 ) + box_1_qposadr + 2], 1.0 );
 }
\ No newline at end of file
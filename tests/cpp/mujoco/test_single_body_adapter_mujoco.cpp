@@ -4,6 +4,7 @@
 
 #include <loco_simulation_mujoco.h>
 #include <primitives/loco_single_body_adapter_mujoco.h>
+#include <loco_body_slots_mujoco.h>
 
 TEST( TestLocoMujocoSingleBodyAdapter, TestLocoMujocoSingleBodyAdapterBuild )
 {
@@ -20,9 +21,9 @@ TEST( TestLocoMujocoSingleBodyAdapter, TestLocoMujocoSingleBodyAdapterBuild )
     plane_body_data.visual = plane_vis_data;
 
     const std::string plane_body_name = "floor";
-    auto plane_body_obj = std::make_unique<loco::TSingleBody>( plane_body_name, plane_body_data, loco::TVec3(), loco::TMat3() );
+    auto plane_body_obj = std::make_unique<loco::primitives::TSingleBody>( plane_body_name, plane_body_data, loco::TVec3(), loco::TMat3() );
     {
-        auto plane_body_adapter = std::make_unique<loco::mujoco::TMujocoSingleBodyAdapter>( plane_body_obj.get() );
+        auto plane_body_adapter = std::make_unique<loco::primitives::TMujocoSingleBodyAdapter>( plane_body_obj.get() );
         plane_body_adapter->Build();
         const std::string expected_name = "floor_col"; // static objects are geom-only, so add suffix _col
         const std::string expected_jnt_name = "floor_freejnt";
@@ -56,9 +57,9 @@ TEST( TestLocoMujocoSingleBodyAdapter, TestLocoMujocoSingleBodyAdapterBuild )
     const std::string box_body_name = "boxy";
     const loco::TVec3 box_body_position = { 1.0f, 2.0f, 3.0f };
     const loco::TVec4 box_body_quaternion = { 0.146f, 0.354f, 0.354f, 0.854f };
-    auto box_body_obj = std::make_unique<loco::TSingleBody>( box_body_name, box_body_data, box_body_position, tinymath::rotation( box_body_quaternion ) );
+    auto box_body_obj = std::make_unique<loco::primitives::TSingleBody>( box_body_name, box_body_data, box_body_position, tinymath::rotation( box_body_quaternion ) );
     {
-        auto box_body_adapter = std::make_unique<loco::mujoco::TMujocoSingleBodyAdapter>( box_body_obj.get() );
+        auto box_body_adapter = std::make_unique<loco::primitives::TMujocoSingleBodyAdapter>( box_body_obj.get() );
         box_body_adapter->Build();
         const std::string expected_name = "boxy";
         const std::string expected_jnt_name = "boxy_freejnt";
@@ -105,9 +106,9 @@ TEST( TestLocoMujocoSingleBodyAdapter, TestLocoMujocoSingleBodyAdapterBuild )
     const std::string mesh_body_name = "monkey_head";
     const loco::TVec3 mesh_body_position = { -1.0f, -2.0f, 3.0f };
     const loco::TVec4 mesh_body_quaternion = { 0.0f, 0.0f, 0.0f, 1.0f };
-    auto mesh_body_obj = std::make_unique<loco::TSingleBody>( mesh_body_name, mesh_body_data, mesh_body_position, tinymath::rotation( mesh_body_quaternion ) );
+    auto mesh_body_obj = std::make_unique<loco::primitives::TSingleBody>( mesh_body_name, mesh_body_data, mesh_body_position, tinymath::rotation( mesh_body_quaternion ) );
     {
-        auto mesh_body_adapter = std::make_unique<loco::mujoco::TMujocoSingleBodyAdapter>( mesh_body_obj.get() );
+        auto mesh_body_adapter = std::make_unique<loco::primitives::TMujocoSingleBodyAdapter>( mesh_body_obj.get() );
         mesh_body_adapter->Build();
         const std::string expected_name = "monkey_head";
         const std::string expected_jnt_name = "monkey_head_freejnt";
@@ -159,12 +160,12 @@ TEST( TestLocoMujocoSingleBodyAdapter, TestLocoMujocoSingleBodyAdapterBuild )
     const std::string sphere_body_name = "heavy_sphere";
     const loco::TVec3 sphere_body_position = { 0.0f, 0.0f, 3.0f };
     const loco::TVec4 sphere_body_quaternion = { 0.0f, 0.0f, 0.0f, 1.0f };
-    auto sphere_body_obj = std::make_unique<loco::TSingleBody>( sphere_body_name, sphere_body_data, sphere_body_position, tinymath::rotation( sphere_body_quaternion ) );
+    auto sphere_body_obj = std::make_unique<loco::primitives::TSingleBody>( sphere_body_name, sphere_body_data, sphere_body_position, tinymath::rotation( sphere_body_quaternion ) );
     {
-        auto sphere_body_adapter = std::make_unique<loco::mujoco::TMujocoSingleBodyAdapter>( sphere_body_obj.get() );
+        auto sphere_body_adapter = std::make_unique<loco::primitives::TMujocoSingleBodyAdapter>( sphere_body_obj.get() );
         sphere_body_adapter->Build(); // will call col's adapter Build method
         auto sphere_col_ref = sphere_body_obj->collider();
-        auto sphere_col_adapter = static_cast<loco::mujoco::TMujocoSingleBodyColliderAdapter*>( sphere_col_ref->collider_adapter() );
+        auto sphere_col_adapter = static_cast<loco::primitives::TMujocoSingleBodyColliderAdapter*>( sphere_col_ref->collider_adapter() );
         const std::string expected_name = "heavy_sphere";
         const std::string expected_jnt_name = "heavy_sphere_freejnt";
         const loco::TVec3 expected_pos = { 0.0f, 0.0f, 3.0f };
@@ -185,7 +186,7 @@ TEST( TestLocoMujocoSingleBodyAdapter, TestLocoMujocoSingleBodyAdapterBuild )
         EXPECT_EQ( joint_mjcf_resource->GetString( "name" ), expected_jnt_name );
         ASSERT_FALSE( mjcf_resources->HasChildOfType( "inertial" ) );
 
-        auto mjcf_col_resources = sphere_col_adapter->element_resources();
+        auto mjcf_col_resources = sphere_col_adapter->elements_resources()[0];
         ASSERT_TRUE( mjcf_col_resources != nullptr );
         EXPECT_TRUE( mjcf_col_resources->HasAttributeFloat( "density" ) );
         EXPECT_TRUE( std::abs( mjcf_col_resources->GetFloat( "density" ) - expected_density ) < 1e-5 );
@@ -199,7 +200,7 @@ TEST( TestLocoMujocoSingleBodyAdapter, TestLocoMujocoSingleBodyAdapterBuild )
     scenario->AddSingleBody( std::move( mesh_body_obj ) );
     scenario->AddSingleBody( std::move( sphere_body_obj ) );
 
-    auto simulation = std::make_unique<loco::mujoco::TMujocoSimulation>( scenario.get() );
+    auto simulation = std::make_unique<loco::TMujocoSimulation>( scenario.get() );
     simulation->Initialize();
 }
 
@@ -247,19 +248,19 @@ TEST( TestLocoMujocoSingleBodyAdapter, TestLocoMujocoSingleBodyAdapterInitialize
         body_data.dyntype = vec_dyntypes[i];
 
         const auto body_name = loco::mujoco::enumShape_to_mjcShape( vec_shape_types[i] ) + "_body";
-        auto body_obj = std::make_unique<loco::TSingleBody>( body_name, body_data, vec_positions[i], loco::TMat3() );
+        auto body_obj = std::make_unique<loco::primitives::TSingleBody>( body_name, body_data, vec_positions[i], loco::TMat3() );
 
         scenario->AddSingleBody( std::move( body_obj ) );
     }
 
-    auto simulation = std::make_unique<loco::mujoco::TMujocoSimulation>( scenario.get() );
+    auto simulation = std::make_unique<loco::TMujocoSimulation>( scenario.get() );
     simulation->Initialize();
 
     auto single_bodies_list = scenario->GetSingleBodiesList();
     for ( size_t i = 0; i < single_bodies_list.size(); i++ )
     {
         auto single_body = single_bodies_list[i];
-        auto single_body_adapter = dynamic_cast<loco::mujoco::TMujocoSingleBodyAdapter*>( single_body->adapter() );
+        auto single_body_adapter = dynamic_cast<loco::primitives::TMujocoSingleBodyAdapter*>( single_body->adapter() );
         ASSERT_TRUE( single_body_adapter != nullptr );
         EXPECT_TRUE( single_body_adapter->mjc_model() != nullptr );
         EXPECT_TRUE( single_body_adapter->mjc_data() != nullptr );
@@ -279,4 +280,172 @@ TEST( TestLocoMujocoSingleBodyAdapter, TestLocoMujocoSingleBodyAdapterInitialize
         EXPECT_EQ( single_body_adapter->mjc_joint_qpos_num(), num_qpos_freejoint );
         EXPECT_EQ( single_body_adapter->mjc_joint_qvel_num(), num_qvel_freejoint );
     }
+}
+
+TEST( TestLocoMujocoSingleBodyAdapter, TestLocoMujocoSingleBodyAdapterParkedSlots )
+{
+    loco::InitUtils();
+
+    auto create_body = []( const std::string& name, const loco::eShapeType& shape, const loco::TVec3& size, const loco::TVec3& position )
+        {
+            auto col_data = loco::TCollisionData();
+            col_data.type = shape;
+            col_data.size = size;
+            auto body_data = loco::TBodyData();
+            body_data.dyntype = loco::eDynamicsType::DYNAMIC;
+            body_data.collision = col_data;
+            body_data.visual.type = shape;
+            body_data.visual.size = size;
+            return std::make_unique<loco::primitives::TSingleBody>( name, body_data, position, loco::TMat3() );
+        };
+
+    auto scenario = std::make_unique<loco::TScenario>();
+    scenario->AddSingleBody( create_body( "box_0", loco::eShapeType::BOX, { 0.2f, 0.2f, 0.2f }, { 0.0f, 0.0f, 1.0f } ) );
+    scenario->AddSingleBody( create_body( "box_1", loco::eShapeType::BOX, { 0.2f, 0.2f, 0.2f }, { 1.0f, 0.0f, 1.0f } ) );
+    scenario->AddSingleBody( create_body( "box_2", loco::eShapeType::BOX, { 0.2f, 0.2f, 0.2f }, { 2.0f, 0.0f, 1.0f } ) );
+    auto simulation = std::make_unique<loco::TMujocoSimulation>( scenario.get() );
+    ASSERT_TRUE( simulation->Initialize() );
+    auto mjc_model = simulation->mjc_model();
+    auto mjc_data = simulation->mjc_data();
+    ASSERT_TRUE( simulation->mjc_body_slots() != nullptr );
+    EXPECT_EQ( simulation->mjc_body_slots()->num_slots(), 0 );
+
+    // Detached bodies are parked once, on the next step
+    scenario->RemoveSingleBodyByName( "box_0" );
+    scenario->RemoveSingleBodyByName( "box_1" );
+    simulation->Step();
+    auto body_slots = simulation->mjc_body_slots();
+    ASSERT_EQ( body_slots->num_slots(), 2 );
+    EXPECT_EQ( body_slots->num_free_slots(), 2 );
+
+    // Parked bodies don't collide, and stay at their rest-cell while the rest keeps being simulated
+    for ( ssize_t slot_id = 0; slot_id < 2; slot_id++ )
+    {
+        const auto& slot = body_slots->slot( slot_id );
+        EXPECT_EQ( mjc_model->geom_contype[slot.geom_id], 0 );
+        EXPECT_EQ( mjc_model->geom_conaffinity[slot.geom_id], 0 );
+    }
+    const auto& parked_slot = body_slots->slot( 1 );
+    const std::vector<mjtNum> qpos_parked( mjc_data->qpos + parked_slot.qpos_adr, mjc_data->qpos + parked_slot.qpos_adr + 7 );
+    for ( ssize_t i = 0; i < 20; i++ )
+        simulation->Step();
+    EXPECT_EQ( body_slots->num_slots(), 2 );
+    for ( ssize_t i = 0; i < 7; i++ )
+        EXPECT_NEAR( mjc_data->qpos[parked_slot.qpos_adr + i], qpos_parked[i], 1e-6 );
+
+    // Only bodies with the same shape can reuse a slot
+    EXPECT_TRUE( simulation->SpawnSingleBody( create_body( "sphere_spawned", loco::eShapeType::SPHERE, { 0.1f, 0.1f, 0.1f }, { 0.0f, 2.0f, 1.0f } ) ) == nullptr );
+    EXPECT_FALSE( scenario->HasSingleBodyNamed( "sphere_spawned" ) );
+
+    // Spawned bodies are written into a parked slot in place (size, mass and pose), without recompiling the model
+    auto box_spawned = simulation->SpawnSingleBody( create_body( "box_spawned", loco::eShapeType::BOX, { 0.4f, 0.2f, 0.2f }, { 0.0f, 2.0f, 1.0f } ) );
+    ASSERT_TRUE( box_spawned != nullptr );
+    EXPECT_EQ( mjc_model, simulation->mjc_model() );
+    EXPECT_EQ( body_slots->num_free_slots(), 1 );
+    auto spawned_adapter = dynamic_cast<loco::primitives::TMujocoSingleBodyAdapter*>( box_spawned->adapter() );
+    ASSERT_TRUE( spawned_adapter != nullptr );
+    const ssize_t spawned_geom_id = spawned_adapter->mjc_geom_id();
+    EXPECT_TRUE( spawned_adapter->mjc_body_id() == body_slots->slot( 0 ).body_id || spawned_adapter->mjc_body_id() == body_slots->slot( 1 ).body_id );
+    EXPECT_NE( mjc_model->geom_contype[spawned_geom_id], 0 );
+    EXPECT_NEAR( mjc_model->geom_size[3 * spawned_geom_id + 0], 0.2, 1e-6 );
+    EXPECT_NEAR( mjc_model->body_mass[spawned_adapter->mjc_body_id()], 1000.0 * 0.4 * 0.2 * 0.2, 1e-3 );
+    EXPECT_NEAR( mjc_model->body_invweight0[2 * spawned_adapter->mjc_body_id()], 1.0 / ( 1000.0 * 0.4 * 0.2 * 0.2 ), 1e-6 );
+    EXPECT_NEAR( mjc_data->qpos[spawned_adapter->mjc_joint_qpos_adr() + 1], 2.0, 1e-6 );
+
+    // Resets and gravity changes undo the parking state (pose, gravity compensation), so the remaining slot is parked again
+    const ssize_t still_parked_id = ( spawned_adapter->mjc_body_id() == body_slots->slot( 0 ).body_id ) ? 1 : 0;
+    const auto& still_parked = body_slots->slot( still_parked_id );
+    const loco::TVec3 rest_position = loco::mujoco::TMujocoBodySlotsManager::RestCellPosition( still_parked.rest_cell );
+    simulation->SetBulkResetEnabled( true );
+    simulation->Reset();
+    EXPECT_NEAR( mjc_data->qpos[still_parked.qpos_adr + 0], rest_position.x(), 1e-6 );
+    EXPECT_NEAR( mjc_data->qpos[still_parked.qpos_adr + 1], rest_position.y(), 1e-6 );
+    EXPECT_NEAR( mjc_data->qpos[still_parked.qpos_adr + 2], rest_position.z(), 1e-6 );
+    const mjtNum parked_mass = mjc_model->body_mass[still_parked.body_id];
+    EXPECT_NEAR( mjc_data->xfrc_applied[6 * still_parked.body_id + 2], -mjc_model->opt.gravity[2] * parked_mass, 1e-6 );
+    EXPECT_EQ( mjc_model->geom_contype[still_parked.geom_id], 0 );
+
+    simulation->SetGravity( { 0.0f, 0.0f, -5.0f } );
+    EXPECT_NEAR( mjc_data->xfrc_applied[6 * still_parked.body_id + 2], 5.0 * parked_mass, 1e-6 );
+    for ( ssize_t i = 0; i < 20; i++ )
+        simulation->Step();
+    EXPECT_NEAR( mjc_data->qpos[still_parked.qpos_adr + 2], rest_position.z(), 1e-6 );
+
+    // Without implicit damping (RK4), parked bodies are put back at rest after every step instead of drifting away
+    simulation->mjc_model()->opt.integrator = mjINT_RK4;
+    mjc_data->qvel[still_parked.qvel_adr + 2] = 1.0;
+    for ( ssize_t i = 0; i < 20; i++ )
+        simulation->Step();
+    EXPECT_NEAR( mjc_data->qpos[still_parked.qpos_adr + 2], rest_position.z(), 1e-6 );
+    EXPECT_DOUBLE_EQ( mjc_data->qvel[still_parked.qvel_adr + 2], 0.0 );
+}
+
+TEST( TestLocoMujocoSingleBodyAdapter, TestLocoMujocoSingleBodyAdapterReservedSlots )
+{
+    loco::InitUtils();
+
+    auto create_sphere = []( const std::string& name, float radius, const loco::TVec3& position )
+        {
+            auto col_data = loco::TCollisionData();
+            col_data.type = loco::eShapeType::SPHERE;
+            col_data.size = { radius, radius, radius };
+            auto body_data = loco::TBodyData();
+            body_data.dyntype = loco::eDynamicsType::DYNAMIC;
+            body_data.collision = col_data;
+            body_data.visual.type = loco::eShapeType::SPHERE;
+            body_data.visual.size = { radius, radius, radius };
+            return std::make_unique<loco::primitives::TSingleBody>( name, body_data, position, loco::TMat3() );
+        };
+
+    auto scenario = std::make_unique<loco::TScenario>();
+    scenario->AddSingleBody( create_sphere( "sphere_0", 0.1f, { 0.0f, 0.0f, 1.0f } ) );
+    auto simulation = std::make_unique<loco::TMujocoSimulation>( scenario.get() );
+    simulation->ReserveBodySlots( loco::eShapeType::SPHERE, { 0.1f, 0.1f, 0.1f }, 2 );
+    simulation->ReserveBodySlots( loco::eShapeType::SPHERE, { 0.5f, 0.5f, 0.5f }, 1 );
+    ASSERT_TRUE( simulation->Initialize() );
+    auto mjc_model = simulation->mjc_model();
+    const ssize_t num_bodies = mjc_model->nbody;
+    ASSERT_TRUE( simulation->mjc_body_slots() != nullptr );
+    EXPECT_EQ( simulation->mjc_body_slots()->num_free_slots(), 3 );
+
+    // Spawned bodies take the slot with the closest size-class, without recompiling the model
+    auto sphere_big = simulation->SpawnSingleBody( create_sphere( "sphere_big", 0.4f, { 1.0f, 0.0f, 1.0f } ) );
+    ASSERT_TRUE( sphere_big != nullptr );
+    EXPECT_EQ( mjc_model, simulation->mjc_model() );
+    EXPECT_EQ( mjc_model->nbody, num_bodies );
+    EXPECT_EQ( simulation->mjc_body_slots()->num_free_slots(), 2 );
+    auto big_adapter = dynamic_cast<loco::primitives::TMujocoSingleBodyAdapter*>( sphere_big->adapter() );
+    ASSERT_TRUE( big_adapter != nullptr );
+    EXPECT_NEAR( mjc_model->geom_size[3 * big_adapter->mjc_geom_id()], 0.4, 1e-6 );
+    EXPECT_NE( mjc_model->geom_contype[big_adapter->mjc_geom_id()], 0 );
+    EXPECT_NEAR( simulation->mjc_data()->qpos[big_adapter->mjc_joint_qpos_adr() + 0], 1.0, 1e-6 );
+    // Inverse weights (used by the solver) and subtree masses follow the new mass-properties, not the reserved ones
+    const ssize_t big_body_id = big_adapter->mjc_body_id();
+    const mjtNum big_mass = mjc_model->body_mass[big_body_id];
+    const mjtNum big_inertia = mjc_model->body_inertia[3 * big_body_id];
+    EXPECT_NEAR( big_mass, 1000.0 * 4.0 / 3.0 * M_PI * 0.4 * 0.4 * 0.4, 1e-2 );
+    EXPECT_NEAR( mjc_model->body_subtreemass[big_body_id], big_mass, 1e-6 );
+    EXPECT_NEAR( mjc_model->body_invweight0[2 * big_body_id + 0], 1.0 / big_mass, 1e-9 );
+    EXPECT_NEAR( mjc_model->body_invweight0[2 * big_body_id + 1], 1.0 / big_inertia, 1e-9 );
+    const ssize_t big_dof_adr = big_adapter->mjc_joint_qvel_adr();
+    for ( ssize_t i = 0; i < 3; i++ )
+    {
+        EXPECT_NEAR( mjc_model->dof_invweight0[big_dof_adr + i], 1.0 / big_mass, 1e-9 );
+        EXPECT_NEAR( mjc_model->dof_invweight0[big_dof_adr + 3 + i], 1.0 / big_inertia, 1e-9 );
+    }
+
+    // Spawned bodies are simulated as any other body
+    const mjtNum height0 = simulation->mjc_data()->qpos[big_adapter->mjc_joint_qpos_adr() + 2];
+    for ( ssize_t i = 0; i < 10; i++ )
+        simulation->Step();
+    EXPECT_LT( simulation->mjc_data()->qpos[big_adapter->mjc_joint_qpos_adr() + 2], height0 );
+
+    // No slots for other shapes
+    auto col_data = loco::TCollisionData();
+    col_data.type = loco::eShapeType::BOX;
+    col_data.size = { 0.1f, 0.1f, 0.1f };
+    auto body_data = loco::TBodyData();
+    body_data.dyntype = loco::eDynamicsType::DYNAMIC;
+    body_data.collision = col_data;
+    EXPECT_TRUE( simulation->SpawnSingleBody( std::make_unique<loco::primitives::TSingleBody>( "box_0", body_data, loco::TVec3( 0.0f, 1.0f, 1.0f ), loco::TMat3() ) ) == nullptr );
 }
\ No newline at end of file
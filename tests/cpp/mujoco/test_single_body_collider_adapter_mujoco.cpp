@@ -1,8 +1,10 @@
 
 #include <loco.h>
 #include <gtest/gtest.h>
+#include "test_helpers_mujoco.h"
 
 #include <loco_simulation_mujoco.h>
+#include <loco_model_cache_mujoco.h>
 #include <primitives/loco_single_body_collider_adapter_mujoco.h>
 //// #include <sys/stat.h>
 
@@ -69,21 +71,21 @@ TEST( TestLocoMujocoCollisionAdapter, TestLocoMujocoCollisionAdapterBuild )
         col_data.size = vec_col_sizes[i];
         vec_col_data.push_back( col_data );
     }
-    std::vector<std::unique_ptr<loco::TSingleBodyCollider>> vec_colliders;
-    std::vector<std::unique_ptr<loco::mujoco::TMujocoSingleBodyColliderAdapter>> vec_colliders_adapters;
+    std::vector<std::unique_ptr<loco::primitives::TSingleBodyCollider>> vec_colliders;
+    std::vector<std::unique_ptr<loco::primitives::TMujocoSingleBodyColliderAdapter>> vec_colliders_adapters;
     for ( size_t i = 0; i < vec_col_data.size(); i++ )
     {
         const auto collider_name = loco::mujoco::enumShape_to_mjcShape( vec_col_data[i].type ) + "_collider";
-        auto col_obj = std::make_unique<loco::TSingleBodyCollider>( collider_name, vec_col_data[i] );
-        auto col_adapter = std::make_unique<loco::mujoco::TMujocoSingleBodyColliderAdapter>( col_obj.get() );
+        auto col_obj = std::make_unique<loco::primitives::TSingleBodyCollider>( collider_name, vec_col_data[i] );
+        auto col_adapter = std::make_unique<loco::primitives::TMujocoSingleBodyColliderAdapter>( col_obj.get() );
         col_adapter->Build();
-        ASSERT_TRUE( col_adapter->element_resources() != nullptr );
+        ASSERT_EQ( col_adapter->elements_resources().size(), 1 );
         vec_colliders.push_back( std::move( col_obj ) );
         vec_colliders_adapters.push_back( std::move( col_adapter ) );
     }
 
     for ( size_t i = 0; i < vec_colliders_adapters.size(); i++ )
-        LOCO_CORE_TRACE( "mjcf-xml-collider:\n{0}", vec_colliders_adapters[i]->element_resources()->ToString() );
+        LOCO_CORE_TRACE( "mjcf-xml-collider:\n{0}", vec_colliders_adapters[i]->elements_resources()[0]->ToString() );
 
     std::vector<loco::TSizef> vec_expected_sizes = { { 0.05f, 0.1f, 0.15f },
                                                      { 0.1f },
@@ -100,7 +102,7 @@ TEST( TestLocoMujocoCollisionAdapter, TestLocoMujocoCollisionAdapterBuild )
     std::vector<std::string> vec_expected_types = { "box", "sphere", "plane", "cylinder", "capsule", "ellipsoid" };
     for ( size_t i = 0; i < vec_colliders_adapters.size(); i++ )
     {
-        auto mjcf_resources = vec_colliders_adapters[i]->element_resources();
+        auto mjcf_resources = vec_colliders_adapters[i]->elements_resources()[0];
         ASSERT_TRUE( mjcf_resources != nullptr );
         EXPECT_TRUE( mjcf_resources->HasAttributeArrayFloat( "size" ) );
         EXPECT_TRUE( allclose_sf( mjcf_resources->GetArrayFloat( "size" ), vec_expected_sizes[i] ) );
@@ -186,12 +188,12 @@ TEST( TestLocoMujocoCollisionAdapter, TestLocoMujocoCollisionAdapterInitialize )
         body_data.visual = vis_data;
 
         const auto body_name = loco::mujoco::enumShape_to_mjcShape( vec_shape_types[i] ) + "_body_" + std::to_string( i );
-        auto body_obj = std::make_unique<loco::TSingleBody>( body_name, body_data, vec_positions[i], loco::TMat3() );
+        auto body_obj = std::make_unique<loco::primitives::TSingleBody>( body_name, body_data, vec_positions[i], loco::TMat3() );
 
         scenario->AddSingleBody( std::move( body_obj ) );
     }
 
-    auto simulation = std::make_unique<loco::mujoco::TMujocoSimulation>( scenario.get() );
+    auto simulation = std::make_unique<loco::TMujocoSimulation>( scenario.get() );
     simulation->Initialize();
 
     auto mjc_model = simulation->mjc_model();
@@ -202,7 +204,7 @@ TEST( TestLocoMujocoCollisionAdapter, TestLocoMujocoCollisionAdapterInitialize )
     {
         auto collider = single_bodies_list[i]->collider();
         ASSERT_TRUE( collider != nullptr );
-        auto mjc_col_adapter = dynamic_cast<loco::mujoco::TMujocoSingleBodyColliderAdapter*>( collider->collider_adapter() );
+        auto mjc_col_adapter = dynamic_cast<loco::primitives::TMujocoSingleBodyColliderAdapter*>( collider->collider_adapter() );
         ASSERT_TRUE( mjc_col_adapter != nullptr );
 
         const ssize_t mjc_geom_id = mjc_col_adapter->mjc_geom_id();
@@ -231,11 +233,11 @@ TEST( TestLocoMujocoCollisionAdapter, TestLocoMujocoCollisionAdapterMeshBuild )
     col_data.mesh_data.filename = loco::PATH_RESOURCES + "meshes/monkey.stl";
 
     const auto collider_name = loco::mujoco::enumShape_to_mjcShape( col_data.type ) + "_collider";
-    auto col_obj = std::make_unique<loco::TSingleBodyCollider>( collider_name, col_data );
-    auto col_adapter = std::make_unique<loco::mujoco::TMujocoSingleBodyColliderAdapter>( col_obj.get() );
+    auto col_obj = std::make_unique<loco::primitives::TSingleBodyCollider>( collider_name, col_data );
+    auto col_adapter = std::make_unique<loco::primitives::TMujocoSingleBodyColliderAdapter>( col_obj.get() );
     col_adapter->Build();
 
-    auto mjcf_resources = col_adapter->element_resources();
+    auto mjcf_resources = col_adapter->elements_resources()[0];
     auto mjcf_asset_resources = col_adapter->element_asset_resources();
     ASSERT_TRUE( mjcf_resources != nullptr );
     ASSERT_TRUE( mjcf_asset_resources != nullptr );
@@ -275,11 +277,11 @@ TEST( TestLocoMujocoCollisionAdapter, TestLocoMujocoCollisionAdapterMeshUserBuil
     col_data.mesh_data.faces = vertices_faces.second;
 
     const auto collider_name = loco::mujoco::enumShape_to_mjcShape( col_data.type ) + "_collider";
-    auto col_obj = std::make_unique<loco::TSingleBodyCollider>( collider_name, col_data );
-    auto col_adapter = std::make_unique<loco::mujoco::TMujocoSingleBodyColliderAdapter>( col_obj.get() );
+    auto col_obj = std::make_unique<loco::primitives::TSingleBodyCollider>( collider_name, col_data );
+    auto col_adapter = std::make_unique<loco::primitives::TMujocoSingleBodyColliderAdapter>( col_obj.get() );
     col_adapter->Build();
 
-    auto mjcf_resources = col_adapter->element_resources();
+    auto mjcf_resources = col_adapter->elements_resources()[0];
     auto mjcf_asset_resources = col_adapter->element_asset_resources();
     ASSERT_TRUE( mjcf_resources != nullptr );
     ASSERT_TRUE( mjcf_asset_resources != nullptr );
@@ -305,14 +307,12 @@ TEST( TestLocoMujocoCollisionAdapter, TestLocoMujocoCollisionAdapterMeshUserBuil
     EXPECT_TRUE( mjcf_asset_resources->HasAttributeVec3( "scale" ) );
     EXPECT_TRUE( tinymath::allclose( mjcf_asset_resources->GetVec3( "scale" ), { 0.2f, 0.2f, 0.2f } ) );
 
-    // @todo: enable only for linux platforms
-    //// struct stat results;
-    //// if ( stat( "mesh_collider.msh", &results ) == 0 )
-    ////     LOCO_CORE_INFO( "mesh-file size in bytes : {0}", results.st_size );
-    //// else
-    ////     LOCO_CORE_ERROR( "Couldn't get file-size of mesh file" );
-    //// const size_t expected_tetrahedron_data_nbytes = 112;
-    //// EXPECT_EQ( results.st_size, expected_tetrahedron_data_nbytes );
+    // User-defined meshes are kept in memory (registered later into mujoco's virtual file-system)
+    auto vfs_mesh_resource = col_adapter->vfs_mesh_resource();
+    ASSERT_TRUE( vfs_mesh_resource != nullptr );
+    EXPECT_EQ( vfs_mesh_resource->filename, "mesh_collider.msh" );
+    const size_t expected_tetrahedron_data_nbytes = 112;
+    EXPECT_EQ( vfs_mesh_resource->contents.size(), expected_tetrahedron_data_nbytes );
 }
 
 TEST( TestLocoMujocoCollisionAdapter, TestLocoMujocoCollisionAdapterMeshInitialize )
@@ -336,13 +336,13 @@ TEST( TestLocoMujocoCollisionAdapter, TestLocoMujocoCollisionAdapterMeshInitiali
     // Create duplicate meshes to check if no duplicate assets are added
     const std::string body_name_1 = "mesh_body_1";
     const std::string body_name_2 = "mesh_body_2";
-    auto body_obj_1 = std::make_unique<loco::TSingleBody>( body_name_1, body_data, loco::TVec3(), loco::TMat3() );
-    auto body_obj_2 = std::make_unique<loco::TSingleBody>( body_name_2, body_data, loco::TVec3(), loco::TMat3() );
+    auto body_obj_1 = std::make_unique<loco::primitives::TSingleBody>( body_name_1, body_data, loco::TVec3(), loco::TMat3() );
+    auto body_obj_2 = std::make_unique<loco::primitives::TSingleBody>( body_name_2, body_data, loco::TVec3(), loco::TMat3() );
 
     scenario->AddSingleBody( std::move( body_obj_1 ) );
     scenario->AddSingleBody( std::move( body_obj_2 ) );
 
-    auto simulation = std::make_unique<loco::mujoco::TMujocoSimulation>( scenario.get() );
+    auto simulation = std::make_unique<loco::TMujocoSimulation>( scenario.get() );
     simulation->Initialize();
 
     auto mjcf_simulation = simulation->mjcf_element();
@@ -358,7 +358,7 @@ TEST( TestLocoMujocoCollisionAdapter, TestLocoMujocoCollisionAdapterMeshInitiali
     ASSERT_TRUE( mesh_body != nullptr );
     auto mesh_collider = mesh_body->collider();
     ASSERT_TRUE( mesh_collider != nullptr );
-    auto mjc_col_adapter = dynamic_cast<loco::mujoco::TMujocoSingleBodyColliderAdapter*>( mesh_collider->collider_adapter() );
+    auto mjc_col_adapter = dynamic_cast<loco::primitives::TMujocoSingleBodyColliderAdapter*>( mesh_collider->collider_adapter() );
     ASSERT_TRUE( mjc_col_adapter != nullptr );
 
     const ssize_t mjc_geom_id = mjc_col_adapter->mjc_geom_id();
@@ -394,11 +394,11 @@ TEST( TestLocoMujocoCollisionAdapter, TestLocoMujocoCollisionAdapterMeshUserInit
     body_data.visual = vis_data;
 
     const auto body_name = "mesh_body";
-    auto body_obj = std::make_unique<loco::TSingleBody>( body_name, body_data, loco::TVec3(), loco::TMat3() );
+    auto body_obj = std::make_unique<loco::primitives::TSingleBody>( body_name, body_data, loco::TVec3(), loco::TMat3() );
 
     scenario->AddSingleBody( std::move( body_obj ) );
 
-    auto simulation = std::make_unique<loco::mujoco::TMujocoSimulation>( scenario.get() );
+    auto simulation = std::make_unique<loco::TMujocoSimulation>( scenario.get() );
     simulation->Initialize();
 
     auto mjc_model = simulation->mjc_model();
@@ -408,7 +408,7 @@ TEST( TestLocoMujocoCollisionAdapter, TestLocoMujocoCollisionAdapterMeshUserInit
     ASSERT_TRUE( mesh_body != nullptr );
     auto mesh_collider = mesh_body->collider();
     ASSERT_TRUE( mesh_collider != nullptr );
-    auto mjc_col_adapter = dynamic_cast<loco::mujoco::TMujocoSingleBodyColliderAdapter*>( mesh_collider->collider_adapter() );
+    auto mjc_col_adapter = dynamic_cast<loco::primitives::TMujocoSingleBodyColliderAdapter*>( mesh_collider->collider_adapter() );
     ASSERT_TRUE( mjc_col_adapter != nullptr );
 
     const ssize_t mjc_geom_id = mjc_col_adapter->mjc_geom_id();
@@ -443,14 +443,14 @@ TEST( TestLocoMujocoCollisionAdapter, TestLocoMujocoCollisionAdapterHfieldBuild
                                         0.5f * 10.0f,
                                         *std::max_element( col_data.hfield_data.heights.begin(),
                                                            col_data.hfield_data.heights.end() ) * 2.0f,
-                                        loco::mujoco::LOCO_MUJOCO_HFIELD_BASE };
+                                        loco::primitives::LOCO_MUJOCO_HFIELD_BASE };
 
     const auto collider_name = loco::mujoco::enumShape_to_mjcShape( col_data.type ) + "_collider";
-    auto col_obj = std::make_unique<loco::TSingleBodyCollider>( collider_name, col_data );
-    auto col_adapter = std::make_unique<loco::mujoco::TMujocoSingleBodyColliderAdapter>( col_obj.get() );
+    auto col_obj = std::make_unique<loco::primitives::TSingleBodyCollider>( collider_name, col_data );
+    auto col_adapter = std::make_unique<loco::primitives::TMujocoSingleBodyColliderAdapter>( col_obj.get() );
     col_adapter->Build();
 
-    auto mjcf_resources = col_adapter->element_resources();
+    auto mjcf_resources = col_adapter->elements_resources()[0];
     auto mjcf_asset_resources = col_adapter->element_asset_resources();
     ASSERT_TRUE( mjcf_resources != nullptr );
     ASSERT_TRUE( mjcf_asset_resources != nullptr );
@@ -504,11 +504,11 @@ TEST( TestLocoMujocoCollisionAdapter, TestLocoMujocoCollisionAdapterHfieldInitia
     body_data.visual = vis_data;
 
     const auto body_name = "hfield_body";
-    auto body_obj = std::make_unique<loco::TSingleBody>( body_name, body_data, loco::TVec3(), loco::TMat3() );
+    auto body_obj = std::make_unique<loco::primitives::TSingleBody>( body_name, body_data, loco::TVec3(), loco::TMat3() );
 
     scenario->AddSingleBody( std::move( body_obj ) );
 
-    auto simulation = std::make_unique<loco::mujoco::TMujocoSimulation>( scenario.get() );
+    auto simulation = std::make_unique<loco::TMujocoSimulation>( scenario.get() );
     simulation->Initialize();
 
     auto mjc_model = simulation->mjc_model();
@@ -518,7 +518,7 @@ TEST( TestLocoMujocoCollisionAdapter, TestLocoMujocoCollisionAdapterHfieldInitia
     ASSERT_TRUE( hfield_body != nullptr );
     auto mesh_collider = hfield_body->collider();
     ASSERT_TRUE( mesh_collider != nullptr );
-    auto mjc_col_adapter = dynamic_cast<loco::mujoco::TMujocoSingleBodyColliderAdapter*>( mesh_collider->collider_adapter() );
+    auto mjc_col_adapter = dynamic_cast<loco::primitives::TMujocoSingleBodyColliderAdapter*>( mesh_collider->collider_adapter() );
     ASSERT_TRUE( mjc_col_adapter != nullptr );
 
     const ssize_t mjc_geom_id = mjc_col_adapter->mjc_geom_id();
@@ -536,7 +536,7 @@ TEST( TestLocoMujocoCollisionAdapter, TestLocoMujocoCollisionAdapterHfieldInitia
     EXPECT_TRUE( std::abs( mjc_model->hfield_size[4 * mjc_geom_hfield_id + 0] - 5.0f ) < 1e-5 );
     EXPECT_TRUE( std::abs( mjc_model->hfield_size[4 * mjc_geom_hfield_id + 1] - 10.0f ) < 1e-5 );
     EXPECT_TRUE( std::abs( mjc_model->hfield_size[4 * mjc_geom_hfield_id + 2] - max_height * 2.0f ) < 1e-5 );
-    EXPECT_TRUE( std::abs( mjc_model->hfield_size[4 * mjc_geom_hfield_id + 3] - loco::mujoco::LOCO_MUJOCO_HFIELD_BASE ) < 1e-5 );
+    EXPECT_TRUE( std::abs( mjc_model->hfield_size[4 * mjc_geom_hfield_id + 3] - loco::primitives::LOCO_MUJOCO_HFIELD_BASE ) < 1e-5 );
     for ( size_t i = 0; i < num_depth_samples; i++ )
     {
         for ( size_t j = 0; j < num_width_samples; j++ )
@@ -550,4 +550,224 @@ TEST( TestLocoMujocoCollisionAdapter, TestLocoMujocoCollisionAdapterHfieldInitia
     // @todo: enable when collision-groups are enabled
     //// EXPECT_EQ( mjc_model->geom_contype[mjc_geom_id], collider->collisionGroup() );
     //// EXPECT_EQ( mjc_model->geom_conaffinity[mjc_geom_id], collider->collisionMask() );
+}
+
+TEST( TestLocoMujocoCollisionAdapter, TestLocoMujocoCollisionAdapterHfieldRegionUpdate )
+{
+    loco::InitUtils();
+
+    auto scenario = std::make_unique<loco::TScenario>();
+
+    const size_t num_width_samples = 40;
+    const size_t num_depth_samples = 40;
+    auto col_data = loco::TCollisionData();
+    col_data.type = loco::eShapeType::HEIGHTFIELD;
+    col_data.size = { 10.0f, 20.0f, 2.0f }; // width, depth, scale-height
+    col_data.hfield_data.nWidthSamples = num_width_samples;
+    col_data.hfield_data.nDepthSamples = num_depth_samples;
+    col_data.hfield_data.heights = create_hfield( num_width_samples, num_depth_samples );
+    auto vis_data = loco::TVisualData();
+    vis_data.type = loco::eShapeType::HEIGHTFIELD;
+    vis_data.size = { 10.0f, 20.0f, 2.0f }; // width, depth, scale-height
+    vis_data.hfield_data = col_data.hfield_data;
+    auto body_data = loco::TBodyData();
+    body_data.collision = col_data;
+    body_data.visual = vis_data;
+
+    const auto body_name = "hfield_body";
+    scenario->AddSingleBody( std::make_unique<loco::primitives::TSingleBody>( body_name, body_data, loco::TVec3(), loco::TMat3() ) );
+
+    auto simulation = std::make_unique<loco::TMujocoSimulation>( scenario.get() );
+    simulation->Initialize();
+
+    auto mjc_model = simulation->mjc_model();
+    auto hfield_collider = scenario->GetSingleBodyByName( body_name )->collider();
+    auto mjc_col_adapter = dynamic_cast<loco::primitives::TMujocoSingleBodyColliderAdapter*>( hfield_collider->collider_adapter() );
+    ASSERT_TRUE( mjc_col_adapter != nullptr );
+    const ssize_t mjc_geom_hfield_id = mjc_col_adapter->mjc_geom_hfield_id();
+    const ssize_t mjc_geom_hfield_start_addr = mjc_col_adapter->mjc_geom_hfield_start_addr();
+
+    auto check_heights = [&]( const std::vector<float>& expected_heights )
+        {
+            const float norm_height = mjc_col_adapter->mjc_hfield_norm_height();
+            EXPECT_TRUE( std::abs( mjc_model->hfield_size[4 * mjc_geom_hfield_id + 2] - norm_height * 2.0f ) < 1e-5 );
+            // The bounding radius follows the elevation, so the broadphase doesn't miss contacts on raised terrain
+            const double elevation = std::max<double>( norm_height * 2.0f, loco::primitives::LOCO_MUJOCO_HFIELD_BASE );
+            EXPECT_NEAR( mjc_model->geom_rbound[mjc_col_adapter->mjc_geom_id()],
+                         std::sqrt( 5.0 * 5.0 + 10.0 * 10.0 + elevation * elevation ), 1e-4 );
+            for ( size_t i = 0; i < expected_heights.size(); i++ )
+                ASSERT_TRUE( std::abs( mjc_model->hfield_data[mjc_geom_hfield_start_addr + i] * norm_height -
+                                       std::max( 0.0f, expected_heights[i] ) ) < 1e-5 );
+        };
+
+    // A patch below the max-height keeps the normalization (only the patch is rewritten)
+    auto heights = col_data.hfield_data.heights;
+    const float max_height = *std::max_element( heights.begin(), heights.end() );
+    std::vector<float> patch( 5 * 7, 0.5f * max_height );
+    mjc_col_adapter->ChangeElevationDataRegion( 10, 12, 5, 7, patch );
+    for ( size_t i = 0; i < 5; i++ )
+        for ( size_t j = 0; j < 7; j++ )
+            heights[( 10 + i ) * num_width_samples + 12 + j] = 0.5f * max_height;
+    EXPECT_TRUE( std::abs( mjc_col_adapter->mjc_hfield_norm_height() - max_height ) < 1e-5 );
+    check_heights( heights );
+
+    // A patch above the max-height grows the normalization (with some headroom)
+    std::fill( patch.begin(), patch.end(), 3.0f * max_height );
+    mjc_col_adapter->ChangeElevationDataRegion( 30, 0, 7, 5, patch );
+    for ( size_t i = 0; i < 7; i++ )
+        for ( size_t j = 0; j < 5; j++ )
+            heights[( 30 + i ) * num_width_samples + j] = 3.0f * max_height;
+    EXPECT_GE( mjc_col_adapter->mjc_hfield_norm_height(), 3.0f * max_height );
+    check_heights( heights );
+}
+
+TEST( TestLocoMujocoCollisionAdapter, TestLocoMujocoCollisionAdapterMeshBatchUpload )
+{
+    loco::InitUtils();
+
+    auto scenario = std::make_unique<loco::TScenario>();
+
+    auto vertices_faces = create_mesh_tetrahedron();
+    for ( ssize_t i = 0; i < 2; i++ )
+    {
+        auto col_data = loco::TCollisionData();
+        col_data.type = loco::eShapeType::CONVEX_MESH;
+        col_data.size = { 0.2f, 0.2f, 0.2f };
+        col_data.mesh_data.vertices = vertices_faces.first;
+        col_data.mesh_data.faces = vertices_faces.second;
+        auto vis_data = loco::TVisualData();
+        vis_data.type = loco::eShapeType::CONVEX_MESH;
+        vis_data.size = { 0.2f, 0.2f, 0.2f };
+        vis_data.mesh_data = col_data.mesh_data;
+        auto body_data = loco::TBodyData();
+        body_data.collision = col_data;
+        body_data.visual = vis_data;
+        scenario->AddSingleBody( std::make_unique<loco::primitives::TSingleBody>( "mesh_body_" + std::to_string( i ), body_data,
+                                                                      loco::TVec3( i, 0.0f, 1.0f ), loco::TMat3() ) );
+    }
+
+    auto simulation = std::make_unique<loco::TMujocoSimulation>( scenario.get() );
+    simulation->Initialize();
+    auto mjc_model = simulation->mjc_model();
+
+    std::vector<loco::primitives::TMujocoSingleBodyColliderAdapter*> mjc_col_adapters;
+    for ( ssize_t i = 0; i < 2; i++ )
+    {
+        auto mesh_collider = scenario->GetSingleBodyByName( "mesh_body_" + std::to_string( i ) )->collider();
+        mjc_col_adapters.push_back( dynamic_cast<loco::primitives::TMujocoSingleBodyColliderAdapter*>( mesh_collider->collider_adapter() ) );
+        ASSERT_TRUE( mjc_col_adapters.back() != nullptr );
+        EXPECT_EQ( mjc_col_adapters.back()->mjc_geom_mesh_vert_capacity(), 4 );
+    }
+
+    // Both meshes in one call, from contiguous buffers (second mesh is scaled by 2)
+    std::vector<float> vertices = vertices_faces.first;
+    for ( const float& coord : vertices_faces.first )
+        vertices.push_back( 2.0f * coord );
+    std::vector<int> faces = vertices_faces.second;
+    faces.insert( faces.end(), vertices_faces.second.begin(), vertices_faces.second.end() );
+    ASSERT_TRUE( loco::primitives::TMujocoSingleBodyColliderAdapter::ChangeVertexDataBatch( mjc_col_adapters, vertices, faces, { 4, 4 }, { 4, 4 } ) );
+
+    const ssize_t mjc_geom_mesh_id = mjc_col_adapters[1]->mjc_geom_mesh_id();
+    const float* mesh_vertices = mjc_model->mesh_vert + 3 * mjc_model->mesh_vertadr[mjc_geom_mesh_id];
+    const int* mesh_faces = mjc_model->mesh_face + 3 * mjc_model->mesh_faceadr[mjc_geom_mesh_id];
+    for ( ssize_t i = 0; i < 12; i++ )
+    {
+        EXPECT_FLOAT_EQ( mesh_vertices[i], 2.0f * vertices_faces.first[i] );
+        EXPECT_EQ( mesh_faces[i], vertices_faces.second[i] );
+    }
+    EXPECT_NEAR( mjc_model->geom_rbound[mjc_col_adapters[1]->mjc_geom_id()], std::sqrt( 12.0 ), 1e-5 );
+    // The compiled hull-graph describes the old vertices, so collisions must not use it anymore
+    EXPECT_EQ( mjc_model->mesh_graphadr[mjc_geom_mesh_id], -1 );
+
+    // Uploads beyond the compiled capacity are rejected (would overwrite the next mesh)
+    std::vector<float> too_many_vertices( 3 * 5, 0.0f );
+    EXPECT_FALSE( mjc_col_adapters[0]->ChangeVertexData( too_many_vertices.data(), 5, faces.data(), 4 ) );
+    EXPECT_EQ( mjc_model->mesh_vertnum[mjc_col_adapters[0]->mjc_geom_mesh_id()], 4 );
+}
+
+TEST( TestLocoMujocoCollisionAdapter, TestLocoMujocoCollisionAdapterMeshCache )
+{
+    loco::InitUtils();
+
+    // Unit cube, plus an interior vertex (not part of the hull)
+    const std::vector<float> vertices = { -0.5f, -0.5f, -0.5f,   0.5f, -0.5f, -0.5f,   0.5f, 0.5f, -0.5f,   -0.5f, 0.5f, -0.5f,
+                                          -0.5f, -0.5f,  0.5f,   0.5f, -0.5f,  0.5f,   0.5f, 0.5f,  0.5f,   -0.5f, 0.5f,  0.5f,
+                                           0.0f,  0.0f,  0.0f };
+    const std::vector<int> faces = { 0, 2, 1,   0, 3, 2,   4, 5, 6,   4, 6, 7,   0, 1, 5,   0, 5, 4,
+                                     1, 2, 6,   1, 6, 5,   2, 3, 7,   2, 7, 6,   3, 0, 4,   3, 4, 7 };
+    const loco::TVec3 scale( 0.5f, 0.5f, 0.5f );
+    EXPECT_EQ( loco::mujoco::TMujocoMeshCache::ComputeKey( vertices, faces, scale ), loco::mujoco::TMujocoMeshCache::ComputeKey( vertices, faces, scale ) );
+    EXPECT_NE( loco::mujoco::TMujocoMeshCache::ComputeKey( vertices, faces, scale ), loco::mujoco::TMujocoMeshCache::ComputeKey( vertices, {}, scale ) );
+    EXPECT_NE( loco::mujoco::TMujocoMeshCache::ComputeKey( vertices, faces, scale ), loco::mujoco::TMujocoMeshCache::ComputeKey( vertices, faces, { 1.0f, 1.0f, 1.0f } ) );
+
+    char cache_dirpath[] = "/tmp/loco_lmsh_cache_XXXXXX";
+    ASSERT_TRUE( mkdtemp( cache_dirpath ) != nullptr );
+    loco::mujoco::TMujocoMeshCache::SetCacheDirectory( cache_dirpath );
+    loco::mujoco::TMujocoMeshCache::ResetStats();
+
+    auto create_scenario = [&]( const std::vector<float>& mesh_vertices, const std::vector<int>& mesh_faces )
+        {
+            auto col_data = loco::TCollisionData();
+            col_data.type = loco::eShapeType::CONVEX_MESH;
+            col_data.size = scale;
+            col_data.mesh_data.vertices = mesh_vertices;
+            col_data.mesh_data.faces = mesh_faces;
+            auto vis_data = loco::TVisualData();
+            vis_data.type = loco::eShapeType::CONVEX_MESH;
+            vis_data.size = scale;
+            vis_data.mesh_data = col_data.mesh_data;
+            auto body_data = loco::TBodyData();
+            body_data.dyntype = loco::eDynamicsType::DYNAMIC;
+            body_data.collision = col_data;
+            body_data.visual = vis_data;
+            auto scenario = std::make_unique<loco::TScenario>();
+            scenario->AddSingleBody( std::make_unique<loco::primitives::TSingleBody>( "mesh_body", body_data, loco::TVec3( 0.0f, 0.0f, 1.0f ), loco::TMat3() ) );
+            return scenario;
+        };
+
+    auto scenario_1 = create_scenario( vertices, faces );
+    auto simulation_1 = std::make_unique<loco::TMujocoSimulation>( scenario_1.get() );
+    ASSERT_TRUE( simulation_1->Initialize() );
+    EXPECT_EQ( loco::mujoco::TMujocoMeshCache::num_misses(), 1 );
+
+    // Second build must be handed the cached hull
+    auto scenario_2 = create_scenario( vertices, faces );
+    auto simulation_2 = std::make_unique<loco::TMujocoSimulation>( scenario_2.get() );
+    ASSERT_TRUE( simulation_2->Initialize() );
+    EXPECT_EQ( loco::mujoco::TMujocoMeshCache::num_hits(), 1 );
+
+    auto mjc_col_adapter = dynamic_cast<loco::primitives::TMujocoSingleBodyColliderAdapter*>(
+                                scenario_2->GetSingleBodyByName( "mesh_body" )->collider()->collider_adapter() );
+    ASSERT_TRUE( mjc_col_adapter != nullptr );
+    auto mjc_model_2 = simulation_2->mjc_model();
+    // Only the hull is handed to mujoco (the interior vertex is gone), and it bounds vertex-data uploads
+    EXPECT_EQ( mjc_model_2->mesh_vertnum[mjc_col_adapter->mjc_geom_mesh_id()], 8 );
+    EXPECT_EQ( mjc_col_adapter->mjc_geom_mesh_vert_capacity(), 8 );
+    EXPECT_EQ( mjc_col_adapter->mjc_geom_mesh_face_capacity(), 12 );
+    // Cube is convex, so mass-properties from the hull match the ones from the full mesh
+    EXPECT_NEAR( mjc_model_2->body_mass[1], simulation_1->mjc_model()->body_mass[1], 1e-5 );
+    for ( ssize_t i = 0; i < 3; i++ )
+    {
+        EXPECT_NEAR( mjc_model_2->body_ipos[3 + i], simulation_1->mjc_model()->body_ipos[3 + i], 1e-5 );
+        EXPECT_NEAR( mjc_model_2->body_inertia[3 + i], simulation_1->mjc_model()->body_inertia[3 + i], 1e-5 );
+    }
+
+    auto entry = loco::mujoco::TMujocoMeshCache::Load( loco::mujoco::TMujocoMeshCache::ComputeKey( vertices, faces, scale ) );
+    ASSERT_TRUE( entry != nullptr );
+    EXPECT_EQ( entry->header()->source_num_vertices, 9 );
+    EXPECT_EQ( entry->header()->hull_num_vertices, 8 );
+
+    // Same cube with a dent on the top face: its hull would have a different mass, so it's never cached
+    std::vector<float> dented_vertices = vertices;
+    dented_vertices[3 * 8 + 2] = 0.1f;
+    const std::vector<int> dented_faces = { 0, 2, 1,   0, 3, 2,   4, 5, 8,   5, 6, 8,   6, 7, 8,   7, 4, 8,   0, 1, 5,   0, 5, 4,
+                                            1, 2, 6,   1, 6, 5,   2, 3, 7,   2, 7, 6,   3, 0, 4,   3, 4, 7 };
+    auto scenario_3 = create_scenario( dented_vertices, dented_faces );
+    auto simulation_3 = std::make_unique<loco::TMujocoSimulation>( scenario_3.get() );
+    ASSERT_TRUE( simulation_3->Initialize() );
+    EXPECT_TRUE( loco::mujoco::TMujocoMeshCache::Load( loco::mujoco::TMujocoMeshCache::ComputeKey( dented_vertices, dented_faces, scale ) ) == nullptr );
+    EXPECT_LT( simulation_3->mjc_model()->body_mass[1], simulation_1->mjc_model()->body_mass[1] );
+
+    loco::mujoco::TMujocoMeshCache::SetCacheDirectory( "" );
+    remove_tmp_directory( cache_dirpath );
 }
\ No newline at end of file
@@ -81,11 +81,11 @@ TEST( TestLocoMujocoConstraintAdapter, TestLocoMujocoConstraintAdapterBuild )
 
     // Spherical constraint
     {
-        auto body = scenario->AddSingleBody( std::make_unique<loco::TCapsule>( "rod_0", 0.1f, 1.0f, loco::TVec3(), loco::TMat3() ) );
-        auto constraint = std::make_unique<loco::TSingleBodySphericalConstraint>( "rod_0_spherical_const", loco::TMat4( loco::TMat3(), loco::TVec3( 0.0f, 0.0f, 0.5f ) ) );
+        auto body = scenario->AddSingleBody( std::make_unique<loco::primitives::TCapsule>( "rod_0", 0.1f, 1.0f, loco::TVec3(), loco::TMat3() ) );
+        auto constraint = std::make_unique<loco::primitives::TSingleBodySphericalConstraint>( "rod_0_spherical_const", loco::TMat4( loco::TMat3(), loco::TVec3( 0.0f, 0.0f, 0.5f ) ) );
         EXPECT_EQ( constraint->constraint_type(), loco::eConstraintType::SPHERICAL );
         body->SetConstraint( std::move( constraint ) );
-        auto body_adapter = std::make_unique<loco::mujoco::TMujocoSingleBodyAdapter>( body );
+        auto body_adapter = std::make_unique<loco::primitives::TMujocoSingleBodyAdapter>( body );
         body->SetBodyAdapter( body_adapter.get() );
         body_adapter->Build();
 
@@ -93,7 +93,7 @@ TEST( TestLocoMujocoConstraintAdapter, TestLocoMujocoConstraintAdapterBuild )
         ASSERT_TRUE( body_constraint != nullptr );
         auto constraint_adapter = body_constraint->constraint_adapter();
         ASSERT_TRUE( constraint_adapter != nullptr );
-        auto mjc_constraint_adapter = dynamic_cast<loco::mujoco::TMujocoSingleBodySphericalConstraintAdapter*>( constraint_adapter );
+        auto mjc_constraint_adapter = dynamic_cast<loco::primitives::TMujocoSingleBodySphericalConstraintAdapter*>( constraint_adapter );
         ASSERT_TRUE( mjc_constraint_adapter != nullptr );
 
         auto mjcf_elements = mjc_constraint_adapter->elements_resources();
@@ -112,11 +112,11 @@ TEST( TestLocoMujocoConstraintAdapter, TestLocoMujocoConstraintAdapterBuild )
 
     // Translational3d constraint
     {
-        auto body = scenario->AddSingleBody( std::make_unique<loco::TSphere>( "sphere_0", 0.1f, loco::TVec3(), loco::TMat3() ) );
-        auto constraint = std::make_unique<loco::TSingleBodyTranslational3dConstraint>( "sphere_0_translational3d_const" );
+        auto body = scenario->AddSingleBody( std::make_unique<loco::primitives::TSphere>( "sphere_0", 0.1f, loco::TVec3(), loco::TMat3() ) );
+        auto constraint = std::make_unique<loco::primitives::TSingleBodyTranslational3dConstraint>( "sphere_0_translational3d_const" );
         EXPECT_EQ( constraint->constraint_type(), loco::eConstraintType::TRANSLATIONAL3D );
         body->SetConstraint( std::move( constraint ) );
-        auto body_adapter = std::make_unique<loco::mujoco::TMujocoSingleBodyAdapter>( body );
+        auto body_adapter = std::make_unique<loco::primitives::TMujocoSingleBodyAdapter>( body );
         body->SetBodyAdapter( body_adapter.get() );
         body_adapter->Build();
 
@@ -124,7 +124,7 @@ TEST( TestLocoMujocoConstraintAdapter, TestLocoMujocoConstraintAdapterBuild )
         ASSERT_TRUE( body_constraint != nullptr );
         auto constraint_adapter = body_constraint->constraint_adapter();
         ASSERT_TRUE( constraint_adapter != nullptr );
-        auto mjc_constraint_adapter = dynamic_cast<loco::mujoco::TMujocoSingleBodyTranslational3dConstraintAdapter*>( constraint_adapter );
+        auto mjc_constraint_adapter = dynamic_cast<loco::primitives::TMujocoSingleBodyTranslational3dConstraintAdapter*>( constraint_adapter );
         ASSERT_TRUE( mjc_constraint_adapter != nullptr );
 
         auto mjcf_elements = mjc_constraint_adapter->elements_resources();
@@ -172,11 +172,11 @@ TEST( TestLocoMujocoConstraintAdapter, TestLocoMujocoConstraintAdapterBuild )
 
     // Universal3d constraint
     {
-        auto body = scenario->AddSingleBody( std::make_unique<loco::TSphere>( "sphere_1", 0.1f, loco::TVec3(), loco::TMat3() ) );
-        auto constraint = std::make_unique<loco::TSingleBodyUniversal3dConstraint>( "sphere_1_universal3d_const" );
+        auto body = scenario->AddSingleBody( std::make_unique<loco::primitives::TSphere>( "sphere_1", 0.1f, loco::TVec3(), loco::TMat3() ) );
+        auto constraint = std::make_unique<loco::primitives::TSingleBodyUniversal3dConstraint>( "sphere_1_universal3d_const" );
         EXPECT_EQ( constraint->constraint_type(), loco::eConstraintType::UNIVERSAL3D );
         body->SetConstraint( std::move( constraint ) );
-        auto body_adapter = std::make_unique<loco::mujoco::TMujocoSingleBodyAdapter>( body );
+        auto body_adapter = std::make_unique<loco::primitives::TMujocoSingleBodyAdapter>( body );
         body->SetBodyAdapter( body_adapter.get() );
         body_adapter->Build();
 
@@ -184,7 +184,7 @@ TEST( TestLocoMujocoConstraintAdapter, TestLocoMujocoConstraintAdapterBuild )
         ASSERT_TRUE( body_constraint != nullptr );
         auto constraint_adapter = body_constraint->constraint_adapter();
         ASSERT_TRUE( constraint_adapter != nullptr );
-        auto mjc_constraint_adapter = dynamic_cast<loco::mujoco::TMujocoSingleBodyUniversal3dConstraintAdapter*>( constraint_adapter );
+        auto mjc_constraint_adapter = dynamic_cast<loco::primitives::TMujocoSingleBodyUniversal3dConstraintAdapter*>( constraint_adapter );
         ASSERT_TRUE( mjc_constraint_adapter != nullptr );
 
         auto mjcf_elements = mjc_constraint_adapter->elements_resources();
@@ -245,11 +245,11 @@ TEST( TestLocoMujocoConstraintAdapter, TestLocoMujocoConstraintAdapterBuild )
 
     // Planar constraint
     {
-        auto body = scenario->AddSingleBody( std::make_unique<loco::TSphere>( "sphere_2", 0.1f, loco::TVec3(), loco::TMat3() ) );
-        auto constraint = std::make_unique<loco::TSingleBodyPlanarConstraint>( "sphere_2_planar_const" );
+        auto body = scenario->AddSingleBody( std::make_unique<loco::primitives::TSphere>( "sphere_2", 0.1f, loco::TVec3(), loco::TMat3() ) );
+        auto constraint = std::make_unique<loco::primitives::TSingleBodyPlanarConstraint>( "sphere_2_planar_const" );
         EXPECT_EQ( constraint->constraint_type(), loco::eConstraintType::PLANAR );
         body->SetConstraint( std::move( constraint ) );
-        auto body_adapter = std::make_unique<loco::mujoco::TMujocoSingleBodyAdapter>( body );
+        auto body_adapter = std::make_unique<loco::primitives::TMujocoSingleBodyAdapter>( body );
         body->SetBodyAdapter( body_adapter.get() );
         body_adapter->Build();
 
@@ -257,7 +257,7 @@ TEST( TestLocoMujocoConstraintAdapter, TestLocoMujocoConstraintAdapterBuild )
         ASSERT_TRUE( body_constraint != nullptr );
         auto constraint_adapter = body_constraint->constraint_adapter();
         ASSERT_TRUE( constraint_adapter != nullptr );
-        auto mjc_constraint_adapter = dynamic_cast<loco::mujoco::TMujocoSingleBodyPlanarConstraintAdapter*>( constraint_adapter );
+        auto mjc_constraint_adapter = dynamic_cast<loco::primitives::TMujocoSingleBodyPlanarConstraintAdapter*>( constraint_adapter );
         ASSERT_TRUE( mjc_constraint_adapter != nullptr );
 
         auto mjcf_elements = mjc_constraint_adapter->elements_resources();
@@ -0,0 +1,117 @@
+#!/usr/bin/env python
+
+import loco
+import loco_mujoco
+import numpy as np
+import os
+import pytest
+import sys
+import threading
+
+def create_scenario() :
+    col_data = loco.sim.CollisionData()
+    col_data.type = loco.sim.ShapeType.BOX
+    col_data.size = [ 0.2, 0.2, 0.2 ]
+    vis_data = loco.sim.VisualData()
+    vis_data.type = loco.sim.ShapeType.BOX
+    vis_data.size = [ 0.2, 0.2, 0.2 ]
+
+    body_data = loco.sim.BodyData()
+    body_data.dyntype = loco.sim.DynamicsType.DYNAMIC
+    body_data.collision = col_data
+    body_data.visual = vis_data
+
+    body_obj = loco.sim.SingleBody( 'box', body_data, [ 0.0, 0.0, 1.0 ], np.identity( 3 ) )
+    scenario = loco.sim.Scenario()
+    scenario.AddSingleBody( body_obj )
+    return scenario
+
+def test_mujoco_bindings_split_phase() :
+    scenario = create_scenario()
+    runtime = loco.sim.Runtime( loco.sim.PHYSICS_MUJOCO, loco.sim.RENDERING_NONE )
+    simulation = runtime.CreateSimulation( scenario )
+
+    # Free-joint box: qpos = (x, y, z, qw, qx, qy, qz), qvel = (v, w)
+    assert ( loco_mujoco.GetQpos( simulation ).shape == ( 7, ) )
+    assert ( loco_mujoco.GetQvel( simulation ).shape == ( 6, ) )
+    assert ( loco_mujoco.GetSensorData( simulation ).shape == ( 0, ) )
+
+    # Split-phase steps must match regular steps (default integrator is Euler)
+    for _ in range( 10 ) :
+        simulation.Step()
+    qpos_step = loco_mujoco.GetQpos( simulation )
+    qvel_step = loco_mujoco.GetQvel( simulation )
+
+    simulation.Reset()
+    for _ in range( 10 ) :
+        loco_mujoco.StepPhase1( simulation )
+        loco_mujoco.StepPhase2( simulation )
+    assert ( np.allclose( loco_mujoco.GetQpos( simulation ), qpos_step ) )
+    assert ( np.allclose( loco_mujoco.GetQvel( simulation ), qvel_step ) )
+
+    # Arrays are copies, so they don't change with the simulation
+    qpos_copy = loco_mujoco.GetQpos( simulation )
+    simulation.Step()
+    assert ( np.allclose( qpos_copy, qpos_step ) )
+
+    # A multi-period step runs the same physics steps as the regular ones
+    simulation.Reset()
+    loco_mujoco.StepN( simulation, 10 )
+    assert ( np.allclose( loco_mujoco.GetQpos( simulation ), qpos_step ) )
+
+    # The box has no actuators, so any control vector is rejected
+    with pytest.raises( ValueError ) :
+        loco_mujoco.SetCtrl( simulation, np.ones( 1 ) )
+    loco_mujoco.SetCtrl( simulation, np.zeros( 0 ) )
+
+    runtime.DestroySimulation()
+
+@pytest.mark.skipif( not sys.platform.startswith( 'linux' ), reason='shared-memory server is only available on linux' )
+def test_mujoco_bindings_shm_round_trip() :
+    scenario = create_scenario()
+    runtime = loco.sim.Runtime( loco.sim.PHYSICS_MUJOCO, loco.sim.RENDERING_NONE )
+    simulation = runtime.CreateSimulation( scenario )
+
+    shm_name = '/loco_test_py_shm_{}'.format( os.getpid() )
+    server = loco_mujoco.ShmServer( simulation, shm_name )
+    assert server.Start()
+    server_thread = threading.Thread( target=server.Serve )
+    server_thread.start()
+
+    client = loco_mujoco.ShmClient( shm_name )
+    assert client.Connect()
+    qpos = client.qpos
+    assert ( qpos.shape == ( 7, ) )
+    assert ( client.qvel.shape == ( 6, ) )
+    assert np.isclose( qpos[2], 1.0 )
+
+    # Observations are views into the segment: updated in place by the server, but never writable by clients
+    for _ in range( 10 ) :
+        assert client.Step()
+    assert ( qpos[2] < 1.0 )
+    assert np.allclose( qpos, loco_mujoco.GetQpos( simulation ) )
+    assert ( client.time > 0.0 )
+    for obs in [ client.qpos, client.qvel, client.sensordata ] :
+        assert not obs.flags.writeable
+        with pytest.raises( ValueError ) :
+            obs[...] = 0.0
+    assert client.ctrl.flags.writeable
+
+    assert client.Reset()
+    assert np.isclose( qpos[2], 1.0 )
+    assert client.Close()
+    server_thread.join()
+
+    # Nobody serves the segment anymore, so requests time out instead of blocking forever
+    client.SetRequestTimeout( 50 )
+    assert not client.Step()
+
+    del qpos, client
+    del server
+    runtime.DestroySimulation()
+
+if __name__ == '__main__' :
+    _ = input( 'Press ENTER to start test : test_mujoco_bindings_split_phase' )
+    test_mujoco_bindings_split_phase()
+    _ = input( 'Press ENTER to start test : test_mujoco_bindings_shm_round_trip' )
+    test_mujoco_bindings_shm_round_trip()
\ No newline at end of file